@@ -3,6 +3,10 @@
 
 int main() {
     Window* win = windowNew(1280, 720, "Example");
+    windowSetDamageTracking(win, 1);    // nothing changes, so only present once
+    windowSetLoopMode(win, WINDOW_LOOP_WAIT_EVENTS);    // sleep instead of spinning
+    windowSetSwapMode(win, WINDOW_SWAP_ADAPTIVE);   // vsync without stalling late frames
+    windowSetFramesInFlight(win, 1);    // lowest input latency
     while (!windowCloseEvent(win)) {
         windowRefresh(win);
     }
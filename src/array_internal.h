@@ -0,0 +1,43 @@
+// Growable array internal API, for modules that keep their own arrays
+
+#ifndef ARRAY_INTERNAL_H
+#define ARRAY_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "defines.h"
+
+// Grow an array so it holds at least needed elements, doubling each time
+// from 64. Returns 0 if out of memory, the array is unchanged then
+// Expanded in the including unit, so it allocates with that unit's tag
+HELPER int internal_arrayReserve(void** array, uint32_t* capacity,
+                                 size_t elementSize, uint32_t needed) {
+    if (needed <= *capacity)
+        return 1;
+    uint32_t newCapacity = *capacity ? *capacity : 64;
+    while (newCapacity < needed)
+        newCapacity *= 2;
+    void* grown = TG_REALLOC(*array, (size_t) newCapacity * elementSize);
+    if (!grown)
+        return 0;
+    *array = grown;
+    *capacity = newCapacity;
+    return 1;
+}
+
+// Grow two arrays sharing one capacity, as internal_arrayReserve. Returns 0
+// if out of memory, the capacity is unchanged then
+HELPER int internal_arrayReservePair(void** first, void** second,
+                                     uint32_t* capacity, size_t firstSize,
+                                     size_t secondSize, uint32_t needed) {
+    uint32_t firstCapacity = *capacity;
+    uint32_t secondCapacity = *capacity;
+    if (!internal_arrayReserve(first, &firstCapacity, firstSize, needed) ||
+        !internal_arrayReserve(second, &secondCapacity, secondSize, needed))
+        return 0;
+    *capacity = firstCapacity;
+    return 1;
+}
+
+#endif // ARRAY_INTERNAL_H
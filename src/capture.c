@@ -0,0 +1,338 @@
+#define TG_MEMORY_TAG MEMORY_TAG_CAPTURE
+
+// get function defines
+#include "capture.h"
+#include "image.h"
+#include "gpu_memory.h"
+#include "trace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <threads.h>
+
+#include "../vendor/glad/gl.h"
+
+// Longest wait on a fence while flushing, retried until the GPU is done
+#define CAPTURE_FENCE_TIMEOUT 1000000000ull
+
+// Internal Struct
+struct _Capture {
+    uint32_t width, height;
+    CaptureFormat format;
+    uint32_t framesPerSecond;
+    char* path;
+    FILE* file;             // RAW and Y4M, every frame goes to one file
+    uint8_t* planes;        // Y4M conversion, encoder thread only
+    uint32_t nextNumber;    // frame number of the next request
+
+    // readback ring, slots [oldest, oldest + inFlight) wait for the GPU
+    uint32_t buffers[CAPTURE_RING_SIZE];
+    GLsync fences[CAPTURE_RING_SIZE];
+    uint32_t slotNumbers[CAPTURE_RING_SIZE];
+    uint32_t oldest;
+    uint32_t inFlight;
+
+    // encoder queue, frames [head, head + queued) wait for the worker,
+    // everything below is guarded by lock
+    mtx_t lock;
+    cnd_t changed;          // a frame was queued, written, or stop was set
+    thrd_t worker;
+    uint8_t stop;
+    uint8_t* frames[CAPTURE_QUEUE_SIZE];
+    uint32_t frameNumbers[CAPTURE_QUEUE_SIZE];
+    uint32_t head;
+    uint32_t queued;
+    CaptureStats stats;
+};
+
+PRIVATE size_t internal_captureFrameBytes(Capture* capture) {
+    return (size_t) capture->width * capture->height * 4;
+}
+
+// BT.601 studio range, the colorimetry Y4M readers assume
+PRIVATE void internal_captureToYuv(Capture* capture, const uint8_t* pixels) {
+    size_t count = (size_t) capture->width * capture->height;
+    uint8_t* y = capture->planes;
+    uint8_t* u = y + count;
+    uint8_t* v = u + count;
+    for (size_t i = 0; i < count; i++) {
+        int r = pixels[i * 4], g = pixels[i * 4 + 1], b = pixels[i * 4 + 2];
+        y[i] = (uint8_t) (((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        u[i] = (uint8_t) (((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        v[i] = (uint8_t) (((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+}
+
+PRIVATE uint8_t internal_captureEncode(Capture* capture,
+                                       const uint8_t* pixels,
+                                       uint32_t number) {
+    size_t bytes = internal_captureFrameBytes(capture);
+    switch (capture->format) {
+        case CAPTURE_FORMAT_PNG: {
+            char name[1024];
+            snprintf(name, sizeof(name), capture->path, number);
+            return imageWritePng(name, pixels, capture->width,
+                                 capture->height, PIXEL_FORMAT_RGBA8, 0);
+        }
+        case CAPTURE_FORMAT_RAW:
+            return fwrite(pixels, 1, bytes, capture->file) == bytes;
+        case CAPTURE_FORMAT_Y4M: {
+            size_t planeBytes = bytes / 4 * 3;
+            internal_captureToYuv(capture, pixels);
+            return fputs("FRAME\n", capture->file) >= 0 &&
+                   fwrite(capture->planes, 1, planeBytes, capture->file) ==
+                   planeBytes;
+        }
+    }
+    return 0;
+}
+
+PRIVATE int internal_captureWorker(void* argument) {
+    Capture* capture = argument;
+    mtx_lock(&capture->lock);
+    for (;;) {
+        while (!capture->queued && !capture->stop)
+            cnd_wait(&capture->changed, &capture->lock);
+        if (!capture->queued)
+            break;
+
+        // the frame stays queued while it is encoded, so its buffer is
+        // not handed out again
+        uint32_t index = capture->head;
+        mtx_unlock(&capture->lock);
+        uint8_t written = internal_captureEncode(capture,
+                                                 capture->frames[index],
+                                                 capture->frameNumbers[index]);
+        mtx_lock(&capture->lock);
+
+        capture->head = (capture->head + 1) % CAPTURE_QUEUE_SIZE;
+        capture->queued--;
+        if (written)
+            capture->stats.written++;
+        else
+            capture->stats.failed++;
+        cnd_broadcast(&capture->changed);
+    }
+    mtx_unlock(&capture->lock);
+    return 0;
+}
+
+// Copy a frame into the encoder queue, rows bottom first when flip is set
+PRIVATE uint8_t internal_capturePush(Capture* capture, const uint8_t* pixels,
+                                     uint8_t flip, uint32_t number) {
+    mtx_lock(&capture->lock);
+    if (capture->queued == CAPTURE_QUEUE_SIZE) {
+        capture->stats.dropped++;
+        mtx_unlock(&capture->lock);
+        return 0;
+    }
+    uint32_t index = (capture->head + capture->queued) % CAPTURE_QUEUE_SIZE;
+    mtx_unlock(&capture->lock);
+
+    // only this thread queues frames, the slot is ours until pushed
+    size_t rowBytes = (size_t) capture->width * 4;
+    uint8_t* frame = capture->frames[index];
+    if (flip) {
+        for (uint32_t row = 0; row < capture->height; row++)
+            memcpy(frame + rowBytes * row,
+                   pixels + rowBytes * (capture->height - 1 - row), rowBytes);
+    } else {
+        memcpy(frame, pixels, rowBytes * capture->height);
+    }
+
+    mtx_lock(&capture->lock);
+    capture->frameNumbers[index] = number;
+    capture->queued++;
+    cnd_broadcast(&capture->changed);
+    mtx_unlock(&capture->lock);
+    return 1;
+}
+
+PRIVATE void internal_captureCount(Capture* capture, uint64_t* counter) {
+    mtx_lock(&capture->lock);
+    (*counter)++;
+    mtx_unlock(&capture->lock);
+}
+
+// Hand finished readbacks to the encoder, oldest first
+PRIVATE void internal_captureCollect(Capture* capture, uint8_t wait) {
+    while (capture->inFlight) {
+        uint32_t slot = capture->oldest;
+        GLenum status = glClientWaitSync(capture->fences[slot],
+                                         GL_SYNC_FLUSH_COMMANDS_BIT,
+                                         wait ? CAPTURE_FENCE_TIMEOUT : 0);
+        if (status == GL_TIMEOUT_EXPIRED) {
+            if (wait)
+                continue;
+            return;     // later frames can't be done either
+        }
+        glDeleteSync(capture->fences[slot]);
+        capture->fences[slot] = NULL;
+
+        const void* pixels = NULL;
+        if (status != GL_WAIT_FAILED) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, capture->buffers[slot]);
+            pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+                                      (GLsizeiptr)
+                                      internal_captureFrameBytes(capture),
+                                      GL_MAP_READ_BIT);
+        }
+        if (pixels) {
+            internal_capturePush(capture, pixels, 1,
+                                 capture->slotNumbers[slot]);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        } else {
+            internal_captureCount(capture, &capture->stats.failed);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        capture->oldest = (capture->oldest + 1) % CAPTURE_RING_SIZE;
+        capture->inFlight--;
+    }
+}
+
+PRIVATE void internal_captureFree(Capture* capture) {
+    for (uint32_t i = 0; i < CAPTURE_QUEUE_SIZE; i++)
+        TG_FREE(capture->frames[i]);
+    if (capture->file)
+        fclose(capture->file);
+    TG_FREE(capture->planes);
+    TG_FREE(capture->path);
+    TG_FREE(capture);
+}
+
+Capture* captureNew(uint32_t width, uint32_t height, CaptureFormat format,
+                    const char* path, uint32_t framesPerSecond) {
+    if (!width || !height)
+        return NULL;
+    Capture* capture = ALLOC_S(Capture);
+    if (!capture)
+        return NULL;
+    memset(capture, 0, sizeof(Capture));
+    capture->width = width;
+    capture->height = height;
+    capture->format = format;
+    capture->framesPerSecond = framesPerSecond ? framesPerSecond : 60;
+
+    size_t bytes = internal_captureFrameBytes(capture);
+    uint8_t failed = 0;
+    size_t pathLength = strlen(path) + 1;
+    capture->path = TG_MALLOC(pathLength);
+    failed |= !capture->path;
+    for (uint32_t i = 0; i < CAPTURE_QUEUE_SIZE; i++) {
+        capture->frames[i] = TG_MALLOC(bytes);
+        failed |= !capture->frames[i];
+    }
+    if (format == CAPTURE_FORMAT_Y4M) {
+        capture->planes = TG_MALLOC(bytes / 4 * 3);
+        failed |= !capture->planes;
+    }
+    if (format != CAPTURE_FORMAT_PNG) {
+        capture->file = fopen(path, "wb");
+        failed |= !capture->file;
+    }
+    if (failed) {
+        internal_captureFree(capture);
+        return NULL;
+    }
+    memcpy(capture->path, path, pathLength);
+    if (format == CAPTURE_FORMAT_Y4M)
+        fprintf(capture->file, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C444\n",
+                width, height, capture->framesPerSecond);
+
+    if (mtx_init(&capture->lock, mtx_plain) != thrd_success) {
+        internal_captureFree(capture);
+        return NULL;
+    }
+    if (cnd_init(&capture->changed) != thrd_success) {
+        mtx_destroy(&capture->lock);
+        internal_captureFree(capture);
+        return NULL;
+    }
+    if (thrd_create(&capture->worker, internal_captureWorker, capture) !=
+        thrd_success) {
+        cnd_destroy(&capture->changed);
+        mtx_destroy(&capture->lock);
+        internal_captureFree(capture);
+        return NULL;
+    }
+    return capture;
+}
+
+uint8_t captureFrame(Capture* capture) {
+    TRACE_FUNCTION();
+    GLsizeiptr bytes = (GLsizeiptr) internal_captureFrameBytes(capture);
+    if (!capture->buffers[0]) {
+        glGenBuffers(CAPTURE_RING_SIZE, capture->buffers);
+        for (uint32_t i = 0; i < CAPTURE_RING_SIZE; i++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, capture->buffers[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+            gpuMemoryAllocated(GPU_MEMORY_BUFFER, (uint64_t) bytes);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+
+    internal_captureCollect(capture, 0);
+    uint32_t number = capture->nextNumber++;
+    internal_captureCount(capture, &capture->stats.submitted);
+    if (capture->inFlight == CAPTURE_RING_SIZE) {
+        // every buffer is still being read, waiting would stall the frame
+        internal_captureCount(capture, &capture->stats.dropped);
+        return 0;
+    }
+
+    uint32_t slot = (capture->oldest + capture->inFlight) % CAPTURE_RING_SIZE;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, capture->buffers[slot]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, (GLsizei) capture->width, (GLsizei) capture->height,
+                 GL_RGBA, GL_UNSIGNED_BYTE, (void*) 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    capture->fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    capture->slotNumbers[slot] = number;
+    capture->inFlight++;
+    return 1;
+}
+
+uint8_t captureSubmitPixels(Capture* capture, const void* pixels) {
+    internal_captureCount(capture, &capture->stats.submitted);
+    return internal_capturePush(capture, pixels, 0, capture->nextNumber++);
+}
+
+void captureFlush(Capture* capture) {
+    TRACE_FUNCTION();
+    internal_captureCollect(capture, 1);
+    mtx_lock(&capture->lock);
+    while (capture->queued)
+        cnd_wait(&capture->changed, &capture->lock);
+    mtx_unlock(&capture->lock);
+    if (capture->file)
+        fflush(capture->file);
+}
+
+CaptureStats captureGetStats(Capture* capture) {
+    mtx_lock(&capture->lock);
+    CaptureStats stats = capture->stats;
+    mtx_unlock(&capture->lock);
+    return stats;
+}
+
+void captureDestroy(Capture* capture) {
+    if (!capture)
+        return;
+    captureFlush(capture);
+    mtx_lock(&capture->lock);
+    capture->stop = 1;
+    cnd_broadcast(&capture->changed);
+    mtx_unlock(&capture->lock);
+    thrd_join(capture->worker, NULL);
+    cnd_destroy(&capture->changed);
+    mtx_destroy(&capture->lock);
+
+    if (capture->buffers[0]) {
+        glDeleteBuffers(CAPTURE_RING_SIZE, capture->buffers);
+        for (uint32_t i = 0; i < CAPTURE_RING_SIZE; i++)
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) internal_captureFrameBytes(capture));
+    }
+    internal_captureFree(capture);
+}
@@ -0,0 +1,105 @@
+// Frame capture public API
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdint.h>
+
+#include "defines.h"
+
+// Pixel pack buffers read back in rotation, frames are mapped this many
+// captures minus one after they were requested
+#define CAPTURE_RING_SIZE 3
+
+// Frames waiting for the encoder before new ones are dropped
+#define CAPTURE_QUEUE_SIZE 4
+
+/**
+ * @brief   How captured frames are written
+ */
+typedef enum CaptureFormat {
+    CAPTURE_FORMAT_PNG,     /**< One file per frame, path is a pattern */
+    CAPTURE_FORMAT_RAW,     /**< Every frame appended to one file as RGBA */
+    CAPTURE_FORMAT_Y4M      /**< YUV4MPEG2 4:4:4 video, one file */
+} CaptureFormat;
+
+/**
+ * @brief   Counters since the capture was created
+ */
+typedef struct CaptureStats {
+    uint64_t submitted;     /**< Frames requested */
+    uint64_t written;       /**< Frames the encoder finished */
+    uint64_t dropped;       /**< Frames skipped, GPU or encoder too slow */
+    uint64_t failed;        /**< Frames that could not be written */
+} CaptureStats;
+
+/**
+ * @brief   Opaque type to Capture struct
+ * @note    Frames are read into pixel pack buffers guarded by fences and
+ *          only mapped once the GPU is done with them, a worker thread
+ *          encodes them. Nothing in captureFrame waits for the GPU, frames
+ *          are dropped and counted instead
+ */
+typedef struct _Capture Capture;
+
+/**
+ * @brief   Create a new capture and start its encoder thread
+ * @param   width: uint32_t, width of the captured frames in pixels
+ * @param   height: uint32_t, height of the captured frames in pixels
+ * @param   format: CaptureFormat, output format
+ * @param   path: file to write, for PNG a printf pattern taking the frame
+ *          number as an unsigned int, such as "frame_%05u.png"
+ * @param   framesPerSecond: uint32_t, rate stored in Y4M headers
+ * @returns Pointer to a new Capture, NULL on failure
+ * @note    Needs no OpenGL context, buffers are created by the first
+ *          captureFrame
+ * @see     Capture, CaptureFormat
+ */
+TGAPI Capture* captureNew(uint32_t width, uint32_t height,
+                          CaptureFormat format, const char* path,
+                          uint32_t framesPerSecond);
+
+/**
+ * @brief   Queue a readback of the bound read framebuffer
+ * @param   capture: Pointer to the capture
+ * @returns 1 if the frame was queued, 0 if it was dropped
+ * @note    Reads the bottom left width x height pixels. For a Window or a
+ *          headless window call it after drawing and before windowRefresh,
+ *          for a RenderTarget bind its framebuffer first. Finished earlier
+ *          readbacks are handed to the encoder on the way
+ */
+TGAPI uint8_t captureFrame(Capture* capture);
+
+/**
+ * @brief   Queue a frame rendered on the CPU
+ * @param   capture: Pointer to the capture
+ * @param   pixels: width x height RGBA pixels, top row first, copied
+ * @returns 1 if the frame was queued, 0 if it was dropped
+ */
+TGAPI uint8_t captureSubmitPixels(Capture* capture, const void* pixels);
+
+/**
+ * @brief   Wait until every queued frame is written
+ * @param   capture: Pointer to the capture
+ * @returns void
+ * @note    Waits for the GPU when readbacks are in flight, not for per frame
+ *          use
+ */
+TGAPI void captureFlush(Capture* capture);
+
+/**
+ * @param   capture: Pointer to the capture
+ * @returns Counters since the capture was created
+ * @see     CaptureStats
+ */
+TGAPI CaptureStats captureGetStats(Capture* capture);
+
+/**
+ * @brief   Flush, stop the encoder and free the capture
+ * @param   capture: Pointer to the capture
+ * @returns void
+ * @note    Needs the OpenGL context captureFrame used, if it was called
+ */
+TGAPI void captureDestroy(Capture* capture);
+
+#endif // CAPTURE_H
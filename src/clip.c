@@ -0,0 +1,332 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "clip.h"
+#include "array_internal.h"
+#include "shader.h"
+#include "gpu_memory.h"
+#include "trace.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+// Polygons only touch the stencil buffer, the color is never written
+static const char* const clipVertex =
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPosition;\n"
+    "uniform vec2 uViewSize;\n"
+    "void main() {\n"
+    "    vec2 ndc = aPosition / uViewSize * 2.0 - 1.0;\n"
+    "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* const clipFragment =
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    FragColor = vec4(0.0);\n"
+    "}\n";
+
+// One pushed clip
+typedef struct ClipEntryInternal {
+    Rect rect;              // intersected with every clip below
+    uint16_t index;         // into the clip table
+    uint8_t polygon;        // 1 if it raised the stencil depth
+    uint32_t firstPoint;    // polygon corners, to undo the stencil on pop
+    uint32_t pointCount;
+} ClipEntryInternal;
+
+// Internal Struct
+struct _ClipStack {
+    Vec2 viewSize;
+    Rect rects[CLIP_MAX_RECTS];
+    uint32_t rectCount;
+
+    ClipEntryInternal* entries;
+    uint32_t depth, entryCapacity;
+    Vec2* points;
+    uint32_t pointCount, pointCapacity;
+    uint32_t stencilDepth;
+    uint8_t stencilCleared;     // once per frame, before the first polygon
+    uint8_t scissorEnabled;
+
+    ClipStats stats;
+
+    // stencil drawing, created on the first polygon
+    uint32_t stencilProgram;
+    uint32_t stencilVao;
+    uint32_t stencilBuffer;
+    uint32_t bufferCapacity;    // corners the GL buffer holds
+};
+
+// Index of rect in the table, added if new, CLIP_INVALID if full
+PRIVATE uint16_t internal_clipFindOrAdd(ClipStack* stack, Rect rect) {
+    for (uint32_t i = 0; i < stack->rectCount; i++)
+        if (!memcmp(&stack->rects[i], &rect, sizeof(Rect)))
+            return (uint16_t) i;
+    if (stack->rectCount == CLIP_MAX_RECTS)
+        return CLIP_INVALID;
+    stack->rects[stack->rectCount] = rect;
+    return (uint16_t) stack->rectCount++;
+}
+
+// Intersection with the top of the stack, collapsed to a point when empty
+// so every empty clip compares equal
+PRIVATE Rect internal_clipIntersect(ClipStack* stack, Rect rect) {
+    Rect current = clipGetRect(stack);
+    Rect clipped = rectIntersect(current, rect);
+    if (rectIsEmpty(clipped))
+        clipped.max = clipped.min = current.min;
+    return clipped;
+}
+
+PRIVATE uint16_t internal_clipPushEntry(ClipStack* stack, Rect rect,
+                                        uint8_t polygon) {
+    if (!internal_arrayReserve((void**) &stack->entries, &stack->entryCapacity,
+                               sizeof(ClipEntryInternal), stack->depth + 1))
+        return CLIP_INVALID;
+    Rect clipped = internal_clipIntersect(stack, rect);
+    uint16_t index = internal_clipFindOrAdd(stack, clipped);
+    if (index == CLIP_INVALID)
+        return CLIP_INVALID;
+
+    ClipEntryInternal* entry = &stack->entries[stack->depth++];
+    entry->rect = clipped;
+    entry->index = index;
+    entry->polygon = polygon;
+    entry->firstPoint = stack->pointCount;
+    entry->pointCount = 0;
+    stack->stats.pushes++;
+    return index;
+}
+
+PRIVATE uint8_t internal_clipStencilCreate(ClipStack* stack) {
+    stack->stencilProgram = shaderCompile(clipVertex, clipFragment);
+    if (!stack->stencilProgram)
+        return 0;
+    glGenVertexArrays(1, &stack->stencilVao);
+    glGenBuffers(1, &stack->stencilBuffer);
+    glBindVertexArray(stack->stencilVao);
+    glBindBuffer(GL_ARRAY_BUFFER, stack->stencilBuffer);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2), (void*) 0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    return 1;
+}
+
+// Draw a polygon into the stencil buffer where it holds the current depth,
+// incrementing or decrementing it, then test against the new depth
+PRIVATE void internal_clipStencilDraw(ClipStack* stack, uint32_t firstPoint,
+                                      uint32_t count, uint32_t operation,
+                                      uint32_t from, uint32_t to) {
+    TRACE_FUNCTION();
+    glBindBuffer(GL_ARRAY_BUFFER, stack->stencilBuffer);
+    if (count > stack->bufferCapacity) {
+        if (stack->bufferCapacity)
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) stack->bufferCapacity * sizeof(Vec2));
+        stack->bufferCapacity = stack->pointCapacity;
+        gpuMemoryAllocated(GPU_MEMORY_BUFFER,
+                           (uint64_t) stack->bufferCapacity * sizeof(Vec2));
+    }
+    glBufferData(GL_ARRAY_BUFFER,                                   // orphan
+                 (GLsizeiptr) stack->bufferCapacity * sizeof(Vec2), NULL,
+                 GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr) count * sizeof(Vec2),
+                    stack->points + firstPoint);
+
+    // the whole polygon has to reach the stencil, whatever is scissored
+    if (stack->scissorEnabled)
+        glDisable(GL_SCISSOR_TEST);
+    glEnable(GL_STENCIL_TEST);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glStencilMask(0xFF);
+    glStencilFunc(GL_EQUAL, (GLint) from, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, operation);
+
+    glUseProgram(stack->stencilProgram);
+    glUniform2f(glGetUniformLocation(stack->stencilProgram, "uViewSize"),
+                stack->viewSize.x, stack->viewSize.y);
+    glBindVertexArray(stack->stencilVao);
+    glDrawArrays(GL_TRIANGLE_FAN, 0, (GLsizei) count);
+    glBindVertexArray(0);
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glStencilFunc(GL_EQUAL, (GLint) to, 0xFF);
+    if (!to)
+        glDisable(GL_STENCIL_TEST);
+    if (stack->scissorEnabled)
+        glEnable(GL_SCISSOR_TEST);
+    stack->stats.stencilWrites++;
+}
+
+ClipStack* clipStackNew(void) {
+    ClipStack* stack = ALLOC_S(ClipStack);
+    if (!stack)
+        return NULL;
+    memset(stack, 0, sizeof(ClipStack));
+    stack->rectCount = 1;
+    return stack;
+}
+
+void clipBegin(ClipStack* stack, Vec2 viewSize) {
+    stack->viewSize = viewSize;
+    stack->rects[CLIP_NONE] = (Rect) { { 0.0f, 0.0f }, viewSize };
+    stack->rectCount = 1;
+    stack->depth = 0;
+    stack->pointCount = 0;
+    stack->stencilDepth = 0;
+    stack->stencilCleared = 0;
+    memset(&stack->stats, 0, sizeof(ClipStats));
+}
+
+uint16_t clipPush(ClipStack* stack, Rect rect) {
+    return internal_clipPushEntry(stack, rect, 0);
+}
+
+uint16_t clipPushRotated(ClipStack* stack, Vec2 center, Vec2 halfSize,
+                         float rotation) {
+    float c = cosf(rotation);
+    float s = sinf(rotation);
+    if (fabsf(c) < 1e-6f || fabsf(s) < 1e-6f) {
+        // a quarter turn swaps the sides, a half turn changes nothing
+        Vec2 extent = fabsf(s) < 1e-6f ? halfSize
+                                       : (Vec2) { halfSize.y, halfSize.x };
+        return clipPush(stack, (Rect) { vec2Sub(center, extent),
+                                        vec2Add(center, extent) });
+    }
+    Vec2 axisX = { c * halfSize.x, s * halfSize.x };
+    Vec2 axisY = { -s * halfSize.y, c * halfSize.y };
+    Vec2 corners[4] = {
+        vec2Sub(vec2Sub(center, axisX), axisY),
+        vec2Sub(vec2Add(center, axisX), axisY),
+        vec2Add(vec2Add(center, axisX), axisY),
+        vec2Add(vec2Sub(center, axisX), axisY)
+    };
+    return clipPushPolygon(stack, corners, 4);
+}
+
+uint16_t clipPushPolygon(ClipStack* stack, const Vec2* points,
+                         uint32_t count) {
+    if (count < 3 || stack->stencilDepth == 0xFF ||
+        !internal_arrayReserve((void**) &stack->points, &stack->pointCapacity,
+                               sizeof(Vec2), stack->pointCount + count) ||
+        (!stack->stencilProgram && !internal_clipStencilCreate(stack)))
+        return CLIP_INVALID;
+
+    Rect bounds = { points[0], points[0] };
+    for (uint32_t i = 1; i < count; i++)
+        bounds = rectUnion(bounds, (Rect) { points[i], points[i] });
+    uint16_t index = internal_clipPushEntry(stack, bounds, 1);
+    if (index == CLIP_INVALID)
+        return CLIP_INVALID;
+
+    ClipEntryInternal* entry = &stack->entries[stack->depth - 1];
+    memcpy(stack->points + stack->pointCount, points, sizeof(Vec2) * count);
+    entry->pointCount = count;
+    stack->pointCount += count;
+
+    if (!stack->stencilCleared) {
+        if (stack->scissorEnabled)
+            glDisable(GL_SCISSOR_TEST);
+        glStencilMask(0xFF);
+        glClearStencil(0);
+        glClear(GL_STENCIL_BUFFER_BIT);
+        if (stack->scissorEnabled)
+            glEnable(GL_SCISSOR_TEST);
+        stack->stencilCleared = 1;
+    }
+    internal_clipStencilDraw(stack, entry->firstPoint, count, GL_INCR,
+                             stack->stencilDepth, stack->stencilDepth + 1);
+    stack->stencilDepth++;
+    return index;
+}
+
+void clipPop(ClipStack* stack) {
+    if (!stack->depth)
+        return;
+    ClipEntryInternal* entry = &stack->entries[--stack->depth];
+    if (entry->polygon) {
+        internal_clipStencilDraw(stack, entry->firstPoint, entry->pointCount,
+                                 GL_DECR, stack->stencilDepth,
+                                 stack->stencilDepth - 1);
+        stack->stencilDepth--;
+        stack->pointCount = entry->firstPoint;
+    }
+}
+
+uint16_t clipGetIndex(ClipStack* stack) {
+    return stack->depth ? stack->entries[stack->depth - 1].index : CLIP_NONE;
+}
+
+Rect clipGetRect(ClipStack* stack) {
+    return stack->depth ? stack->entries[stack->depth - 1].rect
+                        : stack->rects[CLIP_NONE];
+}
+
+const Rect* clipGetRects(ClipStack* stack, uint32_t* count) {
+    *count = stack->rectCount;
+    return stack->rects;
+}
+
+uint32_t clipGetStencilDepth(ClipStack* stack) {
+    return stack->stencilDepth;
+}
+
+void clipFlush(ClipStack* stack) {
+    // the stack holds at most as many distinct rects as the table did
+    stack->rectCount = 1;
+    for (uint32_t i = 0; i < stack->depth; i++) {
+        ClipEntryInternal* entry = &stack->entries[i];
+        entry->index = internal_clipFindOrAdd(stack, entry->rect);
+    }
+}
+
+void clipApplyScissor(ClipStack* stack) {
+    Rect rect = clipGetRect(stack);
+    GLint left = (GLint) floorf(rect.min.x + 0.5f);
+    GLint right = (GLint) floorf(rect.max.x + 0.5f);
+    GLint top = (GLint) floorf(rect.min.y + 0.5f);
+    GLint bottom = (GLint) floorf(rect.max.y + 0.5f);
+    // OpenGL rows start at the bottom
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(left, (GLint) stack->viewSize.y - bottom,
+              right > left ? right - left : 0,
+              bottom > top ? bottom - top : 0);
+    stack->scissorEnabled = 1;
+}
+
+void clipEnd(ClipStack* stack) {
+    if (stack->scissorEnabled)
+        glDisable(GL_SCISSOR_TEST);
+    if (stack->stencilCleared)
+        glDisable(GL_STENCIL_TEST);
+    stack->scissorEnabled = 0;
+    stack->stencilCleared = 0;
+    stack->stencilDepth = 0;
+}
+
+ClipStats clipGetStats(ClipStack* stack) {
+    ClipStats stats = stack->stats;
+    stats.rects = stack->rectCount;
+    return stats;
+}
+
+void clipStackDestroy(ClipStack* stack) {
+    if (!stack)
+        return;
+    shaderDestroy(stack->stencilProgram);
+    if (stack->stencilVao) {
+        glDeleteVertexArrays(1, &stack->stencilVao);
+        glDeleteBuffers(1, &stack->stencilBuffer);
+        if (stack->bufferCapacity)  // only grown by the first stencil draw
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) stack->bufferCapacity * sizeof(Vec2));
+    }
+    TG_FREE(stack->entries);
+    TG_FREE(stack->points);
+    TG_FREE(stack);
+}
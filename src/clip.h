@@ -0,0 +1,169 @@
+// Clip stack public API
+
+#ifndef CLIP_H
+#define CLIP_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "defines.h"
+
+// Clip index of the whole view, what untagged vertices are drawn with
+#define CLIP_NONE 0
+
+// Returned by a push that found the clip table full
+#define CLIP_INVALID 0xFFFFu
+
+// Distinct clip rects per frame, the size of the uniform array shaders read
+#define CLIP_MAX_RECTS 64
+
+/**
+ * @brief   Counters since the last clipBegin
+ */
+typedef struct ClipStats {
+    uint32_t pushes;        /**< Clips pushed, rect and polygon */
+    uint32_t rects;         /**< Entries in the clip table */
+    uint32_t stencilWrites; /**< Polygons drawn into the stencil buffer */
+} ClipStats;
+
+/**
+ * @brief   Opaque type to ClipStack struct
+ * @note    Nested clips for scroll views and panels. Axis aligned clips are
+ *          intersected on the CPU into a table of rects, and vertices are
+ *          tagged with an index into it, so draws under different clips
+ *          still share one draw call. The current rect can also be applied
+ *          with glScissor. Rotated and other convex clips fall back to the
+ *          stencil buffer, which is global state, so draws must be flushed
+ *          before pushing or popping those
+ */
+typedef struct _ClipStack ClipStack;
+
+/**
+ * @brief   Create a new clip stack
+ * @returns Pointer to a new ClipStack, NULL on failure
+ * @see     ClipStack
+ */
+TGAPI ClipStack* clipStackNew(void);
+
+/**
+ * @brief   Start a frame, empties the stack and the clip table
+ * @param   stack: Pointer to the clip stack
+ * @param   viewSize: Vec2, size of the viewport in pixels, see windowGetSize
+ * @returns void
+ * @note    Index CLIP_NONE holds the whole view
+ */
+TGAPI void clipBegin(ClipStack* stack, Vec2 viewSize);
+
+/**
+ * @brief   Push an axis aligned clip, intersected with the current one
+ * @param   stack: Pointer to the clip stack
+ * @param   rect: Rect, in pixels from the top left
+ * @returns Clip index to tag vertices with, CLIP_INVALID if the table is
+ *          full, then the stack is unchanged. Draw what was tagged so far
+ *          and call clipFlush to make room
+ * @note    Identical rects share an index. No GL calls are made
+ */
+TGAPI uint16_t clipPush(ClipStack* stack, Rect rect);
+
+/**
+ * @brief   Push a clip rotated around its center
+ * @param   stack: Pointer to the clip stack
+ * @param   center: Vec2, in pixels
+ * @param   halfSize: Vec2, half width and half height before rotation
+ * @param   rotation: float, clockwise on screen, in radians
+ * @returns Clip index, as clipPush
+ * @note    Multiples of a quarter turn are rects and go through clipPush,
+ *          anything else goes through clipPushPolygon
+ */
+TGAPI uint16_t clipPushRotated(ClipStack* stack, Vec2 center, Vec2 halfSize,
+                               float rotation);
+
+/**
+ * @brief   Push a convex polygon clip, written to the stencil buffer
+ * @param   stack: Pointer to the clip stack
+ * @param   points: corners of the polygon in pixels, in either winding
+ * @param   count: uint32_t, number of corners, at least 3
+ * @returns Clip index of the polygon's bounds intersected with the current
+ *          clip, as clipPush. The stencil test removes the rest
+ * @note    Needs a current OpenGL context and a stencil buffer. Draw what
+ *          was submitted before, the stencil state changes immediately
+ */
+TGAPI uint16_t clipPushPolygon(ClipStack* stack, const Vec2* points,
+                               uint32_t count);
+
+/**
+ * @brief   Return to the clip before the last push
+ * @param   stack: Pointer to the clip stack
+ * @returns void
+ * @note    Popping a polygon clip updates the stencil buffer, see
+ *          clipPushPolygon
+ */
+TGAPI void clipPop(ClipStack* stack);
+
+/**
+ * @param   stack: Pointer to the clip stack
+ * @returns Clip index of the top of the stack, CLIP_NONE when empty
+ */
+TGAPI uint16_t clipGetIndex(ClipStack* stack);
+
+/**
+ * @param   stack: Pointer to the clip stack
+ * @returns Current clip rect, empty when nothing can be drawn. Anything
+ *          outside it can be culled on the CPU
+ */
+TGAPI Rect clipGetRect(ClipStack* stack);
+
+/**
+ * @param   stack: Pointer to the clip stack
+ * @param   count: receives the number of rects
+ * @returns Clip table, indexed by clip index, valid until the next push
+ */
+TGAPI const Rect* clipGetRects(ClipStack* stack, uint32_t* count);
+
+/**
+ * @param   stack: Pointer to the clip stack
+ * @returns Number of polygon clips on the stack, draws that are batched
+ *          together must share it
+ */
+TGAPI uint32_t clipGetStencilDepth(ClipStack* stack);
+
+/**
+ * @brief   Restart the clip table from the clips on the stack
+ * @param   stack: Pointer to the clip stack
+ * @returns void
+ * @note    Indices returned before are invalid afterwards, use
+ *          clipGetIndex for the current one
+ */
+TGAPI void clipFlush(ClipStack* stack);
+
+/**
+ * @brief   Scissor to the current clip rect, for draws that aren't tagged
+ * @param   stack: Pointer to the clip stack
+ * @returns void
+ * @note    Needs a current OpenGL context. Pixels are kept when their
+ *          center is inside the rect, as with tagged vertices
+ */
+TGAPI void clipApplyScissor(ClipStack* stack);
+
+/**
+ * @brief   End a frame, turns off the scissor and stencil tests
+ * @param   stack: Pointer to the clip stack
+ * @returns void
+ * @note    Needs a current OpenGL context when either test was used
+ */
+TGAPI void clipEnd(ClipStack* stack);
+
+/**
+ * @param   stack: Pointer to the clip stack
+ * @returns Counters since the last clipBegin
+ */
+TGAPI ClipStats clipGetStats(ClipStack* stack);
+
+/**
+ * @brief   Free the stack, on the CPU and the GPU
+ * @param   stack: Pointer to the clip stack
+ * @returns void
+ */
+TGAPI void clipStackDestroy(ClipStack* stack);
+
+#endif // CLIP_H
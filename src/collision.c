@@ -0,0 +1,458 @@
+#define TG_MEMORY_TAG MEMORY_TAG_SPATIAL
+
+// get function defines
+#include "collision.h"
+#include "array_internal.h"
+#include "constants.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef VECTOR_SSE
+    #include <xmmintrin.h>
+#endif
+
+// Marks an unused slot, or the end of the free list
+#define COLLISION_NONE 0xFFFFFFFFu
+
+// Moves per body an insertion sort may make before the order is treated as
+// lost and sorted from scratch, after teleports or many new bodies
+#define COLLISION_SWAP_BUDGET 16
+
+typedef struct CollisionBodyInternal {
+    CollisionShape shape;
+    Vec2 center;                // position, or centroid of a polygon
+    Vec2 vertices[COLLISION_MAX_VERTICES];  // world space
+    Vec2 normals[COLLISION_MAX_VERTICES];   // unit edge normals, world space
+    Rect bounds;
+    uint32_t nextFree;          // free list link, COLLISION_NONE when alive
+    uint8_t alive;
+} CollisionBodyInternal;
+
+// Bounds of a body in sort order, moved around by the sort
+typedef struct CollisionProxyInternal {
+    float minX, maxX, minY, maxY;
+    uint32_t body;
+} CollisionProxyInternal;
+
+// Internal Struct
+struct _CollisionWorld {
+    CollisionBodyInternal* bodies;
+    uint32_t bodyCount, bodyCapacity, freeBody, liveBodies;
+
+    // sorted by minX, holds one proxy per live body
+    CollisionProxyInternal* proxies;
+    uint32_t proxyCapacity;
+    uint32_t* proxyOf;          // index in proxies of every body slot, kept
+                                // apart from the bodies so sorting stays in
+                                // cache
+    uint32_t proxyOfCapacity;
+
+    // the sorted bounds as four arrays, minX, maxX, minY then maxY, each
+    // sweepCapacity long and padded with 4 lanes that end every sweep
+    float* sweep;
+    uint32_t sweepCapacity;
+
+    CollisionStats stats;
+};
+
+PRIVATE int internal_collisionIsAlive(const CollisionWorld* world,
+                                      CollisionBody body) {
+    return body < world->bodyCount && world->bodies[body].alive;
+}
+
+// Every turn along the outline bends the same way, and they add up to one
+// full turn. A star bends the same way at every corner but winds twice
+PRIVATE int internal_collisionIsConvex(const CollisionShape* shape) {
+    if (shape->type == COLLISION_SHAPE_CIRCLE)
+        return shape->radius >= 0.0f;
+    uint32_t count = shape->vertexCount;
+    if (count < 3 || count > COLLISION_MAX_VERTICES)
+        return 0;
+    float sign = 0.0f;
+    float winding = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        Vec2 a = shape->vertices[i];
+        Vec2 b = shape->vertices[(i + 1) % count];
+        Vec2 c = shape->vertices[(i + 2) % count];
+        Vec2 in = vec2Sub(b, a);
+        Vec2 out = vec2Sub(c, b);
+        float turn = vec2Cross(in, out);
+        if (turn == 0.0f || turn * sign < 0.0f)
+            return 0;
+        sign = turn;
+        winding += fabsf(atan2f(turn, vec2Dot(in, out)));
+    }
+    // the total is a whole number of turns, split between one and two
+    return winding < 3.0f * PI;
+}
+
+// World space outline, edge normals and bounds
+PRIVATE void internal_collisionPlace(CollisionBodyInternal* body,
+                                     Vec2 position, float rotation) {
+    const CollisionShape* shape = &body->shape;
+    if (shape->type == COLLISION_SHAPE_CIRCLE) {
+        body->center = position;
+        body->bounds = (Rect) {
+            { position.x - shape->radius, position.y - shape->radius },
+            { position.x + shape->radius, position.y + shape->radius }
+        };
+        return;
+    }
+
+    float c = cosf(rotation), s = sinf(rotation);
+    uint32_t count = shape->vertexCount;
+    Vec2 sum = { 0.0f, 0.0f };
+    Rect bounds = { { INFINITY, INFINITY }, { -INFINITY, -INFINITY } };
+    for (uint32_t i = 0; i < count; i++) {
+        Vec2 local = shape->vertices[i];
+        Vec2 world = { position.x + c * local.x - s * local.y,
+                       position.y + s * local.x + c * local.y };
+        body->vertices[i] = world;
+        sum = vec2Add(sum, world);
+        bounds.min.x = world.x < bounds.min.x ? world.x : bounds.min.x;
+        bounds.min.y = world.y < bounds.min.y ? world.y : bounds.min.y;
+        bounds.max.x = world.x > bounds.max.x ? world.x : bounds.max.x;
+        bounds.max.y = world.y > bounds.max.y ? world.y : bounds.max.y;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        Vec2 edge = vec2Sub(body->vertices[(i + 1) % count],
+                            body->vertices[i]);
+        body->normals[i] = vec2Normalize(vec2Perpendicular(edge));
+    }
+    body->center = vec2Scale(sum, 1.0f / (float) count);
+    body->bounds = bounds;
+}
+
+PRIVATE void internal_collisionProject(const CollisionBodyInternal* body,
+                                       Vec2 axis, float* low, float* high) {
+    if (body->shape.type == COLLISION_SHAPE_CIRCLE) {
+        float center = vec2Dot(body->center, axis);
+        *low = center - body->shape.radius;
+        *high = center + body->shape.radius;
+        return;
+    }
+    float min = vec2Dot(body->vertices[0], axis), max = min;
+    for (uint32_t i = 1; i < body->shape.vertexCount; i++) {
+        float d = vec2Dot(body->vertices[i], axis);
+        min = d < min ? d : min;
+        max = d > max ? d : max;
+    }
+    *low = min;
+    *high = max;
+}
+
+// Overlap of both bodies along axis, keeps the smallest seen, 0 if separated
+PRIVATE int internal_collisionAxis(const CollisionBodyInternal* a,
+                                   const CollisionBodyInternal* b, Vec2 axis,
+                                   float* depth, Vec2* normal) {
+    float lowA, highA, lowB, highB;
+    internal_collisionProject(a, axis, &lowA, &highA);
+    internal_collisionProject(b, axis, &lowB, &highB);
+    float overlap = (highA < highB ? highA : highB) -
+                    (lowA > lowB ? lowA : lowB);
+    if (overlap <= 0.0f)
+        return 0;
+    if (overlap < *depth) {
+        *depth = overlap;
+        *normal = axis;
+    }
+    return 1;
+}
+
+// Circles and polygons only meet on the axis through the nearest vertex
+PRIVATE Vec2 internal_collisionVertexAxis(const CollisionBodyInternal* polygon,
+                                          Vec2 center) {
+    Vec2 nearest = polygon->vertices[0];
+    float best = vec2Length(vec2Sub(center, nearest));
+    for (uint32_t i = 1; i < polygon->shape.vertexCount; i++) {
+        float distance = vec2Length(vec2Sub(center, polygon->vertices[i]));
+        if (distance < best) {
+            best = distance;
+            nearest = polygon->vertices[i];
+        }
+    }
+    return best > 0.0f ? vec2Scale(vec2Sub(center, nearest), 1.0f / best)
+                       : polygon->normals[0];
+}
+
+PRIVATE int internal_collisionSat(const CollisionBodyInternal* a,
+                                  const CollisionBodyInternal* b,
+                                  Vec2* normal, float* depth) {
+    *depth = INFINITY;
+    Vec2 between = vec2Sub(b->center, a->center);
+    uint8_t circleA = a->shape.type == COLLISION_SHAPE_CIRCLE;
+    uint8_t circleB = b->shape.type == COLLISION_SHAPE_CIRCLE;
+
+    if (circleA && circleB) {
+        float distance = vec2Length(between);
+        float overlap = a->shape.radius + b->shape.radius - distance;
+        if (overlap <= 0.0f)
+            return 0;
+        *normal = distance > 0.0f ? vec2Scale(between, 1.0f / distance)
+                                  : (Vec2) { 1.0f, 0.0f };
+        *depth = overlap;
+        return 1;
+    }
+
+    if (!circleA)
+        for (uint32_t i = 0; i < a->shape.vertexCount; i++)
+            if (!internal_collisionAxis(a, b, a->normals[i], depth, normal))
+                return 0;
+    if (!circleB)
+        for (uint32_t i = 0; i < b->shape.vertexCount; i++)
+            if (!internal_collisionAxis(a, b, b->normals[i], depth, normal))
+                return 0;
+    if (circleA != circleB) {
+        Vec2 axis = circleA ? internal_collisionVertexAxis(b, a->center)
+                            : internal_collisionVertexAxis(a, b->center);
+        if (!internal_collisionAxis(a, b, axis, depth, normal))
+            return 0;
+    }
+
+    if (vec2Dot(*normal, between) < 0.0f)
+        *normal = vec2Scale(*normal, -1.0f);
+    return 1;
+}
+
+CollisionWorld* collisionWorldNew(uint32_t expectedBodies) {
+    CollisionWorld* world = ALLOC_S(CollisionWorld);
+    if (!world)
+        return NULL;
+    memset(world, 0, sizeof(CollisionWorld));
+    world->freeBody = COLLISION_NONE;
+
+    // sized for expectedBodies if possible, collisionAdd grows as needed
+    internal_arrayReserve((void**) &world->bodies, &world->bodyCapacity,
+                          sizeof(CollisionBodyInternal), expectedBodies);
+    internal_arrayReserve((void**) &world->proxies, &world->proxyCapacity,
+                          sizeof(CollisionProxyInternal), expectedBodies);
+    return world;
+}
+
+PRIVATE void internal_collisionSyncProxy(CollisionWorld* world,
+                                         CollisionBody body) {
+    CollisionBodyInternal* state = &world->bodies[body];
+    CollisionProxyInternal* proxy = &world->proxies[world->proxyOf[body]];
+    proxy->minX = state->bounds.min.x;
+    proxy->maxX = state->bounds.max.x;
+    proxy->minY = state->bounds.min.y;
+    proxy->maxY = state->bounds.max.y;
+}
+
+CollisionBody collisionAdd(CollisionWorld* world, const CollisionShape* shape,
+                           Vec2 position, float rotation) {
+    if (!internal_collisionIsConvex(shape) ||
+        !internal_arrayReserve((void**) &world->proxies, &world->proxyCapacity,
+                               sizeof(CollisionProxyInternal),
+                               world->liveBodies + 1) ||
+        !internal_arrayReserve((void**) &world->sweep, &world->sweepCapacity,
+                               4 * sizeof(float), world->liveBodies + 5))
+        return COLLISION_INVALID_BODY;
+
+    CollisionBody body = world->freeBody;
+    if (body != COLLISION_NONE) {
+        world->freeBody = world->bodies[body].nextFree;
+    } else {
+        if (!internal_arrayReserve((void**) &world->bodies,
+                                   &world->bodyCapacity,
+                                   sizeof(CollisionBodyInternal),
+                                   world->bodyCount + 1) ||
+            !internal_arrayReserve((void**) &world->proxyOf,
+                                   &world->proxyOfCapacity,
+                                   sizeof(uint32_t),
+                                   world->bodyCount + 1))
+            return COLLISION_INVALID_BODY;
+        body = world->bodyCount++;
+    }
+
+    CollisionBodyInternal* state = &world->bodies[body];
+    state->shape = *shape;
+    state->nextFree = COLLISION_NONE;
+    state->alive = 1;
+    internal_collisionPlace(state, position, rotation);
+
+    // appended out of order, the next detect sorts it in
+    world->proxyOf[body] = world->liveBodies++;
+    world->proxies[world->proxyOf[body]].body = body;
+    internal_collisionSyncProxy(world, body);
+    return body;
+}
+
+void collisionSetTransform(CollisionWorld* world, CollisionBody body,
+                           Vec2 position, float rotation) {
+    if (!internal_collisionIsAlive(world, body))
+        return;
+    internal_collisionPlace(&world->bodies[body], position, rotation);
+    internal_collisionSyncProxy(world, body);
+}
+
+void collisionRemove(CollisionWorld* world, CollisionBody body) {
+    if (!internal_collisionIsAlive(world, body))
+        return;
+
+    // close the gap, the rest of the order stays sorted
+    uint32_t proxy = world->proxyOf[body];
+    world->liveBodies--;
+    memmove(&world->proxies[proxy], &world->proxies[proxy + 1],
+            sizeof(CollisionProxyInternal) * (world->liveBodies - proxy));
+    for (uint32_t i = proxy; i < world->liveBodies; i++)
+        world->proxyOf[world->proxies[i].body] = i;
+
+    CollisionBodyInternal* state = &world->bodies[body];
+    state->alive = 0;
+    state->nextFree = world->freeBody;
+    world->freeBody = body;
+}
+
+PRIVATE int internal_collisionCompare(const void* left, const void* right) {
+    float a = ((const CollisionProxyInternal*) left)->minX;
+    float b = ((const CollisionProxyInternal*) right)->minX;
+    return a < b ? -1 : a > b;
+}
+
+// Insertion sort, linear when bodies kept their order since the last call
+PRIVATE uint32_t internal_collisionSort(CollisionWorld* world) {
+    CollisionProxyInternal* proxies = world->proxies;
+    uint64_t budget = (uint64_t) world->liveBodies * COLLISION_SWAP_BUDGET;
+    uint32_t swaps = 0;
+    for (uint32_t i = 1; i < world->liveBodies; i++) {
+        if (proxies[i - 1].minX <= proxies[i].minX)
+            continue;
+        CollisionProxyInternal moving = proxies[i];
+        uint32_t j = i;
+        for (; j > 0 && proxies[j - 1].minX > moving.minX; j--)
+            proxies[j] = proxies[j - 1];
+        proxies[j] = moving;
+        swaps += i - j;
+        if (swaps > budget) {
+            qsort(proxies, world->liveBodies, sizeof(CollisionProxyInternal),
+                  internal_collisionCompare);
+            break;
+        }
+    }
+    if (swaps)
+        for (uint32_t i = 0; i < world->liveBodies; i++)
+            world->proxyOf[proxies[i].body] = i;
+    return swaps;
+}
+
+// Run the SAT on a pair whose bounds overlap
+PRIVATE void internal_collisionPair(CollisionWorld* world, uint32_t first,
+                                    uint32_t second,
+                                    CollisionContact* contacts,
+                                    uint32_t capacity, uint32_t* found) {
+    CollisionBody a = world->proxies[first].body;
+    CollisionBody b = world->proxies[second].body;
+    world->stats.pairs++;
+    Vec2 normal;
+    float depth;
+    if (!internal_collisionSat(&world->bodies[a], &world->bodies[b], &normal,
+                               &depth))
+        return;
+    if (*found < capacity)
+        contacts[*found] = (CollisionContact) { a, b, normal, depth };
+    (*found)++;
+}
+
+uint32_t collisionDetect(CollisionWorld* world, CollisionContact* contacts,
+                         uint32_t capacity) {
+    world->stats.swaps = internal_collisionSort(world);
+    world->stats.pairs = 0;
+    world->stats.contacts = 0;
+    uint32_t count = world->liveBodies;
+    if (!count)
+        return 0;
+
+    uint32_t stride = world->sweepCapacity;
+    float* minX = world->sweep;
+    float* maxX = minX + stride;
+    float* minY = maxX + stride;
+    float* maxY = minY + stride;
+    for (uint32_t i = 0; i < count; i++) {
+        minX[i] = world->proxies[i].minX;
+        maxX[i] = world->proxies[i].maxX;
+        minY[i] = world->proxies[i].minY;
+        maxY[i] = world->proxies[i].maxY;
+    }
+    for (uint32_t i = count; i < count + 4; i++) {
+        minX[i] = INFINITY;     // past every finite maxX, ends most sweeps
+        minY[i] = maxY[i] = 0.0f;
+    }
+
+    uint32_t found = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t j = i + 1;
+#ifdef VECTOR_SSE
+        // four candidates at a time, few of them survive the y test
+        __m128 right = _mm_set1_ps(maxX[i]);
+        __m128 top = _mm_set1_ps(minY[i]);
+        __m128 bottom = _mm_set1_ps(maxY[i]);
+        for (; j < count; j += 4) {
+            __m128 inX = _mm_cmple_ps(_mm_loadu_ps(minX + j), right);
+            int spanX = _mm_movemask_ps(inX);
+            // an infinite maxX spans the padding too, drop those lanes
+            if (count - j < 4)
+                spanX &= (1 << (count - j)) - 1;
+            if (!spanX)
+                break;
+            __m128 inY = _mm_and_ps(
+                _mm_cmple_ps(_mm_loadu_ps(minY + j), bottom),
+                _mm_cmpge_ps(_mm_loadu_ps(maxY + j), top));
+            int overlaps = _mm_movemask_ps(_mm_and_ps(inX, inY)) & spanX;
+            for (uint32_t lane = 0; overlaps; lane++, overlaps >>= 1)
+                if (overlaps & 1)
+                    internal_collisionPair(world, i, j + lane, contacts,
+                                           capacity, &found);
+            if (spanX != 0xF)
+                break;
+        }
+#else
+        for (; j < count && minX[j] <= maxX[i]; j++)
+            if (minY[j] <= maxY[i] && maxY[j] >= minY[i])
+                internal_collisionPair(world, i, j, contacts, capacity,
+                                       &found);
+#endif
+    }
+    world->stats.contacts = found;
+    return found;
+}
+
+uint8_t collisionTest(CollisionWorld* world, CollisionBody a, CollisionBody b,
+                      CollisionContact* contact) {
+    if (!internal_collisionIsAlive(world, a) ||
+        !internal_collisionIsAlive(world, b) || a == b)
+        return 0;
+    Vec2 normal;
+    float depth;
+    if (!internal_collisionSat(&world->bodies[a], &world->bodies[b], &normal,
+                               &depth))
+        return 0;
+    *contact = (CollisionContact) { a, b, normal, depth };
+    return 1;
+}
+
+Rect collisionGetBounds(CollisionWorld* world, CollisionBody body) {
+    if (!internal_collisionIsAlive(world, body))
+        return (Rect) { { 0.0f, 0.0f }, { 0.0f, 0.0f } };
+    return world->bodies[body].bounds;
+}
+
+uint32_t collisionGetCount(CollisionWorld* world) {
+    return world->liveBodies;
+}
+
+CollisionStats collisionGetStats(CollisionWorld* world) {
+    return world->stats;
+}
+
+void collisionWorldDestroy(CollisionWorld* world) {
+    if (!world)
+        return;
+    TG_FREE(world->bodies);
+    TG_FREE(world->proxies);
+    TG_FREE(world->proxyOf);
+    TG_FREE(world->sweep);
+    TG_FREE(world);
+}
@@ -0,0 +1,191 @@
+// Collision detection public API
+
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "defines.h"
+
+// Most vertices of a polygon shape
+#define COLLISION_MAX_VERTICES 8
+
+/**
+ * @brief   Handle to a body stored in a CollisionWorld
+ */
+typedef uint32_t CollisionBody;
+
+/**
+ * @def COLLISION_INVALID_BODY
+ * @brief Returned when a body could not be added
+ */
+#define COLLISION_INVALID_BODY 0xFFFFFFFFu
+
+/**
+ * @brief   Kind of a CollisionShape
+ */
+typedef enum CollisionShapeType {
+    COLLISION_SHAPE_CIRCLE,
+    COLLISION_SHAPE_POLYGON
+} CollisionShapeType;
+
+/**
+ * @brief   Outline of a body, relative to its position
+ */
+typedef struct CollisionShape {
+    CollisionShapeType type;
+    float radius;           /**< Circles only */
+    uint32_t vertexCount;   /**< Polygons only, 3 to COLLISION_MAX_VERTICES */
+    Vec2 vertices[COLLISION_MAX_VERTICES];  /**< Convex, either winding */
+} CollisionShape;
+
+/**
+ * @brief   A pair of overlapping bodies
+ */
+typedef struct CollisionContact {
+    CollisionBody a;
+    CollisionBody b;
+    Vec2 normal;            /**< Unit length, pointing from a towards b */
+    float depth;            /**< Distance b moves along normal to separate */
+} CollisionContact;
+
+/**
+ * @brief   Counters of the last collisionDetect
+ */
+typedef struct CollisionStats {
+    uint32_t swaps;         /**< Moves made to re-sort the bodies */
+    uint32_t pairs;         /**< Bounding box overlaps given to the SAT */
+    uint32_t contacts;      /**< Pairs that actually overlap */
+} CollisionStats;
+
+/**
+ * @brief   Opaque type to CollisionWorld struct
+ * @note    The broad phase keeps bodies sorted by the left edge of their
+ *          bounds and sweeps along x. Bodies move little between frames, so
+ *          the order is repaired with an insertion sort instead of sorted
+ *          from scratch. Overlapping bounds go through a separating axis
+ *          test
+ */
+typedef struct _CollisionWorld CollisionWorld;
+
+/**
+ * @brief   Circle centered on the body position
+ * @param   radius: float, in world units
+ * @returns CollisionShape
+ */
+HELPER CollisionShape collisionShapeCircle(float radius) {
+    CollisionShape shape = { .type = COLLISION_SHAPE_CIRCLE,
+                             .radius = radius };
+    return shape;
+}
+
+/**
+ * @brief   Box centered on the body position
+ * @param   halfSize: Vec2, half width and half height
+ * @returns CollisionShape
+ */
+HELPER CollisionShape collisionShapeBox(Vec2 halfSize) {
+    CollisionShape shape = {
+        .type = COLLISION_SHAPE_POLYGON,
+        .vertexCount = 4,
+        .vertices = { { -halfSize.x, -halfSize.y }, { halfSize.x, -halfSize.y },
+                      { halfSize.x, halfSize.y }, { -halfSize.x, halfSize.y } }
+    };
+    return shape;
+}
+
+/**
+ * @brief   Create a new, empty collision world
+ * @param   expectedBodies: uint32_t, number of bodies to reserve storage for
+ * @returns Pointer to a new CollisionWorld, NULL on failure
+ * @see     CollisionWorld
+ */
+TGAPI CollisionWorld* collisionWorldNew(uint32_t expectedBodies);
+
+/**
+ * @brief   Add a body to the world
+ * @param   world: Pointer to the world
+ * @param   shape: Pointer to the shape, copied
+ * @param   position: Vec2, where the shape origin is placed
+ * @param   rotation: float, in radians, clockwise with y pointing down
+ * @returns Handle to the body, COLLISION_INVALID_BODY if the shape is not
+ *          a convex polygon or storage ran out
+ * @see     CollisionShape
+ */
+TGAPI CollisionBody collisionAdd(CollisionWorld* world,
+                                 const CollisionShape* shape, Vec2 position,
+                                 float rotation);
+
+/**
+ * @brief   Move a body
+ * @param   world: Pointer to the world
+ * @param   body: CollisionBody, body to move
+ * @param   position: Vec2, new position
+ * @param   rotation: float, new rotation in radians
+ * @returns void
+ */
+TGAPI void collisionSetTransform(CollisionWorld* world, CollisionBody body,
+                                 Vec2 position, float rotation);
+
+/**
+ * @brief   Remove a body, the handle may be reused later
+ * @param   world: Pointer to the world
+ * @param   body: CollisionBody, body to remove
+ * @returns void
+ */
+TGAPI void collisionRemove(CollisionWorld* world, CollisionBody body);
+
+/**
+ * @brief   Find every pair of overlapping bodies
+ * @param   world: Pointer to the world
+ * @param   contacts: array receiving the contacts, may be NULL if capacity
+ *          is 0
+ * @param   capacity: uint32_t, number of contacts the array can hold
+ * @returns Total number of contacts, which may exceed capacity. Only the
+ *          first capacity contacts are written
+ * @note    Does not allocate, each pair is reported once
+ * @see     CollisionContact
+ */
+TGAPI uint32_t collisionDetect(CollisionWorld* world,
+                               CollisionContact* contacts, uint32_t capacity);
+
+/**
+ * @brief   Run the separating axis test on two bodies
+ * @param   world: Pointer to the world
+ * @param   a: CollisionBody, first body
+ * @param   b: CollisionBody, second body
+ * @param   contact: receives the contact when they overlap
+ * @returns 1 if the bodies overlap, 0 otherwise
+ */
+TGAPI uint8_t collisionTest(CollisionWorld* world, CollisionBody a,
+                            CollisionBody b, CollisionContact* contact);
+
+/**
+ * @param   world: Pointer to the world
+ * @param   body: CollisionBody, body to look up
+ * @returns Bounding box of the body in world units
+ */
+TGAPI Rect collisionGetBounds(CollisionWorld* world, CollisionBody body);
+
+/**
+ * @param   world: Pointer to the world
+ * @returns Number of bodies currently stored
+ */
+TGAPI uint32_t collisionGetCount(CollisionWorld* world);
+
+/**
+ * @param   world: Pointer to the world
+ * @returns Counters of the last collisionDetect
+ * @see     CollisionStats
+ */
+TGAPI CollisionStats collisionGetStats(CollisionWorld* world);
+
+/**
+ * @brief   Free the world and all of its storage
+ * @param   world: Pointer to the world
+ * @returns void
+ */
+TGAPI void collisionWorldDestroy(CollisionWorld* world);
+
+#endif // COLLISION_H
@@ -0,0 +1,222 @@
+#define TG_MEMORY_TAG MEMORY_TAG_CONTEXT
+
+// get function defines
+#include "context.h"
+#include "window_internal.h"
+#include "array_internal.h"
+#include "shader.h"
+#include "trace.h"
+
+#include <string.h>
+
+#include <GLFW/glfw3.h>
+
+// Internal Struct
+typedef struct ContextResourceInternal {
+    char* name;             // owned copy
+    uint32_t hash;          // compared before the name
+    ContextResourceType type;
+    void* resource;
+    ContextDestroyFunc destroy;
+} ContextResourceInternal;
+
+// Internal Struct
+struct _Context {
+    Window** windows;       // creation order, windows[0] is the share target
+    uint32_t windowCount;
+    uint32_t windowCapacity;
+    ContextResourceInternal* resources;
+    uint32_t resourceCount;
+    uint32_t resourceCapacity;
+};
+
+// FNV-1a, names are short and lookups rare enough
+PRIVATE uint32_t internal_contextHash(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; name++)
+        hash = (hash ^ (uint8_t) *name) * 16777619u;
+    return hash;
+}
+
+PRIVATE int64_t internal_contextFind(Context* context, const char* name) {
+    uint32_t hash = internal_contextHash(name);
+    for (uint32_t i = 0; i < context->resourceCount; i++) {
+        ContextResourceInternal* entry = &context->resources[i];
+        if (entry->hash == hash && strcmp(entry->name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+PRIVATE void internal_contextFreeResource(ContextResourceInternal* entry) {
+    if (entry->destroy)
+        entry->destroy(entry->resource);
+    TG_FREE(entry->name);
+}
+
+// Newest first, later resources may be built from earlier ones
+PRIVATE void internal_contextFreeResources(Context* context) {
+    while (context->resourceCount)
+        internal_contextFreeResource(
+            &context->resources[--context->resourceCount]);
+}
+
+PRIVATE void internal_contextDestroyTexture(void* resource) {
+    textureDestroy(resource);
+}
+
+PRIVATE void internal_contextDestroyShader(void* resource) {
+    shaderDestroy((uint32_t) (uintptr_t) resource);
+}
+
+Context* contextNew(void) {
+    Context* context = ALLOC_S(Context);
+    if (!context)
+        return NULL;
+    // held until contextDestroy, so GLFW survives every window closing
+    if (!internal_windowAcquireGlfw()) {
+        TG_FREE(context);
+        return NULL;
+    }
+    memset(context, 0, sizeof(Context));
+    return context;
+}
+
+Window* contextCreateWindow(Context* context, uint32_t width,
+                            uint32_t height, const char* title) {
+    TRACE_FUNCTION();
+    if (!internal_arrayReserve((void**) &context->windows,
+                               &context->windowCapacity, sizeof(Window*),
+                               context->windowCount + 1))
+        return NULL;
+
+    // any live member of the share group will do, the first is always there
+    void* share = context->windowCount
+                  ? windowGetHandle(context->windows[0]) : NULL;
+    Window* window = internal_windowCreate(width, height, title, share, 1);
+    if (window)
+        context->windows[context->windowCount++] = window;
+    return window;
+}
+
+void contextDestroyWindow(Context* context, Window* window) {
+    uint32_t index = 0;
+    while (index < context->windowCount && context->windows[index] != window)
+        index++;
+    if (index == context->windowCount)
+        return;
+
+    // the shared objects die with the last context referencing them
+    if (context->windowCount == 1) {
+        glfwMakeContextCurrent(windowGetHandle(window));
+        internal_contextFreeResources(context);
+    }
+    windowDestroy(window);
+    memmove(&context->windows[index], &context->windows[index + 1],
+            (context->windowCount - index - 1) * sizeof(Window*));
+    context->windowCount--;
+
+    // keep a context current so shared objects can still be used
+    if (context->windowCount)
+        glfwMakeContextCurrent(windowGetHandle(context->windows[0]));
+}
+
+uint32_t contextGetWindowCount(Context* context) {
+    return context->windowCount;
+}
+
+Window* contextGetWindow(Context* context, uint32_t index) {
+    return index < context->windowCount ? context->windows[index] : NULL;
+}
+
+void contextMakeCurrent(Context* context, Window* window) {
+    UNUSED(context);
+    glfwMakeContextCurrent(windowGetHandle(window));
+}
+
+uint8_t contextAdd(Context* context, const char* name,
+                   ContextResourceType type, void* resource,
+                   ContextDestroyFunc destroy) {
+    if (internal_contextFind(context, name) >= 0)
+        return 0;
+
+    if (!internal_arrayReserve((void**) &context->resources,
+                               &context->resourceCapacity,
+                               sizeof(ContextResourceInternal),
+                               context->resourceCount + 1))
+        return 0;
+
+    size_t length = strlen(name) + 1;
+    char* copy = TG_MALLOC(length);
+    if (!copy)
+        return 0;
+    memcpy(copy, name, length);
+
+    ContextResourceInternal* entry =
+        &context->resources[context->resourceCount++];
+    entry->name = copy;
+    entry->hash = internal_contextHash(name);
+    entry->type = type;
+    entry->resource = resource;
+    entry->destroy = destroy;
+    return 1;
+}
+
+void* contextGet(Context* context, const char* name,
+                 ContextResourceType type) {
+    int64_t index = internal_contextFind(context, name);
+    if (index < 0 || context->resources[index].type != type)
+        return NULL;
+    return context->resources[index].resource;
+}
+
+uint8_t contextRelease(Context* context, const char* name) {
+    int64_t index = internal_contextFind(context, name);
+    if (index < 0)
+        return 0;
+    internal_contextFreeResource(&context->resources[index]);
+    memmove(&context->resources[index], &context->resources[index + 1],
+            (context->resourceCount - index - 1) *
+            sizeof(ContextResourceInternal));
+    context->resourceCount--;
+    return 1;
+}
+
+uint8_t contextAddTexture(Context* context, const char* name,
+                          Texture* texture) {
+    return contextAdd(context, name, CONTEXT_RESOURCE_TEXTURE, texture,
+                      internal_contextDestroyTexture);
+}
+
+Texture* contextGetTexture(Context* context, const char* name) {
+    return contextGet(context, name, CONTEXT_RESOURCE_TEXTURE);
+}
+
+uint8_t contextAddShader(Context* context, const char* name,
+                         uint32_t program) {
+    return contextAdd(context, name, CONTEXT_RESOURCE_SHADER,
+                      (void*) (uintptr_t) program,
+                      internal_contextDestroyShader);
+}
+
+uint32_t contextGetShader(Context* context, const char* name) {
+    return (uint32_t) (uintptr_t) contextGet(context, name,
+                                             CONTEXT_RESOURCE_SHADER);
+}
+
+void contextDestroy(Context* context) {
+    if (!context)
+        return;
+    // without windows only resources that hold no OpenGL objects are left
+    if (context->windowCount)
+        glfwMakeContextCurrent(windowGetHandle(context->windows[0]));
+    internal_contextFreeResources(context);
+    // newest first, windows[0] keeps the share group alive to the end
+    while (context->windowCount)
+        windowDestroy(context->windows[--context->windowCount]);
+
+    TG_FREE(context->windows);
+    TG_FREE(context->resources);
+    TG_FREE(context);
+    internal_windowReleaseGlfw();
+}
@@ -0,0 +1,165 @@
+// Context public API
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stdint.h>
+
+#include "window.h"
+#include "texture.h"
+#include "defines.h"
+
+/**
+ * @brief   Opaque type to Context struct
+ */
+typedef struct _Context Context;
+
+/**
+ * @brief   Kind of a registered resource, lookups must ask for the same kind
+ */
+typedef enum ContextResourceType {
+    CONTEXT_RESOURCE_TEXTURE,   /**< Texture*, see contextAddTexture */
+    CONTEXT_RESOURCE_SHADER,    /**< Program name, see contextAddShader */
+    CONTEXT_RESOURCE_ATLAS,     /**< Glyph or sprite atlas */
+    CONTEXT_RESOURCE_USER       /**< Anything else owned by the context */
+} ContextResourceType;
+
+/**
+ * @brief   Frees a registered resource, called with a current OpenGL context
+ */
+typedef void (*ContextDestroyFunc)(void* resource);
+
+/**
+ * @brief   Create a context, windows created through it share OpenGL objects
+ * @returns Pointer to a new Context, NULL if GLFW failed to initialise
+ * @note    GLFW is initialised once, however many windows and contexts exist
+ * @see     Context, contextCreateWindow
+ */
+TGAPI Context* contextNew(void);
+
+/**
+ * @brief   Create a window sharing buffers, textures and shaders with every
+ *          other window of the context
+ * @param   context: Pointer to the context
+ * @param   width: uint32_t, width of the window
+ * @param   height: uint32_t, height of the window
+ * @param   title: window title
+ * @returns Pointer to a new Window, NULL on failure
+ * @note    The new window's OpenGL context becomes current. Vertex arrays and
+ *          framebuffers are never shared, create them per window
+ * @see     Window, contextMakeCurrent
+ */
+TGAPI Window* contextCreateWindow(Context* context, uint32_t width,
+                                  uint32_t height, const char* title);
+
+/**
+ * @brief   Destroy a window of the context
+ * @param   context: Pointer to the context
+ * @param   window: Pointer to a window created by contextCreateWindow
+ * @returns void
+ * @note    Use this instead of windowDestroy for context windows. Destroying
+ *          the last window frees every registered resource first, since the
+ *          OpenGL objects die with it
+ */
+TGAPI void contextDestroyWindow(Context* context, Window* window);
+
+/**
+ * @param   context: Pointer to the context
+ * @returns Number of live windows
+ */
+TGAPI uint32_t contextGetWindowCount(Context* context);
+
+/**
+ * @param   context: Pointer to the context
+ * @param   index: uint32_t, window index, in creation order
+ * @returns Pointer to the window, NULL if out of range
+ */
+TGAPI Window* contextGetWindow(Context* context, uint32_t index);
+
+/**
+ * @brief   Issue OpenGL calls to a window from now on
+ * @param   context: Pointer to the context
+ * @param   window: Pointer to a window of the context
+ * @returns void
+ * @note    Shared objects stay valid whichever window is current
+ */
+TGAPI void contextMakeCurrent(Context* context, Window* window);
+
+/**
+ * @brief   Register a resource so every window can look it up by name
+ * @param   context: Pointer to the context
+ * @param   name: unique name, copied
+ * @param   type: ContextResourceType of the resource
+ * @param   resource: the resource, owned by the context from now on
+ * @param   destroy: ContextDestroyFunc freeing the resource, may be NULL
+ * @returns 1 on success, 0 if the name is taken or allocation failed
+ * @see     contextGet, contextRelease
+ */
+TGAPI uint8_t contextAdd(Context* context, const char* name,
+                         ContextResourceType type, void* resource,
+                         ContextDestroyFunc destroy);
+
+/**
+ * @brief   Look a resource up by name
+ * @param   context: Pointer to the context
+ * @param   name: name given to contextAdd
+ * @param   type: ContextResourceType the resource was added with
+ * @returns The resource, NULL if missing or of another type
+ */
+TGAPI void* contextGet(Context* context, const char* name,
+                       ContextResourceType type);
+
+/**
+ * @brief   Free a resource and remove it from the registry
+ * @param   context: Pointer to the context
+ * @param   name: name given to contextAdd
+ * @returns 1 if the resource existed, 0 otherwise
+ * @note    Needs a window of the context to be current
+ */
+TGAPI uint8_t contextRelease(Context* context, const char* name);
+
+/**
+ * @brief   Register a texture, destroyed with the context
+ * @param   context: Pointer to the context
+ * @param   name: unique name, copied
+ * @param   texture: Pointer to the texture
+ * @returns 1 on success, 0 if the name is taken or allocation failed
+ * @see     contextAdd
+ */
+TGAPI uint8_t contextAddTexture(Context* context, const char* name,
+                                Texture* texture);
+
+/**
+ * @param   context: Pointer to the context
+ * @param   name: name given to contextAddTexture
+ * @returns Pointer to the texture, NULL if missing
+ */
+TGAPI Texture* contextGetTexture(Context* context, const char* name);
+
+/**
+ * @brief   Register a shader program, destroyed with the context
+ * @param   context: Pointer to the context
+ * @param   name: unique name, copied
+ * @param   program: uint32_t, program from shaderCompile
+ * @returns 1 on success, 0 if the name is taken or allocation failed
+ * @see     contextAdd, shaderCompile
+ */
+TGAPI uint8_t contextAddShader(Context* context, const char* name,
+                               uint32_t program);
+
+/**
+ * @param   context: Pointer to the context
+ * @param   name: name given to contextAddShader
+ * @returns OpenGL program name, 0 if missing
+ */
+TGAPI uint32_t contextGetShader(Context* context, const char* name);
+
+/**
+ * @brief   Free every resource and window, then release GLFW
+ * @param   context: Pointer to the context
+ * @returns void
+ * @note    glfwTerminate runs once no window or context is left
+ */
+TGAPI void contextDestroy(Context* context);
+
+#endif // CONTEXT_H
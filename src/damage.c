@@ -0,0 +1,172 @@
+#define TG_MEMORY_TAG MEMORY_TAG_DAMAGE
+
+// get function defines
+#include "damage.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+// Set of disjoint-ish dirty rects for one frame
+typedef struct DamageListInternal {
+    Rect rects[DAMAGE_MAX_RECTS];
+    uint32_t count;
+    uint8_t full;   // whole framebuffer, rects are ignored
+} DamageListInternal;
+
+// Internal Struct
+struct _DamageTracker {
+    uint32_t width, height;
+    DamageListInternal current;     // damage of the frame being built
+    DamageListInternal previous;    // damage of the last presented frame
+    DamageListInternal regions;     // current + previous, handed to callers
+};
+
+PRIVATE Rect internal_damageBounds(const DamageTracker* tracker) {
+    return (Rect) {
+        { 0.0f, 0.0f },
+        { (float) tracker->width, (float) tracker->height }
+    };
+}
+
+PRIVATE void internal_damageRemove(DamageListInternal* list, uint32_t index) {
+    list->rects[index] = list->rects[--list->count];
+}
+
+// Add a rect, merging it with anything it touches. Once the list is full the
+// rect is merged with whichever entry grows the least
+PRIVATE void internal_damageInsert(DamageListInternal* list, Rect rect,
+                                   Rect bounds) {
+    if (list->full)
+        return;
+    rect = rectIntersect(rect, bounds);
+    if (rectIsEmpty(rect))
+        return;
+
+    uint32_t i = 0;
+    while (i < list->count) {
+        Rect merged = rectUnion(list->rects[i], rect);
+        // merge when touching, or when the union wastes no extra pixels
+        if (rectOverlaps(list->rects[i], rect) ||
+            rectArea(merged) <= rectArea(list->rects[i]) + rectArea(rect)) {
+            rect = merged;
+            internal_damageRemove(list, i);
+            i = 0;  // the grown rect may now touch earlier entries
+            continue;
+        }
+        i++;
+    }
+
+    if (list->count == DAMAGE_MAX_RECTS) {
+        uint32_t best = 0;
+        float bestGrowth = INFINITY;
+        for (i = 0; i < list->count; i++) {
+            float growth = rectArea(rectUnion(list->rects[i], rect)) -
+                           rectArea(list->rects[i]);
+            if (growth < bestGrowth) {
+                bestGrowth = growth;
+                best = i;
+            }
+        }
+        Rect merged = rectUnion(list->rects[best], rect);
+        internal_damageRemove(list, best);
+        internal_damageInsert(list, merged, bounds);
+        return;
+    }
+
+    if (rectArea(rect) >= rectArea(bounds)) {
+        list->full = 1;
+        list->count = 0;
+        return;
+    }
+    list->rects[list->count++] = rect;
+}
+
+DamageTracker* damageTrackerNew(uint32_t width, uint32_t height) {
+    DamageTracker* tracker = ALLOC_S(DamageTracker);
+    if (!tracker)
+        return NULL;
+    memset(tracker, 0, sizeof(DamageTracker));
+    damageSetSize(tracker, width, height);
+    return tracker;
+}
+
+void damageSetSize(DamageTracker* tracker, uint32_t width, uint32_t height) {
+    tracker->width = width;
+    tracker->height = height;
+    // contents of both buffers are undefined after a resize
+    damageAddAll(tracker);
+    tracker->previous.full = 1;
+}
+
+void damageAdd(DamageTracker* tracker, Rect rect) {
+    internal_damageInsert(&tracker->current, rect,
+                          internal_damageBounds(tracker));
+}
+
+void damageAddAll(DamageTracker* tracker) {
+    tracker->current.full = 1;
+    tracker->current.count = 0;
+}
+
+uint8_t damageIsEmpty(DamageTracker* tracker) {
+    // previous damage alone doesn't need a frame, the front buffer is correct
+    return !tracker->current.full && tracker->current.count == 0;
+}
+
+const Rect* damageGetRegions(DamageTracker* tracker, uint32_t* count) {
+    DamageListInternal* regions = &tracker->regions;
+    Rect bounds = internal_damageBounds(tracker);
+
+    if (damageIsEmpty(tracker)) {
+        *count = 0;
+        return regions->rects;
+    }
+
+    if (tracker->current.full || tracker->previous.full) {
+        regions->rects[0] = bounds;
+        regions->count = 1;
+    } else {
+        *regions = tracker->current;
+        for (uint32_t i = 0; i < tracker->previous.count; i++)
+            internal_damageInsert(regions, tracker->previous.rects[i], bounds);
+        if (regions->full) {
+            regions->rects[0] = bounds;
+            regions->count = 1;
+            regions->full = 0;
+        }
+    }
+
+    *count = regions->count;
+    return regions->rects;
+}
+
+void damageScissor(DamageTracker* tracker, Rect region) {
+    region = rectIntersect(region, internal_damageBounds(tracker));
+    // round outwards, partially covered pixels must be redrawn too
+    int32_t x0 = (int32_t) floorf(region.min.x);
+    int32_t y0 = (int32_t) floorf(region.min.y);
+    int32_t x1 = (int32_t) ceilf(region.max.x);
+    int32_t y1 = (int32_t) ceilf(region.max.y);
+    if (x1 < x0) x1 = x0;
+    if (y1 < y0) y1 = y0;
+
+    glEnable(GL_SCISSOR_TEST);
+    // opengl has its origin at the bottom left, flip the y axis
+    glScissor(x0, (int32_t) tracker->height - y1, x1 - x0, y1 - y0);
+}
+
+void damageScissorDisable(void) {
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void damageEndFrame(DamageTracker* tracker) {
+    tracker->previous = tracker->current;
+    tracker->current.count = 0;
+    tracker->current.full = 0;
+}
+
+void damageTrackerDestroy(DamageTracker* tracker) {
+    TG_FREE(tracker);
+}
@@ -0,0 +1,106 @@
+// Damage tracking public API
+
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "defines.h"
+
+/**
+ * @def DAMAGE_MAX_RECTS
+ * @brief Number of separate dirty rects kept per frame, extra rects are merged
+ */
+#define DAMAGE_MAX_RECTS 16
+
+/**
+ * @brief   Opaque type to DamageTracker struct
+ * @note    Rects are in framebuffer pixels, with the origin at the top left,
+ *          the same space as windowGetSize
+ */
+typedef struct _DamageTracker DamageTracker;
+
+/**
+ * @brief   Create a new damage tracker
+ * @param   width: uint32_t, width of the framebuffer
+ * @param   height: uint32_t, height of the framebuffer
+ * @returns Pointer to a new DamageTracker, the first frame is fully damaged
+ * @see     DamageTracker
+ */
+TGAPI DamageTracker* damageTrackerNew(uint32_t width, uint32_t height);
+
+/**
+ * @brief   Resize the tracked framebuffer, damages everything
+ * @param   tracker: Pointer to the tracker
+ * @param   width: uint32_t, new width of the framebuffer
+ * @param   height: uint32_t, new height of the framebuffer
+ * @returns void
+ */
+TGAPI void damageSetSize(DamageTracker* tracker, uint32_t width,
+                         uint32_t height);
+
+/**
+ * @brief   Mark a region as changed this frame
+ * @param   tracker: Pointer to the tracker
+ * @param   rect: Rect, region to redraw, usually the old and new bounds of
+ *          a draw item that changed
+ * @returns void
+ * @note    Overlapping rects are merged as they come in
+ * @see     Rect
+ */
+TGAPI void damageAdd(DamageTracker* tracker, Rect rect);
+
+/**
+ * @brief   Mark the whole framebuffer as changed this frame
+ * @param   tracker: Pointer to the tracker
+ * @returns void
+ */
+TGAPI void damageAddAll(DamageTracker* tracker);
+
+/**
+ * @param   tracker: Pointer to the tracker
+ * @returns 1 if nothing changed this frame, the frame can be skipped
+ */
+TGAPI uint8_t damageIsEmpty(DamageTracker* tracker);
+
+/**
+ * @brief   Get the regions that have to be redrawn this frame
+ * @param   tracker: Pointer to the tracker
+ * @param   count: receives the number of regions
+ * @returns Array of regions, valid until the next call on the tracker
+ * @note    Includes the damage of the previous frame, since the back buffer
+ *          still holds the frame before that one after a swap
+ */
+TGAPI const Rect* damageGetRegions(DamageTracker* tracker, uint32_t* count);
+
+/**
+ * @brief   Restrict rendering to one region, using the scissor test
+ * @param   tracker: Pointer to the tracker
+ * @param   region: Rect, region returned by damageGetRegions
+ * @returns void
+ */
+TGAPI void damageScissor(DamageTracker* tracker, Rect region);
+
+/**
+ * @brief   Disable the scissor test enabled by damageScissor
+ * @returns void
+ */
+TGAPI void damageScissorDisable(void);
+
+/**
+ * @brief   Finish a presented frame, its damage becomes the previous damage
+ * @param   tracker: Pointer to the tracker
+ * @returns void
+ * @note    Only call this when the buffers were actually swapped
+ */
+TGAPI void damageEndFrame(DamageTracker* tracker);
+
+/**
+ * @brief   Free the tracker
+ * @param   tracker: Pointer to the tracker
+ * @returns void
+ */
+TGAPI void damageTrackerDestroy(DamageTracker* tracker);
+
+#endif // DAMAGE_H
@@ -66,6 +66,19 @@
     #define FORCE_INLINE STATIC_INLINE
 #endif
 
+/**
+ * @def STATIC_FORCE_INLINE
+ * @brief Forces inlining of a function defined in a header, each translation
+ * unit gets its own copy so no out of line definition is needed
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define STATIC_FORCE_INLINE static __attribute__((always_inline)) inline
+#elif defined(_MSC_VER)
+    #define STATIC_FORCE_INLINE static __forceinline
+#else
+    #define STATIC_FORCE_INLINE STATIC_INLINE
+#endif
+
 /**
  * @def HELPER
  * @brief Marks a static inline helper function.
@@ -189,6 +202,27 @@
 // Include stdlib for malloc, calloc, realloc, free
 #include <stdlib.h>
 
+/**
+ * @def TG_TRACK_ALLOCATIONS
+ * @brief Routes TG_MALLOC, TG_CALLOC, TG_REALLOC and TG_FREE through the
+ * tracking allocator of memory.h, tagged with TG_MEMORY_TAG
+ */
+#if defined(TG_TRACK_ALLOCATIONS)
+    #include "memory.h"
+
+    #ifndef TG_MEMORY_TAG
+        #define TG_MEMORY_TAG MEMORY_TAG_UNKNOWN
+    #endif
+
+    #define TG_MALLOC(size) \
+        memoryAlloc(size, TG_MEMORY_TAG, __FILE__, __LINE__)
+    #define TG_CALLOC(num, size) \
+        memoryCalloc(num, size, TG_MEMORY_TAG, __FILE__, __LINE__)
+    #define TG_REALLOC(ptr, size) \
+        memoryRealloc(ptr, size, TG_MEMORY_TAG, __FILE__, __LINE__)
+    #define TG_FREE(ptr) memoryFree(ptr)
+#endif
+
 #ifndef TG_MALLOC
     #define TG_MALLOC(size)         malloc(size)
 #endif
@@ -0,0 +1,489 @@
+// mmap, open and fstat are POSIX, not part of plain C18
+#define _POSIX_C_SOURCE 200809L
+
+#define TG_MEMORY_TAG MEMORY_TAG_TEXTURE
+
+// get function defines
+#include "glyph_cache.h"
+#include "array_internal.h"
+#include "gpu_memory.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static const char glyphCacheMagic[8] = { 'T', 'G', 'G', 'L', 'Y', 'P', 'H', 0 };
+
+// Written as is, reads back differently on a machine of the other byte order
+#define GLYPH_CACHE_BYTE_ORDER 0x01020304u
+
+// Pages start on a boundary the mapping can hand to the driver directly
+#define GLYPH_CACHE_ALIGNMENT 4096
+
+// Empty pixels kept between glyphs, so filtering doesn't bleed
+#define GLYPH_CACHE_PADDING 1
+
+// Start of a cache file, offsets are from the start of the file
+typedef struct GlyphCacheHeaderInternal {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t pageSize;
+    uint32_t pageCount;
+    uint32_t glyphCount;
+    uint32_t fontCount;
+    uint64_t fontOffset;    // sorted font hashes
+    uint64_t glyphOffset;   // sorted entries
+    uint64_t pageOffset;    // pages back to back, aligned
+    uint64_t fileSize;
+} GlyphCacheHeaderInternal;
+
+// Internal Struct
+struct _GlyphCache {
+    uint32_t pageSize;
+
+    // file mapping, the mapped glyphs and pages point into it
+    void* mapping;
+    size_t mappingSize;
+    const GlyphCacheEntry* mappedGlyphs;
+    uint32_t mappedGlyphCount;
+    uint32_t mappedPageCount;
+
+    // glyphs inserted since, sorted like the mapped ones
+    GlyphCacheEntry* glyphs;
+    uint32_t glyphCount, glyphCapacity;
+
+    // pages below mappedPageCount are mapped, the others owned
+    uint8_t** pages;
+    uint32_t pageCount, pageCapacity;
+    Texture** textures;     // NULL until a page is first drawn
+    uint32_t textureCapacity;
+    uint32_t evictable;
+
+    // shelf packing into the last page, when it is owned
+    uint32_t shelfX, shelfY, shelfHeight;
+};
+
+PRIVATE int internal_glyphCacheCompare(const GlyphCacheEntry* entry,
+                                       uint64_t fontHash, uint16_t size,
+                                       uint32_t codepoint) {
+    if (entry->fontHash != fontHash)
+        return entry->fontHash < fontHash ? -1 : 1;
+    if (entry->size != size)
+        return entry->size < size ? -1 : 1;
+    if (entry->codepoint != codepoint)
+        return entry->codepoint < codepoint ? -1 : 1;
+    return 0;
+}
+
+// Lower bound of the key, 1 if the entry there matches it
+PRIVATE int internal_glyphCacheSearch(const GlyphCacheEntry* entries,
+                                      uint32_t count, uint64_t fontHash,
+                                      uint16_t size, uint32_t codepoint,
+                                      uint32_t* position) {
+    uint32_t low = 0, high = count;
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (internal_glyphCacheCompare(&entries[middle], fontHash, size,
+                                       codepoint) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    *position = low;
+    return low < count &&
+           internal_glyphCacheCompare(&entries[low], fontHash, size,
+                                      codepoint) == 0;
+}
+
+PRIVATE void* internal_glyphCacheMap(const char* path, size_t* size) {
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+    LARGE_INTEGER length;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &length) && length.QuadPart > 0)
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);      // the mapping keeps the file open
+    if (!mapping)
+        return NULL;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);   // the view keeps the mapping alive
+    *size = (size_t) length.QuadPart;
+    return view;
+#else
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+        return NULL;
+    struct stat status;
+    void* view = MAP_FAILED;
+    if (fstat(file, &status) == 0 && status.st_size > 0)
+        view = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE,
+                    file, 0);
+    close(file);            // the mapping keeps the file open
+    if (view == MAP_FAILED)
+        return NULL;
+    *size = (size_t) status.st_size;
+    return view;
+#endif
+}
+
+PRIVATE void internal_glyphCacheUnmap(void* mapping, size_t size) {
+#if defined(_WIN32) || defined(_WIN64)
+    (void) size;
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, size);
+#endif
+}
+
+// Every offset and count of a mapped file stays inside it
+PRIVATE int internal_glyphCacheValidate(const uint8_t* data, size_t size) {
+    if (size < sizeof(GlyphCacheHeaderInternal))
+        return 0;
+    const GlyphCacheHeaderInternal* header = (const void*) data;
+    if (memcmp(header->magic, glyphCacheMagic, sizeof(glyphCacheMagic)) ||
+        header->version != GLYPH_CACHE_VERSION ||
+        header->byteOrder != GLYPH_CACHE_BYTE_ORDER ||
+        header->fileSize != size || !header->pageSize ||
+        header->pageSize > 0xFFFF)
+        return 0;
+
+    uint64_t pageBytes = (uint64_t) header->pageSize * header->pageSize;
+    if (header->fontOffset % sizeof(uint64_t) ||
+        header->glyphOffset % sizeof(uint64_t) ||
+        header->fontOffset > size ||
+        header->fontCount > (size - header->fontOffset) / sizeof(uint64_t) ||
+        header->glyphOffset > size ||
+        header->glyphCount > (size - header->glyphOffset) /
+                             sizeof(GlyphCacheEntry) ||
+        header->pageOffset > size ||
+        header->pageCount > (size - header->pageOffset) / pageBytes)
+        return 0;
+
+    const GlyphCacheEntry* glyphs = (const void*) (data +
+                                                   header->glyphOffset);
+    for (uint32_t i = 0; i < header->glyphCount; i++) {
+        const GlyphCacheEntry* glyph = &glyphs[i];
+        if (glyph->page >= header->pageCount ||
+            (uint32_t) glyph->x + glyph->width > header->pageSize ||
+            (uint32_t) glyph->y + glyph->height > header->pageSize)
+            return 0;
+        if (i && internal_glyphCacheCompare(&glyphs[i - 1], glyph->fontHash,
+                                            glyph->size,
+                                            glyph->codepoint) >= 0)
+            return 0;   // out of order, binary searches would miss glyphs
+    }
+    return 1;
+}
+
+uint64_t glyphCacheHashFont(const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+GlyphCache* glyphCacheNew(uint32_t pageSize) {
+    if (!pageSize || pageSize > 0xFFFF)
+        return NULL;
+    GlyphCache* cache = ALLOC_S(GlyphCache);
+    if (!cache)
+        return NULL;
+    memset(cache, 0, sizeof(GlyphCache));
+    cache->pageSize = pageSize;
+    return cache;
+}
+
+GlyphCache* glyphCacheLoad(const char* path, const uint64_t* fontHashes,
+                           uint32_t fontCount) {
+    size_t size = 0;
+    uint8_t* data = internal_glyphCacheMap(path, &size);
+    if (!data)
+        return NULL;
+    if (!internal_glyphCacheValidate(data, size)) {
+        internal_glyphCacheUnmap(data, size);
+        return NULL;
+    }
+
+    // a font missing from the file changed or was never cached
+    const GlyphCacheHeaderInternal* header = (const void*) data;
+    const uint64_t* stored = (const void*) (data + header->fontOffset);
+    for (uint32_t i = 0; i < fontCount; i++) {
+        uint32_t found = 0;
+        for (uint32_t j = 0; j < header->fontCount && !found; j++)
+            found = stored[j] == fontHashes[i];
+        if (!found) {
+            internal_glyphCacheUnmap(data, size);
+            return NULL;
+        }
+    }
+
+    GlyphCache* cache = glyphCacheNew(header->pageSize);
+    if (!cache || !internal_arrayReserve((void**) &cache->pages,
+                                         &cache->pageCapacity,
+                                         sizeof(uint8_t*),
+                                         header->pageCount) ||
+        !internal_arrayReserve((void**) &cache->textures,
+                               &cache->textureCapacity, sizeof(Texture*),
+                               header->pageCount)) {
+        glyphCacheDestroy(cache);
+        internal_glyphCacheUnmap(data, size);
+        return NULL;
+    }
+    cache->mapping = data;
+    cache->mappingSize = size;
+    cache->mappedGlyphs = (const void*) (data + header->glyphOffset);
+    cache->mappedGlyphCount = header->glyphCount;
+    cache->mappedPageCount = header->pageCount;
+    uint64_t pageBytes = (uint64_t) header->pageSize * header->pageSize;
+    for (uint32_t i = 0; i < header->pageCount; i++) {
+        cache->pages[i] = data + header->pageOffset + pageBytes * i;
+        cache->textures[i] = NULL;
+    }
+    cache->pageCount = header->pageCount;
+    return cache;
+}
+
+PRIVATE int internal_glyphCacheWrite(FILE* file, const void* data,
+                                     size_t size) {
+    return fwrite(data, 1, size, file) == size;
+}
+
+PRIVATE int internal_glyphCachePad(FILE* file, uint64_t* offset,
+                                   uint64_t alignment) {
+    static const uint8_t zeros[GLYPH_CACHE_ALIGNMENT];
+    uint64_t padding = (alignment - *offset % alignment) % alignment;
+    *offset += padding;
+    return internal_glyphCacheWrite(file, zeros, (size_t) padding);
+}
+
+uint8_t glyphCacheSave(GlyphCache* cache, const char* path) {
+    // merge the mapped and inserted glyphs, both are sorted
+    uint32_t total = cache->mappedGlyphCount + cache->glyphCount;
+    GlyphCacheEntry* merged = TG_MALLOC(sizeof(GlyphCacheEntry) *
+                                        (total ? total : 1));
+    uint64_t* fonts = TG_MALLOC(sizeof(uint64_t) * (total ? total : 1));
+    if (!merged || !fonts) {
+        TG_FREE(merged);
+        TG_FREE(fonts);
+        return 0;
+    }
+    uint32_t a = 0, b = 0, fontCount = 0;
+    for (uint32_t i = 0; i < total; i++) {
+        const GlyphCacheEntry* next;
+        if (b == cache->glyphCount ||
+            (a < cache->mappedGlyphCount &&
+             internal_glyphCacheCompare(&cache->mappedGlyphs[a],
+                                        cache->glyphs[b].fontHash,
+                                        cache->glyphs[b].size,
+                                        cache->glyphs[b].codepoint) < 0))
+            next = &cache->mappedGlyphs[a++];
+        else
+            next = &cache->glyphs[b++];
+        merged[i] = *next;
+        if (!fontCount || fonts[fontCount - 1] != next->fontHash)
+            fonts[fontCount++] = next->fontHash;
+    }
+
+    GlyphCacheHeaderInternal header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, glyphCacheMagic, sizeof(glyphCacheMagic));
+    header.version = GLYPH_CACHE_VERSION;
+    header.byteOrder = GLYPH_CACHE_BYTE_ORDER;
+    header.pageSize = cache->pageSize;
+    header.pageCount = cache->pageCount;
+    header.glyphCount = total;
+    header.fontCount = fontCount;
+    uint64_t pageBytes = (uint64_t) cache->pageSize * cache->pageSize;
+    header.fontOffset = sizeof(header);
+    header.glyphOffset = header.fontOffset + sizeof(uint64_t) * fontCount;
+    header.pageOffset = header.glyphOffset + sizeof(GlyphCacheEntry) * total;
+    header.pageOffset += (GLYPH_CACHE_ALIGNMENT -
+                          header.pageOffset % GLYPH_CACHE_ALIGNMENT) %
+                         GLYPH_CACHE_ALIGNMENT;
+    header.fileSize = header.pageOffset + pageBytes * cache->pageCount;
+
+    // written beside the target and renamed, the target may be mapped
+    char temporary[1024];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+    FILE* file = fopen(temporary, "wb");
+    uint8_t written = file != NULL;
+    uint64_t offset = header.glyphOffset + sizeof(GlyphCacheEntry) * total;
+    written = written &&
+              internal_glyphCacheWrite(file, &header, sizeof(header)) &&
+              internal_glyphCacheWrite(file, fonts,
+                                       sizeof(uint64_t) * fontCount) &&
+              internal_glyphCacheWrite(file, merged,
+                                       sizeof(GlyphCacheEntry) * total) &&
+              internal_glyphCachePad(file, &offset, GLYPH_CACHE_ALIGNMENT);
+    for (uint32_t i = 0; written && i < cache->pageCount; i++)
+        written = internal_glyphCacheWrite(file, cache->pages[i],
+                                           (size_t) pageBytes);
+    if (file && fclose(file) != 0)
+        written = 0;
+    TG_FREE(merged);
+    TG_FREE(fonts);
+
+    if (written) {
+        remove(path);
+        written = rename(temporary, path) == 0;
+    }
+    if (!written)
+        remove(temporary);
+    return written;
+}
+
+const GlyphCacheEntry* glyphCacheFind(GlyphCache* cache, uint64_t fontHash,
+                                      uint32_t codepoint, uint16_t size) {
+    uint32_t position;
+    if (internal_glyphCacheSearch(cache->mappedGlyphs,
+                                  cache->mappedGlyphCount, fontHash, size,
+                                  codepoint, &position))
+        return &cache->mappedGlyphs[position];
+    if (internal_glyphCacheSearch(cache->glyphs, cache->glyphCount, fontHash,
+                                  size, codepoint, &position))
+        return &cache->glyphs[position];
+    return NULL;
+}
+
+// Start an owned page, glyphs are never added to mapped pages
+PRIVATE int internal_glyphCacheAddPage(GlyphCache* cache) {
+    if (cache->pageCount == 0xFFFF ||
+        !internal_arrayReserve((void**) &cache->pages,
+                               &cache->pageCapacity, sizeof(uint8_t*),
+                               cache->pageCount + 1) ||
+        !internal_arrayReserve((void**) &cache->textures,
+                               &cache->textureCapacity,
+                               sizeof(Texture*), cache->pageCount + 1))
+        return 0;
+    uint8_t* page = TG_CALLOC((size_t) cache->pageSize * cache->pageSize, 1);
+    if (!page)
+        return 0;
+    cache->textures[cache->pageCount] = NULL;
+    cache->pages[cache->pageCount++] = page;
+    cache->shelfX = cache->shelfY = cache->shelfHeight = 0;
+    return 1;
+}
+
+const GlyphCacheEntry* glyphCacheInsert(GlyphCache* cache,
+                                        const GlyphCacheEntry* glyph,
+                                        const uint8_t* coverage) {
+    uint32_t width = glyph->width, height = glyph->height;
+    uint32_t position;
+    if (width > cache->pageSize || height > cache->pageSize ||
+        glyphCacheFind(cache, glyph->fontHash, glyph->codepoint,
+                       glyph->size) ||
+        !internal_arrayReserve((void**) &cache->glyphs,
+                               &cache->glyphCapacity,
+                               sizeof(GlyphCacheEntry),
+                               cache->glyphCount + 1))
+        return NULL;
+
+    // next to the previous glyph, on a new shelf, or on a new page
+    if (cache->pageCount > cache->mappedPageCount &&
+        cache->shelfX + width > cache->pageSize) {
+        cache->shelfX = 0;
+        cache->shelfY += cache->shelfHeight;
+        cache->shelfHeight = 0;
+    }
+    if ((cache->pageCount == cache->mappedPageCount ||
+         cache->shelfY + height > cache->pageSize) &&
+        !internal_glyphCacheAddPage(cache))
+        return NULL;
+
+    uint32_t page = cache->pageCount - 1;
+    GlyphCacheEntry stored = *glyph;
+    stored.page = (uint16_t) page;
+    stored.x = (uint16_t) cache->shelfX;
+    stored.y = (uint16_t) cache->shelfY;
+    for (uint32_t row = 0; row < height; row++)
+        memcpy(cache->pages[page] + (size_t) (stored.y + row) *
+                                    cache->pageSize + stored.x,
+               coverage + (size_t) row * width, width);
+    cache->shelfX += width + GLYPH_CACHE_PADDING;
+    if (height + GLYPH_CACHE_PADDING > cache->shelfHeight)
+        cache->shelfHeight = height + GLYPH_CACHE_PADDING;
+    if (cache->textures[page])
+        textureUploadRegion(cache->textures[page], stored.x, stored.y, width,
+                            height, coverage, PIXEL_FORMAT_R8, 0);
+
+    internal_glyphCacheSearch(cache->glyphs, cache->glyphCount,
+                              stored.fontHash, stored.size, stored.codepoint,
+                              &position);
+    memmove(&cache->glyphs[position + 1], &cache->glyphs[position],
+            sizeof(GlyphCacheEntry) * (cache->glyphCount - position));
+    cache->glyphs[position] = stored;
+    cache->glyphCount++;
+    return &cache->glyphs[position];
+}
+
+uint32_t glyphCacheGetCount(GlyphCache* cache) {
+    return cache->mappedGlyphCount + cache->glyphCount;
+}
+
+uint32_t glyphCacheGetPageCount(GlyphCache* cache) {
+    return cache->pageCount;
+}
+
+const uint8_t* glyphCacheGetPage(GlyphCache* cache, uint32_t page) {
+    return page < cache->pageCount ? cache->pages[page] : NULL;
+}
+
+// Drop every page texture, the CPU pages upload them again when needed
+PRIVATE void internal_glyphCacheEvict(void* userData) {
+    GlyphCache* cache = userData;
+    for (uint32_t i = 0; i < cache->pageCount; i++) {
+        textureDestroy(cache->textures[i]);
+        cache->textures[i] = NULL;
+    }
+}
+
+Texture* glyphCacheGetTexture(GlyphCache* cache, uint32_t page) {
+    if (page >= cache->pageCount)
+        return NULL;
+    if (!cache->evictable)
+        cache->evictable = gpuMemoryAddEvictable(internal_glyphCacheEvict,
+                                                 cache);
+    if (!cache->textures[page]) {
+        Texture* texture = textureNew(cache->pageSize, cache->pageSize,
+                                      PIXEL_FORMAT_R8, 0);
+        if (!texture)
+            return NULL;
+        textureUpload(texture, cache->pages[page], PIXEL_FORMAT_R8);
+        cache->textures[page] = texture;
+    }
+    gpuMemoryTouch(cache->evictable);
+    return cache->textures[page];
+}
+
+void glyphCacheDestroy(GlyphCache* cache) {
+    if (!cache)
+        return;
+    if (cache->evictable)
+        gpuMemoryRemoveEvictable(cache->evictable);
+    if (cache->textures)
+        internal_glyphCacheEvict(cache);
+    for (uint32_t i = cache->mappedPageCount; i < cache->pageCount; i++)
+        TG_FREE(cache->pages[i]);
+    if (cache->mapping)
+        internal_glyphCacheUnmap(cache->mapping, cache->mappingSize);
+    TG_FREE(cache->pages);
+    TG_FREE(cache->textures);
+    TG_FREE(cache->glyphs);
+    TG_FREE(cache);
+}
@@ -0,0 +1,148 @@
+// Glyph cache public API
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "texture.h"
+#include "defines.h"
+
+// Bumped whenever the file layout changes, older files are rejected
+#define GLYPH_CACHE_VERSION 1
+
+/**
+ * @brief   Where a glyph sits in the atlas, stored as is in cache files
+ * @note    Entries are ordered by font hash, size, then codepoint
+ */
+typedef struct GlyphCacheEntry {
+    uint64_t fontHash;      /**< glyphCacheHashFont of the font file */
+    uint32_t codepoint;     /**< Unicode codepoint */
+    uint16_t size;          /**< Pixel size the glyph was rasterized at */
+    uint16_t page;          /**< Atlas page holding the coverage */
+    uint16_t x, y;          /**< Top left corner in the page */
+    uint16_t width, height; /**< Size of the coverage in pixels */
+    int16_t bearingX;       /**< Pen position to the left edge */
+    int16_t bearingY;       /**< Baseline to the top edge, up is positive */
+    float advance;          /**< Pen movement after the glyph */
+} GlyphCacheEntry;
+
+/**
+ * @brief   Opaque type to GlyphCache struct
+ * @note    Holds rasterized glyph coverage in square R8 atlas pages and
+ *          an index from (font hash, codepoint, size) to the glyph's rect.
+ *          Rasterizing is up to the caller, the cache only stores results.
+ *          A saved cache is memory mapped when loaded, lookups and uploads
+ *          read the file directly
+ */
+typedef struct _GlyphCache GlyphCache;
+
+/**
+ * @brief   Hash a font file, identifies the font in cache files
+ * @param   data: bytes of the font file
+ * @param   size: size_t, number of bytes
+ * @returns 64 bit FNV-1a hash
+ */
+TGAPI uint64_t glyphCacheHashFont(const void* data, size_t size);
+
+/**
+ * @brief   Create a new, empty glyph cache
+ * @param   pageSize: uint32_t, width and height of atlas pages in pixels
+ * @returns Pointer to a new GlyphCache, NULL on failure
+ * @see     GlyphCache
+ */
+TGAPI GlyphCache* glyphCacheNew(uint32_t pageSize);
+
+/**
+ * @brief   Map a cache file written by glyphCacheSave
+ * @param   path: file to map
+ * @param   fontHashes: const uint64_t*, hashes of the fonts in use
+ * @param   fontCount: uint32_t, number of hashes
+ * @returns Pointer to the loaded GlyphCache, NULL if the file is missing,
+ *          of another version or byte order, damaged, or lacks one of the
+ *          fonts, the glyphs have to be rasterized again then
+ * @note    A font that changed gets a new hash, which invalidates the file
+ */
+TGAPI GlyphCache* glyphCacheLoad(const char* path, const uint64_t* fontHashes,
+                                 uint32_t fontCount);
+
+/**
+ * @brief   Write the cache to a file
+ * @param   cache: Pointer to the glyph cache
+ * @param   path: file to write, replaced
+ * @returns 1 on success, 0 if the file couldn't be written
+ * @note    The file is native endian, it is a cache and not meant to be
+ *          moved between machines
+ */
+TGAPI uint8_t glyphCacheSave(GlyphCache* cache, const char* path);
+
+/**
+ * @brief   Look up a glyph
+ * @param   cache: Pointer to the glyph cache
+ * @param   fontHash: uint64_t, glyphCacheHashFont of the font
+ * @param   codepoint: uint32_t, Unicode codepoint
+ * @param   size: uint16_t, pixel size
+ * @returns The entry, NULL if the glyph isn't cached
+ * @note    Binary search, no allocation. The pointer stays valid until the
+ *          next insert
+ */
+TGAPI const GlyphCacheEntry* glyphCacheFind(GlyphCache* cache,
+                                            uint64_t fontHash,
+                                            uint32_t codepoint,
+                                            uint16_t size);
+
+/**
+ * @brief   Store a rasterized glyph
+ * @param   cache: Pointer to the glyph cache
+ * @param   glyph: const GlyphCacheEntry*, key, size and metrics, the page
+ *          and position are filled in by the cache
+ * @param   coverage: width x height bytes, top row first
+ * @returns The stored entry, NULL if the glyph is larger than a page,
+ *          already cached, or storage ran out
+ * @note    Pages loaded from a file are never written, new glyphs go to
+ *          pages of their own. The pointer stays valid until the next
+ *          insert
+ */
+TGAPI const GlyphCacheEntry* glyphCacheInsert(GlyphCache* cache,
+                                              const GlyphCacheEntry* glyph,
+                                              const uint8_t* coverage);
+
+/**
+ * @param   cache: Pointer to the glyph cache
+ * @returns Number of cached glyphs
+ */
+TGAPI uint32_t glyphCacheGetCount(GlyphCache* cache);
+
+/**
+ * @param   cache: Pointer to the glyph cache
+ * @returns Number of atlas pages
+ */
+TGAPI uint32_t glyphCacheGetPageCount(GlyphCache* cache);
+
+/**
+ * @param   cache: Pointer to the glyph cache
+ * @param   page: uint32_t, page index
+ * @returns pageSize x pageSize coverage bytes, top row first
+ */
+TGAPI const uint8_t* glyphCacheGetPage(GlyphCache* cache, uint32_t page);
+
+/**
+ * @brief   Get the texture of a page, uploading it when needed
+ * @param   cache: Pointer to the glyph cache
+ * @param   page: uint32_t, page index
+ * @returns Pointer to the texture, NULL on failure
+ * @note    Needs a current OpenGL context. Page textures are registered
+ *          with gpuMemoryAddEvictable, they are uploaded again from the
+ *          CPU copy after an eviction
+ */
+TGAPI Texture* glyphCacheGetTexture(GlyphCache* cache, uint32_t page);
+
+/**
+ * @brief   Free the cache, unmap its file and delete its textures
+ * @param   cache: Pointer to the glyph cache
+ * @returns void
+ */
+TGAPI void glyphCacheDestroy(GlyphCache* cache);
+
+#endif // GLYPH_CACHE_H
@@ -0,0 +1,117 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "gpu_memory.h"
+#include "gpu_memory_internal.h"
+#include "array_internal.h"
+#include "window_internal.h"
+
+#include <string.h>
+
+static GpuMemoryScopeInternal fallbackScope = { .frame = 1 };   // no Window current
+
+// Scope of the current context's share group
+PRIVATE GpuMemoryScopeInternal* internal_gpuMemoryScope(void) {
+    WindowGroupInternal* group = internal_windowCurrentGroup();
+    return group ? &group->memory : &fallbackScope;
+}
+
+void internal_gpuMemoryScopeInit(GpuMemoryScopeInternal* scope) {
+    memset(scope, 0, sizeof(GpuMemoryScopeInternal));
+    scope->frame = 1;
+}
+
+void internal_gpuMemoryScopeEndFrame(GpuMemoryScopeInternal* scope) {
+    GpuMemoryStats* stats = &scope->stats;
+    // linear scans are fine, evictions are rare and caches few
+    while (stats->budget && stats->totalBytes > stats->budget) {
+        GpuMemoryEvictableInternal* oldest = NULL;
+        for (uint32_t i = 0; i < scope->evictableCount; i++) {
+            GpuMemoryEvictableInternal* entry = &scope->evictables[i];
+            if (entry->evict && entry->resident &&
+                entry->lastFrame < scope->frame &&
+                (!oldest || entry->lastFrame < oldest->lastFrame))
+                oldest = entry;
+        }
+        if (!oldest)
+            break;  // everything left was used this frame
+        oldest->resident = 0;
+        oldest->evict(oldest->userData);
+        stats->evictions++;
+    }
+    scope->frame++;
+}
+
+void internal_gpuMemoryScopeRelease(GpuMemoryScopeInternal* scope) {
+    TG_FREE(scope->evictables);
+    internal_gpuMemoryScopeInit(scope);
+}
+
+void gpuMemoryAllocated(GpuMemoryCategory category, uint64_t bytes) {
+    GpuMemoryStats* stats = &internal_gpuMemoryScope()->stats;
+    stats->bytes[category] += bytes;
+    stats->counts[category]++;
+    stats->totalBytes += bytes;
+    if (stats->totalBytes > stats->peakBytes)
+        stats->peakBytes = stats->totalBytes;
+}
+
+void gpuMemoryFreed(GpuMemoryCategory category, uint64_t bytes) {
+    GpuMemoryStats* stats = &internal_gpuMemoryScope()->stats;
+    stats->bytes[category] -= bytes;
+    stats->counts[category]--;
+    stats->totalBytes -= bytes;
+}
+
+uint32_t gpuMemoryAddEvictable(GpuMemoryEvictFunc evict, void* userData) {
+    GpuMemoryScopeInternal* scope = internal_gpuMemoryScope();
+    uint32_t slot = 0;
+    while (slot < scope->evictableCount && scope->evictables[slot].evict)
+        slot++;
+    if (!internal_arrayReserve((void**) &scope->evictables,
+                               &scope->evictableCapacity,
+                               sizeof(GpuMemoryEvictableInternal), slot + 1))
+        return GPU_MEMORY_INVALID_HANDLE;
+    if (slot == scope->evictableCount)
+        scope->evictableCount++;
+
+    scope->evictables[slot] =
+        (GpuMemoryEvictableInternal) { evict, userData, 0, 0 };
+    return slot + 1;
+}
+
+void gpuMemoryTouch(uint32_t handle) {
+    GpuMemoryScopeInternal* scope = internal_gpuMemoryScope();
+    if (handle == GPU_MEMORY_INVALID_HANDLE || handle > scope->evictableCount)
+        return;
+    scope->evictables[handle - 1].lastFrame = scope->frame;
+    scope->evictables[handle - 1].resident = 1;
+}
+
+void gpuMemoryRemoveEvictable(uint32_t handle) {
+    GpuMemoryScopeInternal* scope = internal_gpuMemoryScope();
+    if (handle == GPU_MEMORY_INVALID_HANDLE || handle > scope->evictableCount)
+        return;
+    memset(&scope->evictables[handle - 1], 0,
+           sizeof(GpuMemoryEvictableInternal));
+    while (scope->evictableCount &&
+           !scope->evictables[scope->evictableCount - 1].evict)
+        scope->evictableCount--;
+    if (!scope->evictableCount) {
+        TG_FREE(scope->evictables);
+        scope->evictables = NULL;
+        scope->evictableCapacity = 0;
+    }
+}
+
+void gpuMemorySetBudget(uint64_t bytes) {
+    internal_gpuMemoryScope()->stats.budget = bytes;
+}
+
+GpuMemoryStats gpuMemoryGetStats(void) {
+    return internal_gpuMemoryScope()->stats;
+}
+
+void gpuMemoryEndFrame(void) {
+    internal_gpuMemoryScopeEndFrame(internal_gpuMemoryScope());
+}
@@ -0,0 +1,121 @@
+// GPU memory accounting public API
+
+#ifndef GPU_MEMORY_H
+#define GPU_MEMORY_H
+
+#include <stdint.h>
+
+#include "defines.h"
+
+/**
+ * @def GPU_MEMORY_INVALID_HANDLE
+ * @brief Returned when an evictable resource couldn't be registered
+ */
+#define GPU_MEMORY_INVALID_HANDLE 0
+
+/**
+ * @brief   What GPU memory is used for
+ */
+typedef enum GpuMemoryCategory {
+    GPU_MEMORY_BUFFER,          /**< Vertex and transform feedback buffers */
+    GPU_MEMORY_STAGING,         /**< Pixel unpack buffers of uploads */
+    GPU_MEMORY_TEXTURE,         /**< Sampled textures, every mip level */
+    GPU_MEMORY_RENDER_TARGET,   /**< Framebuffer color attachments */
+    GPU_MEMORY_CATEGORY_COUNT
+} GpuMemoryCategory;
+
+/**
+ * @brief   Estimated GPU memory held by the library
+ * @note    Sizes are computed from dimensions and formats, drivers add
+ *          padding and alignment on top. Every function here works on the
+ *          share group of the current OpenGL context, all windows of a
+ *          Context count as one, contexts not made by a Window share
+ *          another
+ */
+typedef struct GpuMemoryStats {
+    uint64_t bytes[GPU_MEMORY_CATEGORY_COUNT];  /**< Bytes per category */
+    uint32_t counts[GPU_MEMORY_CATEGORY_COUNT]; /**< Objects per category */
+    uint64_t totalBytes;    /**< Sum of bytes */
+    uint64_t peakBytes;     /**< Highest totalBytes seen */
+    uint64_t budget;        /**< Budget in bytes, 0 if unlimited */
+    uint32_t evictions;     /**< Cached resources evicted so far */
+} GpuMemoryStats;
+
+/**
+ * @brief   Frees a cached resource to get back under the budget
+ * @note    The resource has to report its bytes freed with gpuMemoryFreed,
+ *          and is expected to be recreated when needed again
+ */
+typedef void (*GpuMemoryEvictFunc)(void* userData);
+
+/**
+ * @brief   Account for a new GPU object
+ * @param   category: GpuMemoryCategory of the object
+ * @param   bytes: uint64_t, size of its storage
+ * @returns void
+ * @note    Library objects are accounted for already, this is for objects
+ *          created by the application
+ */
+TGAPI void gpuMemoryAllocated(GpuMemoryCategory category, uint64_t bytes);
+
+/**
+ * @brief   Account for a deleted GPU object
+ * @param   category: GpuMemoryCategory given to gpuMemoryAllocated
+ * @param   bytes: uint64_t, size given to gpuMemoryAllocated
+ * @returns void
+ */
+TGAPI void gpuMemoryFreed(GpuMemoryCategory category, uint64_t bytes);
+
+/**
+ * @brief   Register a cache that can be freed when over budget
+ * @param   evict: GpuMemoryEvictFunc freeing the cache
+ * @param   userData: passed to evict
+ * @returns Handle, GPU_MEMORY_INVALID_HANDLE on failure
+ * @note    The cache counts as empty until touched. The handle belongs to
+ *          the current share group, touch and remove it with a context of
+ *          that group current, evict is called with one current too
+ * @see     gpuMemoryTouch, gpuMemoryRemoveEvictable
+ */
+TGAPI uint32_t gpuMemoryAddEvictable(GpuMemoryEvictFunc evict, void* userData);
+
+/**
+ * @brief   Mark a cache as filled and used this frame
+ * @param   handle: uint32_t, from gpuMemoryAddEvictable
+ * @returns void
+ * @note    Caches touched in the current frame are never evicted
+ */
+TGAPI void gpuMemoryTouch(uint32_t handle);
+
+/**
+ * @brief   Unregister a cache, before freeing it for good
+ * @param   handle: uint32_t, from gpuMemoryAddEvictable
+ * @returns void
+ */
+TGAPI void gpuMemoryRemoveEvictable(uint32_t handle);
+
+/**
+ * @brief   Limit the GPU memory of the library
+ * @param   bytes: uint64_t, budget, 0 for unlimited
+ * @returns void
+ * @note    Over budget, caches are evicted least recently used first at the
+ *          end of each frame, until the total fits or nothing is left. The
+ *          budget is per share group, see GpuMemoryStats
+ */
+TGAPI void gpuMemorySetBudget(uint64_t bytes);
+
+/**
+ * @returns Copy of the current counters
+ * @see     GpuMemoryStats
+ */
+TGAPI GpuMemoryStats gpuMemoryGetStats(void);
+
+/**
+ * @brief   Close the frame and evict caches if over budget
+ * @returns void
+ * @note    windowRefresh calls this once every window of the share group has
+ *          refreshed, with one of them current. Only call it when rendering
+ *          without a Window
+ */
+TGAPI void gpuMemoryEndFrame(void);
+
+#endif // GPU_MEMORY_H
@@ -0,0 +1,35 @@
+// GPU memory internal API, for the modules that own per context state
+
+#ifndef GPU_MEMORY_INTERNAL_H
+#define GPU_MEMORY_INTERNAL_H
+
+#include "gpu_memory.h"
+
+// Internal Struct
+typedef struct GpuMemoryEvictableInternal {
+    GpuMemoryEvictFunc evict;   // NULL while the slot is free
+    void* userData;
+    uint64_t lastFrame;         // frame of the last touch
+    uint8_t resident;           // touched since the last eviction
+} GpuMemoryEvictableInternal;
+
+// Accounting, budget and caches of one share group, evicting a cache
+// deletes objects that only exist in its contexts
+typedef struct GpuMemoryScopeInternal {
+    GpuMemoryStats stats;
+    uint64_t frame;             // 0 is never a touched frame
+    GpuMemoryEvictableInternal* evictables;
+    uint32_t evictableCount, evictableCapacity;
+} GpuMemoryScopeInternal;
+
+// Empty scope, unlimited budget
+void internal_gpuMemoryScopeInit(GpuMemoryScopeInternal* scope);
+
+// Close the scope's frame and evict over budget, a context of the share
+// group has to be current
+void internal_gpuMemoryScopeEndFrame(GpuMemoryScopeInternal* scope);
+
+// Free the cache list, with the share group's last context
+void internal_gpuMemoryScopeRelease(GpuMemoryScopeInternal* scope);
+
+#endif // GPU_MEMORY_INTERNAL_H
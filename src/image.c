@@ -0,0 +1,387 @@
+#define TG_MEMORY_TAG MEMORY_TAG_IMAGE
+
+// get function defines
+#include "image.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// Largest stored deflate block
+#define IMAGE_STORED_BLOCK 65535
+
+// Bytes adler32 can sum before its 32 bit accumulators may overflow
+#define IMAGE_ADLER_RUN 5552
+
+// Internal Struct
+typedef struct ImageWriterInternal {
+    FILE* file;
+    uint32_t crc;           // of the chunk being written
+    uint32_t adlerA, adlerB;
+    uint32_t blockLeft;     // bytes left in the current stored block
+    size_t rawLeft;         // bytes left in the whole deflate stream
+} ImageWriterInternal;
+
+static const uint8_t pngSignature[8] = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'
+};
+static uint32_t crcTable[256];
+
+PRIVATE void internal_imageCrcInit(void) {
+    if (crcTable[1])
+        return;
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        crcTable[n] = c;
+    }
+}
+
+PRIVATE uint32_t internal_imageCrc(uint32_t crc, const uint8_t* data,
+                                   size_t length) {
+    for (size_t i = 0; i < length; i++)
+        crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+PRIVATE uint32_t internal_imageReadU32(const uint8_t* data) {
+    return (uint32_t) data[0] << 24 | (uint32_t) data[1] << 16 |
+           (uint32_t) data[2] << 8 | data[3];
+}
+
+PRIVATE void internal_imageWriteU32(uint8_t* out, uint32_t value) {
+    out[0] = (uint8_t) (value >> 24);
+    out[1] = (uint8_t) (value >> 16);
+    out[2] = (uint8_t) (value >> 8);
+    out[3] = (uint8_t) value;
+}
+
+// Bytes inside a chunk, counted in its CRC
+PRIVATE void internal_imagePut(ImageWriterInternal* writer,
+                               const void* data, size_t length) {
+    fwrite(data, 1, length, writer->file);
+    writer->crc = internal_imageCrc(writer->crc, data, length);
+}
+
+PRIVATE void internal_imageBeginChunk(ImageWriterInternal* writer,
+                                      const char* type, uint32_t length) {
+    uint8_t header[4];
+    internal_imageWriteU32(header, length);
+    fwrite(header, 1, 4, writer->file);
+    writer->crc = 0xFFFFFFFFu;
+    internal_imagePut(writer, type, 4);
+}
+
+PRIVATE void internal_imageEndChunk(ImageWriterInternal* writer) {
+    uint8_t crc[4];
+    internal_imageWriteU32(crc, writer->crc ^ 0xFFFFFFFFu);
+    fwrite(crc, 1, 4, writer->file);
+}
+
+// Uncompressed bytes of the deflate stream, split into stored blocks
+PRIVATE void internal_imagePutRaw(ImageWriterInternal* writer,
+                                  const uint8_t* data, size_t length) {
+    while (length) {
+        if (!writer->blockLeft) {
+            uint32_t size = writer->rawLeft < IMAGE_STORED_BLOCK
+                            ? (uint32_t) writer->rawLeft : IMAGE_STORED_BLOCK;
+            uint8_t header[5] = {
+                writer->rawLeft == size,    // final block
+                (uint8_t) size, (uint8_t) (size >> 8),
+                (uint8_t) ~size, (uint8_t) (~size >> 8)
+            };
+            internal_imagePut(writer, header, 5);
+            writer->blockLeft = size;
+        }
+
+        size_t run = length < writer->blockLeft ? length : writer->blockLeft;
+        internal_imagePut(writer, data, run);
+        for (size_t done = 0; done < run;) {
+            size_t stop = done + IMAGE_ADLER_RUN < run ? done + IMAGE_ADLER_RUN
+                                                       : run;
+            for (; done < stop; done++) {
+                writer->adlerA += data[done];
+                writer->adlerB += writer->adlerA;
+            }
+            writer->adlerA %= 65521;
+            writer->adlerB %= 65521;
+        }
+        writer->blockLeft -= (uint32_t) run;
+        writer->rawLeft -= run;
+        data += run;
+        length -= run;
+    }
+}
+
+uint8_t imageWritePng(const char* path, const void* pixels, uint32_t width,
+                      uint32_t height, PixelFormat format, uint32_t stride) {
+    uint32_t size = pixelFormatSize(format);
+    size_t rowBytes = (size_t) width * size;
+    size_t raw = (size_t) height * (rowBytes + 1);
+    size_t blocks = raw ? (raw + IMAGE_STORED_BLOCK - 1) / IMAGE_STORED_BLOCK
+                        : 1;
+    uint64_t idatLength = 2 + raw + blocks * 5 + 4;
+    if (!width || !height || idatLength > 0x7FFFFFFFu)
+        return 0;
+    if (!stride)
+        stride = (uint32_t) rowBytes;
+
+    ImageWriterInternal writer = { 0 };
+    writer.file = fopen(path, "wb");
+    if (!writer.file)
+        return 0;
+    internal_imageCrcInit();
+    fwrite(pngSignature, 1, sizeof(pngSignature), writer.file);
+
+    static const uint8_t colorTypes[] = { 0, 2, 6 };   // gray, RGB, RGBA
+    uint8_t header[13];
+    internal_imageWriteU32(header, width);
+    internal_imageWriteU32(header + 4, height);
+    header[8] = 8;  // bits per channel
+    header[9] = colorTypes[format];
+    header[10] = header[11] = header[12] = 0;   // deflate, filters, no interlace
+    internal_imageBeginChunk(&writer, "IHDR", 13);
+    internal_imagePut(&writer, header, 13);
+    internal_imageEndChunk(&writer);
+
+    internal_imageBeginChunk(&writer, "IDAT", (uint32_t) idatLength);
+    static const uint8_t zlibHeader[2] = { 0x78, 0x01 };
+    internal_imagePut(&writer, zlibHeader, 2);
+    writer.adlerA = 1;
+    writer.rawLeft = raw;
+    const uint8_t* row = pixels;
+    for (uint32_t y = 0; y < height; y++, row += stride) {
+        static const uint8_t filterNone = 0;
+        internal_imagePutRaw(&writer, &filterNone, 1);
+        internal_imagePutRaw(&writer, row, rowBytes);
+    }
+    uint8_t adler[4];
+    internal_imageWriteU32(adler, writer.adlerB << 16 | writer.adlerA);
+    internal_imagePut(&writer, adler, 4);
+    internal_imageEndChunk(&writer);
+
+    internal_imageBeginChunk(&writer, "IEND", 0);
+    internal_imageEndChunk(&writer);
+
+    uint8_t ok = !ferror(writer.file);
+    return fclose(writer.file) == 0 && ok;
+}
+
+PRIVATE uint8_t* internal_imageReadFile(const char* path, size_t* length) {
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return NULL;
+    uint8_t* data = NULL;
+    long end = -1;
+    if (fseek(file, 0, SEEK_END) == 0 && (end = ftell(file)) > 0 &&
+        fseek(file, 0, SEEK_SET) == 0 && (data = TG_MALLOC((size_t) end))) {
+        if (fread(data, 1, (size_t) end, file) != (size_t) end) {
+            TG_FREE(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+    *length = end > 0 ? (size_t) end : 0;
+    return data;
+}
+
+PRIVATE uint8_t internal_imagePaeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+// Undo the per row filters, out receives the rows without filter bytes
+PRIVATE uint8_t internal_imageUnfilter(uint8_t* out, const uint8_t* raw,
+                                       uint32_t height, size_t rowBytes,
+                                       uint32_t size) {
+    const uint8_t* previous = NULL;
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t filter = *raw++;
+        uint8_t* row = out + y * rowBytes;
+        for (size_t i = 0; i < rowBytes; i++) {
+            uint8_t left = i >= size ? row[i - size] : 0;
+            uint8_t up = previous ? previous[i] : 0;
+            uint8_t corner = previous && i >= size ? previous[i - size] : 0;
+            switch (filter) {
+                case 0: row[i] = raw[i]; break;
+                case 1: row[i] = raw[i] + left; break;
+                case 2: row[i] = raw[i] + up; break;
+                case 3: row[i] = raw[i] + (uint8_t) ((left + up) / 2); break;
+                case 4: row[i] = raw[i] + internal_imagePaeth(left, up, corner);
+                        break;
+                default: return 0;
+            }
+        }
+        raw += rowBytes;
+        previous = row;
+    }
+    return 1;
+}
+
+// Copy the payload of a zlib stream made of stored blocks
+PRIVATE uint8_t internal_imageInflateStored(uint8_t* out, size_t outSize,
+                                            const uint8_t* stream,
+                                            size_t length) {
+    // CMF says deflate, and CMF and FLG together are a multiple of 31
+    if (length < 2 || (stream[0] & 0x0F) != 8 ||
+        ((uint32_t) stream[0] << 8 | stream[1]) % 31 != 0 ||
+        (stream[1] & 0x20))
+        return 0;
+
+    size_t at = 2, filled = 0;
+    uint8_t final = 0;
+    while (!final) {
+        // stored blocks start byte aligned when every block is stored
+        if (length - at < 5 || (stream[at] & 0x06) != 0)
+            return 0;   // compressed blocks aren't supported
+        final = stream[at] & 1;
+        uint32_t size = stream[at + 1] | (uint32_t) stream[at + 2] << 8;
+        uint32_t check = stream[at + 3] | (uint32_t) stream[at + 4] << 8;
+        at += 5;
+        if ((size ^ check) != 0xFFFF || size > length - at ||
+            size > outSize - filled)
+            return 0;
+        memcpy(out + filled, stream + at, size);
+        filled += size;
+        at += size;
+    }
+    return filled == outSize;
+}
+
+// Validate the chunks, read the header and join the IDAT payloads
+// stream may be allocated even on failure, the caller frees it
+PRIVATE uint8_t internal_imageParseChunks(const uint8_t* file, size_t length,
+                                          uint32_t* width, uint32_t* height,
+                                          PixelFormat* format,
+                                          uint8_t** stream,
+                                          size_t* streamLength) {
+    uint8_t header = 0;
+    if (length < 8 || memcmp(file, pngSignature, 8) != 0)
+        return 0;
+    for (size_t at = 8; at + 12 <= length;) {
+        uint32_t chunkLength = internal_imageReadU32(file + at);
+        if (chunkLength > length - at - 12)
+            return 0;
+        const uint8_t* type = file + at + 4;
+        const uint8_t* data = file + at + 8;
+        uint32_t crc = internal_imageCrc(0xFFFFFFFFu, type, chunkLength + 4);
+        if ((crc ^ 0xFFFFFFFFu) != internal_imageReadU32(data + chunkLength))
+            return 0;
+        at += 12 + (size_t) chunkLength;
+
+        if (memcmp(type, "IHDR", 4) == 0) {
+            if (chunkLength != 13)
+                return 0;
+            *width = internal_imageReadU32(data);
+            *height = internal_imageReadU32(data + 4);
+            switch (data[9]) {
+                case 0: *format = PIXEL_FORMAT_R8; break;
+                case 2: *format = PIXEL_FORMAT_RGB8; break;
+                case 6: *format = PIXEL_FORMAT_RGBA8; break;
+                default: return 0;
+            }
+            if (!*width || !*height || *width > 1u << 16 ||
+                *height > 1u << 16 || data[8] != 8 || data[10] || data[11] ||
+                data[12])
+                return 0;
+            header = 1;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            // the data layer is split into chunks at arbitrary points
+            uint8_t* grown = TG_REALLOC(*stream, *streamLength + chunkLength);
+            if (!grown)
+                return 0;
+            *stream = grown;
+            memcpy(*stream + *streamLength, data, chunkLength);
+            *streamLength += chunkLength;
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        } else if (!(type[0] & 0x20)) {
+            return 0;   // unknown critical chunk
+        }
+    }
+    return header && *stream;
+}
+
+uint8_t* imageReadPng(const char* path, uint32_t* width, uint32_t* height,
+                      PixelFormat* format) {
+    size_t length;
+    uint8_t* file = internal_imageReadFile(path, &length);
+    if (!file)
+        return NULL;
+    internal_imageCrcInit();
+
+    uint8_t* stream = NULL;
+    size_t streamLength = 0;
+    uint32_t w = 0, h = 0;
+    uint8_t parsed = internal_imageParseChunks(file, length, &w, &h, format,
+                                               &stream, &streamLength);
+    TG_FREE(file);
+    if (!parsed) {
+        TG_FREE(stream);
+        return NULL;
+    }
+
+    uint32_t size = pixelFormatSize(*format);
+    size_t rowBytes = (size_t) w * size;
+    size_t rawSize = (size_t) h * (rowBytes + 1);
+    uint8_t* raw = TG_MALLOC(rawSize);
+    uint8_t* pixels = TG_MALLOC(rowBytes * h);
+    uint8_t decoded = raw && pixels &&
+        internal_imageInflateStored(raw, rawSize, stream, streamLength) &&
+        internal_imageUnfilter(pixels, raw, h, rowBytes, size);
+    TG_FREE(stream);
+    TG_FREE(raw);
+    if (!decoded) {
+        TG_FREE(pixels);
+        return NULL;
+    }
+    *width = w;
+    *height = h;
+    return pixels;
+}
+
+void imageFree(uint8_t* pixels) {
+    TG_FREE(pixels);
+}
+
+// Weighted RGB distance, cheap and close to how far apart colors look
+PRIVATE float internal_imageColorDistance(const uint8_t* a, const uint8_t* b) {
+    float mean = (a[0] + b[0]) * 0.5f;
+    float dr = (float) a[0] - b[0];
+    float dg = (float) a[1] - b[1];
+    float db = (float) a[2] - b[2];
+    float distance = sqrtf((2.0f + mean / 256.0f) * dr * dr + 4.0f * dg * dg +
+                           (2.0f + (255.0f - mean) / 256.0f) * db * db);
+    return distance / 765.0f;   // 255 * sqrt(9), the largest distance
+}
+
+ImageDiff imageCompare(const uint8_t* a, const uint8_t* b, uint32_t width,
+                       uint32_t height, PixelFormat format, float threshold) {
+    ImageDiff diff = { 0 };
+    uint32_t size = pixelFormatSize(format);
+    size_t count = (size_t) width * height;
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++, a += size, b += size) {
+        float difference;
+        if (format == PIXEL_FORMAT_R8) {
+            difference = fabsf((float) a[0] - b[0]) / 255.0f;
+        } else {
+            difference = internal_imageColorDistance(a, b);
+            if (format == PIXEL_FORMAT_RGBA8) {
+                float alpha = fabsf((float) a[3] - b[3]) / 255.0f;
+                difference = alpha > difference ? alpha : difference;
+            }
+        }
+        if (difference > diff.maxDifference)
+            diff.maxDifference = difference;
+        if (difference > threshold)
+            diff.differingPixels++;
+        sum += difference;
+    }
+    diff.meanDifference = count ? (float) (sum / count) : 0.0f;
+    return diff;
+}
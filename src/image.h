@@ -0,0 +1,75 @@
+// Image file public API
+
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdint.h>
+
+#include "pixel.h"
+#include "defines.h"
+
+/**
+ * @brief   How far apart two images are
+ * @note    Differences are between 0 and 1, per pixel the larger of a
+ *          perceptually weighted color distance and the alpha distance
+ */
+typedef struct ImageDiff {
+    float maxDifference;        /**< Largest difference of any pixel */
+    float meanDifference;       /**< Average difference over every pixel */
+    uint32_t differingPixels;   /**< Pixels differing by more than threshold */
+} ImageDiff;
+
+/**
+ * @brief   Write pixels to a PNG file
+ * @param   path: file to write
+ * @param   pixels: top row first
+ * @param   width: uint32_t, width in pixels
+ * @param   height: uint32_t, height in pixels
+ * @param   format: PixelFormat of pixels, R8 is written as grayscale
+ * @param   stride: uint32_t, bytes between rows of pixels, 0 if tight
+ * @returns 1 on success, 0 if the file couldn't be written
+ * @note    The image data is stored without compression, writing is cheap
+ *          and needs no scratch memory, files are large
+ */
+TGAPI uint8_t imageWritePng(const char* path, const void* pixels,
+                            uint32_t width, uint32_t height,
+                            PixelFormat format, uint32_t stride);
+
+/**
+ * @brief   Read a PNG file written by imageWritePng
+ * @param   path: file to read
+ * @param   width: receives the width in pixels
+ * @param   height: receives the height in pixels
+ * @param   format: receives the PixelFormat of the pixels
+ * @returns Tightly packed pixels, top row first, free with imageFree, NULL
+ *          on failure
+ * @note    Only 8 bit grayscale, RGB and RGBA without compression or
+ *          interlacing are supported, the layout imageWritePng produces
+ */
+TGAPI uint8_t* imageReadPng(const char* path, uint32_t* width,
+                            uint32_t* height, PixelFormat* format);
+
+/**
+ * @brief   Free pixels returned by imageReadPng
+ * @param   pixels: pixels to free, or NULL
+ * @returns void
+ */
+TGAPI void imageFree(uint8_t* pixels);
+
+/**
+ * @brief   Compare two images of the same size and format
+ * @param   a: tightly packed pixels
+ * @param   b: tightly packed pixels
+ * @param   width: uint32_t, width in pixels
+ * @param   height: uint32_t, height in pixels
+ * @param   format: PixelFormat of both images
+ * @param   threshold: float, difference above which a pixel counts as
+ *          differing, between 0 and 1
+ * @returns The differences
+ * @see     ImageDiff
+ */
+TGAPI ImageDiff imageCompare(const uint8_t* a, const uint8_t* b,
+                             uint32_t width, uint32_t height,
+                             PixelFormat format, float threshold);
+
+#endif // IMAGE_H
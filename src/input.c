@@ -0,0 +1,131 @@
+// get function defines
+#include "input_internal.h"
+
+#include <string.h>
+
+// Slot of the newest event, the queue must not be empty
+PRIVATE InputEventInternal* internal_inputNewest(InputQueueInternal* queue) {
+    uint32_t index = (queue->head + queue->count - 1) % INPUT_QUEUE_CAPACITY;
+    return &queue->events[index];
+}
+
+PRIVATE void internal_inputPush(InputQueueInternal* queue,
+                                InputEventInternal event) {
+    if (queue->count == INPUT_QUEUE_CAPACITY) {
+        queue->dropped++;   // keep the oldest, their order matters more
+        return;
+    }
+    queue->count++;
+    *internal_inputNewest(queue) = event;
+}
+
+PRIVATE void internal_inputSetBit(uint64_t* bits, uint32_t code,
+                                  uint8_t value) {
+    uint64_t mask = 1ull << (code & 63);
+    if (value)
+        bits[code >> 6] |= mask;
+    else
+        bits[code >> 6] &= ~mask;
+}
+
+void internal_inputPushKey(InputQueueInternal* queue, int32_t key,
+                           uint8_t pressed) {
+    if (key < 0 || key >= INPUT_KEY_COUNT)
+        return;     // GLFW_KEY_UNKNOWN and friends
+    internal_inputPush(queue, (InputEventInternal) {
+        INPUT_EVENT_KEY, pressed, (uint32_t) key, { 0.0f, 0.0f }
+    });
+}
+
+void internal_inputPushButton(InputQueueInternal* queue, int32_t button,
+                              uint8_t pressed) {
+    if (button < 0 || button >= INPUT_MOUSE_BUTTON_COUNT)
+        return;
+    internal_inputPush(queue, (InputEventInternal) {
+        INPUT_EVENT_BUTTON, pressed, (uint32_t) button, { 0.0f, 0.0f }
+    });
+}
+
+void internal_inputPushCursor(InputQueueInternal* queue, Vec2 position) {
+    // only the latest position matters, don't flood the queue with moves
+    if (queue->count && internal_inputNewest(queue)->type == INPUT_EVENT_CURSOR) {
+        internal_inputNewest(queue)->value = position;
+        return;
+    }
+    internal_inputPush(queue, (InputEventInternal) {
+        INPUT_EVENT_CURSOR, 0, 0, position
+    });
+}
+
+void internal_inputPushScroll(InputQueueInternal* queue, Vec2 offset) {
+    if (queue->count && internal_inputNewest(queue)->type == INPUT_EVENT_SCROLL) {
+        InputEventInternal* newest = internal_inputNewest(queue);
+        newest->value = vec2Add(newest->value, offset);
+        return;
+    }
+    internal_inputPush(queue, (InputEventInternal) {
+        INPUT_EVENT_SCROLL, 0, 0, offset
+    });
+}
+
+void internal_inputPushChar(InputQueueInternal* queue, uint32_t codepoint) {
+    internal_inputPush(queue, (InputEventInternal) {
+        INPUT_EVENT_CHAR, 0, codepoint, { 0.0f, 0.0f }
+    });
+}
+
+void internal_inputUpdate(InputQueueInternal* queue, InputSnapshot* snapshot) {
+    Vec2 lastPosition = snapshot->mousePosition;
+
+    // transitions only last one frame, held state carries over
+    memset(snapshot->keysPressed, 0, sizeof(snapshot->keysPressed));
+    memset(snapshot->keysReleased, 0, sizeof(snapshot->keysReleased));
+    snapshot->buttonsPressed = 0;
+    snapshot->buttonsReleased = 0;
+    snapshot->scroll = vec2GetZero();
+    snapshot->textLength = 0;
+    uint32_t dropped = queue->dropped;
+
+    for (uint32_t i = 0; i < queue->count; i++) {
+        const InputEventInternal* event =
+            &queue->events[(queue->head + i) % INPUT_QUEUE_CAPACITY];
+        switch (event->type) {
+            case INPUT_EVENT_KEY:
+                internal_inputSetBit(snapshot->keysDown, event->code,
+                                     event->pressed);
+                internal_inputSetBit(event->pressed ? snapshot->keysPressed
+                                                    : snapshot->keysReleased,
+                                     event->code, 1);
+                break;
+            case INPUT_EVENT_BUTTON: {
+                uint8_t bit = (uint8_t) (1u << event->code);
+                if (event->pressed) {
+                    snapshot->buttonsDown |= bit;
+                    snapshot->buttonsPressed |= bit;
+                } else {
+                    snapshot->buttonsDown &= (uint8_t) ~bit;
+                    snapshot->buttonsReleased |= bit;
+                }
+                break;
+            }
+            case INPUT_EVENT_CURSOR:
+                snapshot->mousePosition = event->value;
+                break;
+            case INPUT_EVENT_SCROLL:
+                snapshot->scroll = vec2Add(snapshot->scroll, event->value);
+                break;
+            case INPUT_EVENT_CHAR:
+                if (snapshot->textLength < INPUT_TEXT_CAPACITY)
+                    snapshot->text[snapshot->textLength++] = event->code;
+                else
+                    dropped++;
+                break;
+        }
+    }
+
+    snapshot->mouseDelta = vec2Sub(snapshot->mousePosition, lastPosition);
+    snapshot->droppedEvents = dropped;
+    queue->head = 0;
+    queue->count = 0;
+    queue->dropped = 0;
+}
@@ -0,0 +1,130 @@
+// Input public API
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+#include "vector.h"
+#include "defines.h"
+
+/**
+ * @def INPUT_KEY_COUNT
+ * @brief Number of key codes tracked, key codes are the GLFW_KEY_* values
+ */
+#define INPUT_KEY_COUNT 384
+
+/**
+ * @def INPUT_KEY_WORDS
+ * @brief Number of 64 bit words in a key bitset
+ */
+#define INPUT_KEY_WORDS (INPUT_KEY_COUNT / 64)
+
+/**
+ * @def INPUT_MOUSE_BUTTON_COUNT
+ * @brief Number of mouse buttons tracked, codes are GLFW_MOUSE_BUTTON_* values
+ */
+#define INPUT_MOUSE_BUTTON_COUNT 8
+
+/**
+ * @def INPUT_TEXT_CAPACITY
+ * @brief Most codepoints of typed text kept per frame
+ */
+#define INPUT_TEXT_CAPACITY 32
+
+/**
+ * @def INPUT_QUEUE_CAPACITY
+ * @brief Most input events buffered between two frames, extra are dropped
+ */
+#define INPUT_QUEUE_CAPACITY 256
+
+/**
+ * @brief   State of every input device for one frame
+ * @note    Built once per windowRefresh, never changes until the next one.
+ *          Query it with the inputKey* and inputMouse* helpers
+ */
+typedef struct InputSnapshot {
+    uint64_t keysDown[INPUT_KEY_WORDS];     /**< Held at the end of the frame */
+    uint64_t keysPressed[INPUT_KEY_WORDS];  /**< Went down this frame */
+    uint64_t keysReleased[INPUT_KEY_WORDS]; /**< Went up this frame */
+    uint8_t buttonsDown;        /**< Mouse buttons held, one bit each */
+    uint8_t buttonsPressed;     /**< Mouse buttons that went down */
+    uint8_t buttonsReleased;    /**< Mouse buttons that went up */
+    Vec2 mousePosition;         /**< Cursor position in window coordinates */
+    Vec2 mouseDelta;            /**< Cursor movement since the last frame */
+    Vec2 scroll;                /**< Scroll offset accumulated this frame */
+    uint32_t text[INPUT_TEXT_CAPACITY]; /**< Typed unicode codepoints */
+    uint32_t textLength;        /**< Number of codepoints in text */
+    uint32_t droppedEvents;     /**< Events lost to a full queue, and
+                                     codepoints that didn't fit in text */
+} InputSnapshot;
+
+// Bit lookup shared by the key helpers
+HELPER uint8_t internal_inputTestBit(const uint64_t* bits, int32_t code) {
+    if (code < 0 || code >= INPUT_KEY_COUNT)
+        return 0;
+    return (uint8_t) ((bits[code >> 6] >> (code & 63)) & 1u);
+}
+
+// Bit lookup shared by the mouse button helpers
+HELPER uint8_t internal_inputTestButton(uint8_t bits, int32_t button) {
+    if (button < 0 || button >= INPUT_MOUSE_BUTTON_COUNT)
+        return 0;
+    return (uint8_t) ((bits >> button) & 1u);
+}
+
+/**
+ * @param   input: Pointer to the snapshot
+ * @param   key: int32_t, GLFW_KEY_* code
+ * @returns 1 if the key is held down
+ */
+HELPER uint8_t inputKeyDown(const InputSnapshot* input, int32_t key) {
+    return internal_inputTestBit(input->keysDown, key);
+}
+
+/**
+ * @param   input: Pointer to the snapshot
+ * @param   key: int32_t, GLFW_KEY_* code
+ * @returns 1 if the key went down during this frame
+ */
+HELPER uint8_t inputKeyPressed(const InputSnapshot* input, int32_t key) {
+    return internal_inputTestBit(input->keysPressed, key);
+}
+
+/**
+ * @param   input: Pointer to the snapshot
+ * @param   key: int32_t, GLFW_KEY_* code
+ * @returns 1 if the key went up during this frame
+ */
+HELPER uint8_t inputKeyReleased(const InputSnapshot* input, int32_t key) {
+    return internal_inputTestBit(input->keysReleased, key);
+}
+
+/**
+ * @param   input: Pointer to the snapshot
+ * @param   button: int32_t, GLFW_MOUSE_BUTTON_* code
+ * @returns 1 if the mouse button is held down
+ */
+HELPER uint8_t inputMouseDown(const InputSnapshot* input, int32_t button) {
+    return internal_inputTestButton(input->buttonsDown, button);
+}
+
+/**
+ * @param   input: Pointer to the snapshot
+ * @param   button: int32_t, GLFW_MOUSE_BUTTON_* code
+ * @returns 1 if the mouse button went down during this frame
+ */
+HELPER uint8_t inputMousePressed(const InputSnapshot* input, int32_t button) {
+    return internal_inputTestButton(input->buttonsPressed, button);
+}
+
+/**
+ * @param   input: Pointer to the snapshot
+ * @param   button: int32_t, GLFW_MOUSE_BUTTON_* code
+ * @returns 1 if the mouse button went up during this frame
+ */
+HELPER uint8_t inputMouseReleased(const InputSnapshot* input, int32_t button) {
+    return internal_inputTestButton(input->buttonsReleased, button);
+}
+
+#endif // INPUT_H
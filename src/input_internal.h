@@ -0,0 +1,53 @@
+// Input internal API, shared between the window and input modules
+
+#ifndef INPUT_INTERNAL_H
+#define INPUT_INTERNAL_H
+
+#include "input.h"
+
+// Kind of a buffered input event
+typedef enum InputEventTypeInternal {
+    INPUT_EVENT_KEY,
+    INPUT_EVENT_BUTTON,
+    INPUT_EVENT_CURSOR,
+    INPUT_EVENT_SCROLL,
+    INPUT_EVENT_CHAR
+} InputEventTypeInternal;
+
+// One raw event, as delivered by a GLFW callback
+typedef struct InputEventInternal {
+    uint8_t type;       // InputEventTypeInternal
+    uint8_t pressed;    // key and button events, 1 down, 0 up
+    uint32_t code;      // key, button or codepoint
+    Vec2 value;         // cursor position or scroll offset
+} InputEventInternal;
+
+// Fixed capacity ring buffer, filled by callbacks and drained once per frame
+typedef struct InputQueueInternal {
+    InputEventInternal events[INPUT_QUEUE_CAPACITY];
+    uint32_t head;      // index of the oldest event
+    uint32_t count;
+    uint32_t dropped;   // events lost since the last drain
+} InputQueueInternal;
+
+// Queue a key transition, repeats should be filtered by the caller
+void internal_inputPushKey(InputQueueInternal* queue, int32_t key,
+                           uint8_t pressed);
+
+// Queue a mouse button transition
+void internal_inputPushButton(InputQueueInternal* queue, int32_t button,
+                              uint8_t pressed);
+
+// Queue a cursor move, consecutive moves are coalesced
+void internal_inputPushCursor(InputQueueInternal* queue, Vec2 position);
+
+// Queue a scroll, consecutive scrolls are accumulated
+void internal_inputPushScroll(InputQueueInternal* queue, Vec2 offset);
+
+// Queue a typed unicode codepoint
+void internal_inputPushChar(InputQueueInternal* queue, uint32_t codepoint);
+
+// Drain the queue into the snapshot for the new frame
+void internal_inputUpdate(InputQueueInternal* queue, InputSnapshot* snapshot);
+
+#endif // INPUT_INTERNAL_H
@@ -0,0 +1,346 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "line_series.h"
+#include "array_internal.h"
+#include "shader.h"
+#include "gpu_memory.h"
+#include "trace.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+// One instance per segment, reading two consecutive points, expanded into a
+// quad one feather pixel wider than the line and capped at both ends
+static const char* const lineSeriesVertex =
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aStart;\n"
+    "layout (location = 1) in vec2 aEnd;\n"
+    "uniform vec2 uViewSize;\n"
+    "uniform float uHalfThickness;\n"
+    "out float vDistance;\n"
+    "void main() {\n"
+    "    vec2 delta = aEnd - aStart;\n"
+    "    float len = length(delta);\n"
+    "    vec2 dir = len > 0.0 ? delta / len : vec2(1.0, 0.0);\n"
+    "    vec2 normal = vec2(-dir.y, dir.x);\n"
+    "    float extent = uHalfThickness + 1.0;\n"
+    "    float side = (gl_VertexID & 1) == 0 ? -extent : extent;\n"
+    "    float along = gl_VertexID < 2 ? -uHalfThickness\n"
+    "                                  : len + uHalfThickness;\n"
+    "    vec2 position = aStart + dir * along + normal * side;\n"
+    "    vDistance = side;\n"
+    "    vec2 ndc = position / uViewSize * 2.0 - 1.0;\n"
+    "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* const lineSeriesFragment =
+    "#version 330 core\n"
+    "in float vDistance;\n"
+    "uniform float uHalfThickness;\n"
+    "uniform vec4 uColor;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    float coverage = clamp(uHalfThickness + 0.5 - abs(vDistance),\n"
+    "                           0.0, 1.0);\n"
+    "    FragColor = vec4(uColor.rgb, uColor.a * coverage);\n"
+    "}\n";
+
+// Internal Struct
+struct _LineSeries {
+    float* x;
+    float* y;
+    uint32_t count, capacity;
+
+    // level L at index L - 1, block k spans samples [k * 4^L, (k + 1) * 4^L)
+    float* blockMin[LINE_SERIES_LEVELS];
+    float* blockMax[LINE_SERIES_LEVELS];
+    uint32_t blockCapacity[LINE_SERIES_LEVELS];
+
+    float thickness;
+    float color[4];
+
+    // drawing, created on the first draw
+    Vec2* points;               // decimated points of the last draw
+    uint32_t pointCapacity;
+    uint32_t drawProgram;
+    uint32_t drawVao;
+    uint32_t drawBuffer;
+    uint32_t bufferCapacity;    // points the GL buffer holds
+};
+
+// First index in [low, high) whose x is at least value, or above it when
+// strict is set
+PRIVATE uint32_t internal_lineSeriesSearch(const float* x, uint32_t low,
+                                           uint32_t high, float value,
+                                           uint8_t strict) {
+    while (low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        if (x[middle] < value || (strict && x[middle] == value))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+// Extremes of samples [first, end), whole blocks are read from the pyramid
+PRIVATE void internal_lineSeriesRange(const LineSeries* series,
+                                      uint32_t first, uint32_t end,
+                                      float* outMin, float* outMax) {
+    float low = INFINITY, high = -INFINITY;
+    for (uint32_t level = 0; first < end; level++) {
+        const float* mins = level ? series->blockMin[level - 1] : series->y;
+        const float* maxs = level ? series->blockMax[level - 1] : series->y;
+        uint8_t top = level == LINE_SERIES_LEVELS;
+
+        // unaligned blocks at both ends, the middle moves a level up
+        while (first < end && (top || (first & 3u))) {
+            low = mins[first] < low ? mins[first] : low;
+            high = maxs[first] > high ? maxs[first] : high;
+            first++;
+        }
+        while (first < end && (end & 3u)) {
+            end--;
+            low = mins[end] < low ? mins[end] : low;
+            high = maxs[end] > high ? maxs[end] : high;
+        }
+        first >>= 2;
+        end >>= 2;
+    }
+    *outMin = low;
+    *outMax = high;
+}
+
+PRIVATE void internal_lineSeriesEmit(Vec2* out, uint32_t* written,
+                                     uint32_t maxPoints, Vec2 point) {
+    if (*written < maxPoints)
+        out[(*written)++] = point;
+}
+
+PRIVATE uint8_t internal_lineSeriesDrawCreate(LineSeries* series) {
+    series->drawProgram = shaderCompile(lineSeriesVertex, lineSeriesFragment);
+    if (!series->drawProgram)
+        return 0;
+
+    glGenVertexArrays(1, &series->drawVao);
+    glGenBuffers(1, &series->drawBuffer);
+    glBindVertexArray(series->drawVao);
+    glBindBuffer(GL_ARRAY_BUFFER, series->drawBuffer);
+    // instance i reads points i and i + 1 of the same buffer
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2), (void*) 0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vec2),
+                          (void*) sizeof(Vec2));
+    glVertexAttribDivisor(0, 1);
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    return 1;
+}
+
+LineSeries* lineSeriesNew(uint32_t expectedSamples) {
+    LineSeries* series = ALLOC_S(LineSeries);
+    if (!series)
+        return NULL;
+    memset(series, 0, sizeof(LineSeries));
+    series->thickness = 1.0f;
+    series->color[0] = series->color[1] = series->color[2] = 1.0f;
+    series->color[3] = 1.0f;
+
+    // expectedSamples only saves regrowth, appends grow on demand
+    internal_arrayReservePair((void**) &series->x, (void**) &series->y,
+                              &series->capacity, sizeof(float), sizeof(float),
+                              expectedSamples);
+    return series;
+}
+
+uint8_t lineSeriesAppend(LineSeries* series, const Vec2* samples,
+                         uint32_t count) {
+    if (!internal_arrayReservePair((void**) &series->x, (void**) &series->y,
+                                   &series->capacity, sizeof(float),
+                                   sizeof(float), series->count + count))
+        return 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = series->count;
+        if (index && samples[i].x < series->x[index - 1])
+            return 0;
+        float value = samples[i].y;
+
+        // one block per level covers the new sample, it starts a new block
+        // when the index is a multiple of the block size
+        for (uint32_t level = 0; level < LINE_SERIES_LEVELS; level++) {
+            uint32_t shift = 2 * (level + 1);
+            uint32_t block = index >> shift;
+            if (index & ((1u << shift) - 1u)) {
+                float* low = &series->blockMin[level][block];
+                float* high = &series->blockMax[level][block];
+                *low = value < *low ? value : *low;
+                *high = value > *high ? value : *high;
+                continue;
+            }
+            if (!internal_arrayReservePair(
+                    (void**) &series->blockMin[level],
+                    (void**) &series->blockMax[level],
+                    &series->blockCapacity[level], sizeof(float),
+                    sizeof(float), block + 1))
+                return 0;
+            series->blockMin[level][block] = value;
+            series->blockMax[level][block] = value;
+        }
+        series->x[index] = samples[i].x;
+        series->y[index] = value;
+        series->count++;
+    }
+    return 1;
+}
+
+uint32_t lineSeriesGetCount(LineSeries* series) {
+    return series->count;
+}
+
+void lineSeriesSetStyle(LineSeries* series, float thickness,
+                        const float color[4]) {
+    series->thickness = thickness;
+    memcpy(series->color, color, sizeof(series->color));
+}
+
+uint32_t lineSeriesDecimate(LineSeries* series, Rect view, Vec2 viewSize,
+                            Vec2* out, uint32_t maxPoints) {
+    uint32_t width = (uint32_t) viewSize.x;
+    float spanX = view.max.x - view.min.x;
+    float spanY = view.max.y - view.min.y;
+    if (!series->count || !width || !(spanX > 0.0f) || !(spanY > 0.0f))
+        return 0;
+
+    const float* x = series->x;
+    const float* y = series->y;
+    float scaleX = (float) width / spanX;
+    float scaleY = viewSize.y / spanY;
+
+    // visible samples plus one on each side, so the line leaves the view
+    uint32_t inFirst = internal_lineSeriesSearch(x, 0, series->count,
+                                                 view.min.x, 0);
+    uint32_t inEnd = internal_lineSeriesSearch(x, inFirst, series->count,
+                                               view.max.x, 1);
+    uint32_t first = inFirst ? inFirst - 1 : 0;
+    uint32_t end = inEnd < series->count ? inEnd + 1 : inEnd;
+
+    uint32_t written = 0;
+    if (end - first <= 2 * width) {
+        for (uint32_t i = first; i < end; i++)
+            internal_lineSeriesEmit(out, &written, maxPoints, (Vec2) {
+                (x[i] - view.min.x) * scaleX, (view.max.y - y[i]) * scaleY
+            });
+        return written;
+    }
+
+    float previous = NAN;
+    if (first < inFirst) {
+        previous = (view.max.y - y[first]) * scaleY;
+        internal_lineSeriesEmit(out, &written, maxPoints, (Vec2) {
+            (x[first] - view.min.x) * scaleX, previous
+        });
+    }
+    uint32_t columnFirst = inFirst;
+    for (uint32_t column = 0; column < width; column++) {
+        uint32_t columnEnd = column + 1 == width
+            ? inEnd
+            : internal_lineSeriesSearch(x, columnFirst, inEnd,
+                                        view.min.x + (column + 1) / scaleX, 0);
+        if (columnFirst == columnEnd)
+            continue;   // gap in the data, the line bridges it
+
+        float low, high;
+        internal_lineSeriesRange(series, columnFirst, columnEnd, &low, &high);
+        float top = (view.max.y - high) * scaleY;
+        float bottom = (view.max.y - low) * scaleY;
+        float center = (float) column + 0.5f;
+
+        // start with the extreme nearest the previous column, fewer crossings
+        uint8_t topFirst = fabsf(previous - top) < fabsf(previous - bottom);
+        float start = topFirst ? top : bottom;
+        float finish = topFirst ? bottom : top;
+        internal_lineSeriesEmit(out, &written, maxPoints,
+                                (Vec2) { center, start });
+        if (finish != start)
+            internal_lineSeriesEmit(out, &written, maxPoints,
+                                    (Vec2) { center, finish });
+        previous = finish;
+        columnFirst = columnEnd;
+    }
+    if (end > inEnd)
+        internal_lineSeriesEmit(out, &written, maxPoints, (Vec2) {
+            (x[inEnd] - view.min.x) * scaleX, (view.max.y - y[inEnd]) * scaleY
+        });
+    return written;
+}
+
+void lineSeriesDraw(LineSeries* series, Rect view, Vec2 viewSize) {
+    TRACE_FUNCTION();
+    if (!series->drawProgram && !internal_lineSeriesDrawCreate(series))
+        return;
+    uint32_t maxPoints = 2 * (uint32_t) viewSize.x + 4;
+    if (!internal_arrayReserve((void**) &series->points,
+                               &series->pointCapacity, sizeof(Vec2),
+                               maxPoints))
+        return;
+    uint32_t count = lineSeriesDecimate(series, view, viewSize,
+                                        series->points, maxPoints);
+    if (count < 2)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, series->drawBuffer);
+    if (series->pointCapacity > series->bufferCapacity) {
+        if (series->bufferCapacity)
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) series->bufferCapacity * sizeof(Vec2));
+        series->bufferCapacity = series->pointCapacity;
+        gpuMemoryAllocated(GPU_MEMORY_BUFFER,
+                           (uint64_t) series->bufferCapacity * sizeof(Vec2));
+    }
+    glBufferData(GL_ARRAY_BUFFER,                                   // orphan
+                 (GLsizeiptr) series->bufferCapacity * sizeof(Vec2), NULL,
+                 GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr) count * sizeof(Vec2),
+                    series->points);
+
+    glUseProgram(series->drawProgram);
+    glUniform2f(glGetUniformLocation(series->drawProgram, "uViewSize"),
+                viewSize.x, viewSize.y);
+    glUniform1f(glGetUniformLocation(series->drawProgram, "uHalfThickness"),
+                series->thickness * 0.5f);
+    glUniform4f(glGetUniformLocation(series->drawProgram, "uColor"),
+                series->color[0], series->color[1], series->color[2],
+                series->color[3]);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(series->drawVao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) count - 1);
+    glBindVertexArray(0);
+}
+
+void lineSeriesDestroy(LineSeries* series) {
+    if (!series)
+        return;
+    shaderDestroy(series->drawProgram);
+    if (series->drawVao) {
+        glDeleteVertexArrays(1, &series->drawVao);
+        glDeleteBuffers(1, &series->drawBuffer);
+        if (series->bufferCapacity)
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) series->bufferCapacity * sizeof(Vec2));
+    }
+    for (uint32_t level = 0; level < LINE_SERIES_LEVELS; level++) {
+        TG_FREE(series->blockMin[level]);
+        TG_FREE(series->blockMax[level]);
+    }
+    TG_FREE(series->x);
+    TG_FREE(series->y);
+    TG_FREE(series->points);
+    TG_FREE(series);
+}
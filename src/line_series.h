@@ -0,0 +1,99 @@
+// Line series public API
+
+#ifndef LINE_SERIES_H
+#define LINE_SERIES_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "defines.h"
+
+/**
+ * @def LINE_SERIES_LEVELS
+ * @brief Levels of the min/max pyramid above the raw samples, level L keeps
+ * the extremes of blocks of 4^L samples
+ */
+#define LINE_SERIES_LEVELS 12
+
+/**
+ * @brief   Opaque type to LineSeries struct
+ * @note    Samples are sorted by x, a time axis for instance. Draws reduce
+ *          them to at most two points per pixel column, so the cost follows
+ *          the viewport width rather than the number of samples
+ */
+typedef struct _LineSeries LineSeries;
+
+/**
+ * @brief   Create a new, empty line series
+ * @param   expectedSamples: uint32_t, number of samples to reserve storage for
+ * @returns Pointer to a new LineSeries, NULL on failure
+ * @see     LineSeries
+ */
+TGAPI LineSeries* lineSeriesNew(uint32_t expectedSamples);
+
+/**
+ * @brief   Append samples to the end of the series
+ * @param   series: Pointer to the line series
+ * @param   samples: const Vec2*, x is the position along the axis, y the
+ *          value, x must not decrease
+ * @param   count: uint32_t, number of samples
+ * @returns 1 on success, 0 if a sample went back in x or storage ran out,
+ *          samples before it are kept
+ * @note    Only the pyramid blocks covering the new samples are updated
+ */
+TGAPI uint8_t lineSeriesAppend(LineSeries* series, const Vec2* samples,
+                               uint32_t count);
+
+/**
+ * @param   series: Pointer to the line series
+ * @returns Number of samples appended so far
+ */
+TGAPI uint32_t lineSeriesGetCount(LineSeries* series);
+
+/**
+ * @brief   Set how the series is drawn
+ * @param   series: Pointer to the line series
+ * @param   thickness: float, line width in pixels, one pixel of antialiasing
+ *          is added around it
+ * @param   color: RGBA color, straight alpha
+ * @returns void
+ */
+TGAPI void lineSeriesSetStyle(LineSeries* series, float thickness,
+                              const float color[4]);
+
+/**
+ * @brief   Reduce the visible samples to the points that get drawn
+ * @param   series: Pointer to the line series
+ * @param   view: Rect, visible range, x along the axis and y the values
+ * @param   viewSize: Vec2, size of the viewport in pixels, see windowGetSize
+ * @param   out: Vec2*, receives the points in pixels, origin at the top left
+ *          and values growing upwards
+ * @param   maxPoints: uint32_t, size of out, 2 * viewSize.x + 4 always fits
+ * @returns Number of points written
+ * @note    Samples are kept as they are while there are at most two per
+ *          column. Denser ranges become the minimum and maximum of each
+ *          column, read from the pyramid
+ */
+TGAPI uint32_t lineSeriesDecimate(LineSeries* series, Rect view,
+                                  Vec2 viewSize, Vec2* out,
+                                  uint32_t maxPoints);
+
+/**
+ * @brief   Draw the visible part of the series as a thick, smooth line
+ * @param   series: Pointer to the line series
+ * @param   view: Rect, visible range, as in lineSeriesDecimate
+ * @param   viewSize: Vec2, size of the viewport in pixels, see windowGetSize
+ * @returns void
+ * @note    Uploads the decimated points once, each segment is one instance
+ *          reading two consecutive points, expanded to a quad on the GPU
+ */
+TGAPI void lineSeriesDraw(LineSeries* series, Rect view, Vec2 viewSize);
+
+/**
+ * @brief   Free the series, on the CPU and the GPU
+ * @param   series: Pointer to the line series
+ * @returns void
+ */
+TGAPI void lineSeriesDestroy(LineSeries* series);
+
+#endif // LINE_SERIES_H
@@ -0,0 +1,214 @@
+// get function defines
+#include "memory.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// Internal Struct
+typedef struct MemoryHeaderInternal {
+    size_t size;
+    const char* file;
+    struct MemoryHeaderInternal* previous;
+    struct MemoryHeaderInternal* next;
+    int32_t line;
+    MemoryTag tag;
+} MemoryHeaderInternal;
+
+// Keeps the user block after the header aligned like malloc's
+typedef union MemoryBlockInternal {
+    MemoryHeaderInternal header;
+    max_align_t align;
+} MemoryBlockInternal;
+
+static atomic_flag lock = ATOMIC_FLAG_INIT;
+static MemoryHeaderInternal* liveBlocks;    // newest first, for leak reports
+static MemoryStats tagStats[MEMORY_TAG_COUNT];
+static uint64_t frameAllocations[MEMORY_TAG_COUNT];  // frame being built
+
+static const char* const tagNames[MEMORY_TAG_COUNT] = {
+    "unknown", "window", "context", "spatial", "damage", "texture",
+    "particle", "render", "image", "scene", "capture"
+};
+
+PRIVATE void internal_memoryLock(void) {
+    while (atomic_flag_test_and_set_explicit(&lock, memory_order_acquire))
+        ;
+}
+
+PRIVATE void internal_memoryUnlock(void) {
+    atomic_flag_clear_explicit(&lock, memory_order_release);
+}
+
+// Link a block and charge its tag, called with the lock held
+PRIVATE void internal_memoryTrack(MemoryHeaderInternal* header) {
+    header->previous = NULL;
+    header->next = liveBlocks;
+    if (liveBlocks)
+        liveBlocks->previous = header;
+    liveBlocks = header;
+
+    MemoryStats* stats = &tagStats[header->tag];
+    stats->liveBytes += header->size;
+    stats->liveAllocations++;
+    if (stats->liveBytes > stats->peakBytes)
+        stats->peakBytes = stats->liveBytes;
+}
+
+// Unlink a block and refund its tag, called with the lock held
+PRIVATE void internal_memoryUntrack(MemoryHeaderInternal* header) {
+    if (header->previous)
+        header->previous->next = header->next;
+    else
+        liveBlocks = header->next;
+    if (header->next)
+        header->next->previous = header->previous;
+
+    MemoryStats* stats = &tagStats[header->tag];
+    stats->liveBytes -= header->size;
+    stats->liveAllocations--;
+}
+
+PRIVATE void internal_memoryCount(MemoryTag tag) {
+    tagStats[tag].totalAllocations++;
+    frameAllocations[tag]++;
+}
+
+void* memoryAlloc(size_t size, MemoryTag tag, const char* file, int line) {
+    if (tag >= MEMORY_TAG_COUNT)
+        tag = MEMORY_TAG_UNKNOWN;
+    if (size > SIZE_MAX - sizeof(MemoryBlockInternal))
+        return NULL;
+    MemoryBlockInternal* block = malloc(sizeof(MemoryBlockInternal) + size);
+    if (!block)
+        return NULL;
+
+    block->header.size = size;
+    block->header.file = file;
+    block->header.line = line;
+    block->header.tag = tag;
+    internal_memoryLock();
+    internal_memoryTrack(&block->header);
+    internal_memoryCount(tag);
+    internal_memoryUnlock();
+    return block + 1;
+}
+
+void* memoryCalloc(size_t count, size_t size, MemoryTag tag,
+                   const char* file, int line) {
+    if (size && count > SIZE_MAX / size)
+        return NULL;
+    void* pointer = memoryAlloc(count * size, tag, file, line);
+    if (pointer)
+        memset(pointer, 0, count * size);
+    return pointer;
+}
+
+void* memoryRealloc(void* pointer, size_t size, MemoryTag tag,
+                    const char* file, int line) {
+    if (!pointer)
+        return memoryAlloc(size, tag, file, line);
+    if (!size) {
+        memoryFree(pointer);
+        return NULL;
+    }
+    if (size > SIZE_MAX - sizeof(MemoryBlockInternal))
+        return NULL;
+
+    MemoryBlockInternal* block = (MemoryBlockInternal*) pointer - 1;
+    // the block may move, nobody may walk the list in the meantime
+    internal_memoryLock();
+    internal_memoryUntrack(&block->header);
+    MemoryBlockInternal* resized = realloc(block, sizeof(MemoryBlockInternal) +
+                                                  size);
+    if (resized) {
+        block = resized;
+        block->header.size = size;
+        block->header.file = file;
+        block->header.line = line;
+        internal_memoryCount(block->header.tag);
+    }
+    internal_memoryTrack(&block->header);
+    internal_memoryUnlock();
+    return resized ? block + 1 : NULL;
+}
+
+void memoryFree(void* pointer) {
+    if (!pointer)
+        return;
+    MemoryBlockInternal* block = (MemoryBlockInternal*) pointer - 1;
+    internal_memoryLock();
+    internal_memoryUntrack(&block->header);
+    internal_memoryUnlock();
+    free(block);
+}
+
+uint8_t memoryIsTracking(void) {
+#if defined(TG_TRACK_ALLOCATIONS)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+MemoryStats memoryGetStats(void) {
+    MemoryStats total = { 0 };
+    internal_memoryLock();
+    for (uint32_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+        total.liveBytes += tagStats[i].liveBytes;
+        total.liveAllocations += tagStats[i].liveAllocations;
+        total.totalAllocations += tagStats[i].totalAllocations;
+        total.frameAllocations += tagStats[i].frameAllocations;
+        // tags peak at different times, this is an upper bound
+        total.peakBytes += tagStats[i].peakBytes;
+    }
+    internal_memoryUnlock();
+    return total;
+}
+
+MemoryStats memoryGetTagStats(MemoryTag tag) {
+    if (tag >= MEMORY_TAG_COUNT)
+        tag = MEMORY_TAG_UNKNOWN;
+    internal_memoryLock();
+    MemoryStats stats = tagStats[tag];
+    internal_memoryUnlock();
+    return stats;
+}
+
+const char* memoryTagName(MemoryTag tag) {
+    return tag < MEMORY_TAG_COUNT ? tagNames[tag] : tagNames[0];
+}
+
+void memoryEndFrame(void) {
+    internal_memoryLock();
+    for (uint32_t i = 0; i < MEMORY_TAG_COUNT; i++) {
+        tagStats[i].frameAllocations = frameAllocations[i];
+        frameAllocations[i] = 0;
+    }
+    internal_memoryUnlock();
+}
+
+uint64_t memoryReportLeaks(void) {
+    uint64_t count = 0, bytes = 0;
+    internal_memoryLock();
+    for (MemoryHeaderInternal* header = liveBlocks; header;
+         header = header->next) {
+        fprintf(stderr, "leak: %zu bytes, %s, allocated at %s:%d\n",
+                header->size, tagNames[header->tag], header->file,
+                (int) header->line);
+        count++;
+        bytes += header->size;
+    }
+    internal_memoryUnlock();
+    if (count)
+        fprintf(stderr, "leak: %llu blocks, %llu bytes in total\n",
+                (unsigned long long) count, (unsigned long long) bytes);
+    return count;
+}
+
+#if defined(TG_TRACK_ALLOCATIONS)
+// Whatever the program didn't free by the time it exits
+PRIVATE POST_MAIN void internal_memoryReportAtExit(void) {
+    memoryReportLeaks();
+}
+#endif
@@ -0,0 +1,124 @@
+// Memory tracking public API
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "defines.h"
+
+/**
+ * @brief   Subsystem an allocation is charged to
+ * @note    A source file picks its tag by defining TG_MEMORY_TAG before its
+ *          first include, untagged allocations count as MEMORY_TAG_UNKNOWN
+ */
+typedef enum MemoryTag {
+    MEMORY_TAG_UNKNOWN,
+    MEMORY_TAG_WINDOW,
+    MEMORY_TAG_CONTEXT,
+    MEMORY_TAG_SPATIAL,
+    MEMORY_TAG_DAMAGE,
+    MEMORY_TAG_TEXTURE,
+    MEMORY_TAG_PARTICLE,
+    MEMORY_TAG_RENDER,
+    MEMORY_TAG_IMAGE,
+    MEMORY_TAG_SCENE,
+    MEMORY_TAG_CAPTURE,
+    MEMORY_TAG_COUNT
+} MemoryTag;
+
+/**
+ * @brief   Allocation counters, for every tag or a single one
+ */
+typedef struct MemoryStats {
+    uint64_t liveBytes;         /**< Bytes currently allocated */
+    uint64_t peakBytes;         /**< Highest liveBytes seen */
+    uint64_t liveAllocations;   /**< Blocks currently allocated */
+    uint64_t totalAllocations;  /**< Allocations and reallocations ever made */
+    uint64_t frameAllocations;  /**< Allocations made in the last frame */
+} MemoryStats;
+
+/**
+ * @brief   Allocate a tracked block, what TG_MALLOC expands to
+ * @param   size: size_t, bytes to allocate
+ * @param   tag: MemoryTag charged with the block
+ * @param   file: source file of the call, kept for the leak report
+ * @param   line: int, source line of the call
+ * @returns Pointer to the block, NULL on failure
+ */
+TGAPI void* memoryAlloc(size_t size, MemoryTag tag, const char* file,
+                        int line);
+
+/**
+ * @brief   Allocate a zeroed tracked block, what TG_CALLOC expands to
+ * @param   count: size_t, number of elements
+ * @param   size: size_t, bytes per element
+ * @param   tag: MemoryTag charged with the block
+ * @param   file: source file of the call
+ * @param   line: int, source line of the call
+ * @returns Pointer to the block, NULL on failure or overflow
+ */
+TGAPI void* memoryCalloc(size_t count, size_t size, MemoryTag tag,
+                         const char* file, int line);
+
+/**
+ * @brief   Resize a tracked block, what TG_REALLOC expands to
+ * @param   pointer: block from memoryAlloc, or NULL to allocate
+ * @param   size: size_t, new size in bytes, 0 frees the block
+ * @param   tag: MemoryTag charged with the block
+ * @param   file: source file of the call
+ * @param   line: int, source line of the call
+ * @returns Pointer to the resized block, NULL on failure, leaving the old
+ *          block untouched
+ */
+TGAPI void* memoryRealloc(void* pointer, size_t size, MemoryTag tag,
+                          const char* file, int line);
+
+/**
+ * @brief   Free a tracked block, what TG_FREE expands to
+ * @param   pointer: block from memoryAlloc, or NULL
+ * @returns void
+ */
+TGAPI void memoryFree(void* pointer);
+
+/**
+ * @returns 1 if the library was built with TG_TRACK_ALLOCATIONS, otherwise
+ *          library allocations bypass the counters
+ */
+TGAPI uint8_t memoryIsTracking(void);
+
+/**
+ * @returns Counters summed over every tag
+ * @see     MemoryStats
+ */
+TGAPI MemoryStats memoryGetStats(void);
+
+/**
+ * @param   tag: MemoryTag to read
+ * @returns Counters of one subsystem
+ */
+TGAPI MemoryStats memoryGetTagStats(MemoryTag tag);
+
+/**
+ * @param   tag: MemoryTag
+ * @returns Name of the tag, for reports
+ */
+TGAPI const char* memoryTagName(MemoryTag tag);
+
+/**
+ * @brief   Close the current frame of allocation counters
+ * @returns void
+ * @note    windowRefresh calls this once every window has refreshed, only
+ *          call it when rendering without a Window
+ */
+TGAPI void memoryEndFrame(void);
+
+/**
+ * @brief   Print every live block to stderr
+ * @returns Number of live blocks
+ * @note    Runs by itself when the program exits, on GCC and Clang
+ */
+TGAPI uint64_t memoryReportLeaks(void);
+
+#endif // MEMORY_H
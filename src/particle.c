@@ -0,0 +1,320 @@
+#define TG_MEMORY_TAG MEMORY_TAG_PARTICLE
+
+// get function defines
+#include "particle_internal.h"
+#include "shader.h"
+#include "trace.h"
+
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+#ifdef VECTOR_SSE
+    #include <xmmintrin.h>
+#endif
+
+// Shared by both backends, the layout matches PARTICLE_GPU_STRIDE
+static const char* const particleDrawVertex =
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPosition;\n"
+    "layout (location = 2) in float aAge;\n"
+    "layout (location = 3) in float aLifetime;\n"
+    "uniform vec2 uViewSize;\n"
+    "uniform float uPointSize;\n"
+    "out float vFade;\n"
+    "void main() {\n"
+    "    vFade = aAge < aLifetime ? 1.0 - aAge / aLifetime : 0.0;\n"
+    "    vec2 ndc = aPosition / uViewSize * 2.0 - 1.0;\n"
+    "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);\n"
+    "    gl_PointSize = vFade > 0.0 ? uPointSize : 0.0;\n"
+    "}\n";
+
+static const char* const particleDrawFragment =
+    "#version 330 core\n"
+    "in float vFade;\n"
+    "uniform vec4 uColor;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    vec2 d = gl_PointCoord * 2.0 - 1.0;\n"
+    "    if (vFade <= 0.0 || dot(d, d) > 1.0)\n"
+    "        discard;\n"
+    "    FragColor = vec4(uColor.rgb, uColor.a * vFade);\n"
+    "}\n";
+
+// Floats per particle in the CPU draw buffer: position, age, lifetime
+#define PARTICLE_DRAW_STRIDE 4
+
+// xorshift, good enough for visual noise and never allocates
+PRIVATE float internal_particleRandom(ParticleSystem* system, float min,
+                                      float max) {
+    uint32_t x = system->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    system->random = x;
+    return min + (max - min) * (float) (x & 0xFFFFFF) / 16777216.0f;
+}
+
+void internal_particleSpawn(ParticleSystem* system, float* out) {
+    const ParticleEmitter* emitter = &system->emitter;
+    out[0] = emitter->position.x;
+    out[1] = emitter->position.y;
+    out[2] = internal_particleRandom(system, emitter->velocityMin.x,
+                                     emitter->velocityMax.x);
+    out[3] = internal_particleRandom(system, emitter->velocityMin.y,
+                                     emitter->velocityMax.y);
+    out[4] = 0.0f;
+    out[5] = internal_particleRandom(system, emitter->lifetimeMin,
+                                     emitter->lifetimeMax);
+}
+
+PRIVATE void internal_particleCpuEmit(ParticleSystem* system, uint32_t count) {
+    if (count > system->capacity - system->count)
+        count = system->capacity - system->count;
+
+    float state[PARTICLE_GPU_STRIDE];
+    for (uint32_t i = system->count; i < system->count + count; i++) {
+        internal_particleSpawn(system, state);
+        system->positionX[i] = state[0];
+        system->positionY[i] = state[1];
+        system->velocityX[i] = state[2];
+        system->velocityY[i] = state[3];
+        system->age[i] = state[4];
+        system->lifetime[i] = state[5];
+    }
+    system->count += count;
+}
+
+PRIVATE void internal_particleCpuUpdate(ParticleSystem* system, float dt) {
+    float gx = system->emitter.gravity.x * dt;
+    float gy = system->emitter.gravity.y * dt;
+    uint32_t i = 0;
+
+#ifdef VECTOR_SSE
+    // arrays are padded to a multiple of 4, the tail lanes are harmless
+    __m128 delta = _mm_set1_ps(dt);
+    __m128 stepX = _mm_set1_ps(gx);
+    __m128 stepY = _mm_set1_ps(gy);
+    for (; i < system->count; i += 4) {
+        __m128 vx = _mm_add_ps(_mm_loadu_ps(system->velocityX + i), stepX);
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(system->velocityY + i), stepY);
+        __m128 px = _mm_loadu_ps(system->positionX + i);
+        __m128 py = _mm_loadu_ps(system->positionY + i);
+        _mm_storeu_ps(system->velocityX + i, vx);
+        _mm_storeu_ps(system->velocityY + i, vy);
+        _mm_storeu_ps(system->positionX + i,
+                      _mm_add_ps(px, _mm_mul_ps(vx, delta)));
+        _mm_storeu_ps(system->positionY + i,
+                      _mm_add_ps(py, _mm_mul_ps(vy, delta)));
+        _mm_storeu_ps(system->age + i,
+                      _mm_add_ps(_mm_loadu_ps(system->age + i), delta));
+    }
+#else
+    // plain loop over separate arrays, GCC 12 vectorizes it at -O3 only,
+    // behind a runtime aliasing check, -O2 and debug builds stay scalar
+    for (; i < system->count; i++) {
+        system->velocityX[i] += gx;
+        system->velocityY[i] += gy;
+        system->positionX[i] += system->velocityX[i] * dt;
+        system->positionY[i] += system->velocityY[i] * dt;
+        system->age[i] += dt;
+    }
+#endif
+
+    // swap the last live particle into every dead slot, walking backwards
+    // so the swapped in particle has already been checked
+    for (i = system->count; i-- > 0;) {
+        if (system->age[i] < system->lifetime[i])
+            continue;
+        uint32_t last = --system->count;
+        system->positionX[i] = system->positionX[last];
+        system->positionY[i] = system->positionY[last];
+        system->velocityX[i] = system->velocityX[last];
+        system->velocityY[i] = system->velocityY[last];
+        system->age[i] = system->age[last];
+        system->lifetime[i] = system->lifetime[last];
+    }
+}
+
+PRIVATE uint8_t internal_particleCpuCreate(ParticleSystem* system) {
+    // one block for all six arrays, each padded for 4 wide SIMD
+    size_t padded = ((size_t) system->capacity + 3) & ~(size_t) 3;
+    float* block = TG_CALLOC(padded * 6, sizeof(float));
+    if (!block)
+        return 0;
+    system->positionX = block;
+    system->positionY = block + padded;
+    system->velocityX = block + padded * 2;
+    system->velocityY = block + padded * 3;
+    system->age = block + padded * 4;
+    system->lifetime = block + padded * 5;
+    return 1;
+}
+
+// Draw objects are only made on the first draw, so CPU simulation works
+// without a context
+PRIVATE uint8_t internal_particleDrawCreate(ParticleSystem* system) {
+    system->drawProgram = shaderCompile(particleDrawVertex,
+                                        particleDrawFragment);
+    if (!system->drawProgram)
+        return 0;
+    if (system->backend == PARTICLE_BACKEND_GPU)
+        return 1;
+
+    glGenVertexArrays(1, &system->drawVao);
+    glGenBuffers(1, &system->drawBuffer);
+    glBindVertexArray(system->drawVao);
+    glBindBuffer(GL_ARRAY_BUFFER, system->drawBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr) system->capacity *
+                 PARTICLE_DRAW_STRIDE * sizeof(float), NULL, GL_STREAM_DRAW);
+    gpuMemoryAllocated(GPU_MEMORY_BUFFER, (uint64_t) system->capacity *
+                       PARTICLE_DRAW_STRIDE * sizeof(float));
+    GLsizei stride = PARTICLE_DRAW_STRIDE * sizeof(float);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*) 0);
+    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride,
+                          (void*) (2 * sizeof(float)));
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride,
+                          (void*) (3 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(2);
+    glEnableVertexAttribArray(3);
+    glBindVertexArray(0);
+    return 1;
+}
+
+// Interleave the live CPU particles into the draw buffer
+PRIVATE void internal_particleCpuUpload(ParticleSystem* system) {
+    GLsizeiptr bytes = (GLsizeiptr) system->capacity *
+                       PARTICLE_DRAW_STRIDE * sizeof(float);
+    glBindBuffer(GL_ARRAY_BUFFER, system->drawBuffer);
+    glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STREAM_DRAW);  // orphan
+    float* out = glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes,
+                                  GL_MAP_WRITE_BIT |
+                                  GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!out)
+        return;
+    for (uint32_t i = 0; i < system->count; i++, out += PARTICLE_DRAW_STRIDE) {
+        out[0] = system->positionX[i];
+        out[1] = system->positionY[i];
+        out[2] = system->age[i];
+        out[3] = system->lifetime[i];
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+ParticleSystem* particleSystemNew(ParticleBackend backend, uint32_t capacity) {
+    if (!capacity)
+        return NULL;
+
+    ParticleSystem* system = ALLOC_S(ParticleSystem);
+    if (!system)
+        return NULL;
+    memset(system, 0, sizeof(ParticleSystem));
+    system->backend = backend;
+    system->capacity = capacity;
+    system->random = 0x9E3779B9u;
+    system->emitter = (ParticleEmitter) {
+        .velocityMin = { -50.0f, -50.0f },
+        .velocityMax = { 50.0f, 50.0f },
+        .lifetimeMin = 1.0f,
+        .lifetimeMax = 2.0f,
+        .size = 4.0f,
+        .color = { 1.0f, 1.0f, 1.0f, 1.0f }
+    };
+
+    uint8_t created = backend == PARTICLE_BACKEND_GPU
+                      ? internal_particleGpuCreate(system)
+                      : internal_particleCpuCreate(system);
+    if (!created) {
+        particleSystemDestroy(system);
+        return NULL;
+    }
+    return system;
+}
+
+void particleSystemSetEmitter(ParticleSystem* system,
+                              const ParticleEmitter* emitter) {
+    system->emitter = *emitter;
+}
+
+void particleSystemEmit(ParticleSystem* system, uint32_t count) {
+    if (system->backend == PARTICLE_BACKEND_GPU)
+        internal_particleGpuEmit(system, count);
+    else
+        internal_particleCpuEmit(system, count);
+}
+
+void particleSystemUpdate(ParticleSystem* system, float deltaTime) {
+    TRACE_FUNCTION();
+    // carry the fraction over, low rates still spawn at high frame rates
+    system->emitDebt += system->emitter.rate * deltaTime;
+    uint32_t spawn = (uint32_t) system->emitDebt;
+    system->emitDebt -= (float) spawn;
+
+    if (system->backend == PARTICLE_BACKEND_GPU) {
+        internal_particleGpuUpdate(system, deltaTime);
+        internal_particleGpuEmit(system, spawn);
+    } else {
+        internal_particleCpuUpdate(system, deltaTime);
+        internal_particleCpuEmit(system, spawn);
+    }
+}
+
+void particleSystemDraw(ParticleSystem* system, Vec2 viewSize) {
+    if (!system->count)
+        return;
+    TRACE_FUNCTION();
+    if (!system->drawProgram && !internal_particleDrawCreate(system))
+        return;
+
+    if (system->backend == PARTICLE_BACKEND_GPU) {
+        glBindVertexArray(system->vaos[system->current]);
+    } else {
+        internal_particleCpuUpload(system);
+        glBindVertexArray(system->drawVao);
+    }
+
+    const float* color = system->emitter.color;
+    glUseProgram(system->drawProgram);
+    glUniform2f(glGetUniformLocation(system->drawProgram, "uViewSize"),
+                viewSize.x, viewSize.y);
+    glUniform1f(glGetUniformLocation(system->drawProgram, "uPointSize"),
+                system->emitter.size);
+    glUniform4f(glGetUniformLocation(system->drawProgram, "uColor"),
+                color[0], color[1], color[2], color[3]);
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_POINTS, 0, (GLsizei) system->count);
+    glBindVertexArray(0);
+}
+
+uint32_t particleSystemGetCount(ParticleSystem* system) {
+    return system->count;
+}
+
+uint32_t particleSystemGetPositions(ParticleSystem* system, const float** x,
+                                    const float** y) {
+    if (system->backend == PARTICLE_BACKEND_GPU)
+        return 0;
+    *x = system->positionX;
+    *y = system->positionY;
+    return system->count;
+}
+
+void particleSystemDestroy(ParticleSystem* system) {
+    if (!system)
+        return;
+    if (system->backend == PARTICLE_BACKEND_GPU)
+        internal_particleGpuDestroy(system);
+    TG_FREE(system->positionX);     // owns the whole CPU block
+    shaderDestroy(system->drawProgram);
+    if (system->drawVao) {
+        glDeleteVertexArrays(1, &system->drawVao);
+        glDeleteBuffers(1, &system->drawBuffer);
+        gpuMemoryFreed(GPU_MEMORY_BUFFER, (uint64_t) system->capacity *
+                       PARTICLE_DRAW_STRIDE * sizeof(float));
+    }
+    TG_FREE(system);
+}
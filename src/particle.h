@@ -0,0 +1,110 @@
+// Particle system public API
+
+#ifndef PARTICLE_H
+#define PARTICLE_H
+
+#include <stdint.h>
+
+#include "vector.h"
+#include "defines.h"
+
+/**
+ * @brief   Where particles are simulated
+ */
+typedef enum ParticleBackend {
+    PARTICLE_BACKEND_CPU,   /**< SIMD over structure of arrays, readable */
+    PARTICLE_BACKEND_GPU    /**< Transform feedback, state stays on the GPU */
+} ParticleBackend;
+
+/**
+ * @brief   Describes how new particles are spawned, shared by both backends
+ */
+typedef struct ParticleEmitter {
+    Vec2 position;      /**< Spawn point, in pixels from the top left */
+    Vec2 velocityMin;   /**< Lower bound of the random start velocity */
+    Vec2 velocityMax;   /**< Upper bound of the random start velocity */
+    Vec2 gravity;       /**< Constant acceleration, pixels per second² */
+    float lifetimeMin;  /**< Shortest lifetime in seconds */
+    float lifetimeMax;  /**< Longest lifetime in seconds */
+    float rate;         /**< Particles spawned per second by updates */
+    float size;         /**< Point size in pixels */
+    float color[4];     /**< RGBA color, alpha fades out over the lifetime */
+} ParticleEmitter;
+
+/**
+ * @brief   Opaque type to ParticleSystem struct
+ */
+typedef struct _ParticleSystem ParticleSystem;
+
+/**
+ * @brief   Create a new particle system
+ * @param   backend: ParticleBackend, where to simulate
+ * @param   capacity: uint32_t, most particles alive at once
+ * @returns Pointer to a new ParticleSystem, NULL on failure
+ * @note    The GPU backend needs a current OpenGL context, the CPU backend
+ *          only needs one to draw
+ * @see     ParticleSystem, ParticleBackend
+ */
+TGAPI ParticleSystem* particleSystemNew(ParticleBackend backend,
+                                        uint32_t capacity);
+
+/**
+ * @brief   Replace the emitter description
+ * @param   system: Pointer to the particle system
+ * @param   emitter: Pointer to the emitter, copied
+ * @returns void
+ * @see     ParticleEmitter
+ */
+TGAPI void particleSystemSetEmitter(ParticleSystem* system,
+                                    const ParticleEmitter* emitter);
+
+/**
+ * @brief   Spawn a burst of particles at the emitter
+ * @param   system: Pointer to the particle system
+ * @param   count: uint32_t, number of particles
+ * @returns void
+ * @note    The CPU backend drops particles past capacity, the GPU backend
+ *          recycles the oldest slots
+ */
+TGAPI void particleSystemEmit(ParticleSystem* system, uint32_t count);
+
+/**
+ * @brief   Spawn particles for the elapsed time and advance the simulation
+ * @param   system: Pointer to the particle system
+ * @param   deltaTime: float, seconds since the last update
+ * @returns void
+ */
+TGAPI void particleSystemUpdate(ParticleSystem* system, float deltaTime);
+
+/**
+ * @brief   Draw every live particle as a round point
+ * @param   system: Pointer to the particle system
+ * @param   viewSize: Vec2, size of the viewport in pixels, see windowGetSize
+ * @returns void
+ */
+TGAPI void particleSystemDraw(ParticleSystem* system, Vec2 viewSize);
+
+/**
+ * @param   system: Pointer to the particle system
+ * @returns Live particles on the CPU backend, slots in use on the GPU one
+ */
+TGAPI uint32_t particleSystemGetCount(ParticleSystem* system);
+
+/**
+ * @brief   Read the particle positions, CPU backend only
+ * @param   system: Pointer to the particle system
+ * @param   x: receives the array of x coordinates
+ * @param   y: receives the array of y coordinates
+ * @returns Number of valid entries, 0 on the GPU backend
+ */
+TGAPI uint32_t particleSystemGetPositions(ParticleSystem* system,
+                                          const float** x, const float** y);
+
+/**
+ * @brief   Free the particle system, on the CPU and the GPU
+ * @param   system: Pointer to the particle system
+ * @returns void
+ */
+TGAPI void particleSystemDestroy(ParticleSystem* system);
+
+#endif // PARTICLE_H
@@ -0,0 +1,133 @@
+// get function defines
+#include "particle_internal.h"
+#include "shader.h"
+
+#include "../vendor/glad/gl.h"
+
+// Same integration as the CPU backend, one vertex per particle slot
+static const char* const particleUpdateVertex =
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPosition;\n"
+    "layout (location = 1) in vec2 aVelocity;\n"
+    "layout (location = 2) in float aAge;\n"
+    "layout (location = 3) in float aLifetime;\n"
+    "uniform float uDelta;\n"
+    "uniform vec2 uGravity;\n"
+    "out vec2 outPosition;\n"
+    "out vec2 outVelocity;\n"
+    "out float outAge;\n"
+    "out float outLifetime;\n"
+    "void main() {\n"
+    "    outVelocity = aVelocity + uGravity * uDelta;\n"
+    "    outPosition = aPosition + outVelocity * uDelta;\n"
+    "    outAge = aAge + uDelta;\n"
+    "    outLifetime = aLifetime;\n"
+    "}\n";
+
+static const char* const particleVaryings[] = {
+    "outPosition", "outVelocity", "outAge", "outLifetime"
+};
+
+// Particles spawned per glBufferSubData, bounds the stack staging area
+#define PARTICLE_SPAWN_BATCH 256
+
+uint8_t internal_particleGpuCreate(ParticleSystem* system) {
+    system->updateProgram = shaderCompileFeedback(particleUpdateVertex,
+                                                  particleVaryings, 4);
+    if (!system->updateProgram)
+        return 0;
+
+    GLsizeiptr bytes = (GLsizeiptr) system->capacity * PARTICLE_GPU_STRIDE *
+                       sizeof(float);
+    GLsizei stride = PARTICLE_GPU_STRIDE * sizeof(float);
+    glGenBuffers(2, system->buffers);
+    glGenVertexArrays(2, system->vaos);
+
+    for (uint32_t i = 0; i < 2; i++) {
+        glBindVertexArray(system->vaos[i]);
+        glBindBuffer(GL_ARRAY_BUFFER, system->buffers[i]);
+        // left undefined, only slots below count are ever read
+        glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_DYNAMIC_COPY);
+        gpuMemoryAllocated(GPU_MEMORY_BUFFER, (uint64_t) bytes);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*) 0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+                              (void*) (2 * sizeof(float)));
+        glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, stride,
+                              (void*) (4 * sizeof(float)));
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride,
+                              (void*) (5 * sizeof(float)));
+        for (uint32_t attribute = 0; attribute < 4; attribute++)
+            glEnableVertexAttribArray(attribute);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return 1;
+}
+
+void internal_particleGpuEmit(ParticleSystem* system, uint32_t count) {
+    float staging[PARTICLE_SPAWN_BATCH * PARTICLE_GPU_STRIDE];
+    glBindBuffer(GL_ARRAY_BUFFER, system->buffers[system->current]);
+
+    // spawned particles overwrite the oldest slots, only the new ones are
+    // uploaded, everything else stays on the GPU
+    while (count) {
+        uint32_t batch = count < PARTICLE_SPAWN_BATCH ? count
+                                                      : PARTICLE_SPAWN_BATCH;
+        if (batch > system->capacity - system->cursor)
+            batch = system->capacity - system->cursor;   // stop at the wrap
+
+        for (uint32_t i = 0; i < batch; i++)
+            internal_particleSpawn(system, staging + i * PARTICLE_GPU_STRIDE);
+        glBufferSubData(GL_ARRAY_BUFFER,
+                        (GLintptr) system->cursor * PARTICLE_GPU_STRIDE *
+                        sizeof(float),
+                        (GLsizeiptr) batch * PARTICLE_GPU_STRIDE *
+                        sizeof(float), staging);
+
+        system->cursor += batch;
+        if (system->cursor > system->count)
+            system->count = system->cursor;
+        if (system->cursor == system->capacity)
+            system->cursor = 0;
+        count -= batch;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void internal_particleGpuUpdate(ParticleSystem* system, float deltaTime) {
+    if (!system->count)
+        return;
+    uint32_t target = 1 - system->current;
+
+    glUseProgram(system->updateProgram);
+    glUniform1f(glGetUniformLocation(system->updateProgram, "uDelta"),
+                deltaTime);
+    glUniform2f(glGetUniformLocation(system->updateProgram, "uGravity"),
+                system->emitter.gravity.x, system->emitter.gravity.y);
+
+    // read the current buffer, write the other one, nothing is rasterized
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBindVertexArray(system->vaos[system->current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0,
+                     system->buffers[target]);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, (GLsizei) system->count);
+    glEndTransformFeedback();
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    glBindVertexArray(0);
+    glDisable(GL_RASTERIZER_DISCARD);
+
+    system->current = target;
+}
+
+void internal_particleGpuDestroy(ParticleSystem* system) {
+    shaderDestroy(system->updateProgram);
+    if (system->buffers[0]) {
+        glDeleteBuffers(2, system->buffers);
+        glDeleteVertexArrays(2, system->vaos);
+        uint64_t bytes = (uint64_t) system->capacity * PARTICLE_GPU_STRIDE *
+                         sizeof(float);
+        gpuMemoryFreed(GPU_MEMORY_BUFFER, bytes);
+        gpuMemoryFreed(GPU_MEMORY_BUFFER, bytes);
+    }
+}
@@ -0,0 +1,57 @@
+// Particle internal API, shared between the CPU and GPU backends
+
+#ifndef PARTICLE_INTERNAL_H
+#define PARTICLE_INTERNAL_H
+
+#include "particle.h"
+#include "gpu_memory.h"
+
+// Floats per particle in GPU buffers: position, velocity, age, lifetime
+#define PARTICLE_GPU_STRIDE 6
+
+// Internal Struct
+struct _ParticleSystem {
+    ParticleBackend backend;
+    ParticleEmitter emitter;
+    uint32_t capacity;
+    uint32_t count;         // live particles, or GPU slots ever written
+    float emitDebt;         // fraction of a particle owed by the rate
+    uint32_t random;        // xorshift state
+
+    // CPU backend, structure of arrays padded to a multiple of 4
+    float* positionX;
+    float* positionY;
+    float* velocityX;
+    float* velocityY;
+    float* age;
+    float* lifetime;
+
+    // GPU backend, state ping pongs between two buffers
+    uint32_t buffers[2];
+    uint32_t vaos[2];       // vertex layout of each buffer, update and draw
+    uint32_t current;       // buffer holding the latest state
+    uint32_t cursor;        // next slot to spawn into, wraps around
+    uint32_t updateProgram;
+
+    // drawing, created on the first draw
+    uint32_t drawProgram;
+    uint32_t drawVao;       // CPU backend only, the GPU uses vaos
+    uint32_t drawBuffer;    // CPU backend only
+};
+
+// Random spawn state from the emitter, writes PARTICLE_GPU_STRIDE floats
+void internal_particleSpawn(ParticleSystem* system, float* out);
+
+// Create the buffers and programs of the GPU backend, 0 on failure
+uint8_t internal_particleGpuCreate(ParticleSystem* system);
+
+// Write count new particles into the ring of slots
+void internal_particleGpuEmit(ParticleSystem* system, uint32_t count);
+
+// Integrate every slot with transform feedback
+void internal_particleGpuUpdate(ParticleSystem* system, float deltaTime);
+
+// Free the GPU backend objects
+void internal_particleGpuDestroy(ParticleSystem* system);
+
+#endif // PARTICLE_INTERNAL_H
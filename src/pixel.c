@@ -0,0 +1,141 @@
+// get function defines
+#include "pixel.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PIXEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Exact c * a / 255 rounded, without a division
+PRIVATE uint8_t internal_pixelMultiply(uint32_t c, uint32_t a) {
+    uint32_t t = c * a + 128;
+    return (uint8_t) ((t + (t >> 8)) >> 8);
+}
+
+uint32_t pixelFormatSize(PixelFormat format) {
+    switch (format) {
+        case PIXEL_FORMAT_R8:   return 1;
+        case PIXEL_FORMAT_RGB8: return 3;
+        case PIXEL_FORMAT_RGBA8:
+        default:                return 4;
+    }
+}
+
+void pixelConvert(void* dst, PixelFormat dstFormat, const void* src,
+                  PixelFormat srcFormat, uint32_t width, uint32_t height,
+                  uint32_t srcStride, uint8_t premultiply) {
+    uint32_t srcSize = pixelFormatSize(srcFormat);
+    uint32_t dstSize = pixelFormatSize(dstFormat);
+    if (!srcStride)
+        srcStride = width * srcSize;
+    premultiply = premultiply && dstFormat == PIXEL_FORMAT_RGBA8;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* in = (const uint8_t*) src + (size_t) y * srcStride;
+        uint8_t* out = (uint8_t*) dst + (size_t) y * width * dstSize;
+
+        if (srcFormat == dstFormat) {
+            memcpy(out, in, (size_t) width * dstSize);
+        } else {
+            for (uint32_t x = 0; x < width; x++, in += srcSize, out += dstSize) {
+                uint8_t r = in[0];
+                uint8_t g = srcSize >= 3 ? in[1] : r;
+                uint8_t b = srcSize >= 3 ? in[2] : r;
+                uint8_t a = srcSize == 4 ? in[3] : 255;
+                out[0] = r;
+                if (dstSize >= 3) {
+                    out[1] = g;
+                    out[2] = b;
+                }
+                if (dstSize == 4)
+                    out[3] = a;
+            }
+        }
+
+        if (premultiply)
+            pixelPremultiply((uint8_t*) dst + (size_t) y * width * 4, width);
+    }
+}
+
+void pixelPremultiply(uint8_t* pixels, size_t count) {
+    for (size_t i = 0; i < count; i++, pixels += 4) {
+        uint32_t a = pixels[3];
+        if (a == 255)
+            continue;
+        pixels[0] = internal_pixelMultiply(pixels[0], a);
+        pixels[1] = internal_pixelMultiply(pixels[1], a);
+        pixels[2] = internal_pixelMultiply(pixels[2], a);
+    }
+}
+
+uint32_t pixelMipLevelCount(uint32_t width, uint32_t height) {
+    uint32_t size = width > height ? width : height;
+    uint32_t levels = 1;
+    while (size > 1) {
+        size >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+#ifdef PIXEL_SSE2
+// Two RGBA8 output pixels from a 4x2 block, same rounding as the scalar path
+PRIVATE void internal_pixelDownsampleSse2(uint8_t* dst, const uint8_t* row0,
+                                          const uint8_t* row1) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    __m128i top = _mm_loadu_si128((const __m128i*) row0);
+    __m128i bottom = _mm_loadu_si128((const __m128i*) row1);
+
+    // widen to 16 bit and add the rows, lo holds pixels 0-1, hi pixels 2-3
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(top, zero),
+                               _mm_unpacklo_epi8(bottom, zero));
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(top, zero),
+                               _mm_unpackhi_epi8(bottom, zero));
+
+    // add neighbouring pixels, the low half of each register has the sum
+    lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+    hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+    __m128i sum = _mm_unpacklo_epi64(lo, hi);
+    sum = _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+    _mm_storel_epi64((__m128i*) dst, _mm_packus_epi16(sum, zero));
+}
+#endif
+
+void pixelDownsample(uint8_t* dst, const uint8_t* src, PixelFormat format,
+                     uint32_t width, uint32_t height) {
+    uint32_t size = pixelFormatSize(format);
+    uint32_t dstWidth = width > 1 ? width / 2 : 1;
+    uint32_t dstHeight = height > 1 ? height / 2 : 1;
+    size_t stride = (size_t) width * size;
+
+    for (uint32_t y = 0; y < dstHeight; y++) {
+        const uint8_t* row0 = src + (size_t) (y * 2) * stride;
+        // odd or single row images reuse the last row
+        const uint8_t* row1 = (y * 2 + 1 < height) ? row0 + stride : row0;
+        uint8_t* out = dst + (size_t) y * dstWidth * size;
+        uint32_t x = 0;
+
+#ifdef PIXEL_SSE2
+        // each step reads 4 source pixels, stay inside the row
+        if (size == 4 && width > 1)
+            for (; x + 2 <= dstWidth && x * 2 + 4 <= width; x += 2)
+                internal_pixelDownsampleSse2(out + x * 4, row0 + x * 8,
+                                             row1 + x * 8);
+#endif
+
+        for (; x < dstWidth; x++) {
+            uint32_t x0 = x * 2;
+            uint32_t x1 = (x0 + 1 < width) ? x0 + 1 : x0;
+            for (uint32_t c = 0; c < size; c++) {
+                uint32_t sum = row0[x0 * size + c] + row0[x1 * size + c] +
+                               row1[x0 * size + c] + row1[x1 * size + c];
+                out[x * size + c] = (uint8_t) ((sum + 2) >> 2);
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+// Pixel conversion public API
+
+#ifndef PIXEL_H
+#define PIXEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "defines.h"
+
+/**
+ * @brief   Layout of 8 bit per channel pixel data
+ */
+typedef enum PixelFormat {
+    PIXEL_FORMAT_R8,        /**< One channel, grayscale or coverage */
+    PIXEL_FORMAT_RGB8,      /**< Three channels, no alpha */
+    PIXEL_FORMAT_RGBA8      /**< Four channels, straight alpha */
+} PixelFormat;
+
+/**
+ * @param   format: PixelFormat
+ * @returns Number of bytes in one pixel of the format
+ */
+TGAPI uint32_t pixelFormatSize(PixelFormat format);
+
+/**
+ * @brief   Convert pixels between formats, optionally premultiplying alpha
+ * @param   dst: destination, tightly packed rows of width pixels
+ * @param   dstFormat: PixelFormat of dst
+ * @param   src: source pixels
+ * @param   srcFormat: PixelFormat of src
+ * @param   width: uint32_t, pixels per row
+ * @param   height: uint32_t, number of rows
+ * @param   srcStride: uint32_t, bytes between source rows, 0 if tightly packed
+ * @param   premultiply: 1 to multiply color by alpha, needs an RGBA8 dst
+ * @returns void
+ * @note    R8 expands to gray with opaque alpha, narrowing keeps the first
+ *          channels. dst and src must not overlap
+ */
+TGAPI void pixelConvert(void* dst, PixelFormat dstFormat, const void* src,
+                        PixelFormat srcFormat, uint32_t width,
+                        uint32_t height, uint32_t srcStride,
+                        uint8_t premultiply);
+
+/**
+ * @brief   Multiply the color channels of RGBA8 pixels by their alpha
+ * @param   pixels: RGBA8 pixels, modified in place
+ * @param   count: size_t, number of pixels
+ * @returns void
+ */
+TGAPI void pixelPremultiply(uint8_t* pixels, size_t count);
+
+/**
+ * @param   width: uint32_t, width of the base level
+ * @param   height: uint32_t, height of the base level
+ * @returns Number of mipmap levels down to 1x1, base level included
+ */
+TGAPI uint32_t pixelMipLevelCount(uint32_t width, uint32_t height);
+
+/**
+ * @brief   Halve an image with a 2x2 box filter, to build the next mip level
+ * @param   dst: receives max(width / 2, 1) x max(height / 2, 1) pixels
+ * @param   src: tightly packed source pixels
+ * @param   format: PixelFormat of both images
+ * @param   width: uint32_t, width of src
+ * @param   height: uint32_t, height of src
+ * @returns void
+ * @note    Uses SSE2 for RGBA8 where available. Odd edges reuse the last
+ *          row or column
+ */
+TGAPI void pixelDownsample(uint8_t* dst, const uint8_t* src,
+                           PixelFormat format, uint32_t width,
+                           uint32_t height);
+
+#endif // PIXEL_H
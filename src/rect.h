@@ -0,0 +1,107 @@
+// Rect public API
+
+#ifndef RECT_H
+#define RECT_H
+
+#include "vector.h"
+#include "defines.h"
+
+/**
+ * @brief   Axis aligned box, described by its minimum and maximum corners
+ */
+typedef struct Rect {
+    Vec2 min;   /**< Corner with the smallest components */
+    Vec2 max;   /**< Corner with the largest components */
+} Rect;
+
+/**
+ * @brief   Build a rect from a position and a size
+ * @param   position: Vec2, minimum corner
+ * @param   size: Vec2, width and height as components
+ * @returns Rect spanning position to position + size
+ */
+HELPER Rect rectFromSize(Vec2 position, Vec2 size) {
+    return (Rect) {
+        position,
+        { position.x + size.x, position.y + size.y }
+    };
+}
+
+/**
+ * @param   r: Rect
+ * @returns Width and height of the rect as components of a Vec2
+ */
+HELPER Vec2 rectGetSize(Rect r) {
+    return (Vec2) { r.max.x - r.min.x, r.max.y - r.min.y };
+}
+
+/**
+ * @param   r: Rect
+ * @returns Area of the rect, 0 if the rect is empty
+ */
+HELPER float rectArea(Rect r) {
+    float w = r.max.x - r.min.x;
+    float h = r.max.y - r.min.y;
+    return (w > 0.0f && h > 0.0f) ? w * h : 0.0f;
+}
+
+/**
+ * @param   r: Rect
+ * @returns 1 if the rect has no area
+ */
+HELPER int rectIsEmpty(Rect r) {
+    return !(r.max.x > r.min.x && r.max.y > r.min.y);
+}
+
+/**
+ * @brief   Check if two rects overlap
+ * @param   a: Rect
+ * @param   b: Rect
+ * @returns 1 if the rects overlap, touching edges count as overlap
+ */
+HELPER int rectOverlaps(Rect a, Rect b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+
+/**
+ * @brief   Check if a point lies inside a rect
+ * @param   r: Rect
+ * @param   point: Vec2
+ * @returns 1 if the point is inside or on the border of the rect
+ */
+HELPER int rectContainsPoint(Rect r, Vec2 point) {
+    return point.x >= r.min.x && point.x <= r.max.x &&
+           point.y >= r.min.y && point.y <= r.max.y;
+}
+
+/**
+ * @param   a: Rect
+ * @param   b: Rect
+ * @returns Smallest rect enclosing both a and b
+ */
+HELPER Rect rectUnion(Rect a, Rect b) {
+    return (Rect) {
+        { a.min.x < b.min.x ? a.min.x : b.min.x,
+          a.min.y < b.min.y ? a.min.y : b.min.y },
+        { a.max.x > b.max.x ? a.max.x : b.max.x,
+          a.max.y > b.max.y ? a.max.y : b.max.y }
+    };
+}
+
+/**
+ * @param   a: Rect
+ * @param   b: Rect
+ * @returns Overlapping region of a and b
+ * @note    The result is empty (see rectIsEmpty) if a and b do not overlap
+ */
+HELPER Rect rectIntersect(Rect a, Rect b) {
+    return (Rect) {
+        { a.min.x > b.min.x ? a.min.x : b.min.x,
+          a.min.y > b.min.y ? a.min.y : b.min.y },
+        { a.max.x < b.max.x ? a.max.x : b.max.x,
+          a.max.y < b.max.y ? a.max.y : b.max.y }
+    };
+}
+
+#endif // RECT_H
@@ -0,0 +1,426 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "render_graph.h"
+#include "array_internal.h"
+#include "trace.h"
+#include "gpu_memory.h"
+
+#include <string.h>
+
+// Frames an unused pooled target survives, absorbs passes toggling on and off
+#define RENDER_GRAPH_POOL_FRAMES 3
+
+// Output of a pass that didn't declare one
+#define RENDER_GRAPH_NO_OUTPUT UINT32_MAX
+
+// Internal Struct
+typedef struct RenderGraphEvictInternal {
+    RenderGraph* graph;     // stable, unlike pointers into the resource array
+    uint32_t resource;
+} RenderGraphEvictInternal;
+
+// Internal Struct
+typedef struct RenderGraphResourceInternal {
+    float scale;            // of the view size
+    PixelFormat format;
+    uint8_t persistent;     // layer, otherwise transient
+    uint8_t valid;          // layers only, contents are up to date
+    uint8_t dirty;          // compile, has to be redrawn this frame
+    uint8_t consumed;       // compile, read by a pass that runs
+    uint8_t written;        // execute, drawn into this frame
+    uint32_t width, height; // size for the current view
+    uint32_t lastUse;       // compile, last running pass touching it
+    RenderTarget* target;   // layers own theirs, transients borrow the pool's
+    RenderGraphEvictInternal* evict;    // layers only, NULL if untracked
+    uint32_t evictHandle;   // layers only, see gpu_memory.h
+} RenderGraphResourceInternal;
+
+// Internal Struct
+typedef struct RenderGraphPassInternal {
+    const char* name;
+    RenderGraphPassFunc draw;
+    void* userData;
+    uint32_t reads[RENDER_GRAPH_MAX_READS];
+    uint32_t readCount;
+    uint32_t output;
+    uint8_t run;            // scheduled by the last compile
+} RenderGraphPassInternal;
+
+// Internal Struct
+typedef struct RenderGraphPoolEntryInternal {
+    RenderTarget* target;
+    PixelFormat format;
+    uint8_t inUse;
+    uint64_t lastFrame;     // frame the target was last handed out
+} RenderGraphPoolEntryInternal;
+
+// Internal Struct
+struct _RenderGraph {
+    RenderGraphResourceInternal* resources;    // id - 1
+    uint32_t resourceCount, resourceCapacity;
+    RenderGraphPassInternal* passes;
+    uint32_t passCount, passCapacity;
+    RenderGraphPoolEntryInternal* pool;
+    uint32_t poolCount, poolCapacity;
+    Vec2 viewSize;
+    uint64_t frame;
+    RenderGraphStats stats;
+};
+
+PRIVATE RenderGraphResourceInternal* internal_renderGraphResource(
+        RenderGraph* graph, uint32_t resource) {
+    if (resource == RENDER_GRAPH_BACKBUFFER ||
+        resource > graph->resourceCount)
+        return NULL;
+    return &graph->resources[resource - 1];
+}
+
+PRIVATE uint32_t internal_renderGraphAddResource(RenderGraph* graph,
+                                                 float scale,
+                                                 PixelFormat format,
+                                                 uint8_t persistent) {
+    if (!internal_arrayReserve((void**) &graph->resources,
+                               &graph->resourceCapacity,
+                               sizeof(RenderGraphResourceInternal),
+                               graph->resourceCount + 1))
+        return RENDER_GRAPH_BACKBUFFER;
+    RenderGraphResourceInternal* resource =
+        &graph->resources[graph->resourceCount++];
+    memset(resource, 0, sizeof(RenderGraphResourceInternal));
+    resource->scale = scale;
+    resource->format = format;
+    resource->persistent = persistent;
+    return graph->resourceCount;
+}
+
+// Over the GPU memory budget, drop a cached layer, it is redrawn when needed
+PRIVATE void internal_renderGraphEvict(void* userData) {
+    RenderGraphEvictInternal* evict = userData;
+    RenderGraphResourceInternal* resource =
+        internal_renderGraphResource(evict->graph, evict->resource);
+    renderTargetDestroy(resource->target);
+    resource->target = NULL;
+    resource->valid = 0;
+}
+
+// Layer targets are tracked for eviction from their first creation
+PRIVATE void internal_renderGraphTouchLayer(RenderGraph* graph,
+                                            uint32_t id) {
+    RenderGraphResourceInternal* resource =
+        internal_renderGraphResource(graph, id);
+    if (!resource || !resource->persistent || !resource->target)
+        return;
+    if (!resource->evict) {
+        resource->evict = ALLOC_S(RenderGraphEvictInternal);
+        if (!resource->evict)
+            return;     // still works, just never evicted
+        *resource->evict = (RenderGraphEvictInternal) { graph, id };
+        resource->evictHandle = gpuMemoryAddEvictable(
+            internal_renderGraphEvict, resource->evict);
+    }
+    gpuMemoryTouch(resource->evictHandle);
+}
+
+// Hand out a free pooled target of the right size, or make one
+PRIVATE RenderTarget* internal_renderGraphAcquire(RenderGraph* graph,
+        RenderGraphResourceInternal* resource) {
+    for (uint32_t i = 0; i < graph->poolCount; i++) {
+        RenderGraphPoolEntryInternal* entry = &graph->pool[i];
+        if (!entry->inUse && entry->format == resource->format &&
+            renderTargetGetWidth(entry->target) == resource->width &&
+            renderTargetGetHeight(entry->target) == resource->height) {
+            entry->inUse = 1;
+            entry->lastFrame = graph->frame;
+            return entry->target;
+        }
+    }
+
+    if (!internal_arrayReserve((void**) &graph->pool, &graph->poolCapacity,
+                               sizeof(RenderGraphPoolEntryInternal),
+                               graph->poolCount + 1))
+        return NULL;
+    RenderTarget* target = renderTargetNew(resource->width, resource->height,
+                                           resource->format);
+    if (!target)
+        return NULL;
+    graph->pool[graph->poolCount++] = (RenderGraphPoolEntryInternal) {
+        target, resource->format, 1, graph->frame
+    };
+    return target;
+}
+
+PRIVATE void internal_renderGraphRelease(RenderGraph* graph,
+                                         RenderTarget* target) {
+    for (uint32_t i = 0; i < graph->poolCount; i++) {
+        if (graph->pool[i].target == target) {
+            graph->pool[i].inUse = 0;
+            return;
+        }
+    }
+}
+
+// Free pooled targets nobody asked for in a while, such as old sizes
+PRIVATE void internal_renderGraphTrimPool(RenderGraph* graph) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < graph->poolCount; i++) {
+        RenderGraphPoolEntryInternal entry = graph->pool[i];
+        if (!entry.inUse &&
+            graph->frame - entry.lastFrame > RENDER_GRAPH_POOL_FRAMES)
+            renderTargetDestroy(entry.target);
+        else
+            graph->pool[kept++] = entry;
+    }
+    graph->poolCount = kept;
+}
+
+// Bind the output of a pass, clearing it on the first write of the frame
+PRIVATE uint8_t internal_renderGraphBindOutput(RenderGraph* graph,
+                                               uint32_t output) {
+    static const float transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    if (output == RENDER_GRAPH_BACKBUFFER) {
+        renderTargetBindDefault(graph->viewSize);
+        return 1;
+    }
+
+    RenderGraphResourceInternal* resource =
+        internal_renderGraphResource(graph, output);
+    if (resource->written) {
+        renderTargetBind(resource->target);
+        return 1;
+    }
+
+    if (resource->persistent) {
+        // layers keep their target until the view is resized
+        if (resource->target &&
+            (renderTargetGetWidth(resource->target) != resource->width ||
+             renderTargetGetHeight(resource->target) != resource->height)) {
+            renderTargetDestroy(resource->target);
+            resource->target = NULL;
+        }
+        if (!resource->target)
+            resource->target = renderTargetNew(resource->width,
+                                               resource->height,
+                                               resource->format);
+    } else {
+        resource->target = internal_renderGraphAcquire(graph, resource);
+    }
+    if (!resource->target) {
+        resource->valid = 0;    // try again next frame
+        return 0;
+    }
+    renderTargetClear(resource->target, transparent);
+    resource->written = 1;
+    return 1;
+}
+
+RenderGraph* renderGraphNew(void) {
+    RenderGraph* graph = ALLOC_S(RenderGraph);
+    if (!graph)
+        return NULL;
+    memset(graph, 0, sizeof(RenderGraph));
+    return graph;
+}
+
+uint32_t renderGraphAddTransient(RenderGraph* graph, float scale,
+                                 PixelFormat format) {
+    return internal_renderGraphAddResource(graph, scale, format, 0);
+}
+
+uint32_t renderGraphAddLayer(RenderGraph* graph, float scale,
+                             PixelFormat format) {
+    return internal_renderGraphAddResource(graph, scale, format, 1);
+}
+
+uint32_t renderGraphAddPass(RenderGraph* graph, const char* name,
+                            RenderGraphPassFunc draw, void* userData) {
+    if (!internal_arrayReserve((void**) &graph->passes, &graph->passCapacity,
+                               sizeof(RenderGraphPassInternal),
+                               graph->passCount + 1))
+        return UINT32_MAX;
+    RenderGraphPassInternal* pass = &graph->passes[graph->passCount];
+    memset(pass, 0, sizeof(RenderGraphPassInternal));
+    pass->name = name;
+    pass->draw = draw;
+    pass->userData = userData;
+    pass->output = RENDER_GRAPH_NO_OUTPUT;
+    return graph->passCount++;
+}
+
+uint8_t renderGraphPassRead(RenderGraph* graph, uint32_t pass,
+                            uint32_t resource) {
+    RenderGraphPassInternal* entry = &graph->passes[pass];
+    // the window can't be sampled, the read would only keep passes alive
+    if (!internal_renderGraphResource(graph, resource) ||
+        entry->readCount == RENDER_GRAPH_MAX_READS)
+        return 0;
+    entry->reads[entry->readCount++] = resource;
+    return 1;
+}
+
+void renderGraphPassWrite(RenderGraph* graph, uint32_t pass,
+                          uint32_t resource) {
+    graph->passes[pass].output = resource;
+}
+
+void renderGraphInvalidate(RenderGraph* graph, uint32_t resource) {
+    RenderGraphResourceInternal* entry =
+        internal_renderGraphResource(graph, resource);
+    if (entry)
+        entry->valid = 0;
+}
+
+uint32_t renderGraphCompile(RenderGraph* graph, Vec2 viewSize) {
+    TRACE_FUNCTION();
+    graph->viewSize = viewSize;
+    graph->frame++;
+
+    for (uint32_t i = 0; i < graph->resourceCount; i++) {
+        RenderGraphResourceInternal* resource = &graph->resources[i];
+        float width = viewSize.x * resource->scale + 0.5f;
+        float height = viewSize.y * resource->scale + 0.5f;
+        uint32_t w = width >= 1.0f ? (uint32_t) width : 1;
+        uint32_t h = height >= 1.0f ? (uint32_t) height : 1;
+        if (w != resource->width || h != resource->height)
+            resource->valid = 0;    // resized, the cached pixels are stale
+        resource->width = w;
+        resource->height = h;
+        resource->dirty = resource->persistent && !resource->valid;
+        resource->consumed = 0;
+        resource->written = 0;
+    }
+
+    // forward, anything drawn from a stale layer is stale as well
+    for (uint32_t p = 0; p < graph->passCount; p++) {
+        RenderGraphPassInternal* pass = &graph->passes[p];
+        RenderGraphResourceInternal* output =
+            internal_renderGraphResource(graph, pass->output);
+        if (!output)
+            continue;
+        for (uint32_t r = 0; r < pass->readCount; r++)
+            output->dirty |= graph->resources[pass->reads[r] - 1].dirty;
+    }
+
+    // backward from the window, a pass runs if a running pass needs its
+    // output and that output isn't a cached layer that is still valid
+    uint32_t run = 0;
+    for (uint32_t p = graph->passCount; p-- > 0;) {
+        RenderGraphPassInternal* pass = &graph->passes[p];
+        RenderGraphResourceInternal* output =
+            internal_renderGraphResource(graph, pass->output);
+        if (pass->output == RENDER_GRAPH_BACKBUFFER)
+            pass->run = 1;
+        else if (output)
+            pass->run = output->consumed &&
+                        (!output->persistent || output->dirty);
+        else
+            pass->run = 0;
+        if (!pass->run)
+            continue;
+
+        run++;
+        for (uint32_t r = 0; r < pass->readCount; r++)
+            graph->resources[pass->reads[r] - 1].consumed = 1;
+    }
+
+    // transient lifetimes, and layers drawn this frame are now up to date
+    for (uint32_t p = 0; p < graph->passCount; p++) {
+        RenderGraphPassInternal* pass = &graph->passes[p];
+        if (!pass->run)
+            continue;
+        RenderGraphResourceInternal* output =
+            internal_renderGraphResource(graph, pass->output);
+        if (output) {
+            output->lastUse = p;
+            if (output->persistent)
+                output->valid = 1;
+        }
+        for (uint32_t r = 0; r < pass->readCount; r++)
+            graph->resources[pass->reads[r] - 1].lastUse = p;
+    }
+
+    graph->stats.passesRun = run;
+    graph->stats.passesCulled = graph->passCount - run;
+    return run;
+}
+
+uint8_t renderGraphPassWillRun(RenderGraph* graph, uint32_t pass) {
+    return pass < graph->passCount && graph->passes[pass].run;
+}
+
+void renderGraphExecute(RenderGraph* graph) {
+    TRACE_FUNCTION();
+    for (uint32_t p = 0; p < graph->passCount; p++) {
+        RenderGraphPassInternal* pass = &graph->passes[p];
+        if (!pass->run)
+            continue;
+        if (internal_renderGraphBindOutput(graph, pass->output) &&
+            pass->draw) {
+            TRACE_SCOPE(pass->name ? pass->name : "renderGraphPass");
+            pass->draw(graph, p, pass->userData);
+        }
+        internal_renderGraphTouchLayer(graph, pass->output);
+        for (uint32_t r = 0; r < pass->readCount; r++)
+            internal_renderGraphTouchLayer(graph, pass->reads[r]);
+
+        // hand transients back as soon as their last user is done
+        RenderGraphResourceInternal* output =
+            internal_renderGraphResource(graph, pass->output);
+        if (output && !output->persistent && output->lastUse == p &&
+            output->target) {
+            internal_renderGraphRelease(graph, output->target);
+            output->target = NULL;
+        }
+        for (uint32_t r = 0; r < pass->readCount; r++) {
+            RenderGraphResourceInternal* input =
+                &graph->resources[pass->reads[r] - 1];
+            if (!input->persistent && input->lastUse == p && input->target) {
+                internal_renderGraphRelease(graph, input->target);
+                input->target = NULL;
+            }
+        }
+    }
+
+    renderTargetBindDefault(graph->viewSize);
+    internal_renderGraphTrimPool(graph);
+    graph->stats.pooledTargets = graph->poolCount;
+}
+
+Texture* renderGraphGetTexture(RenderGraph* graph, uint32_t resource) {
+    RenderTarget* target = renderGraphGetTarget(graph, resource);
+    return target ? renderTargetGetTexture(target) : NULL;
+}
+
+RenderTarget* renderGraphGetTarget(RenderGraph* graph, uint32_t resource) {
+    RenderGraphResourceInternal* entry =
+        internal_renderGraphResource(graph, resource);
+    return entry ? entry->target : NULL;
+}
+
+const char* renderGraphGetPassName(RenderGraph* graph, uint32_t pass) {
+    return graph->passes[pass].name;
+}
+
+RenderGraphStats renderGraphGetStats(RenderGraph* graph) {
+    return graph->stats;
+}
+
+void renderGraphDestroy(RenderGraph* graph) {
+    if (!graph)
+        return;
+    for (uint32_t i = 0; i < graph->resourceCount; i++) {
+        RenderGraphResourceInternal* resource = &graph->resources[i];
+        if (!resource->persistent)
+            continue;
+        if (resource->evict)
+            gpuMemoryRemoveEvictable(resource->evictHandle);
+        TG_FREE(resource->evict);
+        renderTargetDestroy(resource->target);
+    }
+    for (uint32_t i = 0; i < graph->poolCount; i++)
+        renderTargetDestroy(graph->pool[i].target);
+    TG_FREE(graph->resources);
+    TG_FREE(graph->passes);
+    TG_FREE(graph->pool);
+    TG_FREE(graph);
+}
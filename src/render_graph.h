@@ -0,0 +1,184 @@
+// Render graph public API
+
+#ifndef RENDER_GRAPH_H
+#define RENDER_GRAPH_H
+
+#include <stdint.h>
+
+#include "render_target.h"
+#include "defines.h"
+
+/**
+ * @def RENDER_GRAPH_BACKBUFFER
+ * @brief Resource standing for the window, passes writing it always run
+ */
+#define RENDER_GRAPH_BACKBUFFER 0
+
+/**
+ * @def RENDER_GRAPH_MAX_READS
+ * @brief Most resources a single pass can read
+ */
+#define RENDER_GRAPH_MAX_READS 8
+
+/**
+ * @brief   Opaque type to RenderGraph struct
+ * @note    Passes run in the order they were added, so add producers before
+ *          the passes reading their output
+ */
+typedef struct _RenderGraph RenderGraph;
+
+/**
+ * @brief   Draws one pass, its output is bound with the viewport set
+ * @see     renderGraphGetTexture
+ */
+typedef void (*RenderGraphPassFunc)(RenderGraph* graph, uint32_t pass,
+                                    void* userData);
+
+/**
+ * @brief   Work done by the last renderGraphCompile and renderGraphExecute
+ */
+typedef struct RenderGraphStats {
+    uint32_t passesRun;     /**< Passes scheduled to draw */
+    uint32_t passesCulled;  /**< Passes skipped, unused or cached */
+    uint32_t pooledTargets; /**< Transient targets alive in the pool */
+} RenderGraphStats;
+
+/**
+ * @brief   Create a new empty render graph
+ * @returns Pointer to a new RenderGraph, NULL on failure
+ * @note    The graph is built once and compiled every frame
+ * @see     RenderGraph, renderGraphCompile
+ */
+TGAPI RenderGraph* renderGraphNew(void);
+
+/**
+ * @brief   Add a target that only lives within a frame
+ * @param   graph: Pointer to the graph
+ * @param   scale: float, size relative to the view, 1 is full size
+ * @param   format: PixelFormat of the target
+ * @returns Resource id, RENDER_GRAPH_BACKBUFFER on failure
+ * @note    Transient targets come from a pool and are shared by passes that
+ *          don't overlap, their contents never survive the frame
+ */
+TGAPI uint32_t renderGraphAddTransient(RenderGraph* graph, float scale,
+                                       PixelFormat format);
+
+/**
+ * @brief   Add a cached layer, redrawn only when invalidated
+ * @param   graph: Pointer to the graph
+ * @param   scale: float, size relative to the view, 1 is full size
+ * @param   format: PixelFormat of the target
+ * @returns Resource id, RENDER_GRAPH_BACKBUFFER on failure
+ * @note    A layer is also redrawn after a resize and when a layer it reads
+ *          was redrawn
+ * @see     renderGraphInvalidate
+ */
+TGAPI uint32_t renderGraphAddLayer(RenderGraph* graph, float scale,
+                                   PixelFormat format);
+
+/**
+ * @brief   Add a pass
+ * @param   graph: Pointer to the graph
+ * @param   name: label for debugging, not copied
+ * @param   draw: RenderGraphPassFunc doing the drawing
+ * @param   userData: passed to draw
+ * @returns Pass id
+ * @note    A pass without an output is always culled
+ * @see     renderGraphPassRead, renderGraphPassWrite
+ */
+TGAPI uint32_t renderGraphAddPass(RenderGraph* graph, const char* name,
+                                  RenderGraphPassFunc draw, void* userData);
+
+/**
+ * @brief   Declare a resource the pass samples from
+ * @param   graph: Pointer to the graph
+ * @param   pass: uint32_t, pass id
+ * @param   resource: uint32_t, resource id
+ * @returns 1 on success, 0 past RENDER_GRAPH_MAX_READS
+ */
+TGAPI uint8_t renderGraphPassRead(RenderGraph* graph, uint32_t pass,
+                                  uint32_t resource);
+
+/**
+ * @brief   Declare the resource the pass draws into, replaces the previous one
+ * @param   graph: Pointer to the graph
+ * @param   pass: uint32_t, pass id
+ * @param   resource: uint32_t, resource id, or RENDER_GRAPH_BACKBUFFER
+ * @returns void
+ * @note    The first pass writing a target in a frame gets it cleared to
+ *          transparent, the backbuffer is never cleared
+ */
+TGAPI void renderGraphPassWrite(RenderGraph* graph, uint32_t pass,
+                                uint32_t resource);
+
+/**
+ * @brief   Mark a layer as out of date
+ * @param   graph: Pointer to the graph
+ * @param   resource: uint32_t, layer id
+ * @returns void
+ */
+TGAPI void renderGraphInvalidate(RenderGraph* graph, uint32_t resource);
+
+/**
+ * @brief   Decide which passes run this frame, without touching OpenGL
+ * @param   graph: Pointer to the graph
+ * @param   viewSize: Vec2, size of the window in pixels, see windowGetSize
+ * @returns Number of passes that will run
+ * @note    Layers scheduled here count as up to date from now on, always
+ *          follow with renderGraphExecute
+ */
+TGAPI uint32_t renderGraphCompile(RenderGraph* graph, Vec2 viewSize);
+
+/**
+ * @param   graph: Pointer to the graph
+ * @param   pass: uint32_t, pass id
+ * @returns 1 if the last compile scheduled the pass
+ */
+TGAPI uint8_t renderGraphPassWillRun(RenderGraph* graph, uint32_t pass);
+
+/**
+ * @brief   Run the compiled passes, ends with the backbuffer bound
+ * @param   graph: Pointer to the graph
+ * @returns void
+ * @note    Needs a current OpenGL context
+ */
+TGAPI void renderGraphExecute(RenderGraph* graph);
+
+/**
+ * @brief   Get the texture of a resource, for use inside a pass
+ * @param   graph: Pointer to the graph
+ * @param   resource: uint32_t, resource id
+ * @returns Pointer to the texture, NULL if the resource has no target yet
+ */
+TGAPI Texture* renderGraphGetTexture(RenderGraph* graph, uint32_t resource);
+
+/**
+ * @param   graph: Pointer to the graph
+ * @param   resource: uint32_t, resource id
+ * @returns Pointer to the target, NULL if the resource has no target yet
+ */
+TGAPI RenderTarget* renderGraphGetTarget(RenderGraph* graph,
+                                         uint32_t resource);
+
+/**
+ * @param   graph: Pointer to the graph
+ * @param   pass: uint32_t, pass id
+ * @returns Name given to renderGraphAddPass
+ */
+TGAPI const char* renderGraphGetPassName(RenderGraph* graph, uint32_t pass);
+
+/**
+ * @param   graph: Pointer to the graph
+ * @returns Counters of the last frame
+ * @see     RenderGraphStats
+ */
+TGAPI RenderGraphStats renderGraphGetStats(RenderGraph* graph);
+
+/**
+ * @brief   Free the graph, its layers and the transient pool
+ * @param   graph: Pointer to the graph
+ * @returns void
+ */
+TGAPI void renderGraphDestroy(RenderGraph* graph);
+
+#endif // RENDER_GRAPH_H
@@ -0,0 +1,163 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "render_target.h"
+#include "shader.h"
+
+#include "../vendor/glad/gl.h"
+
+// Internal Struct
+struct _RenderTarget {
+    uint32_t framebuffer;
+    Texture* texture;
+    uint32_t width, height;
+    uint32_t compositeProgram;  // created on the first composite
+    uint32_t compositeVao;      // empty, core profile needs one bound
+};
+
+// The quad is built from gl_VertexID, no vertex buffer needed
+static const char* const renderTargetVertex =
+    "#version 330 core\n"
+    "uniform vec4 uRect;\n"
+    "uniform vec2 uViewSize;\n"
+    "out vec2 vUv;\n"
+    "void main() {\n"
+    "    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+    "    vec2 pixel = mix(uRect.xy, uRect.zw, corner);\n"
+    "    vec2 ndc = pixel / uViewSize * 2.0 - 1.0;\n"
+    "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);\n"
+    "    vUv = vec2(corner.x, 1.0 - corner.y);\n"
+    "}\n";
+
+static const char* const renderTargetFragment =
+    "#version 330 core\n"
+    "uniform sampler2D uTexture;\n"
+    "in vec2 vUv;\n"
+    "out vec4 fragColor;\n"
+    "void main() {\n"
+    "    fragColor = texture(uTexture, vUv);\n"
+    "}\n";
+
+RenderTarget* renderTargetNew(uint32_t width, uint32_t height,
+                              PixelFormat format) {
+    RenderTarget* target = ALLOC_S(RenderTarget);
+    if (!target)
+        return NULL;
+    target->texture = textureNew(width, height, format,
+                                 TEXTURE_RENDER_TARGET);
+    if (!target->texture) {
+        TG_FREE(target);
+        return NULL;
+    }
+    target->width = width;
+    target->height = height;
+    target->compositeProgram = 0;
+    target->compositeVao = 0;
+
+    glGenFramebuffers(1, &target->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                           textureGetHandle(target->texture), 0);
+    uint32_t status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        glDeleteFramebuffers(1, &target->framebuffer);
+        textureDestroy(target->texture);
+        TG_FREE(target);
+        return NULL;
+    }
+
+    return target;
+}
+
+void renderTargetBind(RenderTarget* target) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glViewport(0, 0, (GLsizei) target->width, (GLsizei) target->height);
+}
+
+void renderTargetBindDefault(Vec2 viewSize) {
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, (GLsizei) viewSize.x, (GLsizei) viewSize.y);
+}
+
+void renderTargetClear(RenderTarget* target, const float color[4]) {
+    renderTargetBind(target);
+    glClearColor(color[0], color[1], color[2], color[3]);
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+
+void renderTargetComposite(RenderTarget* target, Rect destination,
+                           Vec2 viewSize) {
+    // kept per target, vertex arrays aren't shared between contexts and
+    // programs only within a share group, a target has one context anyway
+    if (!target->compositeProgram) {
+        target->compositeProgram = shaderCompile(renderTargetVertex,
+                                                 renderTargetFragment);
+        if (!target->compositeProgram)
+            return;
+        glGenVertexArrays(1, &target->compositeVao);
+    }
+
+    uint32_t program = target->compositeProgram;
+    glUseProgram(program);
+    glUniform4f(glGetUniformLocation(program, "uRect"),
+                destination.min.x, destination.min.y, destination.max.x,
+                destination.max.y);
+    glUniform2f(glGetUniformLocation(program, "uViewSize"),
+                viewSize.x, viewSize.y);
+    glUniform1i(glGetUniformLocation(program, "uTexture"), 0);
+    textureBind(target->texture, 0);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(target->compositeVao);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+}
+
+void renderTargetReadPixels(RenderTarget* target, void* pixels) {
+    PixelFormat format = textureGetFormat(target->texture);
+    uint32_t layout = format == PIXEL_FORMAT_R8 ? GL_RED
+                      : format == PIXEL_FORMAT_RGB8 ? GL_RGB : GL_RGBA;
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, (GLsizei) target->width, (GLsizei) target->height,
+                 layout, GL_UNSIGNED_BYTE, pixels);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // OpenGL rows start at the bottom, flip in place
+    size_t rowBytes = (size_t) target->width * pixelFormatSize(format);
+    uint8_t* top = pixels;
+    uint8_t* bottom = top + rowBytes * (target->height - 1);
+    for (; top < bottom; top += rowBytes, bottom -= rowBytes) {
+        for (size_t i = 0; i < rowBytes; i++) {
+            uint8_t swap = top[i];
+            top[i] = bottom[i];
+            bottom[i] = swap;
+        }
+    }
+}
+
+Texture* renderTargetGetTexture(RenderTarget* target) {
+    return target->texture;
+}
+
+uint32_t renderTargetGetWidth(RenderTarget* target) {
+    return target->width;
+}
+
+uint32_t renderTargetGetHeight(RenderTarget* target) {
+    return target->height;
+}
+
+void renderTargetDestroy(RenderTarget* target) {
+    if (!target)
+        return;
+    glDeleteFramebuffers(1, &target->framebuffer);
+    if (target->compositeProgram) {
+        shaderDestroy(target->compositeProgram);
+        glDeleteVertexArrays(1, &target->compositeVao);
+    }
+    textureDestroy(target->texture);
+    TG_FREE(target);
+}
@@ -0,0 +1,104 @@
+// Render target public API
+
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "texture.h"
+#include "defines.h"
+
+/**
+ * @brief   Opaque type to RenderTarget struct, a framebuffer object drawing
+ *          into a color texture
+ * @note    Framebuffers are not shared between OpenGL contexts, use a target
+ *          only with the window that was current when it was created
+ */
+typedef struct _RenderTarget RenderTarget;
+
+/**
+ * @brief   Create a new offscreen render target
+ * @param   width: uint32_t, width in pixels
+ * @param   height: uint32_t, height in pixels
+ * @param   format: PixelFormat of the color texture
+ * @returns Pointer to a new RenderTarget, NULL on failure
+ * @note    Needs a current OpenGL context, the contents start undefined
+ * @see     RenderTarget, renderTargetBind
+ */
+TGAPI RenderTarget* renderTargetNew(uint32_t width, uint32_t height,
+                                    PixelFormat format);
+
+/**
+ * @brief   Draw into the target from now on, sets the viewport to its size
+ * @param   target: Pointer to the target
+ * @returns void
+ */
+TGAPI void renderTargetBind(RenderTarget* target);
+
+/**
+ * @brief   Draw into the window again
+ * @param   viewSize: Vec2, size of the window in pixels, see windowGetSize
+ * @returns void
+ */
+TGAPI void renderTargetBindDefault(Vec2 viewSize);
+
+/**
+ * @brief   Clear the whole target
+ * @param   target: Pointer to the target
+ * @param   color: RGBA clear color
+ * @returns void
+ * @note    Leaves the target bound
+ */
+TGAPI void renderTargetClear(RenderTarget* target, const float color[4]);
+
+/**
+ * @brief   Draw the target as a textured quad into the bound framebuffer
+ * @param   target: Pointer to the target
+ * @param   destination: Rect, in pixels from the top left
+ * @param   viewSize: Vec2, size of the bound framebuffer in pixels
+ * @returns void
+ * @note    Blends with premultiplied alpha, which is what drawing into a
+ *          target cleared to transparent produces. Composite with the
+ *          window the target was created in current, its vertex array is
+ *          not shared either
+ */
+TGAPI void renderTargetComposite(RenderTarget* target, Rect destination,
+                                 Vec2 viewSize);
+
+/**
+ * @brief   Copy the target back to the CPU, waiting for rendering to finish
+ * @param   target: Pointer to the target
+ * @param   pixels: receives width x height pixels in the target's format,
+ *          tightly packed, top row first
+ * @returns void
+ * @note    Stalls the pipeline, meant for tests and screenshots
+ */
+TGAPI void renderTargetReadPixels(RenderTarget* target, void* pixels);
+
+/**
+ * @param   target: Pointer to the target
+ * @returns The color texture, owned by the target
+ */
+TGAPI Texture* renderTargetGetTexture(RenderTarget* target);
+
+/**
+ * @param   target: Pointer to the target
+ * @returns Width of the target in pixels
+ */
+TGAPI uint32_t renderTargetGetWidth(RenderTarget* target);
+
+/**
+ * @param   target: Pointer to the target
+ * @returns Height of the target in pixels
+ */
+TGAPI uint32_t renderTargetGetHeight(RenderTarget* target);
+
+/**
+ * @brief   Free the target and its texture
+ * @param   target: Pointer to the target
+ * @returns void
+ */
+TGAPI void renderTargetDestroy(RenderTarget* target);
+
+#endif // RENDER_TARGET_H
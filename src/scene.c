@@ -0,0 +1,368 @@
+#define TG_MEMORY_TAG MEMORY_TAG_SCENE
+
+// get function defines
+#include "scene.h"
+#include "array_internal.h"
+#include "trace.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct SceneNodeInternal {
+    SceneMatrix world;
+    Rect worldBounds;
+    SceneTransform local;
+    Rect localBounds;
+    uint32_t parent;        // index, SCENE_INVALID_NODE for roots
+    uint32_t subtreeSize;   // node plus descendants, valid while sorted
+    SceneNode handle;
+    uint8_t dirty;          // queued in the dirty list
+} SceneNodeInternal;
+
+// Internal Struct
+struct _Scene {
+    SceneNodeInternal* nodes;   // depth first unless unsorted is set
+    uint32_t count, capacity;
+    uint8_t unsorted;           // an add or reparent broke the order
+
+    SceneNodeInternal* spare;   // sort target, swapped with nodes
+    uint32_t spareCapacity;
+    uint32_t* scratch;          // child lists and stack of the sort
+    uint32_t scratchCapacity;
+
+    uint32_t* slots;            // handle to index, SCENE_INVALID_NODE if free
+    uint32_t slotCount, slotCapacity;
+    SceneNode* freeHandles;
+    uint32_t freeCount, freeCapacity;
+
+    SceneNode* dirty;           // each live handle at most once
+    uint32_t dirtyCount, dirtyCapacity;
+};
+
+PRIVATE void internal_sceneMarkDirty(Scene* scene, uint32_t index) {
+    SceneNodeInternal* node = &scene->nodes[index];
+    if (node->dirty)
+        return;
+    node->dirty = 1;
+    scene->dirty[scene->dirtyCount++] = node->handle;
+}
+
+PRIVATE SceneMatrix internal_sceneLocalMatrix(SceneTransform local) {
+    float c = cosf(local.rotation);
+    float s = sinf(local.rotation);
+    return (SceneMatrix) {
+        { c * local.scale.x, s * local.scale.x },
+        { -s * local.scale.y, c * local.scale.y },
+        local.position
+    };
+}
+
+PRIVATE SceneMatrix internal_sceneMultiply(SceneMatrix parent,
+                                           SceneMatrix local) {
+    return (SceneMatrix) {
+        { parent.x.x * local.x.x + parent.y.x * local.x.y,
+          parent.x.y * local.x.x + parent.y.y * local.x.y },
+        { parent.x.x * local.y.x + parent.y.x * local.y.y,
+          parent.x.y * local.y.x + parent.y.y * local.y.y },
+        sceneMatrixApply(parent, local.origin)
+    };
+}
+
+// Bounds of a transformed rect from its center and half extents
+PRIVATE Rect internal_sceneBounds(SceneMatrix world, Rect local) {
+    Vec2 center = sceneMatrixApply(world, (Vec2) {
+        (local.min.x + local.max.x) * 0.5f,
+        (local.min.y + local.max.y) * 0.5f
+    });
+    float halfWidth = (local.max.x - local.min.x) * 0.5f;
+    float halfHeight = (local.max.y - local.min.y) * 0.5f;
+    float extentX = fabsf(world.x.x) * halfWidth +
+                    fabsf(world.y.x) * halfHeight;
+    float extentY = fabsf(world.x.y) * halfWidth +
+                    fabsf(world.y.y) * halfHeight;
+    return (Rect) {
+        { center.x - extentX, center.y - extentY },
+        { center.x + extentX, center.y + extentY }
+    };
+}
+
+PRIVATE int internal_sceneCompare(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*) a;
+    uint32_t right = *(const uint32_t*) b;
+    return (left > right) - (left < right);
+}
+
+// Reorder the nodes depth first, siblings keep their insertion order
+PRIVATE int internal_sceneSort(Scene* scene) {
+    uint32_t n = scene->count;
+    if (!internal_arrayReserve((void**) &scene->spare, &scene->spareCapacity,
+                               sizeof(SceneNodeInternal), n) ||
+        !internal_arrayReserve((void**) &scene->scratch,
+                               &scene->scratchCapacity, sizeof(uint32_t),
+                               4 * n + 1))
+        return 0;
+
+    SceneNodeInternal* nodes = scene->nodes;
+    SceneNodeInternal* sorted = scene->spare;
+    uint32_t* childStart = scene->scratch;          // n + 1, offsets
+    uint32_t* children = childStart + n + 1;        // n, grouped by parent
+    uint32_t* stack = children + n;                 // n
+    uint32_t* newIndex = stack + n;                 // n, also fill cursors
+
+    memset(childStart, 0, sizeof(uint32_t) * (n + 1));
+    for (uint32_t i = 0; i < n; i++)
+        if (nodes[i].parent != SCENE_INVALID_NODE)
+            childStart[nodes[i].parent + 1]++;
+    for (uint32_t i = 0; i < n; i++)
+        childStart[i + 1] += childStart[i];
+    memcpy(newIndex, childStart, sizeof(uint32_t) * n);
+    for (uint32_t i = 0; i < n; i++)
+        if (nodes[i].parent != SCENE_INVALID_NODE)
+            children[newIndex[nodes[i].parent]++] = i;
+
+    // preorder walk, pushed in reverse so the first child pops first
+    uint32_t top = 0;
+    for (uint32_t i = n; i-- > 0;)
+        if (nodes[i].parent == SCENE_INVALID_NODE)
+            stack[top++] = i;
+    uint32_t next = 0;
+    while (top) {
+        uint32_t index = stack[--top];
+        newIndex[index] = next;
+        sorted[next++] = nodes[index];
+        for (uint32_t c = childStart[index + 1]; c-- > childStart[index];)
+            stack[top++] = children[c];
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (sorted[i].parent != SCENE_INVALID_NODE)
+            sorted[i].parent = newIndex[sorted[i].parent];
+        sorted[i].subtreeSize = 1;
+        scene->slots[sorted[i].handle] = i;
+    }
+    // children come after their parent, so walking back sums whole subtrees
+    for (uint32_t i = n; i-- > 0;)
+        if (sorted[i].parent != SCENE_INVALID_NODE)
+            sorted[sorted[i].parent].subtreeSize += sorted[i].subtreeSize;
+
+    scene->spare = nodes;
+    scene->nodes = sorted;
+    uint32_t capacity = scene->spareCapacity;
+    scene->spareCapacity = scene->capacity;
+    scene->capacity = capacity;
+    scene->unsorted = 0;
+    return 1;
+}
+
+// Drop handles of removed nodes from the dirty list
+PRIVATE void internal_sceneCompactDirty(Scene* scene) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < scene->dirtyCount; i++)
+        if (scene->slots[scene->dirty[i]] != SCENE_INVALID_NODE)
+            scene->dirty[kept++] = scene->dirty[i];
+    scene->dirtyCount = kept;
+}
+
+Scene* sceneNew(uint32_t expectedNodes) {
+    Scene* scene = ALLOC_S(Scene);
+    if (!scene)
+        return NULL;
+    memset(scene, 0, sizeof(Scene));
+
+    // best effort, sceneAdd grows the arrays itself when short
+    internal_arrayReserve((void**) &scene->nodes, &scene->capacity,
+                          sizeof(SceneNodeInternal), expectedNodes);
+    internal_arrayReserve((void**) &scene->slots, &scene->slotCapacity,
+                          sizeof(uint32_t), expectedNodes);
+    return scene;
+}
+
+SceneNode sceneAdd(Scene* scene, SceneNode parent, SceneTransform local,
+                   Rect localBounds) {
+    uint32_t handle = scene->freeCount ? scene->freeHandles[scene->freeCount - 1]
+                                       : scene->slotCount;
+    if (!internal_arrayReserve((void**) &scene->nodes, &scene->capacity,
+                               sizeof(SceneNodeInternal), scene->count + 1) ||
+        !internal_arrayReserve((void**) &scene->slots, &scene->slotCapacity,
+                               sizeof(uint32_t), handle + 1) ||
+        !internal_arrayReserve((void**) &scene->dirty, &scene->dirtyCapacity,
+                               sizeof(SceneNode), scene->slotCapacity))
+        return SCENE_INVALID_NODE;
+    if (scene->freeCount)
+        scene->freeCount--;
+    else
+        scene->slotCount++;
+
+    uint32_t parentIndex = parent == SCENE_INVALID_NODE ? SCENE_INVALID_NODE
+                                                        : scene->slots[parent];
+    uint32_t index = scene->count++;
+    scene->nodes[index] = (SceneNodeInternal) {
+        .local = local,
+        .localBounds = localBounds,
+        .parent = parentIndex,
+        .subtreeSize = 1,
+        .handle = handle
+    };
+    scene->slots[handle] = index;
+
+    // appending stays depth first when the parent's subtree ends the array,
+    // its ancestors' subtrees then end there too
+    if (!scene->unsorted && parentIndex != SCENE_INVALID_NODE) {
+        SceneNodeInternal* nodes = scene->nodes;
+        if (parentIndex + nodes[parentIndex].subtreeSize == index) {
+            for (uint32_t a = parentIndex; a != SCENE_INVALID_NODE;
+                 a = nodes[a].parent)
+                nodes[a].subtreeSize++;
+        } else {
+            scene->unsorted = 1;
+        }
+    }
+    internal_sceneMarkDirty(scene, index);
+    return handle;
+}
+
+void sceneRemove(Scene* scene, SceneNode node) {
+    if (scene->unsorted && !internal_sceneSort(scene))
+        return;
+    if (!internal_arrayReserve((void**) &scene->freeHandles,
+                               &scene->freeCapacity, sizeof(SceneNode),
+                               scene->slotCapacity))
+        return;
+
+    SceneNodeInternal* nodes = scene->nodes;
+    uint32_t first = scene->slots[node];
+    uint32_t size = nodes[first].subtreeSize;
+    uint8_t hadDirty = 0;
+    for (uint32_t i = first; i < first + size; i++) {
+        scene->slots[nodes[i].handle] = SCENE_INVALID_NODE;
+        scene->freeHandles[scene->freeCount++] = nodes[i].handle;
+        hadDirty |= nodes[i].dirty;
+    }
+    for (uint32_t a = nodes[first].parent; a != SCENE_INVALID_NODE;
+         a = nodes[a].parent)
+        nodes[a].subtreeSize -= size;
+
+    memmove(&nodes[first], &nodes[first + size],
+            sizeof(SceneNodeInternal) * (scene->count - first - size));
+    scene->count -= size;
+    for (uint32_t i = first; i < scene->count; i++) {
+        if (nodes[i].parent != SCENE_INVALID_NODE &&
+            nodes[i].parent >= first + size)
+            nodes[i].parent -= size;
+        scene->slots[nodes[i].handle] = i;
+    }
+    if (hadDirty)
+        internal_sceneCompactDirty(scene);
+}
+
+uint8_t sceneSetParent(Scene* scene, SceneNode node, SceneNode parent) {
+    uint32_t index = scene->slots[node];
+    uint32_t parentIndex = parent == SCENE_INVALID_NODE ? SCENE_INVALID_NODE
+                                                        : scene->slots[parent];
+    for (uint32_t a = parentIndex; a != SCENE_INVALID_NODE;
+         a = scene->nodes[a].parent)
+        if (a == index)
+            return 0;
+
+    scene->nodes[index].parent = parentIndex;
+    scene->unsorted = 1;
+    internal_sceneMarkDirty(scene, index);
+    return 1;
+}
+
+SceneNode sceneGetParent(Scene* scene, SceneNode node) {
+    uint32_t parent = scene->nodes[scene->slots[node]].parent;
+    return parent == SCENE_INVALID_NODE ? SCENE_INVALID_NODE
+                                        : scene->nodes[parent].handle;
+}
+
+void sceneSetTransform(Scene* scene, SceneNode node, SceneTransform local) {
+    uint32_t index = scene->slots[node];
+    scene->nodes[index].local = local;
+    internal_sceneMarkDirty(scene, index);
+}
+
+SceneTransform sceneGetTransform(Scene* scene, SceneNode node) {
+    return scene->nodes[scene->slots[node]].local;
+}
+
+void sceneSetBounds(Scene* scene, SceneNode node, Rect localBounds) {
+    uint32_t index = scene->slots[node];
+    scene->nodes[index].localBounds = localBounds;
+    internal_sceneMarkDirty(scene, index);
+}
+
+uint32_t sceneUpdate(Scene* scene) {
+    TRACE_FUNCTION();
+    if (scene->unsorted && !internal_sceneSort(scene))
+        return 0;
+
+    // handles to indices, sorted so enclosing subtrees come first
+    uint32_t* dirty = scene->dirty;
+    for (uint32_t i = 0; i < scene->dirtyCount; i++)
+        dirty[i] = scene->slots[dirty[i]];
+    qsort(dirty, scene->dirtyCount, sizeof(uint32_t), internal_sceneCompare);
+
+    SceneNodeInternal* nodes = scene->nodes;
+    uint32_t covered = 0;   // end of the last recomputed subtree
+    uint32_t recomputed = 0;
+    for (uint32_t i = 0; i < scene->dirtyCount; i++) {
+        if (dirty[i] < covered)
+            continue;       // inside a subtree already recomputed
+        uint32_t end = dirty[i] + nodes[dirty[i]].subtreeSize;
+        for (uint32_t j = dirty[i]; j < end; j++) {
+            SceneNodeInternal* node = &nodes[j];
+            SceneMatrix local = internal_sceneLocalMatrix(node->local);
+            node->world = node->parent == SCENE_INVALID_NODE
+                ? local
+                : internal_sceneMultiply(nodes[node->parent].world, local);
+            node->worldBounds = internal_sceneBounds(node->world,
+                                                     node->localBounds);
+            node->dirty = 0;
+        }
+        recomputed += end - dirty[i];
+        covered = end;
+    }
+    scene->dirtyCount = 0;
+    return recomputed;
+}
+
+SceneMatrix sceneGetWorld(Scene* scene, SceneNode node) {
+    return scene->nodes[scene->slots[node]].world;
+}
+
+Rect sceneGetWorldBounds(Scene* scene, SceneNode node) {
+    return scene->nodes[scene->slots[node]].worldBounds;
+}
+
+uint32_t sceneQuery(Scene* scene, Rect area, SceneNode* out,
+                    uint32_t maxResults) {
+    uint32_t found = 0;
+    for (uint32_t i = 0; i < scene->count; i++) {
+        const SceneNodeInternal* node = &scene->nodes[i];
+        if (rectIsEmpty(node->localBounds) ||
+            !rectOverlaps(node->worldBounds, area))
+            continue;
+        if (found < maxResults)
+            out[found] = node->handle;
+        found++;
+    }
+    return found;
+}
+
+uint32_t sceneGetCount(Scene* scene) {
+    return scene->count;
+}
+
+void sceneDestroy(Scene* scene) {
+    if (!scene)
+        return;
+    TG_FREE(scene->nodes);
+    TG_FREE(scene->spare);
+    TG_FREE(scene->scratch);
+    TG_FREE(scene->slots);
+    TG_FREE(scene->freeHandles);
+    TG_FREE(scene->dirty);
+    TG_FREE(scene);
+}
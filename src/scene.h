@@ -0,0 +1,197 @@
+// Scene graph public API
+
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "defines.h"
+
+/**
+ * @brief   Opaque type to Scene struct
+ * @note    Nodes are kept in one flat array in depth first order, a parent
+ *          always comes before its children and every subtree is a
+ *          contiguous range, so updates are linear walks over memory
+ */
+typedef struct _Scene Scene;
+
+/**
+ * @brief   Handle to a node of a Scene, stays valid while nodes move around
+ *          in the array
+ */
+typedef uint32_t SceneNode;
+
+/**
+ * @def SCENE_INVALID_NODE
+ * @brief Returned when a node could not be added, and used as the parent of
+ * root nodes
+ */
+#define SCENE_INVALID_NODE 0xFFFFFFFFu
+
+/**
+ * @brief   Transform of a node relative to its parent, scale is applied
+ *          first, then rotation, then translation
+ */
+typedef struct SceneTransform {
+    Vec2 position;  /**< Translation in parent units */
+    float rotation; /**< Counter-clockwise, in radians */
+    Vec2 scale;     /**< Scale along the local axes */
+} SceneTransform;
+
+/**
+ * @brief   2D affine matrix, maps a point p to x * p.x + y * p.y + origin
+ */
+typedef struct SceneMatrix {
+    Vec2 x;         /**< Image of the local x axis */
+    Vec2 y;         /**< Image of the local y axis */
+    Vec2 origin;    /**< Image of the local origin */
+} SceneMatrix;
+
+/**
+ * @returns Transform that leaves points where they are
+ */
+HELPER SceneTransform sceneTransformIdentity(void) {
+    return (SceneTransform) { { 0.0f, 0.0f }, 0.0f, { 1.0f, 1.0f } };
+}
+
+/**
+ * @brief   Apply a matrix to a point
+ * @param   matrix: SceneMatrix, usually from sceneGetWorld
+ * @param   point: Vec2, in the local space of the matrix
+ * @returns Transformed point
+ */
+HELPER Vec2 sceneMatrixApply(SceneMatrix matrix, Vec2 point) {
+    return (Vec2) {
+        matrix.x.x * point.x + matrix.y.x * point.y + matrix.origin.x,
+        matrix.x.y * point.x + matrix.y.y * point.y + matrix.origin.y
+    };
+}
+
+/**
+ * @brief   Create a new, empty scene
+ * @param   expectedNodes: uint32_t, number of nodes to reserve storage for
+ * @returns Pointer to a new Scene, NULL on failure
+ * @see     Scene
+ */
+TGAPI Scene* sceneNew(uint32_t expectedNodes);
+
+/**
+ * @brief   Add a node
+ * @param   scene: Pointer to the scene
+ * @param   parent: SceneNode, SCENE_INVALID_NODE for a root node
+ * @param   local: SceneTransform, relative to the parent
+ * @param   localBounds: Rect, extent in local units, an empty rect for
+ *          nodes that only group others
+ * @returns Handle to the node, SCENE_INVALID_NODE on failure
+ * @note    Adding children in depth first order keeps the array sorted,
+ *          anything else is sorted once by the next sceneUpdate
+ */
+TGAPI SceneNode sceneAdd(Scene* scene, SceneNode parent, SceneTransform local,
+                         Rect localBounds);
+
+/**
+ * @brief   Remove a node along with all its descendants
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode, node to remove
+ * @returns void
+ * @note    Linear in the number of nodes, the handles are reused
+ */
+TGAPI void sceneRemove(Scene* scene, SceneNode node);
+
+/**
+ * @brief   Move a node, and its subtree, under another parent
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode, node to move
+ * @param   parent: SceneNode, new parent, SCENE_INVALID_NODE for a root
+ * @returns 1 on success, 0 if parent is the node or one of its descendants
+ * @note    The local transform is kept, so the world transform changes
+ */
+TGAPI uint8_t sceneSetParent(Scene* scene, SceneNode node, SceneNode parent);
+
+/**
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode
+ * @returns Parent of the node, SCENE_INVALID_NODE for a root
+ */
+TGAPI SceneNode sceneGetParent(Scene* scene, SceneNode node);
+
+/**
+ * @brief   Replace the local transform, the node and its subtree are
+ *          recomputed by the next sceneUpdate
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode
+ * @param   local: SceneTransform, relative to the parent
+ * @returns void
+ */
+TGAPI void sceneSetTransform(Scene* scene, SceneNode node,
+                             SceneTransform local);
+
+/**
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode
+ * @returns Local transform of the node
+ */
+TGAPI SceneTransform sceneGetTransform(Scene* scene, SceneNode node);
+
+/**
+ * @brief   Replace the local bounds, the world bounds follow on the next
+ *          sceneUpdate
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode
+ * @param   localBounds: Rect, extent in local units
+ * @returns void
+ */
+TGAPI void sceneSetBounds(Scene* scene, SceneNode node, Rect localBounds);
+
+/**
+ * @brief   Recompute the world transform and bounds of changed subtrees
+ * @param   scene: Pointer to the scene
+ * @returns Number of nodes recomputed
+ * @note    Costs the size of the changed subtrees, untouched nodes are not
+ *          visited, unless nodes were added out of order or reparented
+ *          since the last update, which sorts the whole array once
+ */
+TGAPI uint32_t sceneUpdate(Scene* scene);
+
+/**
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode
+ * @returns World matrix of the node as of the last sceneUpdate
+ */
+TGAPI SceneMatrix sceneGetWorld(Scene* scene, SceneNode node);
+
+/**
+ * @param   scene: Pointer to the scene
+ * @param   node: SceneNode
+ * @returns Axis aligned world bounds as of the last sceneUpdate
+ */
+TGAPI Rect sceneGetWorldBounds(Scene* scene, SceneNode node);
+
+/**
+ * @brief   Find the nodes whose world bounds overlap an area, for culling
+ * @param   scene: Pointer to the scene
+ * @param   area: Rect, in world units, usually the visible region
+ * @param   out: SceneNode*, receives up to maxResults handles in depth first
+ *          order, so parents are drawn before their children
+ * @param   maxResults: uint32_t, size of out
+ * @returns Number of overlapping nodes, may be more than maxResults
+ * @note    Nodes with empty local bounds never match
+ */
+TGAPI uint32_t sceneQuery(Scene* scene, Rect area, SceneNode* out,
+                          uint32_t maxResults);
+
+/**
+ * @param   scene: Pointer to the scene
+ * @returns Number of nodes in the scene
+ */
+TGAPI uint32_t sceneGetCount(Scene* scene);
+
+/**
+ * @brief   Free the scene and all its nodes
+ * @param   scene: Pointer to the scene
+ * @returns void
+ */
+TGAPI void sceneDestroy(Scene* scene);
+
+#endif // SCENE_H
@@ -0,0 +1,201 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "shader.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+// Slot of a variant that failed to compile, it isn't retried
+#define SHADER_VARIANT_FAILED 0xFFFFFFFFu
+
+// Internal Struct
+struct _ShaderVariants {
+    const char* vertexSource;
+    const char* fragmentSource;
+    const char* const* names;
+    uint32_t nameCount;
+    uint32_t compiled;
+    uint32_t programs[1u << SHADER_MAX_FEATURES];  // 0 until first use
+};
+
+// Compile one stage, returns 0 and prints the log if it fails
+PRIVATE uint32_t internal_shaderStage(uint32_t type, const char* source) {
+    uint32_t shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);   // This can often silently fail
+
+    int32_t success = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char info[512];
+        glGetShaderInfoLog(shader, sizeof(info), NULL, info);
+        fprintf(stderr, "Shader compilation failed.\nLog:\n%s\n", info);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Link an already populated program, returns 0 and prints the log on failure
+PRIVATE uint32_t internal_shaderLink(uint32_t program) {
+    glLinkProgram(program);
+
+    int32_t success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char info[512];
+        glGetProgramInfoLog(program, sizeof(info), NULL, info);
+        fprintf(stderr, "Error linking shaders.\nLog:\n%s\n", info);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+uint32_t shaderCompile(const char* vertexSource, const char* fragmentSource) {
+    uint32_t vertex = internal_shaderStage(GL_VERTEX_SHADER, vertexSource);
+    if (!vertex)
+        return 0;
+    uint32_t fragment = internal_shaderStage(GL_FRAGMENT_SHADER,
+                                             fragmentSource);
+    if (!fragment) {
+        glDeleteShader(vertex);
+        return 0;
+    }
+
+    uint32_t program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    program = internal_shaderLink(program);
+
+    // the program keeps its own copy, stages aren't needed anymore
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    return program;
+}
+
+uint32_t shaderCompileFeedback(const char* vertexSource,
+                               const char* const* varyings,
+                               uint32_t varyingCount) {
+    uint32_t vertex = internal_shaderStage(GL_VERTEX_SHADER, vertexSource);
+    if (!vertex)
+        return 0;
+
+    uint32_t program = glCreateProgram();
+    glAttachShader(program, vertex);
+    // must be declared before linking, the linker lays out the buffer
+    glTransformFeedbackVaryings(program, (GLsizei) varyingCount, varyings,
+                                GL_INTERLEAVED_ATTRIBS);
+    program = internal_shaderLink(program);
+    glDeleteShader(vertex);
+    return program;
+}
+
+uint32_t shaderSpecialize(const char* source, const char* const* names,
+                          uint32_t nameCount, uint32_t features,
+                          char* buffer, uint32_t capacity) {
+    // split after the #version line, defines can't come before it
+    size_t length = strlen(source);
+    size_t head = 0, separator = 0;
+    const char* version = strstr(source, "#version");
+    if (version) {
+        const char* end = strchr(version, '\n');
+        head = end ? (size_t) (end - source) + 1 : length;
+        separator = !end;   // the defines need a line of their own
+    }
+    size_t defines = 0;
+    for (uint32_t i = 0; i < nameCount; i++)
+        if (features & (1u << i))
+            defines += strlen("#define  1\n") + strlen(names[i]);
+    size_t total = length + separator + defines;
+    if (total + 1 > capacity)
+        return (uint32_t) total;
+
+    memcpy(buffer, source, head);
+    char* cursor = buffer + head;
+    if (separator)
+        *cursor++ = '\n';
+    for (uint32_t i = 0; i < nameCount; i++)
+        if (features & (1u << i))
+            cursor += sprintf(cursor, "#define %s 1\n", names[i]);
+    memcpy(cursor, source + head, length - head + 1);
+    return (uint32_t) total;
+}
+
+ShaderVariants* shaderVariantsNew(const char* vertexSource,
+                                  const char* fragmentSource,
+                                  const char* const* names,
+                                  uint32_t nameCount) {
+    if (nameCount > SHADER_MAX_FEATURES)
+        return NULL;
+    ShaderVariants* variants = ALLOC_S(ShaderVariants);
+    if (!variants)
+        return NULL;
+    memset(variants, 0, sizeof(ShaderVariants));
+    variants->vertexSource = vertexSource;
+    variants->fragmentSource = fragmentSource;
+    variants->names = names;
+    variants->nameCount = nameCount;
+    return variants;
+}
+
+// Specialize one stage into a heap buffer, NULL if out of memory
+PRIVATE char* internal_shaderSpecializeAlloc(ShaderVariants* variants,
+                                             const char* source,
+                                             uint32_t features) {
+    uint32_t length = shaderSpecialize(source, variants->names,
+                                       variants->nameCount, features, NULL, 0);
+    char* specialized = TG_MALLOC((size_t) length + 1);
+    if (specialized)
+        shaderSpecialize(source, variants->names, variants->nameCount,
+                         features, specialized, length + 1);
+    return specialized;
+}
+
+uint32_t shaderVariantsGet(ShaderVariants* variants, uint32_t features) {
+    if (features >> variants->nameCount)
+        return 0;
+    uint32_t program = variants->programs[features];
+    if (program)
+        return program == SHADER_VARIANT_FAILED ? 0 : program;
+
+    char* vertex = internal_shaderSpecializeAlloc(variants,
+                                                  variants->vertexSource,
+                                                  features);
+    char* fragment = internal_shaderSpecializeAlloc(variants,
+                                                    variants->fragmentSource,
+                                                    features);
+    if (!vertex || !fragment) {
+        TG_FREE(vertex);
+        TG_FREE(fragment);
+        return 0;   // out of memory, not cached so a later call retries
+    }
+    program = shaderCompile(vertex, fragment);
+    TG_FREE(vertex);
+    TG_FREE(fragment);
+
+    variants->programs[features] = program ? program : SHADER_VARIANT_FAILED;
+    variants->compiled++;
+    return program;
+}
+
+uint32_t shaderVariantsGetCompiledCount(ShaderVariants* variants) {
+    return variants->compiled;
+}
+
+void shaderVariantsDestroy(ShaderVariants* variants) {
+    if (!variants)
+        return;
+    for (uint32_t i = 0; i < (1u << variants->nameCount); i++)
+        if (variants->programs[i] != SHADER_VARIANT_FAILED)
+            shaderDestroy(variants->programs[i]);
+    TG_FREE(variants);
+}
+
+void shaderDestroy(uint32_t program) {
+    if (program)
+        glDeleteProgram(program);
+}
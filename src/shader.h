@@ -0,0 +1,108 @@
+// Shader public API
+
+#ifndef SHADER_H
+#define SHADER_H
+
+#include <stdint.h>
+
+#include "defines.h"
+
+// Feature flags per variant set, variants are indexed by a bitmask of them
+#define SHADER_MAX_FEATURES 8
+
+/**
+ * @brief   Opaque type to ShaderVariants struct
+ * @note    One GLSL source pair specialized by feature flags. Bit i of a
+ *          feature mask turns on "#define <name i> 1" in both stages, so
+ *          each draw runs a program without branches for features it does
+ *          not use. Variants are compiled on first use
+ */
+typedef struct _ShaderVariants ShaderVariants;
+
+/**
+ * @brief   Compile and link a shader program
+ * @param   vertexSource: String, GLSL source of the vertex stage
+ * @param   fragmentSource: String, GLSL source of the fragment stage
+ * @returns OpenGL name of the program, 0 on failure
+ * @note    Compile and link logs are printed to stderr on failure
+ */
+TGAPI uint32_t shaderCompile(const char* vertexSource,
+                             const char* fragmentSource);
+
+/**
+ * @brief   Compile a vertex only program that captures its outputs
+ * @param   vertexSource: String, GLSL source of the vertex stage
+ * @param   varyings: names of the outputs to capture, in buffer order
+ * @param   varyingCount: uint32_t, number of names in varyings
+ * @returns OpenGL name of the program, 0 on failure
+ * @note    Outputs are captured interleaved into a single buffer
+ */
+TGAPI uint32_t shaderCompileFeedback(const char* vertexSource,
+                                     const char* const* varyings,
+                                     uint32_t varyingCount);
+
+/**
+ * @brief   Insert the defines of a feature mask into GLSL source
+ * @param   source: String, GLSL source
+ * @param   names: names of the features, bit i of features is names[i]
+ * @param   nameCount: uint32_t, number of names, at most SHADER_MAX_FEATURES
+ * @param   features: uint32_t, bitmask of the features to define
+ * @param   buffer: receives the specialized source, NUL terminated
+ * @param   capacity: uint32_t, size of buffer in bytes
+ * @returns Length of the specialized source, without the NUL. Nothing is
+ *          written when capacity is smaller than that plus one
+ * @note    Defines go right after the #version line, which GLSL requires
+ *          to come first, or at the top when there is none
+ */
+TGAPI uint32_t shaderSpecialize(const char* source, const char* const* names,
+                                uint32_t nameCount, uint32_t features,
+                                char* buffer, uint32_t capacity);
+
+/**
+ * @brief   Create a variant set, nothing is compiled yet
+ * @param   vertexSource: String, GLSL source of the vertex stage
+ * @param   fragmentSource: String, GLSL source of the fragment stage
+ * @param   names: names of the features, used as #define names
+ * @param   nameCount: uint32_t, number of names, at most SHADER_MAX_FEATURES
+ * @returns Pointer to a new ShaderVariants, NULL on failure
+ * @note    Sources and names are not copied, they must outlive the set.
+ *          Static strings, like the other shaders of the library, do
+ * @see     ShaderVariants
+ */
+TGAPI ShaderVariants* shaderVariantsNew(const char* vertexSource,
+                                        const char* fragmentSource,
+                                        const char* const* names,
+                                        uint32_t nameCount);
+
+/**
+ * @brief   Program of a feature mask, compiled the first time it is asked for
+ * @param   variants: Pointer to the variant set
+ * @param   features: uint32_t, bitmask of the features, bit i is names[i]
+ * @returns OpenGL name of the program, 0 if it does not compile or the mask
+ *          has bits beyond the names
+ * @note    Needs a current OpenGL context. After the first call this is an
+ *          array lookup, a variant that failed is not compiled again
+ */
+TGAPI uint32_t shaderVariantsGet(ShaderVariants* variants, uint32_t features);
+
+/**
+ * @param   variants: Pointer to the variant set
+ * @returns Number of variants compiled so far, failed ones included
+ */
+TGAPI uint32_t shaderVariantsGetCompiledCount(ShaderVariants* variants);
+
+/**
+ * @brief   Delete every compiled variant and free the set
+ * @param   variants: Pointer to the variant set
+ * @returns void
+ */
+TGAPI void shaderVariantsDestroy(ShaderVariants* variants);
+
+/**
+ * @brief   Delete a program created by this module
+ * @param   program: uint32_t, OpenGL name of the program, 0 is ignored
+ * @returns void
+ */
+TGAPI void shaderDestroy(uint32_t program);
+
+#endif // SHADER_H
@@ -0,0 +1,352 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "shape.h"
+#include "array_internal.h"
+#include "vector_types.h"
+#include "clip.h"
+#include "shader.h"
+#include "gpu_memory.h"
+#include "trace.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+// The quad covers the box, its shadow and one pixel of antialiasing, in the
+// rotated frame of the shape. USE_CLIP cuts it to the shape's clip rect,
+// uClipRects holds CLIP_MAX_RECTS
+#define SHAPE_STRINGIFY(x) #x
+#define SHAPE_TO_STRING(x) SHAPE_STRINGIFY(x)
+static const char* const shapeVertex =
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aCenter;\n"
+    "layout (location = 1) in vec2 aHalfSize;\n"
+    "layout (location = 2) in vec4 aParams;\n"
+    "layout (location = 3) in vec2 aShadowOffset;\n"
+    "layout (location = 4) in vec4 aFill;\n"
+    "layout (location = 5) in vec4 aBorder;\n"
+    "layout (location = 6) in vec4 aShadow;\n"
+    "#ifdef USE_CLIP\n"
+    "layout (location = 7) in uint aClip;\n"
+    "uniform vec4 uClipRects[" SHAPE_TO_STRING(CLIP_MAX_RECTS) "];\n"
+    "#endif\n"
+    "uniform vec2 uViewSize;\n"
+    "out vec2 vLocal;\n"
+    "flat out vec2 vHalfSize;\n"
+    "flat out vec4 vParams;\n"
+    "flat out vec2 vShadowOffset;\n"
+    "flat out vec4 vFill;\n"
+    "flat out vec4 vBorder;\n"
+    "flat out vec4 vShadow;\n"
+    "void main() {\n"
+    "    float c = cos(aParams.x);\n"
+    "    float s = sin(aParams.x);\n"
+    "    mat2 rotation = mat2(c, s, -s, c);\n"
+    "    float margin = 1.0;\n"
+    "    if (aShadow.a > 0.0)\n"
+    "        margin += length(aShadowOffset) + aParams.w;\n"
+    "    vec2 corner = vec2((gl_VertexID & 1) == 0 ? -1.0 : 1.0,\n"
+    "                       gl_VertexID < 2 ? -1.0 : 1.0);\n"
+    "    vLocal = corner * (aHalfSize + margin);\n"
+    "    vHalfSize = aHalfSize;\n"
+    "    vParams = aParams;\n"
+    "    vShadowOffset = transpose(rotation) * aShadowOffset;\n"
+    "    vFill = aFill;\n"
+    "    vBorder = aBorder;\n"
+    "    vShadow = aShadow;\n"
+    "    vec2 position = aCenter + rotation * vLocal;\n"
+    "#ifdef USE_CLIP\n"
+    "    vec4 clip = uClipRects[min(aClip, uint(uClipRects.length() - 1))];\n"
+    "    gl_ClipDistance[0] = position.x - clip.x;\n"
+    "    gl_ClipDistance[1] = position.y - clip.y;\n"
+    "    gl_ClipDistance[2] = clip.z - position.x;\n"
+    "    gl_ClipDistance[3] = clip.w - position.y;\n"
+    "#endif\n"
+    "    vec2 ndc = position / uViewSize * 2.0 - 1.0;\n"
+    "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);\n"
+    "}\n";
+
+// Same distance as shapeDistance, output is premultiplied
+static const char* const shapeFragment =
+    "#version 330 core\n"
+    "in vec2 vLocal;\n"
+    "flat in vec2 vHalfSize;\n"
+    "flat in vec4 vParams;\n"
+    "flat in vec2 vShadowOffset;\n"
+    "flat in vec4 vFill;\n"
+    "flat in vec4 vBorder;\n"
+    "flat in vec4 vShadow;\n"
+    "out vec4 FragColor;\n"
+    "float roundedBox(vec2 p, vec2 halfSize, float radius) {\n"
+    "    vec2 q = abs(p) - halfSize + radius;\n"
+    "    return length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;\n"
+    "}\n"
+    "void main() {\n"
+    "    float radius = clamp(vParams.y, 0.0, min(vHalfSize.x, vHalfSize.y));\n"
+    "    float d = roundedBox(vLocal, vHalfSize, radius);\n"
+    "    float coverage = clamp(0.5 - d, 0.0, 1.0);\n"
+    "    float edge = vParams.z > 0.0 ? clamp(0.5 + d + vParams.z, 0.0, 1.0)\n"
+    "                                 : 0.0;\n"
+    "    vec4 color = mix(vFill, vBorder, edge);\n"
+    "    vec4 result = vec4(color.rgb * color.a, color.a) * coverage;\n"
+    "    if (vShadow.a > 0.0) {\n"
+    "        float blur = max(vParams.w, 0.5);\n"
+    "        float shadowDistance = roundedBox(vLocal - vShadowOffset,\n"
+    "                                          vHalfSize, radius);\n"
+    "        float shadow = vShadow.a *\n"
+    "                       (1.0 - smoothstep(-blur, blur, shadowDistance));\n"
+    "        result += vec4(vShadow.rgb * shadow, shadow) * (1.0 - result.a);\n"
+    "    }\n"
+    "    FragColor = result;\n"
+    "}\n";
+
+static const char* const shapeFeatures[] = { "USE_CLIP" };
+
+// Variant bit of shapeFeatures
+#define SHAPE_FEATURE_CLIP 0x1u
+
+// Internal Struct
+struct _ShapeBatch {
+    ShapeInstance* instances;
+    uint16_t* clips;            // clip index per instance
+    uint32_t count, capacity;
+    uint32_t clippedCount;      // instances with a clip other than none
+
+    // drawing, created on the first draw
+    ShaderVariants* variants;
+    uint32_t drawVao;
+    uint32_t drawBuffer;
+    uint32_t clipBuffer;
+    uint32_t bufferCapacity;    // instances the GL buffer holds
+    uint32_t clipCapacity;      // indices the clip buffer holds
+};
+
+PRIVATE void internal_shapePackColor(uint8_t out[4], const float color[4]) {
+    for (int i = 0; i < 4; i++) {
+        float value = color[i] > 0.0f ? color[i] < 1.0f ? color[i] : 1.0f
+                                      : 0.0f;
+        out[i] = (uint8_t) (value * 255.0f + 0.5f);
+    }
+}
+
+PRIVATE int16_t internal_shapePackOffset(float offset) {
+    float value = offset > -32767.0f ? offset < 32767.0f ? offset : 32767.0f
+                                     : -32767.0f;
+    return (int16_t) (value + (value < 0.0f ? -0.5f : 0.5f));
+}
+
+PRIVATE uint8_t internal_shapeDrawCreate(ShapeBatch* batch) {
+    batch->variants = shaderVariantsNew(shapeVertex, shapeFragment,
+                                        shapeFeatures, 1);
+    if (!batch->variants)
+        return 0;
+
+    glGenVertexArrays(1, &batch->drawVao);
+    glGenBuffers(1, &batch->drawBuffer);
+    glGenBuffers(1, &batch->clipBuffer);
+    glBindVertexArray(batch->drawVao);
+    glBindBuffer(GL_ARRAY_BUFFER, batch->drawBuffer);
+    GLsizei stride = sizeof(ShapeInstance);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride,
+                          (void*) offsetof(ShapeInstance, center));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride,
+                          (void*) offsetof(ShapeInstance, halfSize));
+    glVertexAttribPointer(2, 4, GL_HALF_FLOAT, GL_FALSE, stride,
+                          (void*) offsetof(ShapeInstance, params));
+    glVertexAttribPointer(3, 2, GL_SHORT, GL_FALSE, stride,
+                          (void*) offsetof(ShapeInstance, shadowOffset));
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          (void*) offsetof(ShapeInstance, fill));
+    glVertexAttribPointer(5, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          (void*) offsetof(ShapeInstance, border));
+    glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+                          (void*) offsetof(ShapeInstance, shadow));
+    for (uint32_t attribute = 0; attribute < 7; attribute++) {
+        glVertexAttribDivisor(attribute, 1);
+        glEnableVertexAttribArray(attribute);
+    }
+    // read by the clip variant only, enabled while it draws
+    glBindBuffer(GL_ARRAY_BUFFER, batch->clipBuffer);
+    glVertexAttribIPointer(7, 1, GL_UNSIGNED_SHORT, sizeof(uint16_t),
+                           (void*) 0);
+    glVertexAttribDivisor(7, 1);
+    glBindVertexArray(0);
+    return 1;
+}
+
+ShapeBatch* shapeBatchNew(uint32_t expectedShapes) {
+    ShapeBatch* batch = ALLOC_S(ShapeBatch);
+    if (!batch)
+        return NULL;
+    memset(batch, 0, sizeof(ShapeBatch));
+    if (expectedShapes) {
+        batch->instances = TG_MALLOC(sizeof(ShapeInstance) * expectedShapes);
+        batch->clips = TG_MALLOC(sizeof(uint16_t) * expectedShapes);
+        batch->capacity = batch->instances && batch->clips ? expectedShapes
+                                                           : 0;
+    }
+    return batch;
+}
+
+uint8_t shapeBatchAdd(ShapeBatch* batch, const Shape* shape) {
+    if (!internal_arrayReservePair((void**) &batch->instances,
+                                   (void**) &batch->clips, &batch->capacity,
+                                   sizeof(ShapeInstance), sizeof(uint16_t),
+                                   batch->count + 1))
+        return 0;
+    batch->clips[batch->count] = shape->clip;
+    batch->clippedCount += shape->clip != CLIP_NONE;
+
+    ShapeInstance* instance = &batch->instances[batch->count++];
+    instance->center[0] = shape->center.x;
+    instance->center[1] = shape->center.y;
+    instance->halfSize[0] = shape->halfSize.x;
+    instance->halfSize[1] = shape->halfSize.y;
+    float params[4] = {
+        shape->rotation, shape->cornerRadius, shape->borderWidth,
+        shape->shadowBlur
+    };
+    vectorPackHalf(instance->params, params, 4);
+    instance->shadowOffset[0] = internal_shapePackOffset(shape->shadowOffset.x);
+    instance->shadowOffset[1] = internal_shapePackOffset(shape->shadowOffset.y);
+    internal_shapePackColor(instance->fill, shape->fill);
+    internal_shapePackColor(instance->border, shape->border);
+    internal_shapePackColor(instance->shadow, shape->shadow);
+    return 1;
+}
+
+void shapeBatchClear(ShapeBatch* batch) {
+    batch->count = 0;
+    batch->clippedCount = 0;
+}
+
+const ShapeInstance* shapeBatchGetInstances(ShapeBatch* batch,
+                                            uint32_t* count) {
+    *count = batch->count;
+    return batch->instances;
+}
+
+void shapeBatchDraw(ShapeBatch* batch, Vec2 viewSize) {
+    shapeBatchDrawClipped(batch, viewSize, NULL, 0);
+}
+
+void shapeBatchDrawClipped(ShapeBatch* batch, Vec2 viewSize,
+                           const Rect* clips, uint32_t clipCount) {
+    if (!batch->count)
+        return;
+    TRACE_FUNCTION();
+    if (!batch->variants && !internal_shapeDrawCreate(batch))
+        return;
+    uint8_t clipped = batch->clippedCount && clipCount;
+    uint32_t program = shaderVariantsGet(batch->variants,
+                                         clipped ? SHAPE_FEATURE_CLIP : 0);
+    if (!program)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch->drawBuffer);
+    if (batch->capacity > batch->bufferCapacity) {
+        if (batch->bufferCapacity)
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) batch->bufferCapacity *
+                           sizeof(ShapeInstance));
+        batch->bufferCapacity = batch->capacity;
+        gpuMemoryAllocated(GPU_MEMORY_BUFFER,
+                           (uint64_t) batch->bufferCapacity *
+                           sizeof(ShapeInstance));
+    }
+    glBufferData(GL_ARRAY_BUFFER,                                   // orphan
+                 (GLsizeiptr) batch->bufferCapacity * sizeof(ShapeInstance),
+                 NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0,
+                    (GLsizeiptr) batch->count * sizeof(ShapeInstance),
+                    batch->instances);
+
+    glUseProgram(program);
+    glUniform2f(glGetUniformLocation(program, "uViewSize"),
+                viewSize.x, viewSize.y);
+    glBindVertexArray(batch->drawVao);
+    if (clipped) {
+        float rects[CLIP_MAX_RECTS][4];
+        clipCount = clipCount < CLIP_MAX_RECTS ? clipCount : CLIP_MAX_RECTS;
+        for (uint32_t i = 0; i < clipCount; i++) {
+            rects[i][0] = clips[i].min.x;
+            rects[i][1] = clips[i].min.y;
+            rects[i][2] = clips[i].max.x;
+            rects[i][3] = clips[i].max.y;
+        }
+        glUniform4fv(glGetUniformLocation(program, "uClipRects"),
+                     (GLsizei) clipCount, &rects[0][0]);
+        glBindBuffer(GL_ARRAY_BUFFER, batch->clipBuffer);
+        if (batch->capacity > batch->clipCapacity) {
+            if (batch->clipCapacity)
+                gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                               (uint64_t) batch->clipCapacity *
+                               sizeof(uint16_t));
+            batch->clipCapacity = batch->capacity;
+            gpuMemoryAllocated(GPU_MEMORY_BUFFER,
+                               (uint64_t) batch->clipCapacity *
+                               sizeof(uint16_t));
+        }
+        glBufferData(GL_ARRAY_BUFFER,                               // orphan
+                     (GLsizeiptr) batch->clipCapacity * sizeof(uint16_t),
+                     NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0,
+                        (GLsizeiptr) batch->count * sizeof(uint16_t),
+                        batch->clips);
+        glEnableVertexAttribArray(7);
+        for (uint32_t plane = 0; plane < 4; plane++)
+            glEnable(GL_CLIP_DISTANCE0 + plane);
+    }
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei) batch->count);
+    if (clipped) {
+        for (uint32_t plane = 0; plane < 4; plane++)
+            glDisable(GL_CLIP_DISTANCE0 + plane);
+        glDisableVertexAttribArray(7);
+    }
+    glBindVertexArray(0);
+}
+
+float shapeDistance(const Shape* shape, Vec2 point) {
+    // into the frame of the shape, the inverse of its rotation
+    float c = cosf(shape->rotation);
+    float s = sinf(shape->rotation);
+    Vec2 offset = vec2Sub(point, shape->center);
+    Vec2 local = { c * offset.x + s * offset.y, -s * offset.x + c * offset.y };
+
+    float smaller = shape->halfSize.x < shape->halfSize.y ? shape->halfSize.x
+                                                          : shape->halfSize.y;
+    float radius = shape->cornerRadius > 0.0f ? shape->cornerRadius : 0.0f;
+    radius = radius < smaller ? radius : smaller;
+
+    float qx = fabsf(local.x) - shape->halfSize.x + radius;
+    float qy = fabsf(local.y) - shape->halfSize.y + radius;
+    float outside = vec2Length((Vec2) { qx > 0.0f ? qx : 0.0f,
+                                        qy > 0.0f ? qy : 0.0f });
+    float inside = qx > qy ? qx : qy;
+    return outside + (inside < 0.0f ? inside : 0.0f) - radius;
+}
+
+void shapeBatchDestroy(ShapeBatch* batch) {
+    if (!batch)
+        return;
+    shaderVariantsDestroy(batch->variants);
+    if (batch->drawVao) {
+        glDeleteVertexArrays(1, &batch->drawVao);
+        glDeleteBuffers(1, &batch->drawBuffer);
+        glDeleteBuffers(1, &batch->clipBuffer);
+        if (batch->bufferCapacity)
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) batch->bufferCapacity *
+                           sizeof(ShapeInstance));
+        if (batch->clipCapacity)    // only grown by clipped draws
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           (uint64_t) batch->clipCapacity * sizeof(uint16_t));
+    }
+    TG_FREE(batch->instances);
+    TG_FREE(batch->clips);
+    TG_FREE(batch);
+}
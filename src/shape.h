@@ -0,0 +1,195 @@
+// Shape batch public API
+
+#ifndef SHAPE_H
+#define SHAPE_H
+
+#include <stdint.h>
+#include <math.h>
+
+#include "rect.h"
+#include "defines.h"
+
+/**
+ * @brief   A rounded box, the one primitive behind every shape. Rects have
+ *          no corner radius, circles and lines are boxes rounded all the way
+ * @note    Coordinates are pixels from the top left, like windowGetSize.
+ *          Build one with shapeRect, shapeRoundedRect, shapeCircle or
+ *          shapeLine, then set the border and shadow fields as needed
+ */
+typedef struct Shape {
+    Vec2 center;            /**< Center of the box */
+    Vec2 halfSize;          /**< Half width and half height, before rotation */
+    float rotation;         /**< Clockwise on screen, in radians */
+    float cornerRadius;     /**< At most the smaller half size */
+    float borderWidth;      /**< Drawn inside the edge, 0 for none */
+    float fill[4];          /**< RGBA, straight alpha */
+    float border[4];        /**< RGBA, straight alpha */
+    float shadow[4];        /**< RGBA, straight alpha, alpha 0 for none */
+    Vec2 shadowOffset;      /**< Shadow displacement in pixels, ±32767 */
+    float shadowBlur;       /**< Shadow softness in pixels */
+    uint16_t clip;          /**< Clip index, see clipGetIndex, 0 for none */
+} Shape;
+
+/**
+ * @brief   A Shape as stored for the GPU, 40 bytes per instance
+ * @note    Style parameters are half floats, offsets 16-bit integers and
+ *          colors 8 bits per channel. Clip indices are kept apart and only
+ *          uploaded when a shape is clipped
+ */
+typedef struct ShapeInstance {
+    float center[2];
+    float halfSize[2];
+    uint16_t params[4];     /**< rotation, corner radius, border, blur */
+    int16_t shadowOffset[2];
+    uint8_t fill[4];
+    uint8_t border[4];
+    uint8_t shadow[4];
+} ShapeInstance;
+
+/**
+ * @brief   Opaque type to ShapeBatch struct
+ * @note    Collects shapes for one instanced draw call, each shape is a quad
+ *          whose fragment shader evaluates the signed distance to the box
+ */
+typedef struct _ShapeBatch ShapeBatch;
+
+/**
+ * @brief   Shape filling a rect
+ * @param   rect: Rect, in pixels
+ * @param   fill: RGBA color, straight alpha
+ * @returns Shape without border or shadow
+ */
+HELPER Shape shapeRect(Rect rect, const float fill[4]) {
+    Shape shape = {
+        .center = { (rect.min.x + rect.max.x) * 0.5f,
+                    (rect.min.y + rect.max.y) * 0.5f },
+        .halfSize = { (rect.max.x - rect.min.x) * 0.5f,
+                      (rect.max.y - rect.min.y) * 0.5f }
+    };
+    for (int i = 0; i < 4; i++)
+        shape.fill[i] = fill[i];
+    return shape;
+}
+
+/**
+ * @brief   Shape filling a rect with rounded corners
+ * @param   rect: Rect, in pixels
+ * @param   radius: float, corner radius in pixels
+ * @param   fill: RGBA color, straight alpha
+ * @returns Shape without border or shadow
+ */
+HELPER Shape shapeRoundedRect(Rect rect, float radius, const float fill[4]) {
+    Shape shape = shapeRect(rect, fill);
+    shape.cornerRadius = radius;
+    return shape;
+}
+
+/**
+ * @brief   Shape filling a circle
+ * @param   center: Vec2, in pixels
+ * @param   radius: float, in pixels
+ * @param   fill: RGBA color, straight alpha
+ * @returns Shape without border or shadow
+ */
+HELPER Shape shapeCircle(Vec2 center, float radius, const float fill[4]) {
+    Shape shape = shapeRect((Rect) { { center.x - radius, center.y - radius },
+                                     { center.x + radius, center.y + radius } },
+                            fill);
+    shape.cornerRadius = radius;
+    return shape;
+}
+
+/**
+ * @brief   Shape covering a line with round caps
+ * @param   start: Vec2, first end point in pixels
+ * @param   end: Vec2, second end point in pixels
+ * @param   thickness: float, width of the line in pixels
+ * @param   fill: RGBA color, straight alpha
+ * @returns Shape without border or shadow
+ */
+HELPER Shape shapeLine(Vec2 start, Vec2 end, float thickness,
+                       const float fill[4]) {
+    Vec2 delta = vec2Sub(end, start);
+    float half = thickness * 0.5f;
+    Shape shape = shapeRect((Rect) { { 0, 0 }, { 0, 0 } }, fill);
+    shape.center = vec2Lerp(start, end, 0.5f);
+    shape.halfSize = (Vec2) { vec2Length(delta) * 0.5f + half, half };
+    shape.rotation = atan2f(delta.y, delta.x);
+    shape.cornerRadius = half;
+    return shape;
+}
+
+/**
+ * @brief   Create a new, empty shape batch
+ * @param   expectedShapes: uint32_t, number of shapes to reserve storage for
+ * @returns Pointer to a new ShapeBatch, NULL on failure
+ * @see     ShapeBatch
+ */
+TGAPI ShapeBatch* shapeBatchNew(uint32_t expectedShapes);
+
+/**
+ * @brief   Pack a shape and append it, shapes are drawn in order
+ * @param   batch: Pointer to the shape batch
+ * @param   shape: Pointer to the shape, copied
+ * @returns 1 on success, 0 if storage ran out
+ */
+TGAPI uint8_t shapeBatchAdd(ShapeBatch* batch, const Shape* shape);
+
+/**
+ * @brief   Remove every shape, storage is kept for the next frame
+ * @param   batch: Pointer to the shape batch
+ * @returns void
+ */
+TGAPI void shapeBatchClear(ShapeBatch* batch);
+
+/**
+ * @param   batch: Pointer to the shape batch
+ * @param   count: receives the number of shapes
+ * @returns Packed instances in draw order, valid until the next add
+ */
+TGAPI const ShapeInstance* shapeBatchGetInstances(ShapeBatch* batch,
+                                                  uint32_t* count);
+
+/**
+ * @brief   Draw every shape with a single instanced draw call
+ * @param   batch: Pointer to the shape batch
+ * @param   viewSize: Vec2, size of the viewport in pixels, see windowGetSize
+ * @returns void
+ * @note    Blends premultiplied, the output of each shape is its shadow,
+ *          then its fill, then its border
+ */
+TGAPI void shapeBatchDraw(ShapeBatch* batch, Vec2 viewSize);
+
+/**
+ * @brief   Draw every shape with a single instanced draw call, each clipped
+ *          to the rect its clip index selects
+ * @param   batch: Pointer to the shape batch
+ * @param   viewSize: Vec2, size of the viewport in pixels, see windowGetSize
+ * @param   clips: clip rects indexed by Shape.clip, see clipGetRects
+ * @param   clipCount: uint32_t, number of rects, at most CLIP_MAX_RECTS
+ * @returns void
+ * @note    Shapes in different clips share the draw call, the GPU clips
+ *          each one against its rect. Without clipped shapes this is
+ *          shapeBatchDraw
+ */
+TGAPI void shapeBatchDrawClipped(ShapeBatch* batch, Vec2 viewSize,
+                                 const Rect* clips, uint32_t clipCount);
+
+/**
+ * @brief   Signed distance from a point to the edge of a shape, the same
+ *          function the fragment shader evaluates
+ * @param   shape: Pointer to the shape
+ * @param   point: Vec2, in pixels
+ * @returns Distance in pixels, negative inside the shape
+ * @note    Useful for hit testing, a point is on the shape when <= 0
+ */
+TGAPI float shapeDistance(const Shape* shape, Vec2 point);
+
+/**
+ * @brief   Free the batch, on the CPU and the GPU
+ * @param   batch: Pointer to the shape batch
+ * @returns void
+ */
+TGAPI void shapeBatchDestroy(ShapeBatch* batch);
+
+#endif // SHAPE_H
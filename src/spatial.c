@@ -0,0 +1,437 @@
+#define TG_MEMORY_TAG MEMORY_TAG_SPATIAL
+
+// get function defines
+#include "spatial.h"
+#include "array_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+// Marks the end of a chain, or an unused slot
+#define SPATIAL_NONE 0xFFFFFFFFu
+
+// Items covering more cells than this are kept in a separate list that every
+// query walks, so one huge background sprite can't flood the grid
+#define SPATIAL_MAX_ITEM_CELLS 64
+
+// One per (item, cell) pair, chained both into its bucket and its item
+typedef struct SpatialEntryInternal {
+    int32_t cellX, cellY;   // cell this entry sits in, buckets are shared
+    uint32_t item;          // owning item, SPATIAL_NONE when free
+    uint32_t prev, next;    // bucket chain
+    uint32_t itemNext;      // next entry of the same item, or free list link
+} SpatialEntryInternal;
+
+typedef struct SpatialItemInternal {
+    Rect bounds;
+    void* userData;
+    int32_t x0, y0, x1, y1;     // covered cell range, inclusive
+    uint32_t firstEntry;        // head of the entry chain
+    uint32_t oversizedIndex;    // slot in the oversized list, or SPATIAL_NONE
+    uint32_t queryMark;         // stamp of the last query that visited it
+    uint32_t nextFree;          // free list link, SPATIAL_NONE when alive
+    uint8_t alive;
+} SpatialItemInternal;
+
+// Internal Struct
+struct _SpatialGrid {
+    float cellSize, invCellSize;
+
+    SpatialItemInternal* items;
+    uint32_t itemCount, itemCapacity, freeItem, liveItems;
+
+    SpatialEntryInternal* entries;
+    uint32_t entryCount, entryCapacity, freeEntry, liveEntries;
+
+    uint32_t* buckets;      // head entry of every bucket
+    uint32_t bucketMask;    // bucket count - 1, count is a power of two
+
+    SpatialHandle* oversized;
+    uint32_t oversizedCount, oversizedCapacity;
+
+    uint32_t queryStamp;    // bumped per query, dedups multi-cell items
+};
+
+PRIVATE uint32_t internal_spatialHash(const SpatialGrid* grid,
+                                      int32_t x, int32_t y) {
+    uint32_t h = ((uint32_t) x * 73856093u) ^ ((uint32_t) y * 19349663u);
+    return (h ^ (h >> 16)) & grid->bucketMask;
+}
+
+// Cells further out are clamped, spans between two cells still fit int32
+#define SPATIAL_CELL_LIMIT 536870912.0f
+
+PRIVATE int32_t internal_spatialCell(const SpatialGrid* grid, float value) {
+    float cell = floorf(value * grid->invCellSize);
+    if (!(cell > -SPATIAL_CELL_LIMIT))     // NaN lands here too
+        cell = -SPATIAL_CELL_LIMIT;
+    else if (cell > SPATIAL_CELL_LIMIT)
+        cell = SPATIAL_CELL_LIMIT;
+    return (int32_t) cell;
+}
+
+PRIVATE void internal_spatialBucketPush(SpatialGrid* grid, uint32_t index) {
+    SpatialEntryInternal* entry = &grid->entries[index];
+    uint32_t bucket = internal_spatialHash(grid, entry->cellX, entry->cellY);
+    entry->prev = SPATIAL_NONE;
+    entry->next = grid->buckets[bucket];
+    if (entry->next != SPATIAL_NONE)
+        grid->entries[entry->next].prev = index;
+    grid->buckets[bucket] = index;
+}
+
+// Double the bucket table and relink every live entry, keeps chains short
+PRIVATE int internal_spatialRehash(SpatialGrid* grid) {
+    uint32_t bucketCount = (grid->bucketMask + 1) * 2;
+    uint32_t* buckets = TG_MALLOC(sizeof(uint32_t) * bucketCount);
+    if (!buckets)
+        return 0;
+    memset(buckets, 0xFF, sizeof(uint32_t) * bucketCount);
+    TG_FREE(grid->buckets);
+    grid->buckets = buckets;
+    grid->bucketMask = bucketCount - 1;
+
+    for (uint32_t i = 0; i < grid->entryCount; i++)
+        if (grid->entries[i].item != SPATIAL_NONE)
+            internal_spatialBucketPush(grid, i);
+    return 1;
+}
+
+PRIVATE void internal_spatialUnlink(SpatialGrid* grid, SpatialHandle handle) {
+    SpatialItemInternal* item = &grid->items[handle];
+
+    // oversized items live in a flat list, swap the last one into the hole
+    if (item->oversizedIndex != SPATIAL_NONE) {
+        SpatialHandle last = grid->oversized[--grid->oversizedCount];
+        grid->oversized[item->oversizedIndex] = last;
+        grid->items[last].oversizedIndex = item->oversizedIndex;
+        item->oversizedIndex = SPATIAL_NONE;
+        return;
+    }
+
+    uint32_t index = item->firstEntry;
+    while (index != SPATIAL_NONE) {
+        SpatialEntryInternal* entry = &grid->entries[index];
+        uint32_t following = entry->itemNext;
+
+        if (entry->prev != SPATIAL_NONE)
+            grid->entries[entry->prev].next = entry->next;
+        else
+            grid->buckets[internal_spatialHash(grid, entry->cellX,
+                                               entry->cellY)] = entry->next;
+        if (entry->next != SPATIAL_NONE)
+            grid->entries[entry->next].prev = entry->prev;
+
+        entry->item = SPATIAL_NONE;
+        entry->itemNext = grid->freeEntry;
+        grid->freeEntry = index;
+        grid->liveEntries--;
+        index = following;
+    }
+    item->firstEntry = SPATIAL_NONE;
+}
+
+// Register the item in every cell of its current cell range
+PRIVATE int internal_spatialLink(SpatialGrid* grid, SpatialHandle handle) {
+    SpatialItemInternal* item = &grid->items[handle];
+    uint64_t cells = (uint64_t) (item->x1 - item->x0 + 1) *
+                     (uint64_t) (item->y1 - item->y0 + 1);
+
+    if (cells > SPATIAL_MAX_ITEM_CELLS) {
+        if (!internal_arrayReserve((void**) &grid->oversized,
+                                   &grid->oversizedCapacity,
+                                   sizeof(SpatialHandle),
+                                   grid->oversizedCount + 1))
+            return 0;
+        item->oversizedIndex = grid->oversizedCount;
+        grid->oversized[grid->oversizedCount++] = handle;
+        return 1;
+    }
+
+    // Reserve up front, so a failed allocation never leaves a half link
+    uint32_t reused = 0;
+    for (uint32_t i = grid->freeEntry; i != SPATIAL_NONE && reused < cells;
+         i = grid->entries[i].itemNext)
+        reused++;
+    if (!internal_arrayReserve((void**) &grid->entries, &grid->entryCapacity,
+                               sizeof(SpatialEntryInternal),
+                               grid->entryCount + (uint32_t) cells - reused))
+        return 0;
+    item = &grid->items[handle];
+
+    for (int32_t y = item->y0; y <= item->y1; y++) {
+        for (int32_t x = item->x0; x <= item->x1; x++) {
+            uint32_t index = grid->freeEntry;
+            if (index != SPATIAL_NONE)
+                grid->freeEntry = grid->entries[index].itemNext;
+            else
+                index = grid->entryCount++;
+
+            SpatialEntryInternal* entry = &grid->entries[index];
+            entry->cellX = x;
+            entry->cellY = y;
+            entry->item = handle;
+            entry->itemNext = item->firstEntry;
+            item->firstEntry = index;
+            internal_spatialBucketPush(grid, index);
+            grid->liveEntries++;
+        }
+    }
+
+    // rehash failing only costs longer chains, the grid stays valid
+    if (grid->liveEntries > grid->bucketMask + 1)
+        internal_spatialRehash(grid);
+    return 1;
+}
+
+PRIVATE void internal_spatialSetRange(SpatialGrid* grid,
+                                      SpatialItemInternal* item) {
+    item->x0 = internal_spatialCell(grid, item->bounds.min.x);
+    item->y0 = internal_spatialCell(grid, item->bounds.min.y);
+    item->x1 = internal_spatialCell(grid, item->bounds.max.x);
+    item->y1 = internal_spatialCell(grid, item->bounds.max.y);
+}
+
+// Every query gets a fresh stamp, items are reported when their mark differs
+PRIVATE uint32_t internal_spatialNextStamp(SpatialGrid* grid) {
+    if (++grid->queryStamp == 0) {
+        for (uint32_t i = 0; i < grid->itemCount; i++)
+            grid->items[i].queryMark = 0;
+        grid->queryStamp = 1;
+    }
+    return grid->queryStamp;
+}
+
+PRIVATE int internal_spatialIsAlive(const SpatialGrid* grid,
+                                    SpatialHandle handle) {
+    return handle < grid->itemCount && grid->items[handle].alive;
+}
+
+SpatialGrid* spatialGridNew(float cellSize, uint32_t expectedItems) {
+    if (!(cellSize > 0.0f))
+        return NULL;
+
+    SpatialGrid* grid = ALLOC_S(SpatialGrid);
+    if (!grid)
+        return NULL;
+    memset(grid, 0, sizeof(SpatialGrid));
+    grid->cellSize = cellSize;
+    grid->invCellSize = 1.0f / cellSize;
+    grid->freeItem = SPATIAL_NONE;
+    grid->freeEntry = SPATIAL_NONE;
+
+    uint32_t bucketCount = 64;
+    while (bucketCount < expectedItems)
+        bucketCount *= 2;
+    grid->buckets = TG_MALLOC(sizeof(uint32_t) * bucketCount);
+    if (!grid->buckets) {
+        TG_FREE(grid);
+        return NULL;
+    }
+    memset(grid->buckets, 0xFF, sizeof(uint32_t) * bucketCount);
+    grid->bucketMask = bucketCount - 1;
+
+    // only a hint, inserts grow the arrays again if this fails
+    internal_arrayReserve((void**) &grid->items, &grid->itemCapacity,
+                          sizeof(SpatialItemInternal), expectedItems);
+    internal_arrayReserve((void**) &grid->entries, &grid->entryCapacity,
+                          sizeof(SpatialEntryInternal), expectedItems);
+    return grid;
+}
+
+SpatialHandle spatialGridInsert(SpatialGrid* grid, Rect bounds,
+                                void* userData) {
+    SpatialHandle handle = grid->freeItem;
+    if (handle != SPATIAL_NONE) {
+        grid->freeItem = grid->items[handle].nextFree;
+    } else {
+        if (!internal_arrayReserve((void**) &grid->items,
+                                   &grid->itemCapacity,
+                                   sizeof(SpatialItemInternal),
+                                   grid->itemCount + 1))
+            return SPATIAL_INVALID_HANDLE;
+        handle = grid->itemCount++;
+    }
+
+    SpatialItemInternal* item = &grid->items[handle];
+    item->bounds = bounds;
+    item->userData = userData;
+    item->firstEntry = SPATIAL_NONE;
+    item->oversizedIndex = SPATIAL_NONE;
+    item->queryMark = 0;
+    item->nextFree = SPATIAL_NONE;
+    item->alive = 1;
+    internal_spatialSetRange(grid, item);
+
+    if (!internal_spatialLink(grid, handle)) {
+        item = &grid->items[handle];
+        item->alive = 0;
+        item->nextFree = grid->freeItem;
+        grid->freeItem = handle;
+        return SPATIAL_INVALID_HANDLE;
+    }
+    grid->liveItems++;
+    return handle;
+}
+
+void spatialGridMove(SpatialGrid* grid, SpatialHandle handle, Rect bounds) {
+    if (!internal_spatialIsAlive(grid, handle))
+        return;
+
+    SpatialItemInternal* item = &grid->items[handle];
+    SpatialItemInternal moved = *item;
+    moved.bounds = bounds;
+    internal_spatialSetRange(grid, &moved);
+
+    // Most moves stay inside the same cells, only the box changes
+    if (moved.x0 == item->x0 && moved.y0 == item->y0 &&
+        moved.x1 == item->x1 && moved.y1 == item->y1) {
+        item->bounds = bounds;
+        return;
+    }
+
+    internal_spatialUnlink(grid, handle);
+    item->bounds = bounds;
+    item->x0 = moved.x0;
+    item->y0 = moved.y0;
+    item->x1 = moved.x1;
+    item->y1 = moved.y1;
+    if (!internal_spatialLink(grid, handle))
+        spatialGridRemove(grid, handle);    // out of memory, drop the item
+}
+
+void spatialGridRemove(SpatialGrid* grid, SpatialHandle handle) {
+    if (!internal_spatialIsAlive(grid, handle))
+        return;
+
+    internal_spatialUnlink(grid, handle);
+    SpatialItemInternal* item = &grid->items[handle];
+    item->alive = 0;
+    item->userData = NULL;
+    item->nextFree = grid->freeItem;
+    grid->freeItem = handle;
+    grid->liveItems--;
+}
+
+uint32_t spatialGridQueryRect(SpatialGrid* grid, Rect area,
+                              SpatialHandle* out, uint32_t capacity) {
+    uint32_t found = 0;
+
+    for (uint32_t i = 0; i < grid->oversizedCount; i++) {
+        SpatialHandle handle = grid->oversized[i];
+        if (rectOverlaps(grid->items[handle].bounds, area)) {
+            if (found < capacity)
+                out[found] = handle;
+            found++;
+        }
+    }
+
+    int32_t x0 = internal_spatialCell(grid, area.min.x);
+    int32_t y0 = internal_spatialCell(grid, area.min.y);
+    int32_t x1 = internal_spatialCell(grid, area.max.x);
+    int32_t y1 = internal_spatialCell(grid, area.max.y);
+    uint64_t cells = (uint64_t) ((int64_t) x1 - x0 + 1) *
+                     (uint64_t) ((int64_t) y1 - y0 + 1);
+
+    // An area larger than the occupied grid is cheaper to answer linearly
+    if (cells > grid->liveEntries) {
+        for (SpatialHandle handle = 0; handle < grid->itemCount; handle++) {
+            const SpatialItemInternal* item = &grid->items[handle];
+            if (!item->alive || item->oversizedIndex != SPATIAL_NONE)
+                continue;
+            if (rectOverlaps(item->bounds, area)) {
+                if (found < capacity)
+                    out[found] = handle;
+                found++;
+            }
+        }
+        return found;
+    }
+
+    uint32_t stamp = internal_spatialNextStamp(grid);
+    for (int32_t y = y0; y <= y1; y++) {
+        for (int32_t x = x0; x <= x1; x++) {
+            uint32_t index = grid->buckets[internal_spatialHash(grid, x, y)];
+            while (index != SPATIAL_NONE) {
+                const SpatialEntryInternal* entry = &grid->entries[index];
+                index = entry->next;
+                if (entry->cellX != x || entry->cellY != y)
+                    continue;   // another cell sharing the bucket
+
+                SpatialItemInternal* item = &grid->items[entry->item];
+                if (item->queryMark == stamp)
+                    continue;   // already seen through another cell
+                item->queryMark = stamp;
+                if (rectOverlaps(item->bounds, area)) {
+                    if (found < capacity)
+                        out[found] = entry->item;
+                    found++;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+uint32_t spatialGridQueryPoint(SpatialGrid* grid, Vec2 point,
+                               SpatialHandle* out, uint32_t capacity) {
+    uint32_t found = 0;
+
+    for (uint32_t i = 0; i < grid->oversizedCount; i++) {
+        SpatialHandle handle = grid->oversized[i];
+        if (rectContainsPoint(grid->items[handle].bounds, point)) {
+            if (found < capacity)
+                out[found] = handle;
+            found++;
+        }
+    }
+
+    // a single cell holds each item at most once, no stamp needed
+    int32_t x = internal_spatialCell(grid, point.x);
+    int32_t y = internal_spatialCell(grid, point.y);
+    uint32_t index = grid->buckets[internal_spatialHash(grid, x, y)];
+    while (index != SPATIAL_NONE) {
+        const SpatialEntryInternal* entry = &grid->entries[index];
+        index = entry->next;
+        if (entry->cellX != x || entry->cellY != y)
+            continue;
+        if (rectContainsPoint(grid->items[entry->item].bounds, point)) {
+            if (found < capacity)
+                out[found] = entry->item;
+            found++;
+        }
+    }
+    return found;
+}
+
+uint32_t spatialGridQueryView(SpatialGrid* grid, Vec2 origin, Vec2 viewSize,
+                              SpatialHandle* out, uint32_t capacity) {
+    Rect view = rectFromSize(origin, viewSize);
+    return spatialGridQueryRect(grid, view, out, capacity);
+}
+
+Rect spatialGridGetBounds(SpatialGrid* grid, SpatialHandle handle) {
+    if (!internal_spatialIsAlive(grid, handle))
+        return (Rect) { { 0.0f, 0.0f }, { 0.0f, 0.0f } };
+    return grid->items[handle].bounds;
+}
+
+void* spatialGridGetUserData(SpatialGrid* grid, SpatialHandle handle) {
+    if (!internal_spatialIsAlive(grid, handle))
+        return NULL;
+    return grid->items[handle].userData;
+}
+
+uint32_t spatialGridGetCount(SpatialGrid* grid) {
+    return grid->liveItems;
+}
+
+void spatialGridDestroy(SpatialGrid* grid) {
+    if (!grid)
+        return;
+    TG_FREE(grid->items);
+    TG_FREE(grid->entries);
+    TG_FREE(grid->buckets);
+    TG_FREE(grid->oversized);
+    TG_FREE(grid);
+}
@@ -0,0 +1,139 @@
+// Spatial index public API
+
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "defines.h"
+
+/**
+ * @brief   Opaque type to SpatialGrid struct
+ * @note    A hashed uniform grid, cells are only stored when occupied,
+ *          so the world does not need fixed bounds
+ */
+typedef struct _SpatialGrid SpatialGrid;
+
+/**
+ * @brief   Handle to an item stored in a SpatialGrid
+ */
+typedef uint32_t SpatialHandle;
+
+/**
+ * @def SPATIAL_INVALID_HANDLE
+ * @brief Returned when an item could not be inserted
+ */
+#define SPATIAL_INVALID_HANDLE 0xFFFFFFFFu
+
+/**
+ * @brief   Create a new spatial grid
+ * @param   cellSize: float, width and height of a cell in world units
+ * @param   expectedItems: uint32_t, number of items to reserve storage for
+ * @returns Pointer to a new SpatialGrid, NULL on failure
+ * @note    A cell size close to the typical item size works best
+ * @see     SpatialGrid
+ */
+TGAPI SpatialGrid* spatialGridNew(float cellSize, uint32_t expectedItems);
+
+/**
+ * @brief   Insert an item into the grid
+ * @param   grid: Pointer to the grid
+ * @param   bounds: Rect, bounding box of the item
+ * @param   userData: pointer handed back by spatialGridGetUserData
+ * @returns Handle to the item, SPATIAL_INVALID_HANDLE on failure
+ * @note    May allocate, when the grid needs to grow
+ * @see     SpatialGrid, Rect
+ */
+TGAPI SpatialHandle spatialGridInsert(SpatialGrid* grid, Rect bounds,
+                                      void* userData);
+
+/**
+ * @brief   Update the bounds of an item
+ * @param   grid: Pointer to the grid
+ * @param   handle: SpatialHandle, item to move
+ * @param   bounds: Rect, new bounding box
+ * @returns void
+ * @note    Moves that stay within the same cells do not touch the grid
+ * @see     SpatialGrid, Rect
+ */
+TGAPI void spatialGridMove(SpatialGrid* grid, SpatialHandle handle,
+                           Rect bounds);
+
+/**
+ * @brief   Remove an item from the grid, the handle may be reused later
+ * @param   grid: Pointer to the grid
+ * @param   handle: SpatialHandle, item to remove
+ * @returns void
+ * @see     SpatialGrid
+ */
+TGAPI void spatialGridRemove(SpatialGrid* grid, SpatialHandle handle);
+
+/**
+ * @brief   Find every item overlapping an area
+ * @param   grid: Pointer to the grid
+ * @param   area: Rect, region to search
+ * @param   out: array receiving the handles, may be NULL if capacity is 0
+ * @param   capacity: uint32_t, number of handles out can hold
+ * @returns Total number of overlapping items, which may exceed capacity.
+ *          Only the first capacity handles are written
+ * @note    Does not allocate, each item is reported once
+ * @see     SpatialGrid, Rect
+ */
+TGAPI uint32_t spatialGridQueryRect(SpatialGrid* grid, Rect area,
+                                    SpatialHandle* out, uint32_t capacity);
+
+/**
+ * @brief   Find every item containing a point, for mouse hit tests
+ * @param   grid: Pointer to the grid
+ * @param   point: Vec2, point to test
+ * @param   out: array receiving the handles, may be NULL if capacity is 0
+ * @param   capacity: uint32_t, number of handles out can hold
+ * @returns Total number of items under the point, see spatialGridQueryRect
+ * @see     SpatialGrid, Vec2
+ */
+TGAPI uint32_t spatialGridQueryPoint(SpatialGrid* grid, Vec2 point,
+                                     SpatialHandle* out, uint32_t capacity);
+
+/**
+ * @brief   Find every item visible in a view
+ * @param   grid: Pointer to the grid
+ * @param   origin: Vec2, world position of the top left corner of the view
+ * @param   viewSize: Vec2, size of the view, see windowGetSize
+ * @param   out: array receiving the handles, may be NULL if capacity is 0
+ * @param   capacity: uint32_t, number of handles out can hold
+ * @returns Total number of visible items, see spatialGridQueryRect
+ * @see     SpatialGrid, windowGetSize
+ */
+TGAPI uint32_t spatialGridQueryView(SpatialGrid* grid, Vec2 origin,
+                                    Vec2 viewSize, SpatialHandle* out,
+                                    uint32_t capacity);
+
+/**
+ * @param   grid: Pointer to the grid
+ * @param   handle: SpatialHandle, item to look up
+ * @returns Bounding box of the item
+ */
+TGAPI Rect spatialGridGetBounds(SpatialGrid* grid, SpatialHandle handle);
+
+/**
+ * @param   grid: Pointer to the grid
+ * @param   handle: SpatialHandle, item to look up
+ * @returns userData pointer passed on insertion
+ */
+TGAPI void* spatialGridGetUserData(SpatialGrid* grid, SpatialHandle handle);
+
+/**
+ * @param   grid: Pointer to the grid
+ * @returns Number of items currently stored
+ */
+TGAPI uint32_t spatialGridGetCount(SpatialGrid* grid);
+
+/**
+ * @brief   Free the grid and all of its storage
+ * @param   grid: Pointer to the grid
+ * @returns void
+ */
+TGAPI void spatialGridDestroy(SpatialGrid* grid);
+
+#endif // SPATIAL_H
@@ -0,0 +1,298 @@
+#define TG_MEMORY_TAG MEMORY_TAG_TEXTURE
+
+// get function defines
+#include "texture.h"
+#include "texture_internal.h"
+#include "window_internal.h"
+#include "timer.h"
+#include "trace.h"
+#include "gpu_memory.h"
+
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+// Internal Struct
+struct _Texture {
+    uint32_t handle;
+    uint32_t width, height;
+    uint32_t levels;        // mip levels allocated, 1 without mipmaps
+    PixelFormat format;
+    uint32_t flags;         // TextureFlags
+    uint64_t bytes;         // every level, as accounted in gpu_memory
+};
+
+static TextureStagingInternal fallbackStaging; // contexts not made by a Window
+static uint8_t* scratch;            // CPU mip chain, shared by all textures
+static size_t scratchSize;
+static uint32_t liveTextures;       // scratch is freed with the last texture
+static TextureStats frameStats;     // counters of the frame being built
+static TextureStats lastFrameStats; // counters of the last finished frame
+
+PRIVATE void internal_textureGlFormat(PixelFormat format, int32_t* internal,
+                                      uint32_t* layout) {
+    switch (format) {
+        case PIXEL_FORMAT_R8:
+            *internal = GL_R8;
+            *layout = GL_RED;
+            break;
+        case PIXEL_FORMAT_RGB8:
+            *internal = GL_RGB8;
+            *layout = GL_RGB;
+            break;
+        case PIXEL_FORMAT_RGBA8:
+        default:
+            *internal = GL_RGBA8;
+            *layout = GL_RGBA;
+            break;
+    }
+}
+
+// Staging ring of the current context's share group
+PRIVATE TextureStagingInternal* internal_textureStaging(void) {
+    WindowGroupInternal* group = internal_windowCurrentGroup();
+    return group ? &group->staging : &fallbackStaging;
+}
+
+void internal_textureStagingRelease(TextureStagingInternal* staging) {
+    if (staging->buffers[0])
+        glDeleteBuffers(TEXTURE_STAGING_COUNT, staging->buffers);
+    for (uint32_t i = 0; i < TEXTURE_STAGING_COUNT; i++)
+        if (staging->sizes[i])
+            gpuMemoryFreed(GPU_MEMORY_STAGING, staging->sizes[i]);
+    memset(staging, 0, sizeof(TextureStagingInternal));
+}
+
+// Copy pixels into the next staging buffer and submit them to one level
+PRIVATE void internal_textureStream(Texture* texture, uint32_t level,
+                                    uint32_t x, uint32_t y, uint32_t width,
+                                    uint32_t height, const void* pixels,
+                                    PixelFormat format, uint32_t stride,
+                                    uint8_t premultiply) {
+    size_t bytes = (size_t) width * height * pixelFormatSize(texture->format);
+    int32_t internal;
+    uint32_t layout;
+    internal_textureGlFormat(texture->format, &internal, &layout);
+
+    TextureStagingInternal* staging = internal_textureStaging();
+    if (!staging->buffers[0])
+        glGenBuffers(TEXTURE_STAGING_COUNT, staging->buffers);
+    uint32_t buffer = staging->buffers[staging->next];
+    if (staging->sizes[staging->next])
+        gpuMemoryFreed(GPU_MEMORY_STAGING, staging->sizes[staging->next]);
+    gpuMemoryAllocated(GPU_MEMORY_STAGING, bytes);
+    staging->sizes[staging->next] = bytes;
+    staging->next = (staging->next + 1) % TEXTURE_STAGING_COUNT;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    // orphan the old storage, the driver keeps it alive for pending copies
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr) bytes, NULL,
+                 GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0,
+                                    (GLsizeiptr) bytes,
+                                    GL_MAP_WRITE_BIT |
+                                    GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped) {
+        // convert straight into driver memory, no intermediate copy
+        pixelConvert(mapped, texture->format, pixels, format, width, height,
+                     stride, premultiply);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        glBindTexture(GL_TEXTURE_2D, texture->handle);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // rows are tightly packed
+        glTexSubImage2D(GL_TEXTURE_2D, (GLint) level, (GLint) x, (GLint) y,
+                        (GLsizei) width, (GLsizei) height, layout,
+                        GL_UNSIGNED_BYTE, (void*) 0);
+        frameStats.uploadBytes += bytes;
+        frameStats.uploadCount++;
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+PRIVATE uint8_t* internal_textureScratch(size_t size) {
+    if (size > scratchSize) {
+        uint8_t* grown = TG_REALLOC(scratch, size);
+        if (!grown)
+            return NULL;
+        scratch = grown;
+        scratchSize = size;
+    }
+    return scratch;
+}
+
+// Build every mip level on the CPU and stream them all
+PRIVATE uint8_t internal_textureUploadCpuMips(Texture* texture,
+                                              const void* pixels,
+                                              PixelFormat format) {
+    uint32_t size = pixelFormatSize(texture->format);
+    size_t base = (size_t) texture->width * texture->height * size;
+    size_t below = (size_t) (texture->width > 1 ? texture->width / 2 : 1) *
+                   (texture->height > 1 ? texture->height / 2 : 1) * size;
+    // the base level and the one below it, later levels reuse both halves
+    uint8_t* chain = internal_textureScratch(base + below);
+    if (!chain)
+        return 0;
+
+    uint8_t* level = chain;
+    uint8_t* next = chain + base;
+    pixelConvert(level, texture->format, pixels, format, texture->width,
+                 texture->height, 0, texture->flags & TEXTURE_PREMULTIPLY);
+    internal_textureStream(texture, 0, 0, 0, texture->width, texture->height,
+                           level, texture->format, 0, 0);
+
+    uint32_t width = texture->width, height = texture->height;
+    for (uint32_t i = 1; i < texture->levels; i++) {
+        pixelDownsample(next, level, texture->format, width, height);
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+        internal_textureStream(texture, i, 0, 0, width, height, next,
+                               texture->format, 0, 0);
+        // ping pong, the new level lands where the previous one started
+        uint8_t* swap = level;
+        level = next;
+        next = swap;
+    }
+    return 1;
+}
+
+PRIVATE GpuMemoryCategory internal_textureCategory(Texture* texture) {
+    return (texture->flags & TEXTURE_RENDER_TARGET) ? GPU_MEMORY_RENDER_TARGET
+                                                    : GPU_MEMORY_TEXTURE;
+}
+
+Texture* textureNew(uint32_t width, uint32_t height, PixelFormat format,
+                    uint32_t flags) {
+    if (!width || !height)
+        return NULL;
+
+    Texture* texture = ALLOC_S(Texture);
+    if (!texture)
+        return NULL;
+    texture->width = width;
+    texture->height = height;
+    texture->format = format;
+    texture->flags = flags;
+    texture->levels = (flags & TEXTURE_MIPMAPS)
+                      ? pixelMipLevelCount(width, height) : 1;
+
+    int32_t internal;
+    uint32_t layout;
+    internal_textureGlFormat(format, &internal, &layout);
+
+    glGenTextures(1, &texture->handle);
+    glBindTexture(GL_TEXTURE_2D, texture->handle);
+    // allocate every level up front, uploads only ever fill them
+    texture->bytes = 0;
+    for (uint32_t i = 0; i < texture->levels; i++) {
+        uint32_t w = width >> i ? width >> i : 1;
+        uint32_t h = height >> i ? height >> i : 1;
+        glTexImage2D(GL_TEXTURE_2D, (GLint) i, internal, (GLsizei) w,
+                     (GLsizei) h, 0, layout, GL_UNSIGNED_BYTE, NULL);
+        texture->bytes += (uint64_t) w * h * pixelFormatSize(format);
+    }
+    gpuMemoryAllocated(internal_textureCategory(texture), texture->bytes);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                    (GLint) texture->levels - 1);
+
+    GLint magFilter = (flags & TEXTURE_NEAREST) ? GL_NEAREST : GL_LINEAR;
+    GLint minFilter = magFilter;
+    if (flags & TEXTURE_MIPMAPS)
+        minFilter = (flags & TEXTURE_NEAREST) ? GL_NEAREST_MIPMAP_NEAREST
+                                              : GL_LINEAR_MIPMAP_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    liveTextures++;
+    return texture;
+}
+
+void textureUpload(Texture* texture, const void* pixels, PixelFormat format) {
+    TRACE_FUNCTION();
+    uint64_t start = timerNow();
+
+    uint8_t done = 0;
+    if ((texture->flags & TEXTURE_MIPMAPS) &&
+        (texture->flags & TEXTURE_CPU_MIPMAPS))
+        done = internal_textureUploadCpuMips(texture, pixels, format);
+
+    // driver mips, or the scratch allocation failed
+    if (!done) {
+        internal_textureStream(texture, 0, 0, 0, texture->width,
+                               texture->height, pixels, format, 0,
+                               texture->flags & TEXTURE_PREMULTIPLY);
+        if (texture->flags & TEXTURE_MIPMAPS)
+            glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    frameStats.uploadTime += timerNow() - start;
+}
+
+void textureUploadRegion(Texture* texture, uint32_t x, uint32_t y,
+                         uint32_t width, uint32_t height, const void* pixels,
+                         PixelFormat format, uint32_t stride) {
+    if (x >= texture->width || y >= texture->height)
+        return;
+    // clip the region to the texture, keeping the source stride
+    if (!stride)
+        stride = width * pixelFormatSize(format);
+    if (width > texture->width - x)
+        width = texture->width - x;
+    if (height > texture->height - y)
+        height = texture->height - y;
+
+    TRACE_FUNCTION();
+    uint64_t start = timerNow();
+    internal_textureStream(texture, 0, x, y, width, height, pixels, format,
+                           stride, texture->flags & TEXTURE_PREMULTIPLY);
+    if (texture->flags & TEXTURE_MIPMAPS)
+        glGenerateMipmap(GL_TEXTURE_2D);
+    frameStats.uploadTime += timerNow() - start;
+}
+
+void textureBind(Texture* texture, uint32_t unit) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture->handle);
+}
+
+uint32_t textureGetHandle(Texture* texture) {
+    return texture->handle;
+}
+
+uint32_t textureGetWidth(Texture* texture) {
+    return texture->width;
+}
+
+uint32_t textureGetHeight(Texture* texture) {
+    return texture->height;
+}
+
+PixelFormat textureGetFormat(Texture* texture) {
+    return texture->format;
+}
+
+TextureStats textureGetFrameStats(void) {
+    return lastFrameStats;
+}
+
+void textureStatsEndFrame(void) {
+    lastFrameStats = frameStats;
+    memset(&frameStats, 0, sizeof(TextureStats));
+}
+
+void textureDestroy(Texture* texture) {
+    if (!texture)
+        return;
+    glDeleteTextures(1, &texture->handle);
+    gpuMemoryFreed(internal_textureCategory(texture), texture->bytes);
+    TG_FREE(texture);
+
+    // other share groups free their staging with their last window
+    if (--liveTextures == 0) {
+        internal_textureStagingRelease(internal_textureStaging());
+        TG_FREE(scratch);
+        scratch = NULL;
+        scratchSize = 0;
+    }
+}
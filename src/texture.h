@@ -0,0 +1,134 @@
+// Texture public API
+
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <stdint.h>
+
+#include "pixel.h"
+#include "defines.h"
+
+/**
+ * @brief   Opaque type to Texture struct
+ */
+typedef struct _Texture Texture;
+
+/**
+ * @brief   Options for textureNew, combine with bitwise or
+ */
+typedef enum TextureFlags {
+    TEXTURE_MIPMAPS     = 1 << 0,   /**< Allocate and fill a mip chain */
+    TEXTURE_CPU_MIPMAPS = 1 << 1,   /**< Build mips on the CPU, not the driver */
+    TEXTURE_PREMULTIPLY = 1 << 2,   /**< Premultiply alpha while uploading */
+    TEXTURE_NEAREST     = 1 << 3,   /**< Nearest filtering, for pixel art */
+    TEXTURE_RENDER_TARGET = 1 << 4  /**< Accounted as a render target */
+} TextureFlags;
+
+/**
+ * @brief   Upload counters, reset every frame
+ */
+typedef struct TextureStats {
+    uint64_t uploadBytes;   /**< Bytes copied into staging buffers */
+    uint64_t uploadTime;    /**< CPU nanoseconds spent converting and submitting */
+    uint32_t uploadCount;   /**< Number of texture updates submitted */
+} TextureStats;
+
+/**
+ * @brief   Create a new texture, the contents are undefined until uploaded
+ * @param   width: uint32_t, width in pixels
+ * @param   height: uint32_t, height in pixels
+ * @param   format: PixelFormat, format stored on the GPU
+ * @param   flags: uint32_t, TextureFlags
+ * @returns Pointer to a new Texture, NULL on failure
+ * @note    Needs a current OpenGL context
+ * @see     Texture, TextureFlags
+ */
+TGAPI Texture* textureNew(uint32_t width, uint32_t height, PixelFormat format,
+                          uint32_t flags);
+
+/**
+ * @brief   Replace the whole texture
+ * @param   texture: Pointer to the texture
+ * @param   pixels: tightly packed pixels, width x height of the texture
+ * @param   format: PixelFormat of pixels, converted to the texture format
+ * @returns void
+ * @note    Goes through a pixel unpack buffer, the GPU copy is asynchronous
+ * @see     Texture, PixelFormat
+ */
+TGAPI void textureUpload(Texture* texture, const void* pixels,
+                         PixelFormat format);
+
+/**
+ * @brief   Replace part of the texture, such as a new glyph in an atlas
+ * @param   texture: Pointer to the texture
+ * @param   x: uint32_t, left edge of the region
+ * @param   y: uint32_t, top edge of the region
+ * @param   width: uint32_t, width of the region
+ * @param   height: uint32_t, height of the region
+ * @param   pixels: pixels of the region
+ * @param   format: PixelFormat of pixels, converted to the texture format
+ * @param   stride: uint32_t, bytes between rows of pixels, 0 if tight
+ * @returns void
+ * @note    Mipmapped textures regenerate their mips through the driver
+ * @see     Texture, PixelFormat
+ */
+TGAPI void textureUploadRegion(Texture* texture, uint32_t x, uint32_t y,
+                               uint32_t width, uint32_t height,
+                               const void* pixels, PixelFormat format,
+                               uint32_t stride);
+
+/**
+ * @brief   Bind the texture to a texture unit
+ * @param   texture: Pointer to the texture
+ * @param   unit: uint32_t, texture unit index
+ * @returns void
+ */
+TGAPI void textureBind(Texture* texture, uint32_t unit);
+
+/**
+ * @param   texture: Pointer to the texture
+ * @returns OpenGL name of the texture
+ */
+TGAPI uint32_t textureGetHandle(Texture* texture);
+
+/**
+ * @param   texture: Pointer to the texture
+ * @returns Width of the texture in pixels
+ */
+TGAPI uint32_t textureGetWidth(Texture* texture);
+
+/**
+ * @param   texture: Pointer to the texture
+ * @returns Height of the texture in pixels
+ */
+TGAPI uint32_t textureGetHeight(Texture* texture);
+
+/**
+ * @param   texture: Pointer to the texture
+ * @returns PixelFormat stored on the GPU
+ */
+TGAPI PixelFormat textureGetFormat(Texture* texture);
+
+/**
+ * @brief   Get the upload counters of the last finished frame
+ * @returns Copy of the counters
+ * @see     TextureStats, textureStatsEndFrame
+ */
+TGAPI TextureStats textureGetFrameStats(void);
+
+/**
+ * @brief   Close the current frame of upload counters
+ * @returns void
+ * @note    windowRefresh calls this once every window has refreshed, only
+ *          call it when rendering without a Window
+ */
+TGAPI void textureStatsEndFrame(void);
+
+/**
+ * @brief   Free the texture, on the CPU and the GPU
+ * @param   texture: Pointer to the texture
+ * @returns void
+ */
+TGAPI void textureDestroy(Texture* texture);
+
+#endif // TEXTURE_H
@@ -0,0 +1,23 @@
+// Texture internal API, for the modules that own per context state
+
+#ifndef TEXTURE_INTERNAL_H
+#define TEXTURE_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Staging buffers are used round robin, so an upload never waits on the
+// previous one still being copied by the driver
+#define TEXTURE_STAGING_COUNT 3
+
+// Pixel unpack buffers of one share group, names mean nothing elsewhere
+typedef struct TextureStagingInternal {
+    uint32_t buffers[TEXTURE_STAGING_COUNT];    // 0 until the first upload
+    size_t sizes[TEXTURE_STAGING_COUNT];        // current storage
+    uint32_t next;
+} TextureStagingInternal;
+
+// Delete the buffers, a context of their share group has to be current
+void internal_textureStagingRelease(TextureStagingInternal* staging);
+
+#endif // TEXTURE_INTERNAL_H
@@ -0,0 +1,331 @@
+#define TG_MEMORY_TAG MEMORY_TAG_RENDER
+
+// get function defines
+#include "tilemap.h"
+#include "shader.h"
+#include "gpu_memory.h"
+#include "trace.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "../vendor/glad/gl.h"
+
+#define TILEMAP_CHUNK_TILES (TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE)
+
+// One instance per tile of a chunk, the position follows from the instance
+// index so the buffer only holds the tile values
+static const char* const tilemapVertex =
+    "#version 330 core\n"
+    "layout (location = 0) in uint aTile;\n"
+    "uniform vec2 uViewSize;\n"
+    "uniform vec2 uViewMin;\n"
+    "uniform vec2 uScale;\n"
+    "uniform vec2 uOrigin;\n"
+    "uniform float uTileSize;\n"
+    "uniform uvec2 uAtlasGrid;\n"
+    "uniform int uChunkSize;\n"
+    "out vec2 vUv;\n"
+    "void main() {\n"
+    "    vUv = vec2(0.0);\n"
+    "    if (aTile == 0u) {\n"
+    "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"     // clipped away
+    "        return;\n"
+    "    }\n"
+    "    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);\n"
+    "    uint image = aTile - 1u;\n"
+    "    vec2 cell = vec2(image % uAtlasGrid.x, image / uAtlasGrid.x);\n"
+    "    vUv = (cell + corner) / vec2(uAtlasGrid);\n"
+    "    vec2 tile = vec2(gl_InstanceID % uChunkSize,\n"
+    "                     gl_InstanceID / uChunkSize);\n"
+    "    vec2 position = uOrigin + (tile + corner) * uTileSize;\n"
+    "    vec2 ndc = (position - uViewMin) * uScale / uViewSize * 2.0 - 1.0;\n"
+    "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* const tilemapFragment =
+    "#version 330 core\n"
+    "in vec2 vUv;\n"
+    "uniform sampler2D uAtlas;\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    FragColor = texture(uAtlas, vUv);\n"
+    "}\n";
+
+typedef struct TilemapChunkInternal {
+    uint32_t buffer;        // 0 until the chunk is first drawn
+    uint32_t filled;        // tiles that are not empty
+    uint16_t dirtyFirst;    // tiles [dirtyFirst, dirtyEnd) wait for upload
+    uint16_t dirtyEnd;
+} TilemapChunkInternal;
+
+// Internal Struct
+struct _Tilemap {
+    uint32_t width, height;     // in tiles
+    uint32_t chunksX, chunksY;
+    float tileSize;
+    Texture* atlas;
+    uint32_t atlasColumns, atlasRows;
+
+    // chunk after chunk, row by row inside each, so a chunk uploads as is
+    uint16_t* tiles;
+    TilemapChunkInternal* chunks;
+    uint32_t* visible;          // scratch for draws, one slot per chunk
+    TilemapStats stats;
+
+    // drawing, created on the first draw
+    uint32_t drawProgram;
+    uint32_t drawVao;
+};
+
+Tilemap* tilemapNew(uint32_t width, uint32_t height, float tileSize,
+                    Texture* atlas, uint32_t atlasColumns,
+                    uint32_t atlasRows) {
+    if (!width || !height || !atlasColumns || !atlasRows)
+        return NULL;
+    Tilemap* tilemap = ALLOC_S(Tilemap);
+    if (!tilemap)
+        return NULL;
+    memset(tilemap, 0, sizeof(Tilemap));
+    tilemap->width = width;
+    tilemap->height = height;
+    tilemap->chunksX = (width + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+    tilemap->chunksY = (height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+    tilemap->tileSize = tileSize;
+    tilemap->atlas = atlas;
+    tilemap->atlasColumns = atlasColumns;
+    tilemap->atlasRows = atlasRows;
+
+    size_t chunkCount = (size_t) tilemap->chunksX * tilemap->chunksY;
+    tilemap->tiles = TG_CALLOC(chunkCount * TILEMAP_CHUNK_TILES,
+                               sizeof(uint16_t));
+    tilemap->chunks = TG_CALLOC(chunkCount, sizeof(TilemapChunkInternal));
+    tilemap->visible = TG_MALLOC(chunkCount * sizeof(uint32_t));
+    if (!tilemap->tiles || !tilemap->chunks || !tilemap->visible) {
+        tilemapDestroy(tilemap);
+        return NULL;
+    }
+    return tilemap;
+}
+
+PRIVATE void internal_tilemapWrite(Tilemap* tilemap, uint32_t x, uint32_t y,
+                                   uint16_t tile) {
+    uint32_t chunkIndex = (y / TILEMAP_CHUNK_SIZE) * tilemap->chunksX +
+                          x / TILEMAP_CHUNK_SIZE;
+    uint16_t local = (uint16_t) ((y % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE +
+                                 x % TILEMAP_CHUNK_SIZE);
+    uint16_t* slot = &tilemap->tiles[(size_t) chunkIndex * TILEMAP_CHUNK_TILES +
+                                     local];
+    if (*slot == tile)
+        return;
+
+    TilemapChunkInternal* chunk = &tilemap->chunks[chunkIndex];
+    chunk->filled += (tile != TILEMAP_EMPTY) - (*slot != TILEMAP_EMPTY);
+    *slot = tile;
+
+    // one range per chunk, uploaded with a single sub-buffer update
+    if (chunk->dirtyFirst == chunk->dirtyEnd) {
+        chunk->dirtyFirst = local;
+        chunk->dirtyEnd = local + 1;
+    } else {
+        if (local < chunk->dirtyFirst)
+            chunk->dirtyFirst = local;
+        if (local >= chunk->dirtyEnd)
+            chunk->dirtyEnd = local + 1;
+    }
+}
+
+uint8_t tilemapSetTile(Tilemap* tilemap, uint32_t x, uint32_t y,
+                       uint16_t tile) {
+    if (x >= tilemap->width || y >= tilemap->height)
+        return 0;
+    internal_tilemapWrite(tilemap, x, y, tile);
+    return 1;
+}
+
+uint8_t tilemapSetRegion(Tilemap* tilemap, uint32_t x, uint32_t y,
+                         uint32_t width, uint32_t height,
+                         const uint16_t* tiles) {
+    if (x > tilemap->width || width > tilemap->width - x ||
+        y > tilemap->height || height > tilemap->height - y)
+        return 0;
+    for (uint32_t row = 0; row < height; row++)
+        for (uint32_t column = 0; column < width; column++)
+            internal_tilemapWrite(tilemap, x + column, y + row,
+                                  tiles[(size_t) row * width + column]);
+    return 1;
+}
+
+uint16_t tilemapGetTile(Tilemap* tilemap, uint32_t x, uint32_t y) {
+    if (x >= tilemap->width || y >= tilemap->height)
+        return TILEMAP_EMPTY;
+    uint32_t chunkIndex = (y / TILEMAP_CHUNK_SIZE) * tilemap->chunksX +
+                          x / TILEMAP_CHUNK_SIZE;
+    return tilemap->tiles[(size_t) chunkIndex * TILEMAP_CHUNK_TILES +
+                          (y % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE +
+                          x % TILEMAP_CHUNK_SIZE];
+}
+
+// Chunks [*first, *end) along one axis overlapping [low, high) in pixels
+PRIVATE void internal_tilemapSpan(float low, float high, float chunkPixels,
+                                  uint32_t chunks, uint32_t* first,
+                                  uint32_t* end) {
+    float from = floorf(low / chunkPixels);
+    float to = ceilf(high / chunkPixels);
+    from = from > 0.0f ? from : 0.0f;
+    to = to < (float) chunks ? to : (float) chunks;
+    *first = (uint32_t) from;
+    *end = to > from ? (uint32_t) to : *first;
+}
+
+uint32_t tilemapCollectVisible(Tilemap* tilemap, Rect view, uint32_t* chunks,
+                               uint32_t maxChunks) {
+    float chunkPixels = tilemap->tileSize * TILEMAP_CHUNK_SIZE;
+    uint32_t firstX, endX, firstY, endY;
+    internal_tilemapSpan(view.min.x, view.max.x, chunkPixels,
+                         tilemap->chunksX, &firstX, &endX);
+    internal_tilemapSpan(view.min.y, view.max.y, chunkPixels,
+                         tilemap->chunksY, &firstY, &endY);
+
+    uint32_t written = 0;
+    for (uint32_t chunkY = firstY; chunkY < endY; chunkY++) {
+        for (uint32_t chunkX = firstX; chunkX < endX; chunkX++) {
+            uint32_t index = chunkY * tilemap->chunksX + chunkX;
+            if (!tilemap->chunks[index].filled)
+                continue;
+            if (written == maxChunks)
+                return written;
+            chunks[written++] = index;
+        }
+    }
+    return written;
+}
+
+uint8_t tilemapGetPendingUpload(Tilemap* tilemap, uint32_t chunk,
+                                uint32_t* first, uint32_t* count) {
+    TilemapChunkInternal* state = &tilemap->chunks[chunk];
+    if (!state->buffer) {
+        *first = 0;
+        *count = TILEMAP_CHUNK_TILES;
+        return 1;
+    }
+    *first = state->dirtyFirst;
+    *count = (uint32_t) (state->dirtyEnd - state->dirtyFirst);
+    return *count != 0;
+}
+
+PRIVATE uint8_t internal_tilemapDrawCreate(Tilemap* tilemap) {
+    tilemap->drawProgram = shaderCompile(tilemapVertex, tilemapFragment);
+    if (!tilemap->drawProgram)
+        return 0;
+    // the attribute is pointed at each chunk's buffer while drawing
+    glGenVertexArrays(1, &tilemap->drawVao);
+    glBindVertexArray(tilemap->drawVao);
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    return 1;
+}
+
+// Create the chunk's buffer or patch its pending range
+PRIVATE void internal_tilemapUpload(Tilemap* tilemap, uint32_t index) {
+    TilemapChunkInternal* chunk = &tilemap->chunks[index];
+    const uint16_t* tiles = tilemap->tiles + (size_t) index *
+                                             TILEMAP_CHUNK_TILES;
+    if (!chunk->buffer) {
+        glGenBuffers(1, &chunk->buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, chunk->buffer);
+        glBufferData(GL_ARRAY_BUFFER, TILEMAP_CHUNK_TILES * sizeof(uint16_t),
+                     tiles, GL_STATIC_DRAW);
+        gpuMemoryAllocated(GPU_MEMORY_BUFFER,
+                           TILEMAP_CHUNK_TILES * sizeof(uint16_t));
+        tilemap->stats.chunksBuilt++;
+        tilemap->stats.uploadBytes += TILEMAP_CHUNK_TILES * sizeof(uint16_t);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, chunk->buffer);
+        if (chunk->dirtyFirst != chunk->dirtyEnd) {
+            GLsizeiptr bytes = (GLsizeiptr) (chunk->dirtyEnd -
+                                             chunk->dirtyFirst) *
+                               sizeof(uint16_t);
+            glBufferSubData(GL_ARRAY_BUFFER,
+                            (GLintptr) chunk->dirtyFirst * sizeof(uint16_t),
+                            bytes, tiles + chunk->dirtyFirst);
+            tilemap->stats.chunksUpdated++;
+            tilemap->stats.uploadBytes += (uint64_t) bytes;
+        }
+    }
+    chunk->dirtyFirst = 0;
+    chunk->dirtyEnd = 0;
+}
+
+void tilemapDraw(Tilemap* tilemap, Rect view, Vec2 viewSize) {
+    TRACE_FUNCTION();
+    memset(&tilemap->stats, 0, sizeof(TilemapStats));
+    uint32_t count = tilemapCollectVisible(tilemap, view, tilemap->visible,
+                                           tilemap->chunksX *
+                                           tilemap->chunksY);
+    if (!count)
+        return;
+    if (!tilemap->drawProgram && !internal_tilemapDrawCreate(tilemap))
+        return;
+
+    glUseProgram(tilemap->drawProgram);
+    glUniform2f(glGetUniformLocation(tilemap->drawProgram, "uViewSize"),
+                viewSize.x, viewSize.y);
+    glUniform2f(glGetUniformLocation(tilemap->drawProgram, "uViewMin"),
+                view.min.x, view.min.y);
+    glUniform2f(glGetUniformLocation(tilemap->drawProgram, "uScale"),
+                viewSize.x / (view.max.x - view.min.x),
+                viewSize.y / (view.max.y - view.min.y));
+    glUniform1f(glGetUniformLocation(tilemap->drawProgram, "uTileSize"),
+                tilemap->tileSize);
+    glUniform2ui(glGetUniformLocation(tilemap->drawProgram, "uAtlasGrid"),
+                 tilemap->atlasColumns, tilemap->atlasRows);
+    glUniform1i(glGetUniformLocation(tilemap->drawProgram, "uChunkSize"),
+                TILEMAP_CHUNK_SIZE);
+    glUniform1i(glGetUniformLocation(tilemap->drawProgram, "uAtlas"), 0);
+    GLint origin = glGetUniformLocation(tilemap->drawProgram, "uOrigin");
+    textureBind(tilemap->atlas, 0);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(tilemap->drawVao);
+    float chunkPixels = tilemap->tileSize * TILEMAP_CHUNK_SIZE;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t index = tilemap->visible[i];
+        internal_tilemapUpload(tilemap, index);
+        glVertexAttribIPointer(0, 1, GL_UNSIGNED_SHORT, 0, (void*) 0);
+        glUniform2f(origin, (float) (index % tilemap->chunksX) * chunkPixels,
+                    (float) (index / tilemap->chunksX) * chunkPixels);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, TILEMAP_CHUNK_TILES);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    tilemap->stats.chunksDrawn = count;
+}
+
+TilemapStats tilemapGetStats(Tilemap* tilemap) {
+    return tilemap->stats;
+}
+
+void tilemapDestroy(Tilemap* tilemap) {
+    if (!tilemap)
+        return;
+    shaderDestroy(tilemap->drawProgram);
+    if (tilemap->drawVao)
+        glDeleteVertexArrays(1, &tilemap->drawVao);
+    if (tilemap->chunks) {
+        uint32_t chunkCount = tilemap->chunksX * tilemap->chunksY;
+        for (uint32_t i = 0; i < chunkCount; i++) {
+            if (!tilemap->chunks[i].buffer)
+                continue;
+            glDeleteBuffers(1, &tilemap->chunks[i].buffer);
+            gpuMemoryFreed(GPU_MEMORY_BUFFER,
+                           TILEMAP_CHUNK_TILES * sizeof(uint16_t));
+        }
+    }
+    TG_FREE(tilemap->tiles);
+    TG_FREE(tilemap->chunks);
+    TG_FREE(tilemap->visible);
+    TG_FREE(tilemap);
+}
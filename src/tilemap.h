@@ -0,0 +1,141 @@
+// Tilemap public API
+
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <stdint.h>
+
+#include "rect.h"
+#include "texture.h"
+#include "defines.h"
+
+// Tiles along each side of a chunk, chunks are drawn and uploaded as a whole
+#define TILEMAP_CHUNK_SIZE 32
+
+// Tile value of an empty cell, nothing is drawn there
+#define TILEMAP_EMPTY 0
+
+/**
+ * @brief   Counters of the last tilemapDraw
+ */
+typedef struct TilemapStats {
+    uint32_t chunksDrawn;   /**< Visible chunks holding at least one tile */
+    uint32_t chunksBuilt;   /**< Chunks whose buffer was created */
+    uint32_t chunksUpdated; /**< Chunks patched with one sub-buffer update */
+    uint64_t uploadBytes;   /**< Tile data sent to the GPU */
+} TilemapStats;
+
+/**
+ * @brief   Opaque type to Tilemap struct
+ * @note    The map is split into chunks of TILEMAP_CHUNK_SIZE² tiles. Each
+ *          chunk keeps its tiles in a GPU buffer that is built the first
+ *          time it is drawn and only patched when tiles change, so static
+ *          maps cost one instanced draw per visible chunk and no uploads
+ */
+typedef struct _Tilemap Tilemap;
+
+/**
+ * @brief   Create a new tilemap, every tile empty
+ * @param   width: uint32_t, width in tiles
+ * @param   height: uint32_t, height in tiles
+ * @param   tileSize: float, side of a tile in pixels
+ * @param   atlas: Pointer to the texture holding the tile images, not owned
+ * @param   atlasColumns: uint32_t, tile images per atlas row
+ * @param   atlasRows: uint32_t, tile images per atlas column
+ * @returns Pointer to a new Tilemap, NULL on failure
+ * @note    Tile value n shows atlas image n - 1, counted row by row from
+ *          the top left. The atlas should hold premultiplied alpha, see
+ *          TEXTURE_PREMULTIPLY
+ * @see     Tilemap, TILEMAP_EMPTY
+ */
+TGAPI Tilemap* tilemapNew(uint32_t width, uint32_t height, float tileSize,
+                          Texture* atlas, uint32_t atlasColumns,
+                          uint32_t atlasRows);
+
+/**
+ * @brief   Change one tile
+ * @param   tilemap: Pointer to the tilemap
+ * @param   x: uint32_t, column of the tile
+ * @param   y: uint32_t, row of the tile
+ * @param   tile: uint16_t, new tile value
+ * @returns 1 on success, 0 if the tile is outside the map
+ * @note    The GPU copy is updated by the next draw, edits to the same chunk
+ *          within a frame are merged into a single upload
+ */
+TGAPI uint8_t tilemapSetTile(Tilemap* tilemap, uint32_t x, uint32_t y,
+                             uint16_t tile);
+
+/**
+ * @brief   Change a rectangle of tiles
+ * @param   tilemap: Pointer to the tilemap
+ * @param   x: uint32_t, column of the top left tile
+ * @param   y: uint32_t, row of the top left tile
+ * @param   width: uint32_t, columns to write
+ * @param   height: uint32_t, rows to write
+ * @param   tiles: const uint16_t*, width x height values, row by row
+ * @returns 1 on success, 0 if the rectangle leaves the map, nothing is
+ *          written then
+ */
+TGAPI uint8_t tilemapSetRegion(Tilemap* tilemap, uint32_t x, uint32_t y,
+                               uint32_t width, uint32_t height,
+                               const uint16_t* tiles);
+
+/**
+ * @param   tilemap: Pointer to the tilemap
+ * @param   x: uint32_t, column of the tile
+ * @param   y: uint32_t, row of the tile
+ * @returns Value of the tile, TILEMAP_EMPTY outside the map
+ */
+TGAPI uint16_t tilemapGetTile(Tilemap* tilemap, uint32_t x, uint32_t y);
+
+/**
+ * @brief   Find the chunks a view needs
+ * @param   tilemap: Pointer to the tilemap
+ * @param   view: Rect, visible part of the map in pixels
+ * @param   chunks: uint32_t*, receives chunk indices, row by row, a chunk
+ *          index is chunkY * chunks per row + chunkX
+ * @param   maxChunks: uint32_t, size of chunks
+ * @returns Number of chunks written, empty chunks are left out
+ */
+TGAPI uint32_t tilemapCollectVisible(Tilemap* tilemap, Rect view,
+                                     uint32_t* chunks, uint32_t maxChunks);
+
+/**
+ * @brief   Tiles of a chunk the next draw will upload
+ * @param   tilemap: Pointer to the tilemap
+ * @param   chunk: uint32_t, chunk index, see tilemapCollectVisible
+ * @param   first: uint32_t*, receives the first tile, counted row by row
+ *          inside the chunk
+ * @param   count: uint32_t*, receives the number of tiles
+ * @returns 1 if the chunk has pending tiles, 0 if its buffer is current
+ * @note    A chunk that was never drawn reports all of its tiles
+ */
+TGAPI uint8_t tilemapGetPendingUpload(Tilemap* tilemap, uint32_t chunk,
+                                      uint32_t* first, uint32_t* count);
+
+/**
+ * @brief   Draw the visible chunks, uploading their pending tiles
+ * @param   tilemap: Pointer to the tilemap
+ * @param   view: Rect, part of the map in pixels shown in the viewport
+ * @param   viewSize: Vec2, size of the viewport in pixels, see windowGetSize
+ * @returns void
+ * @note    Chunks outside the view keep their pending tiles until they show
+ */
+TGAPI void tilemapDraw(Tilemap* tilemap, Rect view, Vec2 viewSize);
+
+/**
+ * @param   tilemap: Pointer to the tilemap
+ * @returns Counters of the last draw
+ * @see     TilemapStats
+ */
+TGAPI TilemapStats tilemapGetStats(Tilemap* tilemap);
+
+/**
+ * @brief   Free the tilemap, on the CPU and the GPU
+ * @param   tilemap: Pointer to the tilemap
+ * @returns void
+ * @note    The atlas is not freed
+ */
+TGAPI void tilemapDestroy(Tilemap* tilemap);
+
+#endif // TILEMAP_H
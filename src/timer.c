@@ -0,0 +1,54 @@
+// clock_gettime is POSIX, not part of plain C18
+#define _POSIX_C_SOURCE 199309L
+
+#include "timer.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+uint64_t timerNow(void) {
+#if defined(_WIN32) || defined(_WIN64)
+    static LARGE_INTEGER frequency; // ticks per second, queried once
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    // split to avoid overflowing when multiplying by 1e9
+    uint64_t seconds = counter.QuadPart / frequency.QuadPart;
+    uint64_t rest = counter.QuadPart % frequency.QuadPart;
+    return seconds * 1000000000ull + rest * 1000000000ull / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+}
+
+double timerToMs(uint64_t nanoseconds) {
+    return (double) nanoseconds / 1000000.0;
+}
+
+// Margin left for spinning, covers the usual OS sleep overshoot
+#define TIMER_SPIN_MARGIN 1500000ull
+
+void timerSleepUntil(uint64_t deadline) {
+    uint64_t now = timerNow();
+    if (now + TIMER_SPIN_MARGIN < deadline) {
+        uint64_t wait = deadline - now - TIMER_SPIN_MARGIN;
+#if defined(_WIN32) || defined(_WIN64)
+        Sleep((DWORD) (wait / 1000000ull));
+#else
+        struct timespec duration = {
+            (time_t) (wait / 1000000000ull),
+            (long) (wait % 1000000000ull)
+        };
+        nanosleep(&duration, NULL);
+#endif
+    }
+    while (timerNow() < deadline)
+        ;   // spin the remaining fraction of a millisecond
+}
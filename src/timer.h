@@ -0,0 +1,33 @@
+// Timer public API
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+#include "defines.h"
+
+/**
+ * @brief   Read the monotonic clock
+ * @returns Current time in nanoseconds, from an unspecified starting point
+ * @note    Does not need GLFW to be initialised, safe to use in tests
+ */
+TGAPI uint64_t timerNow(void);
+
+/**
+ * @brief   Convert a nanosecond duration to milliseconds
+ * @param   nanoseconds: uint64_t, duration as returned by timerNow deltas
+ * @returns Duration in milliseconds
+ */
+TGAPI double timerToMs(uint64_t nanoseconds);
+
+/**
+ * @brief   Sleep until a point in time, with sub millisecond precision
+ * @param   deadline: uint64_t, time in nanoseconds as returned by timerNow
+ * @returns void
+ * @note    The OS sleep is used for the bulk of the wait, and the last
+ *          stretch is spun, since OS sleeps overshoot by up to a few ms
+ */
+TGAPI void timerSleepUntil(uint64_t deadline);
+
+#endif // TIMER_H
@@ -0,0 +1,129 @@
+// get function defines
+#include "trace.h"
+#include "timer.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+
+// Internal Struct
+typedef struct TraceEventInternal {
+    const char* name;
+    uint64_t start;         // nanoseconds, timerNow
+    uint64_t duration;
+} TraceEventInternal;
+
+// Internal Struct
+typedef struct TraceBufferInternal {
+    TraceEventInternal events[TRACE_BUFFER_EVENTS];
+    _Atomic uint64_t head;      // events ever written, only the owner writes
+    _Atomic uint64_t cleared;   // head at the last traceClear
+    uint32_t thread;            // id shown in the exported trace
+    struct TraceBufferInternal* next;
+} TraceBufferInternal;
+
+static _Thread_local TraceBufferInternal* threadBuffer;
+static _Atomic(TraceBufferInternal*) buffers;  // every thread's, newest first
+static atomic_uint threadCount;
+
+// First event of a thread, push its buffer onto the shared list
+PRIVATE TraceBufferInternal* internal_traceRegister(void) {
+    // not TG_CALLOC, buffers live as long as the process and a thread's
+    // first event must not count against the frame allocation budget
+    TraceBufferInternal* buffer = calloc(1, sizeof(TraceBufferInternal));
+    if (!buffer)
+        return NULL;
+    buffer->thread = atomic_fetch_add(&threadCount, 1) + 1;
+    TraceBufferInternal* head = atomic_load(&buffers);
+    do {
+        buffer->next = head;
+    } while (!atomic_compare_exchange_weak(&buffers, &head, buffer));
+    return buffer;
+}
+
+// First event still held by a buffer
+PRIVATE uint64_t internal_traceFirst(TraceBufferInternal* buffer,
+                                     uint64_t head) {
+    uint64_t first = atomic_load_explicit(&buffer->cleared,
+                                          memory_order_relaxed);
+    if (head - first > TRACE_BUFFER_EVENTS)
+        first = head - TRACE_BUFFER_EVENTS;    // overwritten by the ring
+    return first;
+}
+
+// Names are C identifiers or literals, escape just enough to stay valid JSON
+PRIVATE void internal_traceWriteName(FILE* file, const char* name) {
+    for (; *name; name++) {
+        if (*name == '"' || *name == '\\')
+            fputc('\\', file);
+        if ((unsigned char) *name >= 0x20)
+            fputc(*name, file);
+    }
+}
+
+uint64_t traceBegin(void) {
+    return timerNow();
+}
+
+void traceEnd(const char* name, uint64_t start) {
+    uint64_t end = timerNow();
+    TraceBufferInternal* buffer = threadBuffer;
+    if (!buffer && !(buffer = threadBuffer = internal_traceRegister()))
+        return;
+
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    TraceEventInternal* event = &buffer->events[head % TRACE_BUFFER_EVENTS];
+    event->name = name;
+    event->start = start;
+    event->duration = end - start;
+    // publish the event, readers acquire head before reading slots
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+uint8_t traceExport(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return 0;
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+    uint8_t first = 1;
+    for (TraceBufferInternal* buffer = atomic_load(&buffers); buffer;
+         buffer = buffer->next) {
+        uint64_t head = atomic_load_explicit(&buffer->head,
+                                             memory_order_acquire);
+        for (uint64_t i = internal_traceFirst(buffer, head); i < head; i++) {
+            TraceEventInternal* event = &buffer->events[i %
+                                                        TRACE_BUFFER_EVENTS];
+            fputs(first ? "\n{\"name\":\"" : ",\n{\"name\":\"", file);
+            internal_traceWriteName(file, event->name);
+            // chrome wants microseconds
+            fprintf(file, "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                    "\"pid\":1,\"tid\":%u}", (double) event->start / 1000.0,
+                    (double) event->duration / 1000.0, buffer->thread);
+            first = 0;
+        }
+    }
+    fputs("\n]}\n", file);
+
+    uint8_t ok = !ferror(file);
+    return fclose(file) == 0 && ok;
+}
+
+uint32_t traceGetEventCount(void) {
+    uint64_t count = 0;
+    for (TraceBufferInternal* buffer = atomic_load(&buffers); buffer;
+         buffer = buffer->next) {
+        uint64_t head = atomic_load_explicit(&buffer->head,
+                                             memory_order_acquire);
+        count += head - internal_traceFirst(buffer, head);
+    }
+    return (uint32_t) count;
+}
+
+void traceClear(void) {
+    for (TraceBufferInternal* buffer = atomic_load(&buffers); buffer;
+         buffer = buffer->next)
+        atomic_store_explicit(&buffer->cleared,
+                              atomic_load_explicit(&buffer->head,
+                                                   memory_order_acquire),
+                              memory_order_relaxed);
+}
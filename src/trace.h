@@ -0,0 +1,86 @@
+// Trace public API
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+#include "defines.h"
+
+/**
+ * @def TRACE_BUFFER_EVENTS
+ * @brief Events kept per thread, older events are overwritten
+ */
+#define TRACE_BUFFER_EVENTS 16384
+
+/**
+ * @brief   Start timestamp of a scope
+ * @returns Current time in nanoseconds, pass it to traceEnd
+ * @note    Prefer TRACE_SCOPE, which compiles out without TG_TRACE
+ */
+TGAPI uint64_t traceBegin(void);
+
+/**
+ * @brief   Record a finished scope into the calling thread's ring buffer
+ * @param   name: label of the scope, not copied, use string literals
+ * @param   start: uint64_t, value returned by traceBegin
+ * @returns void
+ * @note    Lock free, each thread only ever writes its own buffer
+ */
+TGAPI void traceEnd(const char* name, uint64_t start);
+
+/**
+ * @brief   Write every recorded event as Chrome trace JSON
+ * @param   path: file to write, open it in chrome://tracing or Perfetto
+ * @returns 1 on success, 0 if the file couldn't be written
+ * @note    Events recorded while exporting may show up torn, export between
+ *          frames or after worker threads are done
+ */
+TGAPI uint8_t traceExport(const char* path);
+
+/**
+ * @returns Number of events held across every thread
+ */
+TGAPI uint32_t traceGetEventCount(void);
+
+/**
+ * @brief   Forget every recorded event
+ * @returns void
+ * @note    Same caveat as traceExport about threads still recording
+ */
+TGAPI void traceClear(void);
+
+/**
+ * @def TRACE_SCOPE
+ * @brief Time the rest of the enclosing block
+ * @param name: label of the scope, a string literal
+ * @note  Records only when built with TG_TRACE, and needs the cleanup
+ *        attribute of GCC or Clang, otherwise it expands to nothing
+ */
+/**
+ * @def TRACE_FUNCTION
+ * @brief Time the rest of the enclosing function, labelled with its name
+ */
+#if defined(TG_TRACE) && (defined(__GNUC__) || defined(__clang__))
+    typedef struct TraceScope {
+        const char* name;
+        uint64_t start;
+    } TraceScope;
+
+    HELPER void internal_traceScopeEnd(TraceScope* scope) {
+        traceEnd(scope->name, scope->start);
+    }
+
+    #define TRACE_CONCAT_(a, b) a##b
+    #define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+    #define TRACE_SCOPE(name) \
+        TraceScope TRACE_CONCAT(traceScope, __LINE__) \
+            __attribute__((cleanup(internal_traceScopeEnd))) = \
+            { (name), traceBegin() }
+    #define TRACE_FUNCTION() TRACE_SCOPE(__func__)
+#else
+    #define TRACE_SCOPE(name) ((void) 0)
+    #define TRACE_FUNCTION() ((void) 0)
+#endif
+
+#endif // TRACE_H
@@ -1,8 +1,24 @@
 #ifndef VECTOR_H
 #define VECTOR_H
 
+#include <stdint.h>
+
 #include "defines.h"
 
+/**
+ * @def TG_VECTOR_INLINE
+ * @brief Define before including vector.h, or build with -Dvector_inline=true,
+ * to compile the vector functions into the caller from vector_impl.h instead
+ * of calling the library. The library exports them either way
+ */
+#ifdef TG_VECTOR_INLINE
+    #define VECTOR_API STATIC_FORCE_INLINE
+    #define VECTOR_DEFINITION STATIC_FORCE_INLINE
+#else
+    #define VECTOR_API TGAPI
+    #define VECTOR_DEFINITION FORCE_INLINE
+#endif
+
 /**
  * @brief   Represents a 2-Dimensional Vector, with floating point components
  */
@@ -14,7 +30,7 @@ typedef struct Vec2 {
 /**
  * @returns 2 Dimensional vector with both components set to zero
  */
-TGAPI Vec2 vec2GetZero();
+VECTOR_API Vec2 vec2GetZero();
 
 /**
  * @brief   Adds two vectors
@@ -22,7 +38,7 @@ TGAPI Vec2 vec2GetZero();
  * @param   v2: Vec2, can be point or direction
  * @returns Vector sum of two 2D Vectors
  */
-TGAPI Vec2 vec2Add(Vec2 v1, Vec2 v2);
+VECTOR_API Vec2 vec2Add(Vec2 v1, Vec2 v2);
 
 /**
  * @brief   Subtract a vector from another
@@ -30,7 +46,7 @@ TGAPI Vec2 vec2Add(Vec2 v1, Vec2 v2);
  * @param   v2: Vec2, can be point or direction
  * @returns Vector difference of two 2D Vectors
  */
-TGAPI Vec2 vec2Sub(Vec2 v1, Vec2 v2);
+VECTOR_API Vec2 vec2Sub(Vec2 v1, Vec2 v2);
 
 /**
  * @brief   Add a scalar to the components of a vector
@@ -38,7 +54,7 @@ TGAPI Vec2 vec2Sub(Vec2 v1, Vec2 v2);
  * @param   scalar: float, value to add to components
  * @returns 2D Vector, with the scalar parameter added to the input vector's components
  */
-TGAPI Vec2 vec2ScalarAdd(Vec2 v1, float scalar);
+VECTOR_API Vec2 vec2ScalarAdd(Vec2 v1, float scalar);
 
 /**
  * @brief   Subtract a scalar from the components of a vector
@@ -46,7 +62,7 @@ TGAPI Vec2 vec2ScalarAdd(Vec2 v1, float scalar);
  * @param   scalar: float, value to subtract from components
  * @returns 2D vector, with the scalar parameter subtracted from the input vector's components
  */
-TGAPI Vec2 vec2ScalarSub(Vec2 v1, float scalar);
+VECTOR_API Vec2 vec2ScalarSub(Vec2 v1, float scalar);
 
 /**
  * @brief   Scale a vector by a scalar
@@ -54,7 +70,7 @@ TGAPI Vec2 vec2ScalarSub(Vec2 v1, float scalar);
  * @param   scalar: float, value to add to components
  * @returns 2D vector, with the scalar parameter subtracted from the input vector's components
  */
-TGAPI Vec2 vec2Scale(Vec2 v1, float scalar);
+VECTOR_API Vec2 vec2Scale(Vec2 v1, float scalar);
 
 /**
  * @brief   Dot/scalar multiplication operation on two vectors
@@ -62,7 +78,7 @@ TGAPI Vec2 vec2Scale(Vec2 v1, float scalar);
  * @param   v2: Vec2, can be point or direction
  * @returns Scalar product of two 2D Vectors
  */
-TGAPI float vec2Dot(Vec2 v1, Vec2 v2);
+VECTOR_API float vec2Dot(Vec2 v1, Vec2 v2);
 
 /**
  * @brief   Cross/vector multiplication operation on two vectors
@@ -74,28 +90,28 @@ TGAPI float vec2Dot(Vec2 v1, Vec2 v2);
  * resultant vector is into the plane. The value represents the area of the parallelogram
  * formed by the two vectors
  */
-TGAPI float vec2Cross(Vec2 v1, Vec2 v2);
+VECTOR_API float vec2Cross(Vec2 v1, Vec2 v2);
 
 /**
  * @brief   get length of a vector
  * @param   v1: Vec2, can be point or direction
  * @returns Returns length of input 2D Vector
  */
-TGAPI float vec2Length(Vec2 v1);
+VECTOR_API float vec2Length(Vec2 v1);
 
 /**
  * @brief   get the squared length of a vector
  * @param   v1: Vec2, can be point or direction
  * @returns Returns the squared length of input 2D Vector
  */
-TGAPI float vec2LengthSquared(Vec2 v1);
+VECTOR_API float vec2LengthSquared(Vec2 v1);
 
 /**
  * @brief   normalize a vector
  * @param   v1: Vec2, can be point or direction
  * @returns Returns normalized input Vector
  */
-TGAPI Vec2 vec2Normalize(Vec2 v1);
+VECTOR_API Vec2 vec2Normalize(Vec2 v1);
 
 /**
  * @brief   clamps each component of a Vec2 between a minimum and maximum value
@@ -104,7 +120,7 @@ TGAPI Vec2 vec2Normalize(Vec2 v1);
  * @param   max: float, maximum allowed value for each component
  * @returns Returns a Vec2 where each component is clamped to [min, max]
  */
-TGAPI Vec2 vec2Clamp(Vec2 v1, float min, float max);
+VECTOR_API Vec2 vec2Clamp(Vec2 v1, float min, float max);
 
 /**
  * @brief   linearly interpolates between two Vec2 vectors or points
@@ -113,7 +129,7 @@ TGAPI Vec2 vec2Clamp(Vec2 v1, float min, float max);
  * @param   t: float, interpolation factor (between 0 and 1)
  * @returns Returns the interpolated Vec2 between a and b by t
  */
-TGAPI Vec2 vec2Lerp(Vec2 v1, Vec2 v2, float t);
+VECTOR_API Vec2 vec2Lerp(Vec2 v1, Vec2 v2, float t);
 
 /**
  * @brief   reflects a vector v1 across a surface normal n
@@ -122,7 +138,7 @@ TGAPI Vec2 vec2Lerp(Vec2 v1, Vec2 v2, float t);
  * @returns Returns the reflection of v1 w.r.t n
  * @note    The vector n must be normalized (unit length)
  */
-TGAPI Vec2 vec2Reflect(Vec2 v1, Vec2 n);
+VECTOR_API Vec2 vec2Reflect(Vec2 v1, Vec2 n);
 
 /**
  * @brief   projects vector v1 onto vector v2
@@ -132,7 +148,7 @@ TGAPI Vec2 vec2Reflect(Vec2 v1, Vec2 n);
  * @note    Projection gives the component of v1 that lies in the direction of v2.
  *          The result is a vector parallel to v2.
  */
-TGAPI Vec2 vec2Projection(Vec2 v1, Vec2 v2);
+VECTOR_API Vec2 vec2Projection(Vec2 v1, Vec2 v2);
 
 /**
  * @brief   calculates the distance between two Vec2 vectors or points
@@ -141,7 +157,7 @@ TGAPI Vec2 vec2Projection(Vec2 v1, Vec2 v2);
  * @returns Returns the Euclidean distance between v1 and v2
  * @note    Equivalent to the length of the vector from v2 to v1
  */
-TGAPI float vec2DistanceFromPoint(Vec2 v1, Vec2 v2);
+VECTOR_API float vec2DistanceFromPoint(Vec2 v1, Vec2 v2);
 
 /**
  * @brief   computes the angle of a Vec2 from the positive X-axis
@@ -149,7 +165,7 @@ TGAPI float vec2DistanceFromPoint(Vec2 v1, Vec2 v2);
  * @returns Returns the angle in radians in the range [0, 2π)
  * @note    Uses `atan2f` internally to handle all quadrants. Angle is measured counter-clockwise.
  */
-TGAPI float vec2Angle(Vec2 v1);
+VECTOR_API float vec2Angle(Vec2 v1);
 
 /**
  * @brief   computes a vector perpendicular to the input Vec2
@@ -157,13 +173,149 @@ TGAPI float vec2Angle(Vec2 v1);
  * @returns Returns a Vec2 that is perpendicular to v1
  * @note    The returned vector is v1 rotated +90° counterclockwise (x, y) → (−y, x)
  */
-TGAPI Vec2 vec2Perpendicular(Vec2 v1);
+VECTOR_API Vec2 vec2Perpendicular(Vec2 v1);
 
 /**
  * @brief   normalizes a Vec2 in place
  * @param   v1: Vec2* pointer, to the vector to normalize
  * @note    If the vector has zero length, it is left unchanged to avoid division by zero.
  */
-TGAPI void vec2Normalized(Vec2 *v1);
+VECTOR_API void vec2Normalized(Vec2 *v1);
+
+/**
+ * Fast approximations, for hot loops that tolerate a bounded error. The
+ * precise functions above stay the default. The bounds below hold against
+ * double precision and are checked by vector_tests.c
+ */
+
+/**
+ * @def VECTOR_SSE
+ * @brief Defined when the fast functions use SSE estimates
+ */
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define VECTOR_SSE
+#endif
+
+/** @brief Largest relative error of mathFastRsqrt with SSE */
+#define FAST_RSQRT_SSE_MAX_ERROR 4e-7f
+
+/** @brief Largest relative error of mathFastRsqrtPortable */
+#define FAST_RSQRT_PORTABLE_MAX_ERROR 1.8e-3f
+
+/** @brief Largest relative error of mathFastRsqrt and the Fast length */
+#ifdef VECTOR_SSE
+    #define FAST_RSQRT_MAX_ERROR FAST_RSQRT_SSE_MAX_ERROR
+#else
+    #define FAST_RSQRT_MAX_ERROR FAST_RSQRT_PORTABLE_MAX_ERROR
+#endif
+
+/** @brief Largest absolute error of mathFastAtan2, in radians */
+#define FAST_ATAN2_MAX_ERROR 2e-5f
+
+/** @brief Largest absolute error of mathFastSin and mathFastCos */
+#define FAST_SINCOS_MAX_ERROR 5e-6f
+
+/**
+ * @brief   approximates 1 / sqrt(x)
+ * @param   x: float, must be positive and normal
+ * @returns Returns the reciprocal square root, see FAST_RSQRT_MAX_ERROR
+ * @note    An estimate refined by one Newton step, the SSE estimate when
+ *          VECTOR_SSE is defined, mathFastRsqrtPortable otherwise
+ */
+VECTOR_API float mathFastRsqrt(float x);
+
+/**
+ * @brief   approximates 1 / sqrt(x) without SSE
+ * @param   x: float, must be positive and normal
+ * @returns Returns the reciprocal square root, see
+ *          FAST_RSQRT_PORTABLE_MAX_ERROR
+ * @note    A bit-level estimate refined by one Newton step, what
+ *          mathFastRsqrt is built from on targets without SSE
+ */
+VECTOR_API float mathFastRsqrtPortable(float x);
+
+/**
+ * @brief   approximates atan2f with a polynomial
+ * @param   y: float, y component
+ * @param   x: float, x component
+ * @returns Returns the angle in radians in the range [-π, π], see
+ *          FAST_ATAN2_MAX_ERROR
+ * @note    atan2(0, 0) returns 0
+ */
+VECTOR_API float mathFastAtan2(float y, float x);
+
+/**
+ * @brief   approximates sinf with a polynomial
+ * @param   x: float, angle in radians
+ * @returns Returns the sine, see FAST_SINCOS_MAX_ERROR
+ * @note    The bound holds for |x| <= 1000, range reduction loses
+ *          precision past that
+ */
+VECTOR_API float mathFastSin(float x);
+
+/**
+ * @brief   approximates cosf with a polynomial
+ * @param   x: float, angle in radians
+ * @returns Returns the cosine, see FAST_SINCOS_MAX_ERROR
+ * @note    Same range as mathFastSin
+ */
+VECTOR_API float mathFastCos(float x);
+
+/**
+ * @brief   get the approximate length of a vector
+ * @param   v1: Vec2, can be point or direction
+ * @returns Returns the length of v1, see FAST_RSQRT_MAX_ERROR
+ */
+VECTOR_API float vec2FastLength(Vec2 v1);
+
+/**
+ * @brief   normalize a vector with mathFastRsqrt
+ * @param   v1: Vec2, can be point or direction
+ * @returns Returns v1 scaled to about unit length, zero vectors unchanged
+ */
+VECTOR_API Vec2 vec2FastNormalize(Vec2 v1);
+
+/**
+ * @brief   approximates vec2Angle with mathFastAtan2
+ * @param   v1: Vec2, input vector
+ * @returns Returns the angle in radians in the range [0, 2π)
+ */
+VECTOR_API float vec2FastAngle(Vec2 v1);
+
+/**
+ * @brief   normalizes an array of vectors
+ * @param   out: Vec2*, receives count vectors, may alias in
+ * @param   in: const Vec2*, vectors to normalize
+ * @param   count: uint32_t, number of vectors
+ * @returns void
+ * @note    Four vectors per iteration on SSE, same result as
+ *          vec2FastNormalize within FAST_RSQRT_MAX_ERROR
+ */
+TGAPI void vec2FastNormalizeBatch(Vec2* out, const Vec2* in, uint32_t count);
+
+/**
+ * @brief   computes the angle of an array of vectors
+ * @param   out: float*, receives count angles in [0, 2π)
+ * @param   in: const Vec2*, input vectors
+ * @param   count: uint32_t, number of vectors
+ * @returns void
+ */
+TGAPI void vec2FastAngleBatch(float* out, const Vec2* in, uint32_t count);
+
+/**
+ * @brief   computes the sine and cosine of an array of angles
+ * @param   sines: float*, receives count sines, NULL to skip
+ * @param   cosines: float*, receives count cosines, NULL to skip
+ * @param   angles: const float*, angles in radians
+ * @param   count: uint32_t, number of angles
+ * @returns void
+ */
+TGAPI void mathFastSinCosBatch(float* sines, float* cosines,
+                               const float* angles, uint32_t count);
+
+#ifdef TG_VECTOR_INLINE
+    #include "vector_impl.h"
+#endif
 
 #endif // VECTOR_H
\ No newline at end of file
@@ -0,0 +1,208 @@
+// Vector function definitions, compiled out of line by vector.c and inlined
+// into callers by vector.h when TG_VECTOR_INLINE is defined
+
+#ifndef VECTOR_IMPL_H
+#define VECTOR_IMPL_H
+
+#include "vector.h"
+#include "constants.h"
+
+#include <math.h>
+#include <string.h>
+
+#ifdef VECTOR_SSE
+    #include <xmmintrin.h>
+#endif
+
+// 2π split in two, k * TWO_PI_HIGH is exact for every k the bound covers
+#define TWO_PI_HIGH 6.28125f
+#define TWO_PI_LOW 1.9353071795864769e-3f
+#define INV_TWO_PI 0.15915494309189535f
+
+VECTOR_DEFINITION Vec2 vec2GetZero() {
+    return (Vec2) { 0.0f, 0.0f };
+}
+
+VECTOR_DEFINITION Vec2 vec2Add(Vec2 v1, Vec2 v2) {
+    return (Vec2) {(v1.x + v2.x), (v1.y + v2.y) };
+}
+
+VECTOR_DEFINITION Vec2 vec2Sub(Vec2 v1, Vec2 v2) {
+    return (Vec2) {v1.x - v2.x,v1.y - v2.y };
+}
+
+VECTOR_DEFINITION Vec2 vec2ScalarAdd(Vec2 v1, float scalar) {
+    return (Vec2) {(v1.x + scalar),(v1.y + scalar) };
+}
+
+VECTOR_DEFINITION Vec2 vec2ScalarSub(Vec2 v1, float scalar) {
+    return (Vec2) {(v1.x - scalar),(v1.y - scalar) };
+}
+
+VECTOR_DEFINITION Vec2 vec2Scale(Vec2 v1, float scalar) {
+    return (Vec2) {(v1.x * scalar),(v1.y * scalar) };
+}
+
+VECTOR_DEFINITION float vec2Length(Vec2 v1) {
+    return sqrtf(v1.x * v1.x + v1.y * v1.y);
+}
+
+
+VECTOR_DEFINITION float vec2LengthSquared(Vec2 v1) {
+    return (v1.x * v1.x + v1.y * v1.y);
+}
+
+VECTOR_DEFINITION Vec2 vec2Normalize(Vec2 v1) {
+    float len = vec2Length(v1);
+    if (!(len == 0.0f))
+        return (Vec2) {(v1.x / len), (v1.y / len) };
+    return v1;
+}
+
+VECTOR_DEFINITION Vec2 vec2Clamp(Vec2 v1, float min, float max) {
+    return (Vec2) {
+        v1.x > min ? v1.x < max ? v1.x : max : min,
+        v1.y > min ? v1.y < max ? v1.y : max : min,
+      };
+}
+
+VECTOR_DEFINITION Vec2 vec2Lerp(Vec2 v1, Vec2 v2, float t) {
+    return (Vec2) {
+        .x = v1.x + (v2.x - v1.x) * t,
+        .y = v1.y + (v2.y - v1.y) * t
+    };
+}
+
+VECTOR_DEFINITION float vec2Dot(Vec2 v1, Vec2 v2) {
+    return (v1.x * v2.x) + (v1.y * v2.y);
+}
+
+// Need to make sure n is normalized assert(fabsf(vec2Length(m) - 1.0f) < EPSILON);
+VECTOR_DEFINITION Vec2 vec2Reflect(Vec2 v1, Vec2 n) {
+    float factor = 2.0f*vec2Dot(v1, n);
+    Vec2 subvec = {n.x * factor, n.y * factor};
+    return vec2Sub(v1, subvec);
+}
+
+VECTOR_DEFINITION Vec2 vec2Projection(Vec2 v1, Vec2 v2) {
+    float dot = vec2Dot(v1, v2);
+    float lensq = vec2LengthSquared(v2);
+    float scalar = dot / lensq;
+    return (Vec2) { v2.x * scalar, v2.y * scalar };
+}
+
+VECTOR_DEFINITION Vec2 vec2Perpendicular(Vec2 v1) {
+    return (Vec2) { -v1.y, v1.x };
+}
+
+VECTOR_DEFINITION float vec2Cross(Vec2 v1, Vec2 v2) {
+    return (v1.x * v2.y) - (v1.y * v2.x);
+}
+
+VECTOR_DEFINITION float vec2DistanceFromPoint(Vec2 v1, Vec2 v2) {
+    Vec2 pointer_vector = vec2Sub(v1, v2);
+    return vec2Length(pointer_vector);
+}
+
+VECTOR_DEFINITION float vec2Angle(Vec2 v1) {
+    float angle = atan2f(v1.y, v1.x);
+    if (angle < 0.0f)
+        angle += 2.0f * PI;
+    return angle;  // range: [0, 2π)
+}
+
+VECTOR_DEFINITION void vec2Normalized(Vec2 *v1) {
+    float len = vec2Length(*v1);
+    if (!(len == 0.0f)) {
+        v1->x /= len;
+        v1->y /= len;
+    }
+}
+
+VECTOR_DEFINITION float mathFastRsqrtPortable(float x) {
+    uint32_t bits;
+    float estimate;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5f375a86u - (bits >> 1);
+    memcpy(&estimate, &bits, sizeof(estimate));
+    return estimate * (1.5f - 0.5f * x * estimate * estimate);
+}
+
+VECTOR_DEFINITION float mathFastRsqrt(float x) {
+#ifdef VECTOR_SSE
+    float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return estimate * (1.5f - 0.5f * x * estimate * estimate);
+#else
+    return mathFastRsqrtPortable(x);
+#endif
+}
+
+VECTOR_DEFINITION float mathFastAtan2(float y, float x) {
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    float high = ax > ay ? ax : ay;
+    float low = ax > ay ? ay : ax;
+    if (high == 0.0f)
+        return 0.0f;
+
+    // atan on [0, 1], Abramowitz and Stegun 4.4.49, error 1e-5
+    float a = low / high;
+    float s = a * a;
+    float angle = a * (0.9998660f + s * (-0.3302995f + s * (0.1801410f +
+                  s * (-0.0851330f + s * 0.0208351f))));
+    if (ay > ax)
+        angle = 0.5f * PI - angle;
+    if (x < 0.0f)
+        angle = PI - angle;
+    return y < 0.0f ? -angle : angle;
+}
+
+// Reduce to [-π, π]
+HELPER float internal_vectorReduceAngle(float x) {
+    float k = floorf(x * INV_TWO_PI + 0.5f);
+    return (x - k * TWO_PI_HIGH) - k * TWO_PI_LOW;
+}
+
+// Taylor series to x^9 on [-π/2, π/2], error 3.6e-6 at the ends
+HELPER float internal_vectorSinPoly(float x) {
+    float s = x * x;
+    return x * (1.0f + s * (-1.0f / 6.0f + s * (1.0f / 120.0f +
+           s * (-1.0f / 5040.0f + s * (1.0f / 362880.0f)))));
+}
+
+VECTOR_DEFINITION float mathFastSin(float x) {
+    float r = internal_vectorReduceAngle(x);
+    if (r > 0.5f * PI)
+        r = PI - r;
+    else if (r < -0.5f * PI)
+        r = -PI - r;
+    return internal_vectorSinPoly(r);
+}
+
+VECTOR_DEFINITION float mathFastCos(float x) {
+    return internal_vectorSinPoly(0.5f * PI -
+                                  fabsf(internal_vectorReduceAngle(x)));
+}
+
+VECTOR_DEFINITION float vec2FastLength(Vec2 v1) {
+    float lengthSquared = vec2LengthSquared(v1);
+    if (lengthSquared == 0.0f)
+        return 0.0f;
+    return lengthSquared * mathFastRsqrt(lengthSquared);
+}
+
+VECTOR_DEFINITION Vec2 vec2FastNormalize(Vec2 v1) {
+    float lengthSquared = vec2LengthSquared(v1);
+    if (lengthSquared == 0.0f)
+        return v1;
+    return vec2Scale(v1, mathFastRsqrt(lengthSquared));
+}
+
+VECTOR_DEFINITION float vec2FastAngle(Vec2 v1) {
+    float angle = mathFastAtan2(v1.y, v1.x);
+    if (angle < 0.0f)
+        angle += 2.0f * PI;
+    return angle;  // range: [0, 2π)
+}
+
+#endif // VECTOR_IMPL_H
@@ -0,0 +1,96 @@
+// get function defines
+#include "vector_types.h"
+
+#include <string.h>
+
+// Plain loops without calls. Only the snorm unpack vectorizes, with GCC at
+// -O3, the clamps and the bit level half conversions branch on every value
+// and stay scalar
+
+void vectorPackSnorm16(int16_t* out, const float* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        float value = in[i] > -1.0f ? in[i] < 1.0f ? in[i] : 1.0f : -1.0f;
+        value *= 32767.0f;
+        out[i] = (int16_t) (value + (value < 0.0f ? -0.5f : 0.5f));
+    }
+}
+
+void vectorPackUnorm16(uint16_t* out, const float* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        float value = in[i] > 0.0f ? in[i] < 1.0f ? in[i] : 1.0f : 0.0f;
+        out[i] = (uint16_t) (value * 65535.0f + 0.5f);
+    }
+}
+
+void vectorUnpackSnorm16(float* out, const int16_t* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        float value = in[i] * (1.0f / 32767.0f);
+        out[i] = value > -1.0f ? value : -1.0f;     // -32768 maps to -1 too
+    }
+}
+
+// Bit level conversion, exact for every float including the edge cases
+PRIVATE uint16_t internal_vectorFloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = (uint16_t) ((bits >> 16) & 0x8000u);
+    uint32_t exponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+
+    if (exponent == 0xffu)      // infinity, NaN stays a quiet NaN
+        return sign | 0x7c00u | (mantissa ? 0x200u : 0u);
+
+    int32_t halfExponent = (int32_t) exponent - 127 + 15;
+    if (halfExponent >= 31)     // too large, overflow to infinity
+        return sign | 0x7c00u;
+
+    uint32_t shift;
+    uint32_t half;
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) // below half of the smallest subnormal
+            return sign;
+        mantissa |= 0x800000u;  // subnormal, make the implicit bit explicit
+        shift = (uint32_t) (14 - halfExponent);
+        half = mantissa >> shift;
+    } else {
+        shift = 13;
+        half = ((uint32_t) halfExponent << 10) | (mantissa >> shift);
+    }
+
+    // round to nearest even, a carry into the exponent is still correct
+    uint32_t remainder = mantissa & ((1u << shift) - 1u);
+    uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1u)))
+        half++;
+    return sign | (uint16_t) half;
+}
+
+PRIVATE float internal_vectorHalfToFloat(uint16_t half) {
+    uint32_t sign = (uint32_t) (half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1fu;
+    uint32_t mantissa = half & 0x3ffu;
+    uint32_t bits;
+
+    if (exponent == 0x1fu) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else if (exponent) {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    } else {
+        // zero or subnormal, exactly representable as a float
+        float value = (float) mantissa * (1.0f / 16777216.0f);
+        return sign ? -value : value;
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void vectorPackHalf(uint16_t* out, const float* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++)
+        out[i] = internal_vectorFloatToHalf(in[i]);
+}
+
+void vectorUnpackHalf(float* out, const uint16_t* in, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++)
+        out[i] = internal_vectorHalfToFloat(in[i]);
+}
@@ -0,0 +1,190 @@
+// Generated vector types public API
+
+#ifndef VECTOR_TYPES_H
+#define VECTOR_TYPES_H
+
+#include <stdint.h>
+#include <math.h>
+
+#include "defines.h"
+
+// Component lists, op is expanded once per component
+#define VECTOR_EACH_2(op) op(x), op(y)
+#define VECTOR_EACH_3(op) op(x), op(y), op(z)
+#define VECTOR_EACH_4(op) op(x), op(y), op(z), op(w)
+#define VECTOR_SUM_2(op) (op(x) + op(y))
+#define VECTOR_SUM_3(op) (op(x) + op(y) + op(z))
+#define VECTOR_SUM_4(op) (op(x) + op(y) + op(z) + op(w))
+#define VECTOR_ALL_2(op) (op(x) && op(y))
+#define VECTOR_ALL_3(op) (op(x) && op(y) && op(z))
+#define VECTOR_ALL_4(op) (op(x) && op(y) && op(z) && op(w))
+#define VECTOR_FIELDS_2(T) T x; T y;
+#define VECTOR_FIELDS_3(T) T x; T y; T z;
+#define VECTOR_FIELDS_4(T) T x; T y; T z; T w;
+
+// Per component operations on the arguments a, b, lo, hi, s and t
+#define VECTOR_OP_ZERO(c) 0
+#define VECTOR_OP_ADD(c) a.c + b.c
+#define VECTOR_OP_SUB(c) a.c - b.c
+#define VECTOR_OP_SCALAR_ADD(c) a.c + s
+#define VECTOR_OP_SCALAR_SUB(c) a.c - s
+#define VECTOR_OP_SCALE(c) a.c * s
+#define VECTOR_OP_MUL(c) a.c * b.c
+#define VECTOR_OP_MIN(c) a.c < b.c ? a.c : b.c
+#define VECTOR_OP_MAX(c) a.c > b.c ? a.c : b.c
+#define VECTOR_OP_CLAMP(c) a.c > lo ? a.c < hi ? a.c : hi : lo
+#define VECTOR_OP_EQUAL(c) a.c == b.c
+#define VECTOR_OP_WIDE_MUL(c) (VectorWide) a.c * b.c
+#define VECTOR_OP_LERP(c) a.c + (b.c - a.c) * t
+
+/**
+ * @def VECTOR_DEFINE
+ * @brief Define a vector type and the operations shared by every component
+ * type, all inlined into the caller
+ * @param Name: type name, a struct with fields x, y, z, w
+ * @param prefix: function prefix, e.g. vec3 gives vec3Add
+ * @param T: component type
+ * @param Wide: type dot products accumulate in
+ * @param N: 2, 3 or 4 components
+ * @note Defines prefixGetZero, prefixAdd, prefixSub, prefixScalarAdd,
+ * prefixScalarSub, prefixScale, prefixMin, prefixMax, prefixClamp,
+ * prefixEqual and prefixDot. Integer arithmetic wraps like the component
+ * type, a uint16 vector minus a larger one wraps around
+ */
+#define VECTOR_DEFINE(Name, prefix, T, Wide, N)                               \
+    typedef struct Name { VECTOR_FIELDS_##N(T) } Name;                        \
+    STATIC_FORCE_INLINE Name prefix##GetZero(void) {                          \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_ZERO) };                    \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Add(Name a, Name b) {                    \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_ADD) };                     \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Sub(Name a, Name b) {                    \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_SUB) };                     \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##ScalarAdd(Name a, T s) {                 \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_SCALAR_ADD) };              \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##ScalarSub(Name a, T s) {                 \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_SCALAR_SUB) };              \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Scale(Name a, T s) {                     \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_SCALE) };                   \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Min(Name a, Name b) {                    \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_MIN) };                     \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Max(Name a, Name b) {                    \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_MAX) };                     \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Clamp(Name a, T lo, T hi) {              \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_CLAMP) };                   \
+    }                                                                         \
+    STATIC_FORCE_INLINE uint8_t prefix##Equal(Name a, Name b) {               \
+        return VECTOR_ALL_##N(VECTOR_OP_EQUAL);                               \
+    }                                                                         \
+    STATIC_FORCE_INLINE Wide prefix##Dot(Name a, Name b) {                    \
+        typedef Wide VectorWide;                                              \
+        return VECTOR_SUM_##N(VECTOR_OP_WIDE_MUL);                            \
+    }
+
+/**
+ * @def VECTOR_DEFINE_FLOAT
+ * @brief VECTOR_DEFINE plus the operations that only make sense on floats
+ * @note Adds prefixLengthSquared, prefixLength, prefixNormalize, which
+ * leaves zero vectors unchanged like vec2Normalize, and prefixLerp
+ */
+#define VECTOR_DEFINE_FLOAT(Name, prefix, N)                                  \
+    VECTOR_DEFINE(Name, prefix, float, float, N)                              \
+    STATIC_FORCE_INLINE float prefix##LengthSquared(Name a) {                 \
+        return prefix##Dot(a, a);                                             \
+    }                                                                         \
+    STATIC_FORCE_INLINE float prefix##Length(Name a) {                        \
+        return sqrtf(prefix##Dot(a, a));                                      \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Normalize(Name a) {                      \
+        float length = prefix##Length(a);                                     \
+        return length == 0.0f ? a : prefix##Scale(a, 1.0f / length);          \
+    }                                                                         \
+    STATIC_FORCE_INLINE Name prefix##Lerp(Name a, Name b, float t) {          \
+        return (Name) { VECTOR_EACH_##N(VECTOR_OP_LERP) };                    \
+    }
+
+/**
+ * Vec2 keeps its own API in vector.h. Vec3 and Vec4 are for positions,
+ * colors and homogeneous coordinates, the integer types for packed vertex
+ * formats and pixel coordinates
+ */
+VECTOR_DEFINE_FLOAT(Vec3, vec3, 3)
+VECTOR_DEFINE_FLOAT(Vec4, vec4, 4)
+VECTOR_DEFINE(IVec2, ivec2, int32_t, int64_t, 2)
+VECTOR_DEFINE(IVec3, ivec3, int32_t, int64_t, 3)
+VECTOR_DEFINE(IVec4, ivec4, int32_t, int64_t, 4)
+VECTOR_DEFINE(U16Vec2, u16vec2, uint16_t, uint64_t, 2)
+VECTOR_DEFINE(U16Vec3, u16vec3, uint16_t, uint64_t, 3)
+VECTOR_DEFINE(U16Vec4, u16vec4, uint16_t, uint64_t, 4)
+
+/**
+ * @brief   Cross product of two 3D vectors
+ * @param   a: Vec3, first vector
+ * @param   b: Vec3, second vector
+ * @returns Vector perpendicular to both, following the right hand rule
+ */
+STATIC_FORCE_INLINE Vec3 vec3Cross(Vec3 a, Vec3 b) {
+    return (Vec3) {
+        a.y * b.z - a.z * b.y,
+        a.z * b.x - a.x * b.z,
+        a.x * b.y - a.y * b.x
+    };
+}
+
+/**
+ * @brief   Pack floats into signed normalized 16-bit integers
+ * @param   out: int16_t*, receives count values
+ * @param   in: const float*, values in [-1, 1], clamped
+ * @param   count: uint32_t, number of floats, 3 per Vec3, 4 per Vec4
+ * @returns void
+ * @note    Rounds to nearest, -1 maps to -32767 as GL_SHORT normalized
+ *          attributes expect
+ */
+TGAPI void vectorPackSnorm16(int16_t* out, const float* in, uint32_t count);
+
+/**
+ * @brief   Pack floats into unsigned normalized 16-bit integers
+ * @param   out: uint16_t*, receives count values
+ * @param   in: const float*, values in [0, 1], clamped
+ * @param   count: uint32_t, number of floats
+ * @returns void
+ */
+TGAPI void vectorPackUnorm16(uint16_t* out, const float* in, uint32_t count);
+
+/**
+ * @brief   Unpack signed normalized 16-bit integers back to floats
+ * @param   out: float*, receives count values in [-1, 1]
+ * @param   in: const int16_t*, packed values
+ * @param   count: uint32_t, number of values
+ * @returns void
+ */
+TGAPI void vectorUnpackSnorm16(float* out, const int16_t* in, uint32_t count);
+
+/**
+ * @brief   Convert floats to IEEE half floats, for GL_HALF_FLOAT attributes
+ * @param   out: uint16_t*, receives count half floats
+ * @param   in: const float*, values to convert
+ * @param   count: uint32_t, number of floats
+ * @returns void
+ * @note    Rounds to nearest even, overflows to infinity, keeps NaN and
+ *          produces subnormals
+ */
+TGAPI void vectorPackHalf(uint16_t* out, const float* in, uint32_t count);
+
+/**
+ * @brief   Convert IEEE half floats back to floats, exactly
+ * @param   out: float*, receives count values
+ * @param   in: const uint16_t*, half floats
+ * @param   count: uint32_t, number of values
+ * @returns void
+ */
+TGAPI void vectorUnpackHalf(float* out, const uint16_t* in, uint32_t count);
+
+#endif // VECTOR_TYPES_H
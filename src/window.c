@@ -1,18 +1,52 @@
+#define TG_MEMORY_TAG MEMORY_TAG_WINDOW
+
 // get function defines
 #include "window.h"
+#include "window_internal.h"
+#include "timer.h"
+#include "trace.h"
+#include "texture.h"
+#include "memory.h"
+#include "input_internal.h"
 
-// malloc
-#include <stdlib.h>
+// memset
+#include <string.h>
+// sqrt
+#include <math.h>
 
 // Glad is always included before glfw
 #include "../vendor/glad/gl.h"
 #include <GLFW/glfw3.h>
 
+static uint32_t glfwUsers;  // windows and contexts holding GLFW initialised
+static uint32_t liveWindows;
+static WindowFrameInternal statsFrame = { 1, 0 };   // application frame of the global counters
+
 // Internal Struct
 struct _Window {
     uint32_t width, height;
     const char* title;
     GLFWwindow* windowHandle;
+    DamageTracker* damage;  // NULL unless damage tracking is enabled
+    WindowLoopMode loopMode;
+    double waitTimeout;     // seconds, 0 waits forever
+    uint8_t invalidated;    // a redraw was requested since the frame began
+    uint8_t redrawing;      // the frame being built was requested
+    uint64_t frameInterval; // nanoseconds between frames, 0 if uncapped
+    uint64_t nextFrame;     // timerNow value the next frame may start at
+    InputQueueInternal inputQueue;  // raw events since the last refresh
+    InputSnapshot input;    // state handed out for the current frame
+    WindowSwapMode swapMode;
+    uint32_t framesInFlight;    // 0 if the driver decides
+    GLsync fences[WINDOW_MAX_FRAMES_IN_FLIGHT]; // one per unfinished frame, oldest first
+    uint32_t fenceCount;
+    uint64_t lastSwap;      // timerNow value the previous frame was presented at
+    uint64_t frameTimes[WINDOW_FRAME_HISTORY];  // nanoseconds, a ring
+    uint64_t fenceWaits[WINDOW_FRAME_HISTORY];  // nanoseconds, same ring
+    uint32_t frameCursor, frameCount;
+    WindowGroupInternal* group; // shared with the windows it shares objects with
+    uint64_t statsFrame;    // last application frame this window refreshed in
+    uint64_t groupFrame;    // last frame of its group it refreshed in
 };
 
 // Callback to window resize event, glfw calls this automatically
@@ -23,26 +57,135 @@ PRIVATE void internal_windowResizeCallback(GLFWwindow* window, int width, int he
     win->width = width; // set the new width internally
     win->height = height; // set the new height internally
     glViewport(0, 0, width, height); // resize the rendering viewport of opengl to fit window
+
+    if (win->damage) {
+        int32_t fbWidth, fbHeight;  // damage is tracked in framebuffer pixels
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        damageSetSize(win->damage, fbWidth, fbHeight); // buffers are undefined after resize
+    }
+    win->invalidated = 1;   // on demand windows redraw after a resize
 }
 
-// Return a pointer to a fresh new window
-Window* windowNew(uint32_t width, uint32_t height, const char* title) {
-    glfwInit(); // initialise GLFW
+// Callback to window refresh event, the OS lost the window contents
+PRIVATE void internal_windowRefreshCallback(GLFWwindow* window) {
+    windowInvalidate(glfwGetWindowUserPointer(window));
+}
+
+// Input callbacks only queue the event, the snapshot is built once per frame
+PRIVATE void internal_windowKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    UNUSED(scancode);
+    UNUSED(mods);
+    if (action == GLFW_REPEAT)
+        return; // held state doesn't change on repeats
+    Window* win = glfwGetWindowUserPointer(window);
+    internal_inputPushKey(&win->inputQueue, key, action == GLFW_PRESS);
+}
+
+PRIVATE void internal_windowMouseButtonCallback(GLFWwindow* window, int button, int action, int mods) {
+    UNUSED(mods);
+    Window* win = glfwGetWindowUserPointer(window);
+    internal_inputPushButton(&win->inputQueue, button, action == GLFW_PRESS);
+}
+
+PRIVATE void internal_windowCursorCallback(GLFWwindow* window, double x, double y) {
+    Window* win = glfwGetWindowUserPointer(window);
+    internal_inputPushCursor(&win->inputQueue, (Vec2) { (float) x, (float) y });
+}
+
+PRIVATE void internal_windowScrollCallback(GLFWwindow* window, double x, double y) {
+    Window* win = glfwGetWindowUserPointer(window);
+    internal_inputPushScroll(&win->inputQueue, (Vec2) { (float) x, (float) y });
+}
+
+PRIVATE void internal_windowCharCallback(GLFWwindow* window, unsigned int codepoint) {
+    Window* win = glfwGetWindowUserPointer(window);
+    internal_inputPushChar(&win->inputQueue, codepoint);
+}
+
+uint8_t internal_windowAcquireGlfw(void) {
+    if (glfwUsers == 0 && !glfwInit())  // only the first user initialises GLFW
+        return 0;
+    glfwUsers++;
+    return 1;
+}
+
+void internal_windowReleaseGlfw(void) {
+    if (glfwUsers && --glfwUsers == 0)
+        glfwTerminate();    // the last user tears GLFW down
+}
+
+Window* internal_windowCreate(uint32_t width, uint32_t height, const char* title, void* share, uint8_t visible) {
+    if (!internal_windowAcquireGlfw())
+        return NULL;
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);  // set major version of opengl
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);  // set minor version of opengl
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // set profile of opengl
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE); // hints stick, so always set it
 
     // Allocate memory for window and init fields
-    Window* window = malloc(sizeof(Window));
-    window->windowHandle = glfwCreateWindow(width, height, title, NULL, NULL);  // return pointer to our window
+    Window* window = ALLOC_S(Window);
+    if (!window) {
+        internal_windowReleaseGlfw();
+        return NULL;
+    }
+    window->windowHandle = glfwCreateWindow(width, height, title, NULL, share);  // share the GL objects of another window, if any
+    if (!window->windowHandle) {
+        TG_FREE(window);
+        internal_windowReleaseGlfw();
+        return NULL;
+    }
+    // sharing objects means sharing what the library keeps per context too
+    Window* shareWindow = share ? glfwGetWindowUserPointer(share) : NULL;
+    window->group = shareWindow ? shareWindow->group
+                                : TG_CALLOC(1, sizeof(WindowGroupInternal));
+    if (!window->group) {
+        glfwDestroyWindow(window->windowHandle);
+        TG_FREE(window);
+        internal_windowReleaseGlfw();
+        return NULL;
+    }
+    if (!window->group->windowCount) {
+        window->group->frame.index = 1;
+        internal_gpuMemoryScopeInit(&window->group->memory);
+    }
+    window->group->windowCount++;
+    window->statsFrame = 0;
+    window->groupFrame = 0;
+    liveWindows++;
+
     window->width = width;  // set width
     window->height = height;    // set height
     window->title = title;  // set title
+    window->damage = NULL;  // damage tracking is opt in
+    window->loopMode = WINDOW_LOOP_CONTINUOUS;  // poll every frame, like a game loop
+    window->waitTimeout = 0.0;
+    window->invalidated = 1;    // the first frame always has to be drawn
+    window->redrawing = 0;
+    window->frameInterval = 0;  // uncapped
+    window->nextFrame = 0;
+    memset(&window->inputQueue, 0, sizeof(InputQueueInternal));  // no events yet
+    memset(&window->input, 0, sizeof(InputSnapshot));  // nothing held
+    window->swapMode = WINDOW_SWAP_DEFAULT; // glfwSwapInterval is only called when asked to
+    window->framesInFlight = 0; // the driver decides
+    window->fenceCount = 0;
+    window->lastSwap = 0;   // the first frame has no frame time
+    window->frameCursor = 0;
+    window->frameCount = 0;
 
     glfwMakeContextCurrent(window->windowHandle); // attach the window to the thread on which opengl calls are issued
     glfwSetWindowUserPointer(window->windowHandle, window); // attach the window pointer to our custom window struct
     glfwSetWindowSizeCallback(window->windowHandle, internal_windowResizeCallback); // pass resize callback
+    glfwSetWindowRefreshCallback(window->windowHandle, internal_windowRefreshCallback); // pass refresh callback
+    glfwSetKeyCallback(window->windowHandle, internal_windowKeyCallback);    // pass input callbacks
+    glfwSetMouseButtonCallback(window->windowHandle, internal_windowMouseButtonCallback);
+    glfwSetCursorPosCallback(window->windowHandle, internal_windowCursorCallback);
+    glfwSetScrollCallback(window->windowHandle, internal_windowScrollCallback);
+    glfwSetCharCallback(window->windowHandle, internal_windowCharCallback);
+
+    double cursorX, cursorY;    // start from the real cursor position, not the origin
+    glfwGetCursorPos(window->windowHandle, &cursorX, &cursorY);
+    window->input.mousePosition = (Vec2) { (float) cursorX, (float) cursorY };
 
     gladLoadGL(glfwGetProcAddress); // load gl functions through GLAD, glfwGetProcAddress returns address of process
 
@@ -53,11 +196,31 @@ Window* windowNew(uint32_t width, uint32_t height, const char* title) {
     return window;  // return pointer to our custom window struct
 }
 
+// Return a pointer to a fresh new window
+Window* windowNew(uint32_t width, uint32_t height, const char* title) {
+    TRACE_FUNCTION();   // context creation and GL loading dominate startup
+    return internal_windowCreate(width, height, title, NULL, 1);
+}
+
+// Hidden window, only its OpenGL context is used
+Window* windowNewHeadless(uint32_t width, uint32_t height) {
+    TRACE_FUNCTION();
+    return internal_windowCreate(width, height, "", NULL, 0);
+}
+
 // Void pointer here because we don't want to reveal glfw as part of public api
 void* windowGetHandle(Window* window) {
     return window->windowHandle;
 }
 
+WindowGroupInternal* internal_windowCurrentGroup(void) {
+    if (!glfwUsers)
+        return NULL;    // glfwGetCurrentContext errors before glfwInit
+    GLFWwindow* handle = glfwGetCurrentContext();
+    Window* window = handle ? glfwGetWindowUserPointer(handle) : NULL;
+    return window ? window->group : NULL;
+}
+
 uint32_t windowGetWidth(Window* window) {
     return window->width;
 }
@@ -107,19 +270,328 @@ uint8_t windowCloseEvent(Window* window) {
     return glfwWindowShouldClose(window->windowHandle);
 }
 
+void windowSetDamageTracking(Window* window, uint8_t enabled) {
+    if (enabled && !window->damage) {
+        Vec2 size = windowGetSize(window);
+        window->damage = damageTrackerNew((uint32_t) size.x, (uint32_t) size.y);
+    } else if (!enabled && window->damage) {
+        damageTrackerDestroy(window->damage);
+        window->damage = NULL;
+    }
+}
+
+DamageTracker* windowGetDamage(Window* window) {
+    return window->damage;
+}
+
+void windowSetLoopMode(Window* window, WindowLoopMode mode) {
+    window->loopMode = mode;
+}
+
+void windowSetWaitTimeout(Window* window, double seconds) {
+    window->waitTimeout = seconds;
+}
+
+void windowInvalidate(Window* window) {
+    window->invalidated = 1;
+    if (window->damage)
+        damageAddAll(window->damage);   // the next frame is damaged again as it begins
+    glfwPostEmptyEvent();   // wake up glfwWaitEvents, safe from any thread
+}
+
+uint8_t windowNeedsRedraw(Window* window) {
+    if (window->damage)
+        return window->invalidated || !damageIsEmpty(window->damage);
+    if (window->loopMode == WINDOW_LOOP_ON_DEMAND)
+        return window->invalidated || window->redrawing;
+    return 1;
+}
+
+// Requests made until now are for the frame beginning, later ones, such as
+// an animation invalidating while it draws, are for the one after it
+PRIVATE void internal_windowBeginFrame(Window* window) {
+    window->redrawing = window->invalidated;
+    window->invalidated = 0;
+    if (window->redrawing && window->damage)
+        damageAddAll(window->damage);
+}
+
+void windowSetFrameRateCap(Window* window, uint32_t framesPerSecond) {
+    window->frameInterval = framesPerSecond ? 1000000000ull / framesPerSecond : 0;
+    window->nextFrame = timerNow();
+}
+
+uint64_t internal_windowNextFrameSlot(uint64_t* next, uint64_t now,
+                                      uint64_t interval) {
+    if (now < *next) {
+        uint64_t slot = *next;
+        *next += interval;
+        return slot;
+    }
+    // fell behind, start counting from now instead of rushing to catch up
+    *next = now + interval;
+    return 0;
+}
+
+// Sleep until the next frame slot, keeps frames evenly spaced
+PRIVATE void internal_windowPaceFrame(Window* window) {
+    if (!window->frameInterval)
+        return;
+    TRACE_SCOPE("windowPaceFrame");
+    uint64_t slot = internal_windowNextFrameSlot(&window->nextFrame,
+                                                 timerNow(),
+                                                 window->frameInterval);
+    if (slot)
+        timerSleepUntil(slot);
+}
+
+// Seconds between refreshes of the monitor the window is on, 60 Hz if unknown
+PRIVATE double internal_windowDisplayInterval(Window* window) {
+    GLFWmonitor* monitor = glfwGetWindowMonitor(window->windowHandle);
+    const GLFWvidmode* mode = glfwGetVideoMode(monitor ? monitor : glfwGetPrimaryMonitor());
+    return mode && mode->refreshRate > 0 ? 1.0 / mode->refreshRate : 1.0 / 60.0;
+}
+
+// Handle pending events, waiting for them if the loop mode allows
+// idle is set when the frame was skipped, nothing would be drawn by polling
+PRIVATE void internal_windowProcessEvents(Window* window, int idle) {
+    TRACE_SCOPE("windowProcessEvents");    // includes time spent waiting
+    switch (window->loopMode) {
+        case WINDOW_LOOP_WAIT_EVENTS:
+            if (window->waitTimeout > 0.0)
+                glfwWaitEventsTimeout(window->waitTimeout); // wake up at least this often
+            else
+                glfwWaitEvents();
+            break;
+        case WINDOW_LOOP_ON_DEMAND:
+            // invalidated while drawing means animation, keep going without sleeping
+            if (windowNeedsRedraw(window))
+                glfwPollEvents();
+            else
+                glfwWaitEvents();
+            break;
+        case WINDOW_LOOP_CONTINUOUS:
+        default:
+            // an uncapped idle loop would spin a core, wait at most one display refresh
+            // a frame cap already slept in internal_windowPaceFrame
+            if (idle && !window->frameInterval)
+                glfwWaitEventsTimeout(internal_windowDisplayInterval(window));
+            else
+                glfwPollEvents();   // poll events like window close, window redraw, window rezise, etc.
+            break;
+    }
+
+    internal_inputUpdate(&window->inputQueue, &window->input);  // freeze input for the next frame
+}
+
+WindowSwapMode windowSetSwapMode(Window* window, WindowSwapMode mode) {
+    glfwMakeContextCurrent(window->windowHandle);   // the interval is set on the current context
+    if (mode == WINDOW_SWAP_ADAPTIVE &&
+        !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+        mode = WINDOW_SWAP_VSYNC;   // no tearing late frames, plain vsync is the closest
+    switch (mode) {
+        case WINDOW_SWAP_IMMEDIATE: glfwSwapInterval(0); break;
+        case WINDOW_SWAP_VSYNC: glfwSwapInterval(1); break;
+        case WINDOW_SWAP_ADAPTIVE: glfwSwapInterval(-1); break; // negative means adaptive
+        case WINDOW_SWAP_DEFAULT:
+        default: break;     // the driver's setting can't be read back, leave it
+    }
+    window->swapMode = mode;
+    return mode;
+}
+
+void windowSetFramesInFlight(Window* window, uint32_t frames) {
+    window->framesInFlight = frames < WINDOW_MAX_FRAMES_IN_FLIGHT ? frames : WINDOW_MAX_FRAMES_IN_FLIGHT;
+}
+
+Vec2 windowLatchCursor(Window* window) {
+    double x, y;    // asks the OS directly, queued events stay for the next snapshot
+    glfwGetCursorPos(window->windowHandle, &x, &y);
+    return (Vec2) { (float) x, (float) y };
+}
+
+WindowFrameStats internal_windowFrameStats(const uint64_t* frameTimes,
+                                           const uint64_t* fenceWaits,
+                                           uint32_t count) {
+    WindowFrameStats stats;
+    memset(&stats, 0, sizeof(WindowFrameStats));
+    stats.frames = count;
+    if (!count)
+        return stats;
+
+    double sum = 0.0, waited = 0.0;
+    stats.minMs = stats.maxMs = timerToMs(frameTimes[0]);
+    for (uint32_t i = 0; i < count; i++) {
+        double ms = timerToMs(frameTimes[i]);
+        sum += ms;
+        waited += timerToMs(fenceWaits[i]);
+        stats.minMs = ms < stats.minMs ? ms : stats.minMs;
+        stats.maxMs = ms > stats.maxMs ? ms : stats.maxMs;
+    }
+    stats.meanMs = sum / count;
+    stats.fenceWaitMs = waited / count;
+
+    double squares = 0.0;   // second pass, subtracting the mean first keeps the precision
+    for (uint32_t i = 0; i < count; i++) {
+        double delta = timerToMs(frameTimes[i]) - stats.meanMs;
+        squares += delta * delta;
+    }
+    stats.varianceMs = squares / count;
+    stats.deviationMs = sqrt(stats.varianceMs);
+    return stats;
+}
+
+WindowFrameStats windowGetFrameStats(Window* window) {
+    // the ring's order doesn't matter to the stats
+    return internal_windowFrameStats(window->frameTimes, window->fenceWaits,
+                                     window->frameCount);
+}
+
+// Fence the frame just swapped, then wait until few enough frames are unfinished
+// returns the nanoseconds spent waiting
+PRIVATE uint64_t internal_windowLimitFramesInFlight(Window* window) {
+    if (!window->framesInFlight && !window->fenceCount)
+        return 0;
+    TRACE_SCOPE("windowLimitFramesInFlight");
+    uint64_t start = timerNow();
+    if (window->framesInFlight)
+        window->fences[window->fenceCount++] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // frames in flight counts the one the caller builds next
+    uint32_t allowed = window->framesInFlight ? window->framesInFlight - 1 : 0;
+    while (window->fenceCount > allowed) {
+        // flush so the fence reaches the GPU, a second at most in case the driver hangs
+        glClientWaitSync(window->fences[0], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        glDeleteSync(window->fences[0]);
+        window->fenceCount--;
+        memmove(window->fences, window->fences + 1, sizeof(GLsync) * window->fenceCount);
+    }
+    return timerNow() - start;
+}
+
+// Frame time of the frame just presented, into the history ring
+PRIVATE void internal_windowRecordFrame(Window* window, uint64_t waited) {
+    uint64_t now = timerNow();
+    if (window->lastSwap) {
+        window->frameTimes[window->frameCursor] = now - window->lastSwap;
+        window->fenceWaits[window->frameCursor] = waited;
+        window->frameCursor = (window->frameCursor + 1) % WINDOW_FRAME_HISTORY;
+        if (window->frameCount < WINDOW_FRAME_HISTORY)
+            window->frameCount++;
+    }
+    window->lastSwap = now;
+}
+
+const InputSnapshot* windowGetInput(Window* window) {
+    return &window->input;
+}
+
+// Count a refresh towards a frame spanning windowCount windows, returns the
+// number of frames closed. It closes once every window has refreshed, a
+// window coming around again first means the others aren't refreshed at the
+// moment, that closes it too
+PRIVATE uint32_t internal_windowCountRefresh(WindowFrameInternal* frame,
+                                             uint64_t* seen,
+                                             uint32_t windowCount) {
+    uint32_t closed = 0;
+    if (*seen == frame->index) {
+        frame->index++;
+        frame->refreshes = 0;
+        closed++;
+    }
+    *seen = frame->index;
+    if (++frame->refreshes >= windowCount) {
+        frame->index++;
+        frame->refreshes = 0;
+        closed++;
+    }
+    return closed;
+}
+
+// Upload and allocation counters are global, one frame of them spans every
+// window. GPU memory is accounted per share group, and evicting deletes
+// objects of the group, so it runs over the group's windows with one of
+// them current
+PRIVATE void internal_windowEndFrames(Window* window) {
+    for (uint32_t i = internal_windowCountRefresh(&statsFrame,
+             &window->statsFrame, liveWindows); i; i--) {
+        textureStatsEndFrame();
+        memoryEndFrame();
+    }
+
+    WindowGroupInternal* group = window->group;
+    uint32_t closed = internal_windowCountRefresh(&group->frame,
+        &window->groupFrame, group->windowCount);
+    if (!closed)
+        return;
+    GLFWwindow* current = glfwGetCurrentContext();
+    if (current != window->windowHandle)
+        glfwMakeContextCurrent(window->windowHandle);
+    for (; closed; closed--)
+        internal_gpuMemoryScopeEndFrame(&group->memory);
+    if (current != window->windowHandle)
+        glfwMakeContextCurrent(current);
+}
+
 // Needed for window to not get stale or freeze
 void windowRefresh(Window* window) {
+    TRACE_FUNCTION();
+    // An unchanged frame is not presented at all
+    // the front buffer already shows the right image
+    if (!windowNeedsRedraw(window)) {
+        window->lastSwap = 0;   // idle time isn't a frame time
+        internal_windowEndFrames(window);
+        internal_windowPaceFrame(window);
+        internal_windowProcessEvents(window, 1);
+        internal_windowBeginFrame(window);
+        return;
+    }
+
     // Swap the front and back buffer
     // this is needed because windows have 2 buffers, front and back.
     // the front buffer is used to display whatever is going on screen
     // the back buffer is used to store whatever we are rendering
     // when we are done rendering, we swap the buffers, so that the completed back buffer
     // is now being displayed, and the front buffer is now being drawn on. This swapping happens every frame.
-    glfwSwapBuffers(window->windowHandle);
-    glfwPollEvents();   // poll events like window close, window redraw, window rezise, etc.
+    {
+        TRACE_SCOPE("glfwSwapBuffers"); // blocks here when vsync is on
+        glfwSwapBuffers(window->windowHandle);
+    }
+    // waiting on the GPU comes before reading input, so the input is as fresh as it can be
+    internal_windowRecordFrame(window, internal_windowLimitFramesInFlight(window));
+    if (window->damage)
+        damageEndFrame(window->damage); // this frame's damage is now the previous one
+    window->redrawing = 0;
+    internal_windowEndFrames(window);  // evicts caches if over the GPU memory budget
+
+    internal_windowPaceFrame(window);
+    internal_windowProcessEvents(window, 0);
+    internal_windowBeginFrame(window);
 }
 
 // free the pointer to the allocated window struct
 void windowDestroy(Window* window) {
-    free(window);
+    if (!window)
+        return;
+    damageTrackerDestroy(window->damage);
+    if (window->fenceCount) {
+        glfwMakeContextCurrent(window->windowHandle);   // fences belong to this context
+        for (uint32_t i = 0; i < window->fenceCount; i++)
+            glDeleteSync(window->fences[i]);
+    }
+    if (--window->group->windowCount == 0) {
+        glfwMakeContextCurrent(window->windowHandle);   // the group's objects die with it
+        internal_textureStagingRelease(&window->group->staging);
+        internal_gpuMemoryScopeRelease(&window->group->memory);
+        TG_FREE(window->group);
+    } else if (window->groupFrame == window->group->frame.index) {
+        window->group->frame.refreshes--;   // the frame waits on one window less
+    }
+    if (window->statsFrame == statsFrame.index)
+        statsFrame.refreshes--;
+    liveWindows--;
+    glfwDestroyWindow(window->windowHandle);    // also destroys its GL context
+    TG_FREE(window);
+    internal_windowReleaseGlfw();   // terminates GLFW with the last window
 }
\ No newline at end of file
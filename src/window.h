@@ -6,6 +6,8 @@
 #include <stdint.h>
 
 #include "vector.h"
+#include "damage.h"
+#include "input.h"
 #include "defines.h"
 
 /**
@@ -13,22 +15,74 @@
  */
 typedef struct _Window Window;
 
+/**
+ * @brief   How windowRefresh waits for the next frame
+ */
+typedef enum WindowLoopMode {
+    WINDOW_LOOP_CONTINUOUS,     /**< Poll events, render every frame */
+    WINDOW_LOOP_WAIT_EVENTS,    /**< Sleep until an event or the timeout */
+    WINDOW_LOOP_ON_DEMAND       /**< Render only after windowInvalidate */
+} WindowLoopMode;
+
+// Most frames windowSetFramesInFlight lets the GPU queue up
+#define WINDOW_MAX_FRAMES_IN_FLIGHT 4
+
+// Presented frames windowGetFrameStats looks back over
+#define WINDOW_FRAME_HISTORY 120
+
+/**
+ * @brief   How windowRefresh presents, see windowSetSwapMode
+ */
+typedef enum WindowSwapMode {
+    WINDOW_SWAP_DEFAULT,        /**< Whatever the driver is set to */
+    WINDOW_SWAP_IMMEDIATE,      /**< No vsync, lowest latency, may tear */
+    WINDOW_SWAP_VSYNC,          /**< Wait for vertical blank, no tearing */
+    WINDOW_SWAP_ADAPTIVE        /**< Vsync, but late frames swap at once */
+} WindowSwapMode;
+
+/**
+ * @brief   Frame times over the last WINDOW_FRAME_HISTORY presented frames
+ * @note    A frame time is the time between two buffer swaps returning,
+ *          including the wait for frames in flight
+ */
+typedef struct WindowFrameStats {
+    uint32_t frames;        /**< Frame times the stats are made of */
+    double meanMs;          /**< Average frame time */
+    double varianceMs;      /**< Variance of the frame time, in ms² */
+    double deviationMs;     /**< Standard deviation, the jitter */
+    double minMs;           /**< Fastest frame */
+    double maxMs;           /**< Slowest frame, the worst hitch */
+    double fenceWaitMs;     /**< Average time blocked on frames in flight */
+} WindowFrameStats;
+
 /**
  * @brief   Create a new window
  * @param   width: uint32_t, width of the window
  * @param   height: uint32_t, height of the window
- * @returns Pointer to a new Window
- * @see     Window
+ * @returns Pointer to a new Window, NULL on failure
+ * @note    Every window has its own OpenGL objects, use a Context to create
+ *          windows that share them
+ * @see     Window, contextCreateWindow
  */
 TGAPI Window* windowNew(uint32_t width, uint32_t height, const char* title);
 
+/**
+ * @brief   Create a hidden window, to render offscreen into render targets
+ * @param   width: uint32_t, width of the default framebuffer
+ * @param   height: uint32_t, height of the default framebuffer
+ * @returns Pointer to a new Window, NULL on failure, such as no display
+ * @note    The window is never shown, everything else works as usual
+ * @see     Window, renderTargetReadPixels
+ */
+TGAPI Window* windowNewHeadless(uint32_t width, uint32_t height);
+
 /**
  * @brief   Get raw pointer to the window
  * @param   window: Pointer to the window
  * @returns Raw pointer to GLFW as void*
  * @see     Window
  */
-TGAPI INLINE void* windowGetHandle(Window* window);
+TGAPI void* windowGetHandle(Window* window);
 
 /**
  * @brief   Get width of current window
@@ -36,7 +90,7 @@ TGAPI INLINE void* windowGetHandle(Window* window);
  * @returns Width of the window
  * @see     Window
  */
-TGAPI INLINE uint32_t windowGetWidth(Window* window);
+TGAPI uint32_t windowGetWidth(Window* window);
 
 /**
  * @brief   Get height of current window
@@ -44,7 +98,7 @@ TGAPI INLINE uint32_t windowGetWidth(Window* window);
  * @returns Height of the window
  * @see     Window
  */
-TGAPI INLINE uint32_t windowGetHeight(Window* window);
+TGAPI uint32_t windowGetHeight(Window* window);
 
 /**
  * @brief   Get title of current window
@@ -52,7 +106,7 @@ TGAPI INLINE uint32_t windowGetHeight(Window* window);
  * @returns Title of the window
  * @see     Window
  */
-TGAPI INLINE const char* windowGetTitle(Window* window);
+TGAPI const char* windowGetTitle(Window* window);
 
 /**
  * @brief   Get position of current window
@@ -60,7 +114,7 @@ TGAPI INLINE const char* windowGetTitle(Window* window);
  * @returns 2D Vector, with position of the window as components
  * @see     Window, Vec2
  */
-TGAPI INLINE Vec2 windowGetPosition(Window* window);
+TGAPI Vec2 windowGetPosition(Window* window);
 
 /**
  * @brief   Get size of current window
@@ -68,7 +122,7 @@ TGAPI INLINE Vec2 windowGetPosition(Window* window);
  * @returns 2D Vector, with size of the window as components
  * @see     Window, Vec2
  */
-TGAPI INLINE Vec2 windowGetSize(Window* window);
+TGAPI Vec2 windowGetSize(Window* window);
 
 /**
  * @brief   Set title of current window
@@ -77,7 +131,7 @@ TGAPI INLINE Vec2 windowGetSize(Window* window);
  * @returns void
  * @see     Window
  */
-TGAPI INLINE void windowSetTitle(Window* window, const char* title);
+TGAPI void windowSetTitle(Window* window, const char* title);
 
 /**
  * @brief   Set title of current window
@@ -87,7 +141,7 @@ TGAPI INLINE void windowSetTitle(Window* window, const char* title);
  * @returns void
  * @see     Window
  */
-TGAPI INLINE void windowSetSize(Window* window, uint32_t width, uint32_t height);
+TGAPI void windowSetSize(Window* window, uint32_t width, uint32_t height);
 
 /**
  * @brief   Set title of current window
@@ -96,7 +150,7 @@ TGAPI INLINE void windowSetSize(Window* window, uint32_t width, uint32_t height)
  * @returns void
  * @see     Window, Vec2
  */
-TGAPI INLINE void windowSetSizeVec2(Window* window, Vec2 size);
+TGAPI void windowSetSizeVec2(Window* window, Vec2 size);
 
 /**
  * @brief   Set title of current window
@@ -106,7 +160,7 @@ TGAPI INLINE void windowSetSizeVec2(Window* window, Vec2 size);
  * @returns void
  * @see     Window
  */
-TGAPI INLINE void windowSetPosition(Window* window, uint32_t x, uint32_t y);
+TGAPI void windowSetPosition(Window* window, uint32_t x, uint32_t y);
 
 /**
  * @brief   Set title of current window
@@ -115,7 +169,7 @@ TGAPI INLINE void windowSetPosition(Window* window, uint32_t x, uint32_t y);
  * @returns void
  * @see     Window, Vec2
  */
-TGAPI INLINE void windowSetPositionVec2(Window* window, Vec2 position);
+TGAPI void windowSetPositionVec2(Window* window, Vec2 position);
 
 /**
  * @brief   Check if window the window received a close event
@@ -123,7 +177,127 @@ TGAPI INLINE void windowSetPositionVec2(Window* window, Vec2 position);
  * @returns 1 if window close event has not been received
  * @see     Window
  */
-TGAPI INLINE uint8_t windowCloseEvent(Window* window);
+TGAPI uint8_t windowCloseEvent(Window* window);
+
+/**
+ * @brief   Enable or disable damage tracked partial redraws
+ * @param   window: Pointer to the window
+ * @param   enabled: 1 to track damage, 0 to always present every frame
+ * @returns void
+ * @note    While enabled, windowRefresh skips the buffer swap on frames
+ *          where nothing was damaged
+ * @see     Window, DamageTracker
+ */
+TGAPI void windowSetDamageTracking(Window* window, uint8_t enabled);
+
+/**
+ * @brief   Get the damage tracker of the window
+ * @param   window: Pointer to the window
+ * @returns Pointer to the tracker, NULL if damage tracking is disabled
+ * @see     Window, DamageTracker, windowSetDamageTracking
+ */
+TGAPI DamageTracker* windowGetDamage(Window* window);
+
+/**
+ * @brief   Set how the window waits between frames
+ * @param   window: Pointer to the window
+ * @param   mode: WindowLoopMode, WINDOW_LOOP_CONTINUOUS by default
+ * @returns void
+ * @see     Window, WindowLoopMode
+ */
+TGAPI void windowSetLoopMode(Window* window, WindowLoopMode mode);
+
+/**
+ * @brief   Set the longest time WINDOW_LOOP_WAIT_EVENTS sleeps for
+ * @param   window: Pointer to the window
+ * @param   seconds: double, wake up timeout, 0 waits for events forever
+ * @returns void
+ * @see     Window, WindowLoopMode
+ */
+TGAPI void windowSetWaitTimeout(Window* window, double seconds);
+
+/**
+ * @brief   Request a redraw, wakes up a window waiting for events
+ * @param   window: Pointer to the window
+ * @returns void
+ * @note    With damage tracking enabled, the whole window is damaged.
+ *          Called while drawing, it requests the frame after this one,
+ *          which is how an animation keeps WINDOW_LOOP_ON_DEMAND going
+ * @see     Window, windowNeedsRedraw
+ */
+TGAPI void windowInvalidate(Window* window);
+
+/**
+ * @brief   Check if the next frame has to be drawn
+ * @param   window: Pointer to the window
+ * @returns 1 if the caller should render before calling windowRefresh
+ * @note    Always 1 in WINDOW_LOOP_CONTINUOUS without damage tracking
+ * @see     Window, windowInvalidate, windowSetDamageTracking
+ */
+TGAPI uint8_t windowNeedsRedraw(Window* window);
+
+/**
+ * @brief   Limit how often windowRefresh returns
+ * @param   window: Pointer to the window
+ * @param   framesPerSecond: uint32_t, frame rate cap, 0 to disable
+ * @returns void
+ * @note    Frames are paced with a precise sleep, see timerSleepUntil
+ * @see     Window
+ */
+TGAPI void windowSetFrameRateCap(Window* window, uint32_t framesPerSecond);
+
+/**
+ * @brief   Set the swap interval used by windowRefresh
+ * @param   window: Pointer to the window
+ * @param   mode: WindowSwapMode, WINDOW_SWAP_DEFAULT by default
+ * @returns Mode in effect, WINDOW_SWAP_ADAPTIVE becomes WINDOW_SWAP_VSYNC
+ *          when the driver has no EXT_swap_control_tear
+ * @note    Makes the window's context current, the interval belongs to it
+ * @see     Window, WindowSwapMode
+ */
+TGAPI WindowSwapMode windowSetSwapMode(Window* window, WindowSwapMode mode);
+
+/**
+ * @brief   Limit how many frames the GPU may still be working on when
+ *          windowRefresh returns
+ * @param   window: Pointer to the window
+ * @param   frames: uint32_t, at most WINDOW_MAX_FRAMES_IN_FLIGHT, 0 leaves
+ *          it to the driver, which often queues several
+ * @returns void
+ * @note    A fence is placed after every swap and windowRefresh waits on
+ *          the oldest one, before input is read. 1 gives the lowest input
+ *          latency, 2 keeps the CPU and GPU working in parallel
+ * @see     Window, windowGetFrameStats
+ */
+TGAPI void windowSetFramesInFlight(Window* window, uint32_t frames);
+
+/**
+ * @brief   Sample the cursor right now, instead of at the start of the frame
+ * @param   window: Pointer to the window
+ * @returns Cursor position in window coordinates
+ * @note    Late latching: render everything else first, then draw what
+ *          follows the cursor with this position just before windowRefresh.
+ *          Events aren't processed, the input snapshot is left alone
+ * @see     Window, windowGetInput
+ */
+TGAPI Vec2 windowLatchCursor(Window* window);
+
+/**
+ * @brief   Get frame time statistics, to compare presentation modes
+ * @param   window: Pointer to the window
+ * @returns Stats over the last WINDOW_FRAME_HISTORY presented frames
+ * @see     Window, WindowFrameStats
+ */
+TGAPI WindowFrameStats windowGetFrameStats(Window* window);
+
+/**
+ * @brief   Get the input state of the current frame
+ * @param   window: Pointer to the window
+ * @returns Pointer to the snapshot, updated by every windowRefresh
+ * @note    Queries on the snapshot are O(1) and never call into GLFW
+ * @see     Window, InputSnapshot, inputKeyDown
+ */
+TGAPI const InputSnapshot* windowGetInput(Window* window);
 
 /**
  * @brief   Refresh the window
@@ -131,14 +305,15 @@ TGAPI INLINE uint8_t windowCloseEvent(Window* window);
  * @returns void
  * @see     Window
  */
-TGAPI INLINE void windowRefresh(Window* window);
+TGAPI void windowRefresh(Window* window);
 
 /**
  * @brief   De initialise the window
  * @param   window: Pointer to the window
  * @returns void
+ * @note    Destroying the last window terminates GLFW
  * @see     Window
  */
-TGAPI INLINE void windowDestroy(Window* window);
+TGAPI void windowDestroy(Window* window);
 
 #endif //WINDOW_H
\ No newline at end of file
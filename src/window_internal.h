@@ -0,0 +1,52 @@
+// Window internal API, for modules that create or drive windows
+
+#ifndef WINDOW_INTERNAL_H
+#define WINDOW_INTERNAL_H
+
+#include <stdint.h>
+
+#include "window.h"
+#include "texture_internal.h"
+#include "gpu_memory_internal.h"
+
+// A frame spanning several windows, closed once each has refreshed
+typedef struct WindowFrameInternal {
+    uint64_t index;         // starts at 1, windows start out at 0
+    uint32_t refreshes;     // windows refreshed in it
+} WindowFrameInternal;
+
+// State kept per share group, windows of a Context have one between them
+typedef struct WindowGroupInternal {
+    uint32_t windowCount;   // freed with the last window
+    WindowFrameInternal frame;  // GPU memory frames, over the group's windows
+    TextureStagingInternal staging;
+    GpuMemoryScopeInternal memory;
+} WindowGroupInternal;
+
+// Share group of the current OpenGL context, NULL if no Window made it
+WindowGroupInternal* internal_windowCurrentGroup(void);
+
+// Create a window, sharing the OpenGL object namespace of share if not NULL
+// share is the raw GLFW handle, see windowGetHandle
+Window* internal_windowCreate(uint32_t width, uint32_t height,
+                              const char* title, void* share,
+                              uint8_t visible);
+
+// Advance next, the timerNow value a capped frame may start at, by one
+// interval. Returns the slot to sleep until, 0 if the frame is late, then
+// the slots restart from now
+uint64_t internal_windowNextFrameSlot(uint64_t* next, uint64_t now,
+                                      uint64_t interval);
+
+// Stats over count frame times and fence waits, in nanoseconds
+WindowFrameStats internal_windowFrameStats(const uint64_t* frameTimes,
+                                           const uint64_t* fenceWaits,
+                                           uint32_t count);
+
+// Reference counted glfwInit, returns 0 if GLFW failed to initialise
+uint8_t internal_windowAcquireGlfw(void);
+
+// Reference counted glfwTerminate, the last release terminates GLFW
+void internal_windowReleaseGlfw(void);
+
+#endif // WINDOW_INTERNAL_H
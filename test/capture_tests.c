@@ -0,0 +1,186 @@
+#include "testing_framework.h"
+#include "../src/capture.h"
+#include "../src/image.h"
+#include "../src/render_target.h"
+#include "../src/window.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WIDTH 8
+#define HEIGHT 4
+#define FRAME_BYTES (WIDTH * HEIGHT * 4)
+
+static Window* glWindow;    // NULL without a display, GL tests are skipped
+
+static void fillFrame(uint8_t* pixels, uint32_t seed) {
+    for (uint32_t i = 0; i < FRAME_BYTES; i++)
+        pixels[i] = (uint8_t) (i * 7 + seed * 31);
+}
+
+static long readFile(const char* path, uint8_t* out, long size) {
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return -1;
+    long read = (long) fread(out, 1, (size_t) size, file);
+    fclose(file);
+    return read;
+}
+
+// Raw frames are appended in submission order, top row first
+int test_rawFrames() {
+    uint8_t frames[3][FRAME_BYTES];
+    Capture* capture = captureNew(WIDTH, HEIGHT, CAPTURE_FORMAT_RAW,
+                                  "capture_test.raw", 30);
+    for (uint32_t i = 0; i < 3; i++) {
+        fillFrame(frames[i], i);
+        ASSERT_EQ(1, (int) captureSubmitPixels(capture, frames[i]));
+    }
+    captureFlush(capture);
+    CaptureStats stats = captureGetStats(capture);
+    ASSERT_EQ(3, (int) stats.submitted);
+    ASSERT_EQ(3, (int) stats.written);
+    ASSERT_EQ(0, (int) (stats.dropped + stats.failed));
+    captureDestroy(capture);
+
+    static uint8_t file[4 * FRAME_BYTES];
+    ASSERT_EQ(3 * FRAME_BYTES, (int) readFile("capture_test.raw", file,
+                                              sizeof(file)));
+    ASSERT_EQ(0, memcmp(file, frames, sizeof(frames)));
+    remove("capture_test.raw");
+    return 0;
+}
+
+// Y4M holds a header, then a FRAME marker and three full planes per frame
+int test_y4mFrames() {
+    uint8_t white[FRAME_BYTES], black[FRAME_BYTES];
+    memset(white, 255, sizeof(white));
+    memset(black, 0, sizeof(black));
+    Capture* capture = captureNew(WIDTH, HEIGHT, CAPTURE_FORMAT_Y4M,
+                                  "capture_test.y4m", 25);
+    captureSubmitPixels(capture, white);
+    captureSubmitPixels(capture, black);
+    captureDestroy(capture);
+
+    static const char header[] = "YUV4MPEG2 W8 H4 F25:1 Ip A1:1 C444\n";
+    size_t headerLength = sizeof(header) - 1;
+    size_t frameLength = 6 + WIDTH * HEIGHT * 3;
+    static uint8_t file[1024];
+    ASSERT_EQ((int) (headerLength + 2 * frameLength),
+              (int) readFile("capture_test.y4m", file, sizeof(file)));
+    ASSERT_EQ(0, memcmp(file, header, headerLength));
+
+    const uint8_t* frame = file + headerLength;
+    ASSERT_EQ(0, memcmp(frame, "FRAME\n", 6));
+    ASSERT_EQ(235, (int) frame[6]);                         // white luma
+    ASSERT_EQ(128, (int) frame[6 + WIDTH * HEIGHT]);        // neutral chroma
+    ASSERT_EQ(128, (int) frame[6 + 2 * WIDTH * HEIGHT]);
+    frame += frameLength;
+    ASSERT_EQ(0, memcmp(frame, "FRAME\n", 6));
+    ASSERT_EQ(16, (int) frame[6]);                          // black luma
+    ASSERT_EQ(128, (int) frame[6 + 2 * WIDTH * HEIGHT]);
+    remove("capture_test.y4m");
+    return 0;
+}
+
+// PNG frames are numbered by request and read back unchanged
+int test_pngFrames() {
+    uint8_t frames[2][FRAME_BYTES];
+    Capture* capture = captureNew(WIDTH, HEIGHT, CAPTURE_FORMAT_PNG,
+                                  "capture_test_%02u.png", 0);
+    for (uint32_t i = 0; i < 2; i++) {
+        fillFrame(frames[i], 10 + i);
+        captureSubmitPixels(capture, frames[i]);
+    }
+    captureDestroy(capture);
+
+    uint32_t width, height;
+    PixelFormat format;
+    uint8_t* pixels = imageReadPng("capture_test_01.png", &width, &height,
+                                   &format);
+    ASSERT_EQ(1, (int) (pixels != NULL));
+    ASSERT_EQ(WIDTH, (int) width);
+    ASSERT_EQ(HEIGHT, (int) height);
+    ASSERT_EQ(PIXEL_FORMAT_RGBA8, (int) format);
+    ASSERT_EQ(0, memcmp(pixels, frames[1], FRAME_BYTES));
+    imageFree(pixels);
+    remove("capture_test_00.png");
+    remove("capture_test_01.png");
+    return 0;
+}
+
+// A slow encoder drops frames instead of blocking, every frame is counted
+int test_droppedFrames() {
+    uint32_t size = 512;
+    uint8_t* pixels = calloc((size_t) size * size, 4);
+    Capture* capture = captureNew(size, size, CAPTURE_FORMAT_PNG,
+                                  "capture_test_drop.png", 0);
+    uint32_t queued = 0;
+    for (uint32_t i = 0; i < 64; i++)
+        queued += captureSubmitPixels(capture, pixels);
+    captureFlush(capture);
+    CaptureStats stats = captureGetStats(capture);
+    ASSERT_EQ(64, (int) stats.submitted);
+    ASSERT_EQ((int) queued, (int) stats.written);
+    ASSERT_EQ(64, (int) (stats.written + stats.dropped));
+    ASSERT_EQ(1, (int) (queued >= CAPTURE_QUEUE_SIZE));
+    captureDestroy(capture);
+    free(pixels);
+    remove("capture_test_drop.png");
+    return 0;
+}
+
+// Readbacks of a render target arrive through the pixel pack buffers
+int test_framebufferReadback() {
+    if (!glWindow) {
+        printf("framebuffer readback: no OpenGL context, skipped\n");
+        return 0;
+    }
+    static const float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+    RenderTarget* target = renderTargetNew(WIDTH, HEIGHT, PIXEL_FORMAT_RGBA8);
+    Capture* capture = captureNew(WIDTH, HEIGHT, CAPTURE_FORMAT_RAW,
+                                  "capture_test_gl.raw", 60);
+    for (uint32_t i = 0; i < 5; i++) {
+        renderTargetClear(target, red);
+        captureFrame(capture);
+    }
+    captureFlush(capture);
+    CaptureStats stats = captureGetStats(capture);
+    ASSERT_EQ(5, (int) stats.submitted);
+    ASSERT_EQ(5, (int) (stats.written + stats.dropped));
+    ASSERT_EQ(1, (int) (stats.written > 0));
+    captureDestroy(capture);
+    renderTargetDestroy(target);
+
+    uint8_t frame[FRAME_BYTES];
+    ASSERT_EQ(FRAME_BYTES, (int) readFile("capture_test_gl.raw", frame,
+                                          FRAME_BYTES));
+    ASSERT_EQ(255, (int) frame[0]);
+    ASSERT_EQ(0, (int) frame[1]);
+    ASSERT_EQ(255, (int) frame[FRAME_BYTES - 1]);
+    remove("capture_test_gl.raw");
+    return 0;
+}
+
+int main() {
+    glWindow = windowNewHeadless(64, 64);
+
+    int failed = 0;
+    failed += runTest("test_rawFrames", test_rawFrames);
+    failed += runTest("test_y4mFrames", test_y4mFrames);
+    failed += runTest("test_pngFrames", test_pngFrames);
+    failed += runTest("test_droppedFrames", test_droppedFrames);
+    failed += runTest("test_framebufferReadback", test_framebufferReadback);
+
+    if (glWindow)
+        windowDestroy(glWindow);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,186 @@
+#include "testing_framework.h"
+#include "../src/clip.h"
+#include "../src/shape.h"
+#include "../src/render_target.h"
+#include "../src/window.h"
+#include "../src/gpu_memory.h"
+
+#include <stdio.h>
+
+#define SIZE 64
+
+static Window* glWindow;    // NULL without a display, GL tests are skipped
+
+static int rectEquals(Rect a, Rect b) {
+    return a.min.x == b.min.x && a.min.y == b.min.y && a.max.x == b.max.x &&
+           a.max.y == b.max.y;
+}
+
+int test_nestedIntersect() {
+    ClipStack* stack = clipStackNew();
+    clipBegin(stack, (Vec2) { 100, 80 });
+    ASSERT_EQ(CLIP_NONE, (int) clipGetIndex(stack));
+    ASSERT_EQ(1, rectEquals(clipGetRect(stack),
+                            (Rect) { { 0, 0 }, { 100, 80 } }));
+
+    uint16_t panel = clipPush(stack, (Rect) { { 10, 10 }, { 90, 70 } });
+    uint16_t scroll = clipPush(stack, (Rect) { { 50, -20 }, { 200, 40 } });
+    ASSERT_EQ(1, (int) panel);
+    ASSERT_EQ(2, (int) scroll);
+    ASSERT_EQ(1, rectEquals(clipGetRect(stack),
+                            (Rect) { { 50, 10 }, { 90, 40 } }));
+
+    uint32_t count;
+    const Rect* rects = clipGetRects(stack, &count);
+    ASSERT_EQ(3, (int) count);
+    ASSERT_EQ(1, rectEquals(rects[scroll], clipGetRect(stack)));
+
+    clipPop(stack);
+    ASSERT_EQ((int) panel, (int) clipGetIndex(stack));
+    clipPop(stack);
+    clipPop(stack);     // popping an empty stack is ignored
+    ASSERT_EQ(CLIP_NONE, (int) clipGetIndex(stack));
+    ASSERT_EQ(2, (int) clipGetStats(stack).pushes);
+    clipStackDestroy(stack);
+    return 0;
+}
+
+// Equal clips share an index, so siblings batch into one table entry
+int test_sharedIndices() {
+    ClipStack* stack = clipStackNew();
+    clipBegin(stack, (Vec2) { 100, 100 });
+    Rect row = { { 0, 0 }, { 100, 20 } };
+    uint16_t first = clipPush(stack, row);
+    clipPop(stack);
+    ASSERT_EQ((int) first, (int) clipPush(stack, row));
+    clipPop(stack);
+
+    // every empty clip is the same entry, nothing drawn through it shows
+    clipPush(stack, (Rect) { { 0, 0 }, { 10, 10 } });
+    uint16_t empty = clipPush(stack, (Rect) { { 20, 20 }, { 30, 30 } });
+    ASSERT_EQ(1, rectIsEmpty(clipGetRect(stack)));
+    clipPop(stack);
+    ASSERT_EQ((int) empty, (int) clipPush(stack,
+                                          (Rect) { { 50, 0 }, { 60, 5 } }));
+    ASSERT_EQ(4, (int) clipGetStats(stack).rects);     // view, row, 10², empty
+
+    // a quarter turn is still a rect, no stencil needed
+    clipBegin(stack, (Vec2) { 100, 100 });
+    clipPushRotated(stack, (Vec2) { 50, 40 }, (Vec2) { 10, 20 },
+                    1.5707963f);
+    ASSERT_EQ(0, (int) clipGetStencilDepth(stack));
+    ASSERT_EQ(1, rectEquals(clipGetRect(stack),
+                            (Rect) { { 30, 30 }, { 70, 50 } }));
+    clipStackDestroy(stack);
+    return 0;
+}
+
+int test_tableFull() {
+    ClipStack* stack = clipStackNew();
+    clipBegin(stack, (Vec2) { 1000, 1000 });
+    uint16_t outer = clipPush(stack, (Rect) { { 0, 0 }, { 900, 900 } });
+    for (uint32_t i = 2; i < CLIP_MAX_RECTS; i++) {
+        ASSERT_EQ((int) i, (int) clipPush(stack,
+                                          (Rect) { { (float) i, 0 },
+                                                   { 500, 500 } }));
+        clipPop(stack);
+    }
+    Rect late = { { 700, 700 }, { 800, 800 } };
+    ASSERT_EQ(CLIP_INVALID, (int) clipPush(stack, late));
+    ASSERT_EQ((int) outer, (int) clipGetIndex(stack));
+
+    // after drawing, the table restarts from what is on the stack
+    clipFlush(stack);
+    ASSERT_EQ(2, (int) clipGetStats(stack).rects);
+    ASSERT_EQ(2, (int) clipPush(stack, late));
+    clipStackDestroy(stack);
+    return 0;
+}
+
+// Shapes under different clips in one draw call
+int test_clippedShapes() {
+    if (!glWindow) {
+        printf("clipped shapes: no OpenGL context, skipped\n");
+        return 0;
+    }
+    static const float clear[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    static const float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+    static const float blue[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+    RenderTarget* target = renderTargetNew(SIZE, SIZE, PIXEL_FORMAT_RGBA8);
+    renderTargetClear(target, clear);
+
+    ClipStack* stack = clipStackNew();
+    ShapeBatch* batch = shapeBatchNew(0);
+    clipBegin(stack, (Vec2) { SIZE, SIZE });
+    clipPush(stack, (Rect) { { 0, 0 }, { SIZE / 2, SIZE } });
+    Shape left = shapeRect((Rect) { { 0, 0 }, { SIZE, SIZE } }, red);
+    left.clip = clipGetIndex(stack);
+    shapeBatchAdd(batch, &left);
+    clipPop(stack);
+    Shape corner = shapeRect((Rect) { { 40, 40 }, { 60, 60 } }, blue);
+    shapeBatchAdd(batch, &corner);
+
+    uint32_t count;
+    const Rect* rects = clipGetRects(stack, &count);
+    shapeBatchDrawClipped(batch, (Vec2) { SIZE, SIZE }, rects, count);
+    clipEnd(stack);
+
+    static uint8_t pixels[SIZE * SIZE * 4];
+    renderTargetReadPixels(target, pixels);
+    ASSERT_EQ(255, (int) pixels[(10 * SIZE + 10) * 4]);
+    ASSERT_EQ(0, (int) pixels[(10 * SIZE + 50) * 4 + 3]);
+    ASSERT_EQ(255, (int) pixels[(50 * SIZE + 50) * 4 + 2]);
+    shapeBatchDestroy(batch);
+    clipStackDestroy(stack);
+    renderTargetDestroy(target);
+    return 0;
+}
+
+// The stencil buffer is accounted once grown, and freed with the stack
+int test_stencilAccountsBuffer() {
+    if (!glWindow) {
+        printf("stencil accounting: no OpenGL context, skipped\n");
+        return 0;
+    }
+    static const Vec2 triangle[3] = { { 8, 8 }, { 56, 8 }, { 32, 56 } };
+    GpuMemoryStats before = gpuMemoryGetStats();
+    ClipStack* stack = clipStackNew();
+    clipBegin(stack, (Vec2) { SIZE, SIZE });
+    ASSERT_EQ(1, (int) (clipPushPolygon(stack, triangle, 3) != CLIP_INVALID));
+    clipPop(stack);
+    clipEnd(stack);
+    GpuMemoryStats drawn = gpuMemoryGetStats();
+    ASSERT_EQ(1, (int) (drawn.counts[GPU_MEMORY_BUFFER] -
+                        before.counts[GPU_MEMORY_BUFFER]));
+
+    clipStackDestroy(stack);
+    GpuMemoryStats after = gpuMemoryGetStats();
+    ASSERT_EQ((int) before.counts[GPU_MEMORY_BUFFER],
+              (int) after.counts[GPU_MEMORY_BUFFER]);
+    ASSERT_EQ(1, (int) (after.bytes[GPU_MEMORY_BUFFER] ==
+                        before.bytes[GPU_MEMORY_BUFFER]));
+    return 0;
+}
+
+int main() {
+    glWindow = windowNewHeadless(SIZE, SIZE);
+
+    int failed = 0;
+    failed += runTest("test_nestedIntersect", test_nestedIntersect);
+    failed += runTest("test_sharedIndices", test_sharedIndices);
+    failed += runTest("test_tableFull", test_tableFull);
+    failed += runTest("test_clippedShapes", test_clippedShapes);
+    failed += runTest("test_stencilAccountsBuffer",
+                      test_stencilAccountsBuffer);
+
+    if (glWindow)
+        windowDestroy(glWindow);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
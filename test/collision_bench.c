@@ -0,0 +1,75 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../src/collision.h"
+#include "../src/timer.h"
+
+#define FRAME_COUNT 100
+#define MAX_CONTACTS 1000000
+
+static CollisionContact contacts[MAX_CONTACTS];
+
+// Half circles, half rotating boxes, bouncing inside a square that keeps
+// about ten body areas of room per body
+static void benchmarkCollision(uint32_t count) {
+    CollisionWorld* world = collisionWorldNew(count);
+    CollisionBody* bodies = malloc(sizeof(CollisionBody) * count);
+    Vec2* positions = malloc(sizeof(Vec2) * count);
+    Vec2* velocities = malloc(sizeof(Vec2) * count);
+    float side = sqrtf((float) count * 1000.0f);
+    srand(1);
+    for (uint32_t i = 0; i < count; i++) {
+        positions[i] = (Vec2) { (float) rand() / RAND_MAX * side,
+                                (float) rand() / RAND_MAX * side };
+        velocities[i] = (Vec2) { (float) rand() / RAND_MAX * 4.0f - 2.0f,
+                                 (float) rand() / RAND_MAX * 4.0f - 2.0f };
+        CollisionShape shape = i % 2 ? collisionShapeCircle(5.0f)
+                                     : collisionShapeBox((Vec2) { 5, 4 });
+        bodies[i] = collisionAdd(world, &shape, positions[i], 0.0f);
+    }
+
+    uint64_t start = timerNow();
+    uint32_t found = collisionDetect(world, contacts, MAX_CONTACTS);
+    double firstMs = timerToMs(timerNow() - start);
+
+    double moveMs = 0.0, detectMs = 0.0;
+    uint64_t swaps = 0, pairs = 0;
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        start = timerNow();
+        for (uint32_t i = 0; i < count; i++) {
+            Vec2* p = &positions[i];
+            Vec2* v = &velocities[i];
+            *p = vec2Add(*p, *v);
+            if (p->x < 0.0f || p->x > side)
+                v->x = -v->x;
+            if (p->y < 0.0f || p->y > side)
+                v->y = -v->y;
+            collisionSetTransform(world, bodies[i], *p,
+                                  (float) frame * 0.02f);
+        }
+        uint64_t detect = timerNow();
+        found = collisionDetect(world, contacts, MAX_CONTACTS);
+        moveMs += timerToMs(detect - start);
+        detectMs += timerToMs(timerNow() - detect);
+        CollisionStats stats = collisionGetStats(world);
+        swaps += stats.swaps;
+        pairs += stats.pairs;
+    }
+
+    printf("%7u bodies | first sort %7.3f ms | move %6.3f ms, detect "
+           "%6.3f ms per frame | %6llu swaps, %7llu pairs, %6u contacts\n",
+           count, firstMs, moveMs / FRAME_COUNT, detectMs / FRAME_COUNT,
+           (unsigned long long) (swaps / FRAME_COUNT),
+           (unsigned long long) (pairs / FRAME_COUNT), found);
+    free(velocities);
+    free(positions);
+    free(bodies);
+    collisionWorldDestroy(world);
+}
+
+int main() {
+    benchmarkCollision(10000);
+    benchmarkCollision(100000);
+    return 0;
+}
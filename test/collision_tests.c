@@ -0,0 +1,201 @@
+#include "testing_framework.h"
+#include "../src/collision.h"
+
+#include <stdlib.h>
+
+#define BODY_COUNT 400
+#define MAX_CONTACTS 4096
+
+static CollisionContact contacts[MAX_CONTACTS];
+static CollisionContact expected[MAX_CONTACTS];
+
+static int nearlyEqual(float a, float b) {
+    return fabsf(a - b) < 1e-4f;
+}
+
+static int compareContacts(const void* left, const void* right) {
+    const CollisionContact* a = left;
+    const CollisionContact* b = right;
+    uint64_t keyA = (uint64_t) (a->a < a->b ? a->a : a->b) << 32 |
+                    (a->a < a->b ? a->b : a->a);
+    uint64_t keyB = (uint64_t) (b->a < b->b ? b->a : b->b) << 32 |
+                    (b->a < b->b ? b->b : b->a);
+    return keyA < keyB ? -1 : keyA > keyB;
+}
+
+// Circles and boxes report the separating normal and depth
+int test_narrowPhase() {
+    CollisionWorld* world = collisionWorldNew(0);
+    CollisionShape circle = collisionShapeCircle(5.0f);
+    CollisionShape box = collisionShapeBox((Vec2) { 10.0f, 5.0f });
+
+    CollisionBody c0 = collisionAdd(world, &circle, (Vec2) { 0, 0 }, 0.0f);
+    CollisionBody c1 = collisionAdd(world, &circle, (Vec2) { 6, 8 }, 0.0f);
+    CollisionContact contact;
+    ASSERT_EQ(0, (int) collisionTest(world, c0, c1, &contact));   // touching
+    collisionSetTransform(world, c1, (Vec2) { 3, 4 }, 0.0f);
+    ASSERT_EQ(1, (int) collisionTest(world, c0, c1, &contact));
+    ASSERT_EQ(1, (int) nearlyEqual(0.6f, contact.normal.x));
+    ASSERT_EQ(1, (int) nearlyEqual(0.8f, contact.normal.y));
+    ASSERT_EQ(1, (int) nearlyEqual(5.0f, contact.depth));
+    collisionSetTransform(world, c1, (Vec2) { 6, 7 }, 0.0f);
+    ASSERT_EQ(1, (int) collisionTest(world, c0, c1, &contact));
+    ASSERT_EQ(1, (int) nearlyEqual(10.0f - sqrtf(85.0f), contact.depth));
+
+    // boxes overlapping by 2 along x and 4 along y separate along x
+    CollisionBody b0 = collisionAdd(world, &box, (Vec2) { 100, 100 }, 0.0f);
+    CollisionBody b1 = collisionAdd(world, &box, (Vec2) { 118, 94 }, 0.0f);
+    ASSERT_EQ(1, (int) collisionTest(world, b0, b1, &contact));
+    ASSERT_EQ(1, (int) nearlyEqual(1.0f, contact.normal.x));
+    ASSERT_EQ(1, (int) nearlyEqual(0.0f, contact.normal.y));
+    ASSERT_EQ(1, (int) nearlyEqual(2.0f, contact.depth));
+    ASSERT_EQ(1, (int) collisionTest(world, b1, b0, &contact));
+    ASSERT_EQ(1, (int) nearlyEqual(-1.0f, contact.normal.x));
+
+    // rotated a quarter turn b1 is 5 wide, 20 tall, no longer touching
+    collisionSetTransform(world, b1, (Vec2) { 118, 94 }, 1.5707964f);
+    ASSERT_EQ(0, (int) collisionTest(world, b0, b1, &contact));
+
+    // inside the bounding box corner but outside the circle
+    CollisionBody c2 = collisionAdd(world, &circle, (Vec2) { 114, 109 },
+                                    0.0f);
+    ASSERT_EQ(0, (int) collisionTest(world, b0, c2, &contact));
+    collisionSetTransform(world, c2, (Vec2) { 112.4f, 108.2f }, 0.0f);
+    ASSERT_EQ(1, (int) collisionTest(world, b0, c2, &contact));
+    ASSERT_EQ(1, (int) nearlyEqual(1.0f, contact.depth));
+    ASSERT_EQ(1, (int) nearlyEqual(0.6f, contact.normal.x));
+    ASSERT_EQ(1, (int) nearlyEqual(0.8f, contact.normal.y));
+    ASSERT_EQ(1, (int) collisionTest(world, c2, b0, &contact));
+    ASSERT_EQ(1, (int) nearlyEqual(-0.6f, contact.normal.x));
+
+    // concave outlines are refused
+    CollisionShape dart = {
+        .type = COLLISION_SHAPE_POLYGON, .vertexCount = 4,
+        .vertices = { { 0, 0 }, { 10, 5 }, { 0, 2 }, { -10, 5 } }
+    };
+    ASSERT_EQ((int) COLLISION_INVALID_BODY,
+              (int) collisionAdd(world, &dart, (Vec2) { 0, 0 }, 0.0f));
+
+    // so are self intersecting ones, every corner of a star turns the same way
+    CollisionShape star = {
+        .type = COLLISION_SHAPE_POLYGON, .vertexCount = 5,
+        .vertices = { { 0, -10 }, { 5.9f, 8.1f }, { -9.5f, -3.1f },
+                      { 9.5f, -3.1f }, { -5.9f, 8.1f } }
+    };
+    ASSERT_EQ((int) COLLISION_INVALID_BODY,
+              (int) collisionAdd(world, &star, (Vec2) { 0, 0 }, 0.0f));
+    collisionWorldDestroy(world);
+    return 0;
+}
+
+// Sweep and prune finds exactly the pairs an all pairs test finds
+int test_matchesBruteForce() {
+    CollisionWorld* world = collisionWorldNew(BODY_COUNT);
+    static CollisionBody bodies[BODY_COUNT];
+    static Vec2 positions[BODY_COUNT];
+    srand(7);
+    for (uint32_t i = 0; i < BODY_COUNT; i++) {
+        positions[i] = (Vec2) { (float) (rand() % 1000),
+                                (float) (rand() % 400) };
+        CollisionShape shape = i % 2
+            ? collisionShapeCircle(4.0f + (float) (rand() % 8))
+            : collisionShapeBox((Vec2) { 3.0f + (float) (rand() % 10),
+                                         3.0f + (float) (rand() % 10) });
+        bodies[i] = collisionAdd(world, &shape, positions[i],
+                                 (float) (rand() % 628) * 0.01f);
+    }
+
+    for (int frame = 0; frame < 5; frame++) {
+        uint32_t count = collisionDetect(world, contacts, MAX_CONTACTS);
+        ASSERT_EQ(1, (int) (count < MAX_CONTACTS && count > 0));
+        uint32_t brute = 0;
+        for (uint32_t a = 0; a < BODY_COUNT; a++)
+            for (uint32_t b = a + 1; b < BODY_COUNT; b++)
+                brute += collisionTest(world, bodies[a], bodies[b],
+                                       &expected[brute]);
+        ASSERT_EQ((int) brute, (int) count);
+        ASSERT_EQ((int) count, (int) collisionGetStats(world).contacts);
+
+        qsort(contacts, count, sizeof(CollisionContact), compareContacts);
+        qsort(expected, brute, sizeof(CollisionContact), compareContacts);
+        for (uint32_t i = 0; i < count; i++) {
+            ASSERT_EQ(0, compareContacts(&contacts[i], &expected[i]));
+            ASSERT_EQ(1, (int) nearlyEqual(contacts[i].depth,
+                                           expected[i].depth));
+        }
+
+        // small moves, the order only needs local repairs
+        for (uint32_t i = 0; i < BODY_COUNT; i++) {
+            positions[i].x += (float) (rand() % 21 - 10);
+            positions[i].y += (float) (rand() % 21 - 10);
+            collisionSetTransform(world, bodies[i], positions[i],
+                                  (float) frame * 0.3f);
+        }
+    }
+    collisionWorldDestroy(world);
+    return 0;
+}
+
+// A body without bounds spans every sweep, up to the last body and no further
+int test_infiniteBounds() {
+    CollisionWorld* world = collisionWorldNew(0);
+    CollisionShape huge = collisionShapeCircle(INFINITY);
+    CollisionShape box = collisionShapeBox((Vec2) { 2.0f, 2.0f });
+    static CollisionBody bodies[7];
+    bodies[0] = collisionAdd(world, &huge, (Vec2) { 0, 0 }, 0.0f);
+    for (uint32_t i = 1; i < 7; i++)
+        bodies[i] = collisionAdd(world, &box, (Vec2) { 10.0f * i, 0 }, 0.0f);
+
+    uint32_t count = collisionDetect(world, contacts, MAX_CONTACTS);
+    uint32_t brute = 0;
+    for (uint32_t a = 0; a < 7; a++)
+        for (uint32_t b = a + 1; b < 7; b++)
+            brute += collisionTest(world, bodies[a], bodies[b],
+                                   &expected[brute]);
+    ASSERT_EQ((int) brute, (int) count);
+    collisionWorldDestroy(world);
+    return 0;
+}
+
+// Removed bodies stop colliding, the buffer is filled up to its capacity
+int test_removeAndCapacity() {
+    CollisionWorld* world = collisionWorldNew(0);
+    CollisionShape circle = collisionShapeCircle(10.0f);
+    CollisionBody bodies[4];
+    for (uint32_t i = 0; i < 4; i++)
+        bodies[i] = collisionAdd(world, &circle, (Vec2) { (float) i, 0 }, 0);
+    ASSERT_EQ(6, (int) collisionDetect(world, contacts, 2));
+    ASSERT_EQ(6, (int) collisionDetect(world, NULL, 0));
+
+    collisionRemove(world, bodies[1]);
+    ASSERT_EQ(3, (int) collisionGetCount(world));
+    uint32_t count = collisionDetect(world, contacts, MAX_CONTACTS);
+    ASSERT_EQ(3, (int) count);
+    for (uint32_t i = 0; i < count; i++)
+        ASSERT_EQ(1, (int) (contacts[i].a != bodies[1] &&
+                            contacts[i].b != bodies[1]));
+
+    CollisionBody reused = collisionAdd(world, &circle, (Vec2) { 500, 0 }, 0);
+    ASSERT_EQ((int) bodies[1], (int) reused);
+    ASSERT_EQ(3, (int) collisionDetect(world, contacts, MAX_CONTACTS));
+    collisionSetTransform(world, reused, (Vec2) { -5, 0 }, 0);
+    ASSERT_EQ(6, (int) collisionDetect(world, contacts, MAX_CONTACTS));
+    collisionWorldDestroy(world);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_narrowPhase", test_narrowPhase);
+    failed += runTest("test_matchesBruteForce", test_matchesBruteForce);
+    failed += runTest("test_infiniteBounds", test_infiniteBounds);
+    failed += runTest("test_removeAndCapacity", test_removeAndCapacity);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,161 @@
+#include "testing_framework.h"
+#include "../src/context.h"
+
+#include <stdio.h>
+
+// Resources are plain ints, destroying one logs its value
+static int freed[64];
+static uint32_t freedCount;
+
+static void logDestroy(void* resource) {
+    freed[freedCount++] = *(int*) resource;
+}
+
+int test_addGet() {
+    Context* context = contextNew();
+    if (!context) {
+        printf("add and get: GLFW failed to initialise, skipped\n");
+        return 0;
+    }
+    static int atlas = 1, user = 2;
+    ASSERT_EQ(1, (int) contextAdd(context, "atlas", CONTEXT_RESOURCE_ATLAS,
+                                  &atlas, NULL));
+    ASSERT_EQ(1, (int) contextAdd(context, "user", CONTEXT_RESOURCE_USER,
+                                  &user, NULL));
+    ASSERT_EQ(1, (int) (contextGet(context, "atlas",
+                                   CONTEXT_RESOURCE_ATLAS) == &atlas));
+    ASSERT_EQ(1, (int) (contextGet(context, "user",
+                                   CONTEXT_RESOURCE_USER) == &user));
+
+    // asking for another kind or a missing name finds nothing
+    ASSERT_EQ(1, (int) (contextGet(context, "atlas",
+                                   CONTEXT_RESOURCE_USER) == NULL));
+    ASSERT_EQ(1, (int) (contextGet(context, "missing",
+                                   CONTEXT_RESOURCE_USER) == NULL));
+    contextDestroy(context);
+    return 0;
+}
+
+int test_duplicateRejected() {
+    Context* context = contextNew();
+    if (!context) {
+        printf("duplicate names: GLFW failed to initialise, skipped\n");
+        return 0;
+    }
+    static int first = 1, second = 2;
+    freedCount = 0;
+    ASSERT_EQ(1, (int) contextAdd(context, "name", CONTEXT_RESOURCE_USER,
+                                  &first, logDestroy));
+    ASSERT_EQ(0, (int) contextAdd(context, "name", CONTEXT_RESOURCE_ATLAS,
+                                  &second, logDestroy));
+
+    // the first one stays, the rejected one is left to the caller
+    ASSERT_EQ(1, (int) (contextGet(context, "name",
+                                   CONTEXT_RESOURCE_USER) == &first));
+    ASSERT_EQ(0, (int) freedCount);
+    contextDestroy(context);
+    ASSERT_EQ(1, (int) freedCount);
+    ASSERT_EQ(1, freed[0]);
+    return 0;
+}
+
+int test_release() {
+    Context* context = contextNew();
+    if (!context) {
+        printf("release: GLFW failed to initialise, skipped\n");
+        return 0;
+    }
+    static int value = 7, again = 8;
+    freedCount = 0;
+    ASSERT_EQ(1, (int) contextAdd(context, "value", CONTEXT_RESOURCE_USER,
+                                  &value, logDestroy));
+    ASSERT_EQ(1, (int) contextRelease(context, "value"));
+    ASSERT_EQ(1, (int) freedCount);
+    ASSERT_EQ(7, freed[0]);
+    ASSERT_EQ(1, (int) (contextGet(context, "value",
+                                   CONTEXT_RESOURCE_USER) == NULL));
+    ASSERT_EQ(0, (int) contextRelease(context, "value"));
+
+    // the name is free again
+    ASSERT_EQ(1, (int) contextAdd(context, "value", CONTEXT_RESOURCE_USER,
+                                  &again, logDestroy));
+    contextDestroy(context);
+    ASSERT_EQ(2, (int) freedCount);
+    ASSERT_EQ(8, freed[1]);
+    return 0;
+}
+
+// Newest first, across growth of the registry and a release in the middle
+int test_destroyOrder() {
+    Context* context = contextNew();
+    if (!context) {
+        printf("destroy order: GLFW failed to initialise, skipped\n");
+        return 0;
+    }
+    static int values[40];
+    char name[16];
+    freedCount = 0;
+    for (int i = 0; i < 40; i++) {
+        values[i] = i;
+        snprintf(name, sizeof(name), "resource%d", i);
+        ASSERT_EQ(1, (int) contextAdd(context, name, CONTEXT_RESOURCE_USER,
+                                      &values[i], logDestroy));
+    }
+    ASSERT_EQ(1, (int) contextRelease(context, "resource20"));
+    ASSERT_EQ(1, (int) (contextGet(context, "resource39",
+                                   CONTEXT_RESOURCE_USER) == &values[39]));
+
+    contextDestroy(context);
+    ASSERT_EQ(40, (int) freedCount);
+    ASSERT_EQ(20, freed[0]);
+    for (int i = 1; i < 40; i++) {
+        int expected = 40 - i;
+        ASSERT_EQ(expected <= 20 ? expected - 1 : expected, freed[i]);
+    }
+    return 0;
+}
+
+// The shared objects die with the last window, so do the resources
+int test_lastWindowFrees() {
+    Context* context = contextNew();
+    Window* first = context ? contextCreateWindow(context, 16, 16, "") : NULL;
+    if (!first) {
+        printf("last window: no OpenGL context, skipped\n");
+        contextDestroy(context);
+        return 0;
+    }
+    Window* second = contextCreateWindow(context, 16, 16, "");
+    static int value = 3;
+    freedCount = 0;
+    ASSERT_EQ(1, (int) contextAdd(context, "value", CONTEXT_RESOURCE_USER,
+                                  &value, logDestroy));
+    contextDestroyWindow(context, first);
+    ASSERT_EQ(0, (int) freedCount);
+    ASSERT_EQ(1, (int) contextGetWindowCount(context));
+    ASSERT_EQ(1, (int) (contextGetWindow(context, 0) == second));
+
+    contextDestroyWindow(context, second);
+    ASSERT_EQ(1, (int) freedCount);
+    ASSERT_EQ(1, (int) (contextGet(context, "value",
+                                   CONTEXT_RESOURCE_USER) == NULL));
+    contextDestroy(context);
+    ASSERT_EQ(1, (int) freedCount);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_addGet", test_addGet);
+    failed += runTest("test_duplicateRejected", test_duplicateRejected);
+    failed += runTest("test_release", test_release);
+    failed += runTest("test_destroyOrder", test_destroyOrder);
+    failed += runTest("test_lastWindowFrees", test_lastWindowFrees);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,101 @@
+#include "testing_framework.h"
+#include "../src/damage.h"
+
+static Rect box(float x, float y, float w, float h) {
+    return rectFromSize((Vec2) { x, y }, (Vec2) { w, h });
+}
+
+// A new tracker starts fully damaged, present it twice to settle both buffers
+static DamageTracker* settledTracker() {
+    DamageTracker* tracker = damageTrackerNew(800, 600);
+    damageEndFrame(tracker);
+    damageEndFrame(tracker);
+    return tracker;
+}
+
+int test_startsDamaged() {
+    DamageTracker* tracker = damageTrackerNew(800, 600);
+    uint32_t count;
+    const Rect* regions = damageGetRegions(tracker, &count);
+    ASSERT_EQ(1, (int) count);
+    ASSERT_FLOAT_EQ(800.0, regions[0].max.x);
+    damageTrackerDestroy(tracker);
+    return 0;
+}
+
+int test_idleIsEmpty() {
+    DamageTracker* tracker = settledTracker();
+    uint32_t count;
+    ASSERT_EQ(1, (int) damageIsEmpty(tracker));
+    damageGetRegions(tracker, &count);
+    ASSERT_EQ(0, (int) count);
+    damageTrackerDestroy(tracker);
+    return 0;
+}
+
+int test_mergeOverlapping() {
+    DamageTracker* tracker = settledTracker();
+    damageAdd(tracker, box(10, 10, 20, 20));
+    damageAdd(tracker, box(20, 20, 20, 20));
+    damageAdd(tracker, box(300, 300, 10, 10));
+    uint32_t count;
+    damageGetRegions(tracker, &count);
+    ASSERT_EQ(2, (int) count);
+    damageTrackerDestroy(tracker);
+    return 0;
+}
+
+int test_clippedToFramebuffer() {
+    DamageTracker* tracker = settledTracker();
+    damageAdd(tracker, box(-50, -50, 60, 60));
+    damageAdd(tracker, box(900, 900, 10, 10));
+    uint32_t count;
+    const Rect* regions = damageGetRegions(tracker, &count);
+    ASSERT_EQ(1, (int) count);
+    ASSERT_FLOAT_EQ(0.0, regions[0].min.x);
+    ASSERT_FLOAT_EQ(10.0, regions[0].max.x);
+    damageTrackerDestroy(tracker);
+    return 0;
+}
+
+int test_previousFrameIncluded() {
+    DamageTracker* tracker = settledTracker();
+    damageAdd(tracker, box(0, 0, 10, 10));
+    damageEndFrame(tracker);
+    damageAdd(tracker, box(400, 400, 10, 10));
+    uint32_t count;
+    damageGetRegions(tracker, &count);
+    ASSERT_EQ(2, (int) count);
+    damageTrackerDestroy(tracker);
+    return 0;
+}
+
+int test_overflowMerges() {
+    DamageTracker* tracker = settledTracker();
+    for (int i = 0; i < DAMAGE_MAX_RECTS * 2; i++)
+        damageAdd(tracker, box((float) i * 20.0f, (float) (i % 2) * 300.0f,
+                               5, 5));
+    uint32_t count;
+    damageGetRegions(tracker, &count);
+    ASSERT_EQ(1, (int) (count <= DAMAGE_MAX_RECTS));
+    damageTrackerDestroy(tracker);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_startsDamaged", test_startsDamaged);
+    failed += runTest("test_idleIsEmpty", test_idleIsEmpty);
+    failed += runTest("test_mergeOverlapping", test_mergeOverlapping);
+    failed += runTest("test_clippedToFramebuffer", test_clippedToFramebuffer);
+    failed += runTest("test_previousFrameIncluded", test_previousFrameIncluded);
+    failed += runTest("test_overflowMerges", test_overflowMerges);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,80 @@
+#include <math.h>
+#include <stdio.h>
+
+#include "../src/glyph_cache.h"
+#include "../src/timer.h"
+
+#define CACHE_PATH "glyph_cache_bench.bin"
+#define PAGE_SIZE 1024
+#define CODEPOINTS 256
+
+static const uint16_t sizes[] = { 12, 16, 24, 32, 48, 64 };
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+static uint8_t coverage[64 * 64];
+
+// Stands in for a rasterizer, 4x4 supersampled coverage of a few rings,
+// a fraction of the work of real outlines
+static void rasterize(uint32_t codepoint, uint32_t width, uint32_t height) {
+    float rings = 1.0f + (float) (codepoint % 5);
+    for (uint32_t y = 0; y < height; y++)
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t inside = 0;
+            for (uint32_t sample = 0; sample < 16; sample++) {
+                float u = (x + (sample % 4 + 0.5f) / 4.0f) / width - 0.5f;
+                float v = (y + (sample / 4 + 0.5f) / 4.0f) / height - 0.5f;
+                inside += sinf(sqrtf(u * u + v * v) * rings * 20.0f) > 0.0f;
+            }
+            coverage[y * width + x] = (uint8_t) (inside * 255 / 16);
+        }
+}
+
+int main() {
+    const char font[] = "stand-in for the bytes of a font file";
+    uint64_t fontHash = glyphCacheHashFont(font, sizeof(font));
+
+    // cold: rasterize everything, then write the cache for the next run
+    uint64_t start = timerNow();
+    GlyphCache* cache = glyphCacheNew(PAGE_SIZE);
+    for (uint32_t s = 0; s < SIZE_COUNT; s++)
+        for (uint32_t codepoint = 0; codepoint < CODEPOINTS; codepoint++) {
+            GlyphCacheEntry glyph = {
+                .fontHash = fontHash, .codepoint = codepoint,
+                .size = sizes[s], .width = (uint16_t) (sizes[s] * 3 / 4),
+                .height = sizes[s], .bearingY = (int16_t) sizes[s],
+                .advance = sizes[s] * 0.8f
+            };
+            rasterize(codepoint, glyph.width, glyph.height);
+            glyphCacheInsert(cache, &glyph, coverage);
+        }
+    double rasterizeMs = timerToMs(timerNow() - start);
+    uint64_t save = timerNow();
+    glyphCacheSave(cache, CACHE_PATH);
+    double saveMs = timerToMs(timerNow() - save);
+    uint32_t glyphs = glyphCacheGetCount(cache);
+    uint32_t pages = glyphCacheGetPageCount(cache);
+    glyphCacheDestroy(cache);
+
+    // warm: map the file and touch every glyph and page, as an upload would
+    start = timerNow();
+    cache = glyphCacheLoad(CACHE_PATH, &fontHash, 1);
+    uint32_t found = 0, checksum = 0;
+    for (uint32_t s = 0; cache && s < SIZE_COUNT; s++)
+        for (uint32_t codepoint = 0; codepoint < CODEPOINTS; codepoint++)
+            found += glyphCacheFind(cache, fontHash, codepoint,
+                                    sizes[s]) != NULL;
+    for (uint32_t i = 0; cache && i < glyphCacheGetPageCount(cache); i++) {
+        const uint8_t* page = glyphCacheGetPage(cache, i);
+        for (uint32_t offset = 0; offset < PAGE_SIZE * PAGE_SIZE; offset += 64)
+            checksum += page[offset];
+    }
+    double warmMs = timerToMs(timerNow() - start);
+
+    printf("%u glyphs on %u pages | cold %8.3f ms (rasterize %8.3f ms, save "
+           "%6.3f ms) | warm %6.3f ms, %u found | checksum %u\n",
+           glyphs, pages, rasterizeMs + saveMs, rasterizeMs, saveMs, warmMs,
+           found, checksum);
+    glyphCacheDestroy(cache);
+    remove(CACHE_PATH);
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "testing_framework.h"
+#include "../src/glyph_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define CACHE_PATH "glyph_cache_test.bin"
+#define PAGE_SIZE 64
+
+static uint8_t coverage[32 * 32];
+
+// A glyph whose coverage is a pattern unique to its codepoint
+static GlyphCacheEntry makeGlyph(uint64_t font, uint32_t codepoint,
+                                 uint16_t size) {
+    GlyphCacheEntry glyph = { .fontHash = font, .codepoint = codepoint,
+                              .size = size, .width = (uint16_t) (size / 2),
+                              .height = size, .bearingX = 1,
+                              .bearingY = (int16_t) size,
+                              .advance = size * 0.6f };
+    for (uint32_t i = 0; i < (uint32_t) glyph.width * glyph.height; i++)
+        coverage[i] = (uint8_t) (codepoint * 31 + i);
+    return glyph;
+}
+
+static int checkCoverage(GlyphCache* cache, const GlyphCacheEntry* glyph) {
+    const uint8_t* page = glyphCacheGetPage(cache, glyph->page);
+    for (uint32_t y = 0; y < glyph->height; y++)
+        for (uint32_t x = 0; x < glyph->width; x++)
+            if (page[(glyph->y + y) * PAGE_SIZE + glyph->x + x] !=
+                (uint8_t) (glyph->codepoint * 31 + y * glyph->width + x))
+                return 0;
+    return 1;
+}
+
+int test_insertAndFind() {
+    GlyphCache* cache = glyphCacheNew(PAGE_SIZE);
+    for (uint32_t codepoint = 'A'; codepoint <= 'Z'; codepoint++) {
+        GlyphCacheEntry glyph = makeGlyph(7, codepoint, 16);
+        ASSERT_EQ(1, glyphCacheInsert(cache, &glyph, coverage) != NULL);
+    }
+    GlyphCacheEntry twice = makeGlyph(7, 'Q', 16);
+    ASSERT_EQ(1, glyphCacheInsert(cache, &twice, coverage) == NULL);
+    GlyphCacheEntry large = makeGlyph(7, 'W', 16);
+    large.width = PAGE_SIZE + 1;
+    ASSERT_EQ(1, glyphCacheInsert(cache, &large, coverage) == NULL);
+
+    // 8x16 glyphs plus padding fit 7 per shelf and 3 shelves per page
+    ASSERT_EQ(26, (int) glyphCacheGetCount(cache));
+    ASSERT_EQ(2, (int) glyphCacheGetPageCount(cache));
+    for (uint32_t codepoint = 'A'; codepoint <= 'Z'; codepoint++) {
+        const GlyphCacheEntry* glyph = glyphCacheFind(cache, 7, codepoint, 16);
+        ASSERT_EQ(1, glyph != NULL);
+        ASSERT_EQ((int) codepoint, (int) glyph->codepoint);
+        ASSERT_EQ(1, checkCoverage(cache, glyph));
+    }
+    ASSERT_EQ(1, glyphCacheFind(cache, 7, 'A', 17) == NULL);
+    ASSERT_EQ(1, glyphCacheFind(cache, 8, 'A', 16) == NULL);
+    glyphCacheDestroy(cache);
+    return 0;
+}
+
+int test_saveAndLoad() {
+    GlyphCache* cache = glyphCacheNew(PAGE_SIZE);
+    for (uint32_t codepoint = '0'; codepoint <= '9'; codepoint++) {
+        GlyphCacheEntry glyph = makeGlyph(3, codepoint, 12);
+        glyphCacheInsert(cache, &glyph, coverage);
+        glyph = makeGlyph(5, codepoint, 20);
+        glyphCacheInsert(cache, &glyph, coverage);
+    }
+    ASSERT_EQ(1, (int) glyphCacheSave(cache, CACHE_PATH));
+
+    uint64_t fonts[2] = { 5, 3 };
+    GlyphCache* loaded = glyphCacheLoad(CACHE_PATH, fonts, 2);
+    ASSERT_EQ(1, loaded != NULL);
+    ASSERT_EQ((int) glyphCacheGetCount(cache),
+              (int) glyphCacheGetCount(loaded));
+    ASSERT_EQ((int) glyphCacheGetPageCount(cache),
+              (int) glyphCacheGetPageCount(loaded));
+    for (uint32_t codepoint = '0'; codepoint <= '9'; codepoint++) {
+        const GlyphCacheEntry* a = glyphCacheFind(cache, 5, codepoint, 20);
+        const GlyphCacheEntry* b = glyphCacheFind(loaded, 5, codepoint, 20);
+        ASSERT_EQ(1, b != NULL);
+        ASSERT_EQ(0, memcmp(a, b, sizeof(GlyphCacheEntry)));
+        ASSERT_EQ(1, checkCoverage(loaded, b));
+    }
+    for (uint32_t i = 0; i < glyphCacheGetPageCount(cache); i++)
+        ASSERT_EQ(0, memcmp(glyphCacheGetPage(cache, i),
+                            glyphCacheGetPage(loaded, i),
+                            PAGE_SIZE * PAGE_SIZE));
+    glyphCacheDestroy(loaded);
+
+    // a font that changed is missing from the file, the cache is stale
+    uint64_t changed[2] = { 3, 6 };
+    ASSERT_EQ(1, glyphCacheLoad(CACHE_PATH, changed, 2) == NULL);
+    ASSERT_EQ(1, glyphCacheLoad("missing_glyph_cache.bin", fonts, 2) == NULL);
+    glyphCacheDestroy(cache);
+    remove(CACHE_PATH);
+    return 0;
+}
+
+// Damaged or outdated files are rejected rather than trusted
+int test_rejectsBadFiles() {
+    GlyphCache* cache = glyphCacheNew(PAGE_SIZE);
+    GlyphCacheEntry glyph = makeGlyph(9, 'x', 10);
+    glyphCacheInsert(cache, &glyph, coverage);
+    glyphCacheSave(cache, CACHE_PATH);
+    glyphCacheDestroy(cache);
+
+    FILE* file = fopen(CACHE_PATH, "rb");
+    static uint8_t bytes[1 << 16];
+    size_t size = fread(bytes, 1, sizeof(bytes), file);
+    fclose(file);
+    uint64_t font = 9;
+
+    // version, right after the 8 byte magic
+    uint32_t version = GLYPH_CACHE_VERSION + 1;
+    memcpy(bytes + 8, &version, sizeof(version));
+    file = fopen(CACHE_PATH, "wb");
+    fwrite(bytes, 1, size, file);
+    fclose(file);
+    ASSERT_EQ(1, glyphCacheLoad(CACHE_PATH, &font, 1) == NULL);
+
+    // truncated
+    version = GLYPH_CACHE_VERSION;
+    memcpy(bytes + 8, &version, sizeof(version));
+    file = fopen(CACHE_PATH, "wb");
+    fwrite(bytes, 1, size - 100, file);
+    fclose(file);
+    ASSERT_EQ(1, glyphCacheLoad(CACHE_PATH, &font, 1) == NULL);
+
+    file = fopen(CACHE_PATH, "wb");
+    fwrite(bytes, 1, size, file);
+    fclose(file);
+    cache = glyphCacheLoad(CACHE_PATH, &font, 1);
+    ASSERT_EQ(1, cache != NULL);
+    glyphCacheDestroy(cache);
+    remove(CACHE_PATH);
+    return 0;
+}
+
+// Glyphs added to a loaded cache go to new pages, saving keeps both
+int test_insertAfterLoad() {
+    GlyphCache* cache = glyphCacheNew(PAGE_SIZE);
+    GlyphCacheEntry glyph = makeGlyph(1, 'b', 14);
+    glyphCacheInsert(cache, &glyph, coverage);
+    glyphCacheSave(cache, CACHE_PATH);
+    glyphCacheDestroy(cache);
+
+    uint64_t font = 1;
+    cache = glyphCacheLoad(CACHE_PATH, &font, 1);
+    ASSERT_EQ(1, cache != NULL);
+    glyph = makeGlyph(1, 'a', 14);
+    const GlyphCacheEntry* added = glyphCacheInsert(cache, &glyph, coverage);
+    ASSERT_EQ(1, added != NULL);
+    ASSERT_EQ(1, (int) added->page);
+    glyph = makeGlyph(2, 'c', 14);
+    glyphCacheInsert(cache, &glyph, coverage);
+    ASSERT_EQ(3, (int) glyphCacheGetCount(cache));
+    ASSERT_EQ(1, glyphCacheSave(cache, CACHE_PATH));
+    glyphCacheDestroy(cache);
+
+    uint64_t fonts[2] = { 1, 2 };
+    cache = glyphCacheLoad(CACHE_PATH, fonts, 2);
+    ASSERT_EQ(1, cache != NULL);
+    ASSERT_EQ(3, (int) glyphCacheGetCount(cache));
+    ASSERT_EQ(2, (int) glyphCacheGetPageCount(cache));
+    ASSERT_EQ(1, checkCoverage(cache, glyphCacheFind(cache, 1, 'a', 14)));
+    ASSERT_EQ(1, checkCoverage(cache, glyphCacheFind(cache, 1, 'b', 14)));
+    ASSERT_EQ(1, checkCoverage(cache, glyphCacheFind(cache, 2, 'c', 14)));
+    glyphCacheDestroy(cache);
+    remove(CACHE_PATH);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_insertAndFind", test_insertAndFind);
+    failed += runTest("test_saveAndLoad", test_saveAndLoad);
+    failed += runTest("test_rejectsBadFiles", test_rejectsBadFiles);
+    failed += runTest("test_insertAfterLoad", test_insertAfterLoad);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,164 @@
+#include "testing_framework.h"
+#include "../src/gpu_memory.h"
+#include "../src/context.h"
+#include "../src/window.h"
+
+#include <stdio.h>
+
+// Stands in for an atlas page or a cached layer
+typedef struct FakeCache {
+    uint64_t bytes;
+    uint32_t handle;
+    uint8_t resident;
+} FakeCache;
+
+static void fakeEvict(void* userData) {
+    FakeCache* cache = userData;
+    gpuMemoryFreed(GPU_MEMORY_TEXTURE, cache->bytes);
+    cache->resident = 0;
+}
+
+static void fakeFill(FakeCache* cache, uint64_t bytes) {
+    cache->bytes = bytes;
+    cache->resident = 1;
+    if (!cache->handle)
+        cache->handle = gpuMemoryAddEvictable(fakeEvict, cache);
+    gpuMemoryAllocated(GPU_MEMORY_TEXTURE, bytes);
+    gpuMemoryTouch(cache->handle);
+}
+
+static void fakeRelease(FakeCache* cache) {
+    if (cache->resident)
+        fakeEvict(cache);
+    gpuMemoryRemoveEvictable(cache->handle);
+    cache->handle = GPU_MEMORY_INVALID_HANDLE;
+}
+
+int test_categories() {
+    GpuMemoryStats before = gpuMemoryGetStats();
+    gpuMemoryAllocated(GPU_MEMORY_BUFFER, 1000);
+    gpuMemoryAllocated(GPU_MEMORY_RENDER_TARGET, 4000);
+    GpuMemoryStats during = gpuMemoryGetStats();
+    ASSERT_EQ(1000, (int) (during.bytes[GPU_MEMORY_BUFFER] -
+                           before.bytes[GPU_MEMORY_BUFFER]));
+    ASSERT_EQ(1, (int) (during.counts[GPU_MEMORY_RENDER_TARGET] -
+                        before.counts[GPU_MEMORY_RENDER_TARGET]));
+    ASSERT_EQ(5000, (int) (during.totalBytes - before.totalBytes));
+
+    gpuMemoryFreed(GPU_MEMORY_BUFFER, 1000);
+    gpuMemoryFreed(GPU_MEMORY_RENDER_TARGET, 4000);
+    GpuMemoryStats after = gpuMemoryGetStats();
+    ASSERT_EQ(1, (int) (after.totalBytes == before.totalBytes));
+    ASSERT_EQ(1, (int) (after.peakBytes >= before.totalBytes + 5000));
+    return 0;
+}
+
+int test_evictsLeastRecentlyUsed() {
+    FakeCache old = { 0 }, recent = { 0 }, current = { 0 };
+    uint64_t base = gpuMemoryGetStats().totalBytes;
+    fakeFill(&old, 100);
+    gpuMemoryEndFrame();
+    fakeFill(&recent, 100);
+    gpuMemoryEndFrame();
+    fakeFill(&current, 100);
+
+    // one cache too many, the oldest goes first
+    gpuMemorySetBudget(base + 250);
+    gpuMemoryEndFrame();
+    ASSERT_EQ(0, (int) old.resident);
+    ASSERT_EQ(1, (int) recent.resident);
+    ASSERT_EQ(1, (int) current.resident);
+
+    // touching keeps a cache alive over an older one
+    gpuMemoryTouch(recent.handle);
+    gpuMemoryEndFrame();
+    fakeFill(&old, 100);
+    gpuMemoryTouch(old.handle);
+    gpuMemoryEndFrame();
+    ASSERT_EQ(1, (int) old.resident);
+    ASSERT_EQ(1, (int) recent.resident);
+    ASSERT_EQ(0, (int) current.resident);
+
+    gpuMemorySetBudget(0);
+    fakeRelease(&old);
+    fakeRelease(&recent);
+    fakeRelease(&current);
+    ASSERT_EQ(1, (int) (gpuMemoryGetStats().totalBytes == base));
+    return 0;
+}
+
+int test_currentFrameNeverEvicted() {
+    FakeCache cache = { 0 };
+    uint32_t evictions = gpuMemoryGetStats().evictions;
+    fakeFill(&cache, 500);
+    gpuMemorySetBudget(1);
+    gpuMemoryEndFrame();
+    ASSERT_EQ(1, (int) cache.resident);
+
+    // a frame later it is fair game
+    gpuMemoryEndFrame();
+    ASSERT_EQ(0, (int) cache.resident);
+    ASSERT_EQ(1, (int) (gpuMemoryGetStats().evictions - evictions));
+
+    gpuMemorySetBudget(0);
+    fakeRelease(&cache);
+    return 0;
+}
+
+int test_unlimitedBudget() {
+    FakeCache cache = { 0 };
+    fakeFill(&cache, 1u << 30);
+    gpuMemoryEndFrame();
+    gpuMemoryEndFrame();
+    ASSERT_EQ(1, (int) cache.resident);
+    fakeRelease(&cache);
+    return 0;
+}
+
+int test_shareGroupsAccountedApart() {
+    Context* context = contextNew();
+    Window* first = context ? contextCreateWindow(context, 16, 16, "") : NULL;
+    if (!first) {
+        printf("share groups: no OpenGL context, skipped\n");
+        contextDestroy(context);
+        return 0;
+    }
+    Window* second = contextCreateWindow(context, 16, 16, "");
+    ASSERT_EQ(1, second != NULL);
+    uint64_t base = gpuMemoryGetStats().totalBytes;
+    gpuMemoryAllocated(GPU_MEMORY_BUFFER, 100);
+
+    // a window of its own shares nothing, so it starts from zero
+    Window* other = windowNewHeadless(16, 16);
+    ASSERT_EQ(0, (int) gpuMemoryGetStats().totalBytes);
+    windowDestroy(other);
+
+    // both windows of the context see the same counters
+    contextMakeCurrent(context, first);
+    ASSERT_EQ(1, (int) (gpuMemoryGetStats().totalBytes == base + 100));
+    contextMakeCurrent(context, second);
+    ASSERT_EQ(1, (int) (gpuMemoryGetStats().totalBytes == base + 100));
+    gpuMemoryFreed(GPU_MEMORY_BUFFER, 100);
+    contextDestroy(context);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_categories", test_categories);
+    failed += runTest("test_evictsLeastRecentlyUsed",
+                      test_evictsLeastRecentlyUsed);
+    failed += runTest("test_currentFrameNeverEvicted",
+                      test_currentFrameNeverEvicted);
+    failed += runTest("test_unlimitedBudget", test_unlimitedBudget);
+    failed += runTest("test_shareGroupsAccountedApart",
+                      test_shareGroupsAccountedApart);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
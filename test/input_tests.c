@@ -0,0 +1,110 @@
+#include <string.h>
+
+#include "testing_framework.h"
+#include "../src/input_internal.h"
+
+#define KEY_A 65
+#define KEY_SPACE 32
+
+static InputQueueInternal queue;
+static InputSnapshot snapshot;
+
+static void reset() {
+    memset(&queue, 0, sizeof(queue));
+    memset(&snapshot, 0, sizeof(snapshot));
+}
+
+int test_pressHoldRelease() {
+    reset();
+    internal_inputPushKey(&queue, KEY_A, 1);
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_EQ(1, inputKeyPressed(&snapshot, KEY_A));
+    ASSERT_EQ(1, inputKeyDown(&snapshot, KEY_A));
+
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_EQ(0, inputKeyPressed(&snapshot, KEY_A));
+    ASSERT_EQ(1, inputKeyDown(&snapshot, KEY_A));
+
+    internal_inputPushKey(&queue, KEY_A, 0);
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_EQ(1, inputKeyReleased(&snapshot, KEY_A));
+    ASSERT_EQ(0, inputKeyDown(&snapshot, KEY_A));
+    return 0;
+}
+
+int test_tapWithinFrame() {
+    reset();
+    internal_inputPushKey(&queue, KEY_SPACE, 1);
+    internal_inputPushKey(&queue, KEY_SPACE, 0);
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_EQ(1, inputKeyPressed(&snapshot, KEY_SPACE));
+    ASSERT_EQ(1, inputKeyReleased(&snapshot, KEY_SPACE));
+    ASSERT_EQ(0, inputKeyDown(&snapshot, KEY_SPACE));
+    return 0;
+}
+
+int test_outOfRangeKeys() {
+    reset();
+    internal_inputPushKey(&queue, -1, 1);
+    internal_inputPushKey(&queue, INPUT_KEY_COUNT, 1);
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_EQ(0, inputKeyDown(&snapshot, -1));
+    ASSERT_EQ(0, inputKeyDown(&snapshot, INPUT_KEY_COUNT));
+    return 0;
+}
+
+int test_mouse() {
+    reset();
+    internal_inputPushCursor(&queue, (Vec2) { 10.0f, 10.0f });
+    internal_inputPushCursor(&queue, (Vec2) { 30.0f, 40.0f });
+    internal_inputPushButton(&queue, 1, 1);
+    internal_inputPushScroll(&queue, (Vec2) { 0.0f, 1.0f });
+    internal_inputPushScroll(&queue, (Vec2) { 0.0f, 2.0f });
+    ASSERT_EQ(3, (int) queue.count);
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_FLOAT_EQ(30.0, snapshot.mousePosition.x);
+    ASSERT_FLOAT_EQ(40.0, snapshot.mouseDelta.y);
+    ASSERT_FLOAT_EQ(3.0, snapshot.scroll.y);
+    ASSERT_EQ(1, inputMousePressed(&snapshot, 1));
+    ASSERT_EQ(0, inputMouseDown(&snapshot, 0));
+
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_FLOAT_EQ(0.0, snapshot.mouseDelta.x);
+    ASSERT_FLOAT_EQ(0.0, snapshot.scroll.y);
+    ASSERT_EQ(1, inputMouseDown(&snapshot, 1));
+
+    // codes outside the tracked buttons don't alias onto held ones
+    ASSERT_EQ(0, inputMouseDown(&snapshot, 1 + INPUT_MOUSE_BUTTON_COUNT));
+    ASSERT_EQ(0, inputMouseDown(&snapshot, 1 - INPUT_MOUSE_BUTTON_COUNT));
+    return 0;
+}
+
+int test_textAndOverflow() {
+    reset();
+    for (uint32_t i = 0; i < INPUT_QUEUE_CAPACITY + 10; i++)
+        internal_inputPushChar(&queue, 'a' + i % 26);
+    internal_inputUpdate(&queue, &snapshot);
+    ASSERT_EQ(INPUT_TEXT_CAPACITY, (int) snapshot.textLength);
+    ASSERT_EQ('a', (int) snapshot.text[0]);
+    // 10 never made it into the queue, the rest didn't fit in text
+    ASSERT_EQ(INPUT_QUEUE_CAPACITY + 10 - INPUT_TEXT_CAPACITY,
+              (int) snapshot.droppedEvents);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_pressHoldRelease", test_pressHoldRelease);
+    failed += runTest("test_tapWithinFrame", test_tapWithinFrame);
+    failed += runTest("test_outOfRangeKeys", test_outOfRangeKeys);
+    failed += runTest("test_mouse", test_mouse);
+    failed += runTest("test_textAndOverflow", test_textAndOverflow);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,166 @@
+#include "testing_framework.h"
+#include "../src/line_series.h"
+#include "../src/gpu_memory.h"
+#include "../src/window.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SAMPLE_COUNT 1000000
+#define WIDTH 200
+
+static Vec2 samples[SAMPLE_COUNT];
+static Vec2 points[2 * WIDTH + 4];
+
+static void fillSamples() {
+    for (uint32_t i = 0; i < SAMPLE_COUNT; i++) {
+        float spike = i % 7919 == 0 ? 50.0f : i % 6007 == 0 ? -50.0f : 0.0f;
+        samples[i] = (Vec2) { (float) i, sinf((float) i * 0.001f) + spike };
+    }
+}
+
+// Every column holds the brute force extremes of its samples
+int test_decimateMatchesBruteForce() {
+    fillSamples();
+    LineSeries* series = lineSeriesNew(SAMPLE_COUNT);
+    ASSERT_EQ(1, (int) lineSeriesAppend(series, samples, SAMPLE_COUNT));
+
+    Rect view = { { 0.0f, -60.0f }, { (float) SAMPLE_COUNT, 60.0f } };
+    Vec2 size = { WIDTH, 100.0f };
+    uint32_t count = lineSeriesDecimate(series, view, size, points,
+                                        2 * WIDTH + 4);
+    ASSERT_EQ(1, (int) (count > WIDTH && count <= 2 * WIDTH));
+
+    float scaleX = WIDTH / (view.max.x - view.min.x);
+    float scaleY = size.y / (view.max.y - view.min.y);
+    uint32_t sample = 0, point = 0;
+    for (uint32_t column = 0; column < WIDTH; column++) {
+        float boundary = view.min.x + (column + 1) / scaleX;
+        float low = INFINITY, high = -INFINITY;
+        for (; sample < SAMPLE_COUNT &&
+               (column + 1 == WIDTH || samples[sample].x < boundary);
+             sample++) {
+            low = samples[sample].y < low ? samples[sample].y : low;
+            high = samples[sample].y > high ? samples[sample].y : high;
+        }
+        float top = (view.max.y - high) * scaleY;
+        float bottom = (view.max.y - low) * scaleY;
+
+        float first = points[point].y, last = first;
+        ASSERT_FLOAT_EQ(points[point].x, column + 0.5);
+        point++;
+        if (point < count && points[point].x == column + 0.5f)
+            last = points[point++].y;
+        ASSERT_FLOAT_EQ(first < last ? first : last, top);
+        ASSERT_FLOAT_EQ(first < last ? last : first, bottom);
+    }
+    ASSERT_EQ((int) count, (int) point);
+    lineSeriesDestroy(series);
+    return 0;
+}
+
+int test_sparseKeepsSamples() {
+    LineSeries* series = lineSeriesNew(0);
+    Vec2 few[4] = { { 0, 0 }, { 10, 10 }, { 20, 0 }, { 30, 10 } };
+    lineSeriesAppend(series, few, 4);
+
+    // the samples just outside the view are kept so the line leaves it
+    Rect view = { { 5, 0 }, { 25, 10 } };
+    uint32_t count = lineSeriesDecimate(series, view, (Vec2) { 20, 10 },
+                                        points, 2 * WIDTH + 4);
+    ASSERT_EQ(4, (int) count);
+    ASSERT_FLOAT_EQ(points[0].x, -5.0);
+    ASSERT_FLOAT_EQ(points[0].y, 10.0);
+    ASSERT_FLOAT_EQ(points[1].x, 5.0);
+    ASSERT_FLOAT_EQ(points[1].y, 0.0);
+    ASSERT_FLOAT_EQ(points[3].x, 25.0);
+
+    count = lineSeriesDecimate(series, (Rect) { { 100, 0 }, { 200, 1 } },
+                               (Vec2) { 20, 10 }, points, 2 * WIDTH + 4);
+    ASSERT_EQ(1, (int) count);     // only the last sample, left of the view
+    lineSeriesDestroy(series);
+    return 0;
+}
+
+// Appending in pieces gives the same pyramid as one large append
+int test_incrementalAppend() {
+    fillSamples();
+    LineSeries* whole = lineSeriesNew(0);
+    LineSeries* pieces = lineSeriesNew(0);
+    lineSeriesAppend(whole, samples, SAMPLE_COUNT);
+    srand(7);
+    for (uint32_t done = 0; done < SAMPLE_COUNT;) {
+        uint32_t chunk = 1 + (uint32_t) rand() % 5000;
+        if (chunk > SAMPLE_COUNT - done)
+            chunk = SAMPLE_COUNT - done;
+        ASSERT_EQ(1, (int) lineSeriesAppend(pieces, samples + done, chunk));
+        done += chunk;
+    }
+    ASSERT_EQ(SAMPLE_COUNT, (int) lineSeriesGetCount(pieces));
+
+    static Vec2 expected[2 * WIDTH + 4];
+    Rect view = { { 123456.0f, -2.0f }, { 654321.0f, 2.0f } };
+    uint32_t a = lineSeriesDecimate(whole, view, (Vec2) { WIDTH, 50 },
+                                    expected, 2 * WIDTH + 4);
+    uint32_t b = lineSeriesDecimate(pieces, view, (Vec2) { WIDTH, 50 },
+                                    points, 2 * WIDTH + 4);
+    ASSERT_EQ((int) a, (int) b);
+    for (uint32_t i = 0; i < a; i++) {
+        ASSERT_FLOAT_EQ(expected[i].x, points[i].x);
+        ASSERT_FLOAT_EQ(expected[i].y, points[i].y);
+    }
+
+    // going back in x is refused, the series is left as it was
+    Vec2 late = { 5.0f, 0.0f };
+    ASSERT_EQ(0, (int) lineSeriesAppend(pieces, &late, 1));
+    ASSERT_EQ(SAMPLE_COUNT, (int) lineSeriesGetCount(pieces));
+    lineSeriesDestroy(whole);
+    lineSeriesDestroy(pieces);
+    return 0;
+}
+
+// The GL buffer is accounted once, from its first growth to destruction
+int test_drawAccountsBuffer() {
+    Window* window = windowNewHeadless(64, 64);
+    if (!window) {
+        printf("buffer accounting: no OpenGL context, skipped\n");
+        return 0;
+    }
+    fillSamples();
+    GpuMemoryStats before = gpuMemoryGetStats();
+    LineSeries* series = lineSeriesNew(0);
+    ASSERT_EQ(1, (int) lineSeriesAppend(series, samples, 1000));
+    Rect view = { { 0.0f, -2.0f }, { 1000.0f, 2.0f } };
+    lineSeriesDraw(series, view, (Vec2) { 64, 64 });
+    GpuMemoryStats drawn = gpuMemoryGetStats();
+    ASSERT_EQ(1, (int) (drawn.counts[GPU_MEMORY_BUFFER] -
+                        before.counts[GPU_MEMORY_BUFFER]));
+
+    // a series never drawn frees nothing
+    lineSeriesDestroy(lineSeriesNew(0));
+    lineSeriesDestroy(series);
+    GpuMemoryStats after = gpuMemoryGetStats();
+    ASSERT_EQ((int) before.counts[GPU_MEMORY_BUFFER],
+              (int) after.counts[GPU_MEMORY_BUFFER]);
+    ASSERT_EQ(1, (int) (after.bytes[GPU_MEMORY_BUFFER] ==
+                        before.bytes[GPU_MEMORY_BUFFER]));
+    windowDestroy(window);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_decimateMatchesBruteForce",
+                      test_decimateMatchesBruteForce);
+    failed += runTest("test_sparseKeepsSamples", test_sparseKeepsSamples);
+    failed += runTest("test_incrementalAppend", test_incrementalAppend);
+    failed += runTest("test_drawAccountsBuffer", test_drawAccountsBuffer);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,154 @@
+#include "testing_framework.h"
+#include "../src/memory.h"
+#include "../src/spatial.h"
+#include "../src/damage.h"
+#include "../src/particle.h"
+#include "../src/render_graph.h"
+
+#define STEADY_ITEMS 512
+
+int test_tagAccounting() {
+    MemoryStats before = memoryGetTagStats(MEMORY_TAG_UNKNOWN);
+    void* block = memoryAlloc(100, MEMORY_TAG_UNKNOWN, __FILE__, __LINE__);
+    void* zeroed = memoryCalloc(10, 4, MEMORY_TAG_UNKNOWN, __FILE__,
+                                __LINE__);
+    MemoryStats during = memoryGetTagStats(MEMORY_TAG_UNKNOWN);
+    ASSERT_EQ(140, (int) (during.liveBytes - before.liveBytes));
+    ASSERT_EQ(2, (int) (during.liveAllocations - before.liveAllocations));
+    ASSERT_EQ(0, (int) ((uint8_t*) zeroed)[39]);
+
+    memoryFree(block);
+    memoryFree(zeroed);
+    MemoryStats after = memoryGetTagStats(MEMORY_TAG_UNKNOWN);
+    ASSERT_EQ(0, (int) (after.liveBytes - before.liveBytes));
+    ASSERT_EQ(1, (int) (after.peakBytes >= before.liveBytes + 140));
+    return 0;
+}
+
+int test_reallocKeepsContents() {
+    MemoryStats before = memoryGetTagStats(MEMORY_TAG_RENDER);
+    uint32_t* values = memoryAlloc(4 * sizeof(uint32_t), MEMORY_TAG_RENDER,
+                                   __FILE__, __LINE__);
+    for (uint32_t i = 0; i < 4; i++)
+        values[i] = i * 7;
+    values = memoryRealloc(values, 1000 * sizeof(uint32_t), MEMORY_TAG_RENDER,
+                           __FILE__, __LINE__);
+    ASSERT_EQ(21, (int) values[3]);
+
+    MemoryStats during = memoryGetTagStats(MEMORY_TAG_RENDER);
+    ASSERT_EQ(4000, (int) (during.liveBytes - before.liveBytes));
+    ASSERT_EQ(1, (int) (during.liveAllocations - before.liveAllocations));
+
+    // size 0 frees, like TG_FREE
+    ASSERT_EQ(1, memoryRealloc(values, 0, MEMORY_TAG_RENDER, __FILE__,
+                               __LINE__) == NULL);
+    MemoryStats after = memoryGetTagStats(MEMORY_TAG_RENDER);
+    ASSERT_EQ(0, (int) (after.liveAllocations - before.liveAllocations));
+    return 0;
+}
+
+int test_frameCounters() {
+    memoryEndFrame();
+    memoryFree(memoryAlloc(8, MEMORY_TAG_UNKNOWN, __FILE__, __LINE__));
+    memoryFree(memoryAlloc(8, MEMORY_TAG_UNKNOWN, __FILE__, __LINE__));
+    memoryEndFrame();
+    ASSERT_EQ(2, (int) memoryGetStats().frameAllocations);
+    memoryEndFrame();
+    ASSERT_EQ(0, (int) memoryGetStats().frameAllocations);
+    return 0;
+}
+
+int test_leakReport() {
+    uint64_t before = memoryReportLeaks();
+    void* leaked = memoryAlloc(16, MEMORY_TAG_UNKNOWN, __FILE__, __LINE__);
+    ASSERT_EQ(1, (int) (memoryReportLeaks() - before));
+    memoryFree(leaked);
+    ASSERT_EQ(0, (int) (memoryReportLeaks() - before));
+    return 0;
+}
+
+// CPU side of a typical frame, moving items, particles, damage and passes
+static void steadyFrame(SpatialGrid* grid, SpatialHandle* handles,
+                        ParticleSystem* particles, DamageTracker* damage,
+                        RenderGraph* graph, uint32_t frame) {
+    SpatialHandle found[64];
+    for (uint32_t i = 0; i < STEADY_ITEMS; i++) {
+        float x = (float) ((i * 37 + frame * 5) % 1000);
+        float y = (float) ((i * 91 + frame * 3) % 1000);
+        spatialGridMove(grid, handles[i],
+                        rectFromSize((Vec2) { x, y }, (Vec2) { 8, 8 }));
+    }
+    spatialGridQueryRect(grid, rectFromSize((Vec2) { 0, 0 },
+                                            (Vec2) { 300, 300 }), found, 64);
+    particleSystemUpdate(particles, 1.0f / 60.0f);
+    damageAdd(damage, rectFromSize((Vec2) { (float) frame, 0 },
+                                   (Vec2) { 16, 16 }));
+    uint32_t count;
+    damageGetRegions(damage, &count);
+    damageEndFrame(damage);
+    renderGraphCompile(graph, (Vec2) { 800, 600 });
+}
+
+int test_steadyStateAllocationFree() {
+    if (!memoryIsTracking()) {
+        printf("library built without TG_TRACK_ALLOCATIONS, skipping\n");
+        return 0;
+    }
+
+    SpatialGrid* grid = spatialGridNew(32.0f, STEADY_ITEMS);
+    SpatialHandle handles[STEADY_ITEMS];
+    for (uint32_t i = 0; i < STEADY_ITEMS; i++)
+        handles[i] = spatialGridInsert(grid, rectFromSize(
+            (Vec2) { (float) i, 0 }, (Vec2) { 8, 8 }), NULL);
+    ASSERT_EQ(1, (int) (memoryGetTagStats(MEMORY_TAG_SPATIAL).liveBytes > 0));
+
+    ParticleSystem* particles = particleSystemNew(PARTICLE_BACKEND_CPU, 4096);
+    ParticleEmitter emitter = {
+        .velocityMax = { 50.0f, 50.0f }, .lifetimeMin = 0.5f,
+        .lifetimeMax = 1.0f, .rate = 2000.0f
+    };
+    particleSystemSetEmitter(particles, &emitter);
+    DamageTracker* damage = damageTrackerNew(800, 600);
+    RenderGraph* graph = renderGraphNew();
+    uint32_t layer = renderGraphAddLayer(graph, 1.0f, PIXEL_FORMAT_RGBA8);
+    uint32_t pass = renderGraphAddPass(graph, "layer", NULL, NULL);
+    renderGraphPassWrite(graph, pass, layer);
+    pass = renderGraphAddPass(graph, "final", NULL, NULL);
+    renderGraphPassRead(graph, pass, layer);
+    renderGraphPassWrite(graph, pass, RENDER_GRAPH_BACKBUFFER);
+
+    // the first frames may grow buffers, after that nothing should
+    uint32_t frame = 0;
+    for (; frame < 120; frame++)
+        steadyFrame(grid, handles, particles, damage, graph, frame);
+    memoryEndFrame();
+    for (; frame < 240; frame++) {
+        steadyFrame(grid, handles, particles, damage, graph, frame);
+        memoryEndFrame();
+        ASSERT_EQ(0, (int) memoryGetStats().frameAllocations);
+    }
+
+    renderGraphDestroy(graph);
+    damageTrackerDestroy(damage);
+    particleSystemDestroy(particles);
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_tagAccounting", test_tagAccounting);
+    failed += runTest("test_reallocKeepsContents", test_reallocKeepsContents);
+    failed += runTest("test_frameCounters", test_frameCounters);
+    failed += runTest("test_leakReport", test_leakReport);
+    failed += runTest("test_steadyStateAllocationFree",
+                      test_steadyStateAllocationFree);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,36 @@
+#include <stdio.h>
+
+#include "../src/particle.h"
+#include "../src/timer.h"
+
+#define FRAME_COUNT 100
+
+static void benchmarkCpu(uint32_t count) {
+    ParticleSystem* system = particleSystemNew(PARTICLE_BACKEND_CPU, count);
+    ParticleEmitter emitter = {
+        .velocityMin = { -100.0f, -100.0f },
+        .velocityMax = { 100.0f, 100.0f },
+        .gravity = { 0.0f, 98.0f },
+        .lifetimeMin = 1000.0f,     // nothing dies, every frame is full
+        .lifetimeMax = 1000.0f
+    };
+    particleSystemSetEmitter(system, &emitter);
+    particleSystemEmit(system, count);
+
+    uint64_t start = timerNow();
+    for (int i = 0; i < FRAME_COUNT; i++)
+        particleSystemUpdate(system, 1.0f / 60.0f);
+    double ms = timerToMs(timerNow() - start);
+
+    printf("%8u particles | %7.3f ms per update | %9.0f particles per ms\n",
+           count, ms / FRAME_COUNT,
+           (double) count * FRAME_COUNT / ms);
+    particleSystemDestroy(system);
+}
+
+int main() {
+    benchmarkCpu(10000);
+    benchmarkCpu(100000);
+    benchmarkCpu(1000000);
+    return 0;
+}
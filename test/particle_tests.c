@@ -0,0 +1,85 @@
+#include "testing_framework.h"
+#include "../src/particle.h"
+
+static ParticleEmitter fixedEmitter() {
+    return (ParticleEmitter) {
+        .position = { 10.0f, 20.0f },
+        .velocityMin = { 2.0f, 0.0f },
+        .velocityMax = { 2.0f, 0.0f },
+        .gravity = { 0.0f, 10.0f },
+        .lifetimeMin = 1.0f,
+        .lifetimeMax = 1.0f
+    };
+}
+
+int test_emitCapacity() {
+    ParticleSystem* system = particleSystemNew(PARTICLE_BACKEND_CPU, 10);
+    particleSystemEmit(system, 25);
+    ASSERT_EQ(10, (int) particleSystemGetCount(system));
+    particleSystemDestroy(system);
+    return 0;
+}
+
+int test_integration() {
+    ParticleSystem* system = particleSystemNew(PARTICLE_BACKEND_CPU, 7);
+    ParticleEmitter emitter = fixedEmitter();
+    particleSystemSetEmitter(system, &emitter);
+    particleSystemEmit(system, 7);
+    particleSystemUpdate(system, 0.5f);
+
+    const float* x;
+    const float* y;
+    uint32_t count = particleSystemGetPositions(system, &x, &y);
+    ASSERT_EQ(7, (int) count);
+    // velocity is updated first: vy = 5, then y += 5 * 0.5
+    for (uint32_t i = 0; i < count; i++) {
+        ASSERT_FLOAT_EQ(11.0, x[i]);
+        ASSERT_FLOAT_EQ(22.5, y[i]);
+    }
+    particleSystemDestroy(system);
+    return 0;
+}
+
+int test_expiry() {
+    ParticleSystem* system = particleSystemNew(PARTICLE_BACKEND_CPU, 100);
+    ParticleEmitter emitter = fixedEmitter();
+    particleSystemSetEmitter(system, &emitter);
+    particleSystemEmit(system, 50);
+    particleSystemUpdate(system, 0.6f);
+    emitter.lifetimeMin = emitter.lifetimeMax = 5.0f;
+    particleSystemSetEmitter(system, &emitter);
+    particleSystemEmit(system, 20);
+    particleSystemUpdate(system, 0.6f);
+    ASSERT_EQ(20, (int) particleSystemGetCount(system));
+    particleSystemDestroy(system);
+    return 0;
+}
+
+int test_rate() {
+    ParticleSystem* system = particleSystemNew(PARTICLE_BACKEND_CPU, 1000);
+    ParticleEmitter emitter = fixedEmitter();
+    emitter.lifetimeMin = emitter.lifetimeMax = 100.0f;
+    emitter.rate = 10.0f;
+    particleSystemSetEmitter(system, &emitter);
+    for (int i = 0; i < 40; i++)
+        particleSystemUpdate(system, 0.025f);
+    ASSERT_EQ(10, (int) particleSystemGetCount(system));
+    particleSystemDestroy(system);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_emitCapacity", test_emitCapacity);
+    failed += runTest("test_integration", test_integration);
+    failed += runTest("test_expiry", test_expiry);
+    failed += runTest("test_rate", test_rate);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,131 @@
+#include <string.h>
+
+#include "testing_framework.h"
+#include "../src/pixel.h"
+
+int test_formatSize() {
+    ASSERT_EQ(1, (int) pixelFormatSize(PIXEL_FORMAT_R8));
+    ASSERT_EQ(3, (int) pixelFormatSize(PIXEL_FORMAT_RGB8));
+    ASSERT_EQ(4, (int) pixelFormatSize(PIXEL_FORMAT_RGBA8));
+    return 0;
+}
+
+int test_expandFormats() {
+    uint8_t gray[2] = { 10, 200 };
+    uint8_t rgb[6] = { 1, 2, 3, 4, 5, 6 };
+    uint8_t out[8];
+
+    pixelConvert(out, PIXEL_FORMAT_RGBA8, gray, PIXEL_FORMAT_R8, 2, 1, 0, 0);
+    ASSERT_EQ(10, out[0]);
+    ASSERT_EQ(10, out[2]);
+    ASSERT_EQ(255, out[3]);
+    ASSERT_EQ(200, out[4]);
+
+    pixelConvert(out, PIXEL_FORMAT_RGBA8, rgb, PIXEL_FORMAT_RGB8, 2, 1, 0, 0);
+    ASSERT_EQ(3, out[2]);
+    ASSERT_EQ(255, out[3]);
+    ASSERT_EQ(4, out[4]);
+    return 0;
+}
+
+int test_narrowWithStride() {
+    // 1x2 image with 8 bytes between rows, padding must be skipped
+    uint8_t rgba[16] = { 9, 8, 7, 6, 0, 0, 0, 0, 5, 4, 3, 2, 0, 0, 0, 0 };
+    uint8_t out[6];
+    pixelConvert(out, PIXEL_FORMAT_RGB8, rgba, PIXEL_FORMAT_RGBA8, 1, 2, 8, 0);
+    ASSERT_EQ(9, out[0]);
+    ASSERT_EQ(7, out[2]);
+    ASSERT_EQ(5, out[3]);
+    pixelConvert(out, PIXEL_FORMAT_R8, rgba, PIXEL_FORMAT_RGBA8, 1, 2, 8, 0);
+    ASSERT_EQ(9, out[0]);
+    ASSERT_EQ(5, out[1]);
+    return 0;
+}
+
+int test_premultiply() {
+    uint8_t pixels[8] = { 255, 128, 0, 128, 200, 100, 50, 255 };
+    pixelPremultiply(pixels, 2);
+    ASSERT_EQ(128, pixels[0]);
+    ASSERT_EQ(64, pixels[1]);
+    ASSERT_EQ(0, pixels[2]);
+    ASSERT_EQ(128, pixels[3]);
+    ASSERT_EQ(200, pixels[4]);
+
+    uint8_t transparent[4] = { 255, 255, 255, 0 };
+    uint8_t out[4];
+    pixelConvert(out, PIXEL_FORMAT_RGBA8, transparent, PIXEL_FORMAT_RGBA8,
+                 1, 1, 0, 1);
+    ASSERT_EQ(0, out[0]);
+    return 0;
+}
+
+int test_mipLevelCount() {
+    ASSERT_EQ(1, (int) pixelMipLevelCount(1, 1));
+    ASSERT_EQ(11, (int) pixelMipLevelCount(1024, 512));
+    ASSERT_EQ(3, (int) pixelMipLevelCount(5, 3));
+    return 0;
+}
+
+int test_downsampleBox() {
+    uint8_t src[4] = { 0, 10, 20, 31 };
+    uint8_t dst[1];
+    pixelDownsample(dst, src, PIXEL_FORMAT_R8, 2, 2);
+    ASSERT_EQ(15, dst[0]);
+    return 0;
+}
+
+// The SIMD path must match the per channel reference exactly
+int test_downsampleMatchesScalar() {
+    enum { W = 13, H = 6 };
+    uint8_t src[W * H * 4];
+    uint8_t dst[(W / 2) * (H / 2) * 4];
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < sizeof(src); i++) {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (uint8_t) (seed >> 16);
+    }
+    pixelDownsample(dst, src, PIXEL_FORMAT_RGBA8, W, H);
+
+    for (int y = 0; y < H / 2; y++) {
+        for (int x = 0; x < W / 2; x++) {
+            for (int c = 0; c < 4; c++) {
+                int sum = src[((y * 2) * W + x * 2) * 4 + c] +
+                          src[((y * 2) * W + x * 2 + 1) * 4 + c] +
+                          src[((y * 2 + 1) * W + x * 2) * 4 + c] +
+                          src[((y * 2 + 1) * W + x * 2 + 1) * 4 + c];
+                ASSERT_EQ((sum + 2) >> 2, dst[(y * (W / 2) + x) * 4 + c]);
+            }
+        }
+    }
+    return 0;
+}
+
+int test_downsampleSingleRow() {
+    uint8_t src[3 * 4] = { 10, 10, 10, 10, 30, 30, 30, 30, 99, 99, 99, 99 };
+    uint8_t dst[4];
+    pixelDownsample(dst, src, PIXEL_FORMAT_RGBA8, 3, 1);
+    ASSERT_EQ(20, dst[0]);
+    ASSERT_EQ(20, dst[3]);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_formatSize", test_formatSize);
+    failed += runTest("test_expandFormats", test_expandFormats);
+    failed += runTest("test_narrowWithStride", test_narrowWithStride);
+    failed += runTest("test_premultiply", test_premultiply);
+    failed += runTest("test_mipLevelCount", test_mipLevelCount);
+    failed += runTest("test_downsampleBox", test_downsampleBox);
+    failed += runTest("test_downsampleMatchesScalar",
+                      test_downsampleMatchesScalar);
+    failed += runTest("test_downsampleSingleRow", test_downsampleSingleRow);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,136 @@
+#include "testing_framework.h"
+#include "../src/render_graph.h"
+
+// Only renderGraphCompile is exercised, it decides everything without GL
+static const Vec2 viewSize = { 800, 600 };
+
+int test_unusedPassCulled() {
+    RenderGraph* graph = renderGraphNew();
+    uint32_t unused = renderGraphAddTransient(graph, 1.0f, PIXEL_FORMAT_RGBA8);
+    uint32_t orphan = renderGraphAddPass(graph, "orphan", NULL, NULL);
+    renderGraphPassWrite(graph, orphan, unused);
+    uint32_t final = renderGraphAddPass(graph, "final", NULL, NULL);
+    renderGraphPassWrite(graph, final, RENDER_GRAPH_BACKBUFFER);
+
+    ASSERT_EQ(1, (int) renderGraphCompile(graph, viewSize));
+    ASSERT_EQ(0, (int) renderGraphPassWillRun(graph, orphan));
+    ASSERT_EQ(1, (int) renderGraphPassWillRun(graph, final));
+    ASSERT_EQ(1, (int) renderGraphGetStats(graph).passesCulled);
+    renderGraphDestroy(graph);
+    return 0;
+}
+
+int test_transientChainRuns() {
+    RenderGraph* graph = renderGraphNew();
+    uint32_t blur = renderGraphAddTransient(graph, 0.5f, PIXEL_FORMAT_RGBA8);
+    uint32_t producer = renderGraphAddPass(graph, "blur", NULL, NULL);
+    renderGraphPassWrite(graph, producer, blur);
+    uint32_t final = renderGraphAddPass(graph, "final", NULL, NULL);
+    renderGraphPassRead(graph, final, blur);
+    renderGraphPassWrite(graph, final, RENDER_GRAPH_BACKBUFFER);
+
+    // transients are redrawn every frame they are needed
+    for (int frame = 0; frame < 3; frame++)
+        ASSERT_EQ(2, (int) renderGraphCompile(graph, viewSize));
+    renderGraphDestroy(graph);
+    return 0;
+}
+
+int test_layerCached() {
+    RenderGraph* graph = renderGraphNew();
+    uint32_t panel = renderGraphAddLayer(graph, 1.0f, PIXEL_FORMAT_RGBA8);
+    uint32_t draw = renderGraphAddPass(graph, "panel", NULL, NULL);
+    renderGraphPassWrite(graph, draw, panel);
+    uint32_t final = renderGraphAddPass(graph, "final", NULL, NULL);
+    renderGraphPassRead(graph, final, panel);
+    renderGraphPassWrite(graph, final, RENDER_GRAPH_BACKBUFFER);
+
+    ASSERT_EQ(2, (int) renderGraphCompile(graph, viewSize));
+    ASSERT_EQ(1, (int) renderGraphCompile(graph, viewSize));
+    ASSERT_EQ(0, (int) renderGraphPassWillRun(graph, draw));
+
+    renderGraphInvalidate(graph, panel);
+    ASSERT_EQ(2, (int) renderGraphCompile(graph, viewSize));
+    ASSERT_EQ(1, (int) renderGraphCompile(graph, viewSize));
+
+    // a resize throws the cached pixels away
+    ASSERT_EQ(2, (int) renderGraphCompile(graph, (Vec2) { 1024, 768 }));
+    renderGraphDestroy(graph);
+    return 0;
+}
+
+int test_staleLayerPropagates() {
+    RenderGraph* graph = renderGraphNew();
+    uint32_t background = renderGraphAddLayer(graph, 1.0f, PIXEL_FORMAT_RGBA8);
+    uint32_t panel = renderGraphAddLayer(graph, 1.0f, PIXEL_FORMAT_RGBA8);
+    uint32_t first = renderGraphAddPass(graph, "background", NULL, NULL);
+    renderGraphPassWrite(graph, first, background);
+    uint32_t second = renderGraphAddPass(graph, "panel", NULL, NULL);
+    renderGraphPassRead(graph, second, background);
+    renderGraphPassWrite(graph, second, panel);
+    uint32_t final = renderGraphAddPass(graph, "final", NULL, NULL);
+    renderGraphPassRead(graph, final, panel);
+    renderGraphPassWrite(graph, final, RENDER_GRAPH_BACKBUFFER);
+
+    ASSERT_EQ(3, (int) renderGraphCompile(graph, viewSize));
+    ASSERT_EQ(1, (int) renderGraphCompile(graph, viewSize));
+
+    // only the panel reads the background, but it has to be redrawn too
+    renderGraphInvalidate(graph, background);
+    ASSERT_EQ(3, (int) renderGraphCompile(graph, viewSize));
+
+    // redrawing the panel alone leaves the background cached
+    renderGraphInvalidate(graph, panel);
+    ASSERT_EQ(2, (int) renderGraphCompile(graph, viewSize));
+    ASSERT_EQ(0, (int) renderGraphPassWillRun(graph, first));
+    renderGraphDestroy(graph);
+    return 0;
+}
+
+int test_unreadLayerStaysStale() {
+    RenderGraph* graph = renderGraphNew();
+    uint32_t panel = renderGraphAddLayer(graph, 1.0f, PIXEL_FORMAT_RGBA8);
+    uint32_t draw = renderGraphAddPass(graph, "panel", NULL, NULL);
+    renderGraphPassWrite(graph, draw, panel);
+    uint32_t final = renderGraphAddPass(graph, "final", NULL, NULL);
+    renderGraphPassWrite(graph, final, RENDER_GRAPH_BACKBUFFER);
+
+    ASSERT_EQ(1, (int) renderGraphCompile(graph, viewSize));
+
+    // once something reads it, the never drawn layer gets drawn
+    renderGraphPassRead(graph, final, panel);
+    ASSERT_EQ(2, (int) renderGraphCompile(graph, viewSize));
+    renderGraphDestroy(graph);
+    return 0;
+}
+
+int test_readLimit() {
+    RenderGraph* graph = renderGraphNew();
+    uint32_t layer = renderGraphAddLayer(graph, 1.0f, PIXEL_FORMAT_RGBA8);
+    uint32_t pass = renderGraphAddPass(graph, "reader", NULL, NULL);
+    for (int i = 0; i < RENDER_GRAPH_MAX_READS; i++)
+        ASSERT_EQ(1, (int) renderGraphPassRead(graph, pass, layer));
+    ASSERT_EQ(0, (int) renderGraphPassRead(graph, pass, layer));
+    ASSERT_EQ(0, (int) renderGraphPassRead(graph, pass,
+                                           RENDER_GRAPH_BACKBUFFER));
+    renderGraphDestroy(graph);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_unusedPassCulled", test_unusedPassCulled);
+    failed += runTest("test_transientChainRuns", test_transientChainRuns);
+    failed += runTest("test_layerCached", test_layerCached);
+    failed += runTest("test_staleLayerPropagates", test_staleLayerPropagates);
+    failed += runTest("test_unreadLayerStaysStale", test_unreadLayerStaysStale);
+    failed += runTest("test_readLimit", test_readLimit);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
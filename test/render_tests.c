@@ -0,0 +1,281 @@
+#include "testing_framework.h"
+#include "../src/image.h"
+#include "../src/pixel.h"
+#include "../src/damage.h"
+#include "../src/particle.h"
+#include "../src/render_target.h"
+#include "../src/window.h"
+#include "../src/timer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Reference scenes rendered through the CPU paths, and through OpenGL when
+// a hidden window can be created. Outputs land in the working directory as
+// render_<scene>.png, timings in render_timings.csv. A scene without a
+// golden image fails, set TG_UPDATE_GOLDENS to write the golden images from
+// the current output.
+
+#define SCENE_SIZE 64
+
+typedef struct SceneImage {
+    uint8_t pixels[SCENE_SIZE * SCENE_SIZE * 4];
+    uint32_t width, height;
+    PixelFormat format;
+} SceneImage;
+
+typedef struct SceneCheck {
+    float threshold;        // difference at which a pixel counts as changed
+    uint32_t maxDiffering;  // changed pixels tolerated, rasterisation noise
+    double budgetMs;        // generous, catches order of magnitude slowdowns
+} SceneCheck;
+
+static const char* goldenDirectory = "golden";
+static FILE* timings;
+static Window* glWindow;    // NULL without a display, GL scenes are skipped
+
+static void splat(SceneImage* image, float x, float y, uint8_t amount) {
+    if (x < 0.0f || y < 0.0f || x >= image->width || y >= image->height)
+        return;
+    uint8_t* pixel = &image->pixels[(uint32_t) y * image->width + (uint32_t) x];
+    *pixel = *pixel > 255 - amount ? 255 : *pixel + amount;
+}
+
+static ParticleSystem* fountain() {
+    ParticleSystem* system = particleSystemNew(PARTICLE_BACKEND_CPU, 1024);
+    ParticleEmitter emitter = {
+        .position = { 32.0f, 4.0f },
+        .velocityMin = { -20.0f, -5.0f },
+        .velocityMax = { 20.0f, 5.0f },
+        .gravity = { 0.0f, 40.0f },
+        .lifetimeMin = 2.0f,
+        .lifetimeMax = 3.0f,
+        .size = 3.0f,
+        .color = { 1.0f, 1.0f, 1.0f, 1.0f }
+    };
+    particleSystemSetEmitter(system, &emitter);
+    particleSystemEmit(system, 600);
+    for (int i = 0; i < 45; i++)
+        particleSystemUpdate(system, 1.0f / 60.0f);
+    return system;
+}
+
+static void sceneMipGradient(SceneImage* image) {
+    static uint8_t source[SCENE_SIZE * SCENE_SIZE * 4];
+    for (uint32_t y = 0; y < SCENE_SIZE; y++) {
+        for (uint32_t x = 0; x < SCENE_SIZE; x++) {
+            uint8_t* pixel = &source[(y * SCENE_SIZE + x) * 4];
+            pixel[0] = (uint8_t) (x * 4);
+            pixel[1] = (uint8_t) (y * 4);
+            pixel[2] = (uint8_t) ((x ^ y) * 4);
+            pixel[3] = 255;
+        }
+    }
+    image->width = image->height = SCENE_SIZE / 2;
+    image->format = PIXEL_FORMAT_RGBA8;
+    pixelDownsample(image->pixels, source, PIXEL_FORMAT_RGBA8, SCENE_SIZE,
+                    SCENE_SIZE);
+}
+
+static void scenePremultipliedChecker(SceneImage* image) {
+    static uint8_t source[32 * 32 * 4];
+    for (uint32_t y = 0; y < 32; y++) {
+        for (uint32_t x = 0; x < 32; x++) {
+            uint8_t* pixel = &source[(y * 32 + x) * 4];
+            uint8_t odd = ((x / 4) ^ (y / 4)) & 1;
+            pixel[0] = odd ? 255 : 0;
+            pixel[1] = odd ? 64 : 128;
+            pixel[2] = odd ? 0 : 255;
+            pixel[3] = (uint8_t) (x * 8);
+        }
+    }
+    image->width = image->height = 32;
+    image->format = PIXEL_FORMAT_RGBA8;
+    pixelConvert(image->pixels, PIXEL_FORMAT_RGBA8, source, PIXEL_FORMAT_RGBA8,
+                 32, 32, 0, 1);
+}
+
+static void sceneParticleSplat(SceneImage* image) {
+    image->width = image->height = SCENE_SIZE;
+    image->format = PIXEL_FORMAT_R8;
+    memset(image->pixels, 0, SCENE_SIZE * SCENE_SIZE);
+
+    ParticleSystem* system = fountain();
+    const float* x;
+    const float* y;
+    uint32_t count = particleSystemGetPositions(system, &x, &y);
+    for (uint32_t i = 0; i < count; i++)
+        splat(image, x[i], y[i], 48);
+    particleSystemDestroy(system);
+}
+
+static void sceneDamageRegions(SceneImage* image) {
+    image->width = image->height = SCENE_SIZE;
+    image->format = PIXEL_FORMAT_R8;
+    memset(image->pixels, 0, SCENE_SIZE * SCENE_SIZE);
+
+    DamageTracker* tracker = damageTrackerNew(SCENE_SIZE, SCENE_SIZE);
+    damageEndFrame(tracker);
+    damageEndFrame(tracker);
+    damageAdd(tracker, rectFromSize((Vec2) { 4, 4 }, (Vec2) { 10, 10 }));
+    damageAdd(tracker, rectFromSize((Vec2) { 8, 8 }, (Vec2) { 10, 10 }));
+    damageAdd(tracker, rectFromSize((Vec2) { 40, 6 }, (Vec2) { 12, 30 }));
+    damageAdd(tracker, rectFromSize((Vec2) { 20, 44 }, (Vec2) { 30, 8 }));
+
+    uint32_t count;
+    const Rect* regions = damageGetRegions(tracker, &count);
+    for (uint32_t i = 0; i < count; i++)
+        for (float y = regions[i].min.y; y < regions[i].max.y; y++)
+            for (float x = regions[i].min.x; x < regions[i].max.x; x++)
+                splat(image, x, y, (uint8_t) (60 + 40 * i));
+    damageTrackerDestroy(tracker);
+}
+
+static void sceneGlComposite(SceneImage* image) {
+    static const float background[4] = { 0.1f, 0.2f, 0.6f, 1.0f };
+    static const float panel[4] = { 0.5f, 0.0f, 0.0f, 0.5f };
+    image->width = image->height = SCENE_SIZE;
+    image->format = PIXEL_FORMAT_RGBA8;
+
+    RenderTarget* target = renderTargetNew(SCENE_SIZE, SCENE_SIZE,
+                                           PIXEL_FORMAT_RGBA8);
+    RenderTarget* layer = renderTargetNew(32, 32, PIXEL_FORMAT_RGBA8);
+    renderTargetClear(layer, panel);
+    renderTargetClear(target, background);
+    renderTargetComposite(layer, (Rect) { { 16, 8 }, { 48, 40 } },
+                          (Vec2) { SCENE_SIZE, SCENE_SIZE });
+    renderTargetReadPixels(target, image->pixels);
+    renderTargetDestroy(layer);
+    renderTargetDestroy(target);
+}
+
+static void sceneGlParticles(SceneImage* image) {
+    static const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    image->width = image->height = SCENE_SIZE;
+    image->format = PIXEL_FORMAT_RGBA8;
+
+    RenderTarget* target = renderTargetNew(SCENE_SIZE, SCENE_SIZE,
+                                           PIXEL_FORMAT_RGBA8);
+    renderTargetClear(target, black);
+    ParticleSystem* system = fountain();
+    particleSystemDraw(system, (Vec2) { SCENE_SIZE, SCENE_SIZE });
+    renderTargetReadPixels(target, image->pixels);
+    particleSystemDestroy(system);
+    renderTargetDestroy(target);
+}
+
+// Render, time, save and compare one scene against its golden image
+static int checkScene(const char* name, void (*render)(SceneImage*),
+                      SceneCheck check) {
+    static SceneImage image;
+    uint64_t start = timerNow();
+    render(&image);
+    double elapsed = timerToMs(timerNow() - start);
+    fprintf(timings, "%s,%.3f\n", name, elapsed);
+
+    char output[256], golden[512];
+    snprintf(output, sizeof(output), "render_%s.png", name);
+    snprintf(golden, sizeof(golden), "%s/%s.png", goldenDirectory, name);
+    ASSERT_EQ(1, (int) imageWritePng(output, image.pixels, image.width,
+                                     image.height, image.format, 0));
+    if (getenv("TG_UPDATE_GOLDENS")) {
+        ASSERT_EQ(1, (int) imageWritePng(golden, image.pixels, image.width,
+                                         image.height, image.format, 0));
+        printf("%s: golden updated\n", name);
+        return 0;
+    }
+
+    uint32_t width, height;
+    PixelFormat format;
+    uint8_t* expected = imageReadPng(golden, &width, &height, &format);
+    if (!expected) {
+        // a scene without a golden would pass whatever it renders
+        printf(RED "[FAIL]" RESET " %s: no golden image at %s, set "
+               "TG_UPDATE_GOLDENS to keep %s as one\n", name, golden, output);
+        return 1;
+    }
+    uint8_t matches = width == image.width && height == image.height &&
+                      format == image.format;
+    ImageDiff diff = { 0 };
+    if (matches)
+        diff = imageCompare(expected, image.pixels, width, height, format,
+                            check.threshold);
+    imageFree(expected);
+    ASSERT_EQ(1, (int) matches);
+
+    printf("%s: %.3f ms, max difference %.3f, %u pixels differ\n", name,
+           elapsed, diff.maxDifference, diff.differingPixels);
+    ASSERT_EQ(1, (int) (diff.differingPixels <= check.maxDiffering));
+    ASSERT_EQ(1, (int) (elapsed <= check.budgetMs));
+    return 0;
+}
+
+int test_mipGradient() {
+    return checkScene("mip_gradient", sceneMipGradient,
+                      (SceneCheck) { 0.01f, 0, 50.0 });
+}
+
+int test_premultipliedChecker() {
+    return checkScene("premultiplied_checker", scenePremultipliedChecker,
+                      (SceneCheck) { 0.01f, 0, 50.0 });
+}
+
+int test_particleSplat() {
+    return checkScene("particle_splat", sceneParticleSplat,
+                      (SceneCheck) { 0.2f, 16, 50.0 });
+}
+
+int test_damageRegions() {
+    return checkScene("damage_regions", sceneDamageRegions,
+                      (SceneCheck) { 0.01f, 0, 50.0 });
+}
+
+int test_glComposite() {
+    if (!glWindow) {
+        printf("gl_composite: no OpenGL context, skipped\n");
+        return 0;
+    }
+    return checkScene("gl_composite", sceneGlComposite,
+                      (SceneCheck) { 0.02f, 0, 500.0 });
+}
+
+int test_glParticles() {
+    if (!glWindow) {
+        printf("gl_particles: no OpenGL context, skipped\n");
+        return 0;
+    }
+    // point rasterisation differs a little between drivers
+    return checkScene("gl_particles", sceneGlParticles,
+                      (SceneCheck) { 0.1f, SCENE_SIZE * SCENE_SIZE / 50,
+                                     500.0 });
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1)
+        goldenDirectory = argv[1];
+    timings = fopen("render_timings.csv", "w");
+    if (!timings)
+        return 1;
+    fprintf(timings, "scene,milliseconds\n");
+    glWindow = windowNewHeadless(SCENE_SIZE, SCENE_SIZE);
+
+    int failed = 0;
+    failed += runTest("test_mipGradient", test_mipGradient);
+    failed += runTest("test_premultipliedChecker", test_premultipliedChecker);
+    failed += runTest("test_particleSplat", test_particleSplat);
+    failed += runTest("test_damageRegions", test_damageRegions);
+    failed += runTest("test_glComposite", test_glComposite);
+    failed += runTest("test_glParticles", test_glParticles);
+
+    if (glWindow)
+        windowDestroy(glWindow);
+    fclose(timings);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,59 @@
+#include <stdio.h>
+
+#include "../src/scene.h"
+#include "../src/timer.h"
+
+#define FRAME_COUNT 100
+
+// Roots of 100 nodes each, a root, 9 groups and 90 leaves
+static void benchmarkScene(uint32_t count, uint32_t movingPercent) {
+    Scene* scene = sceneNew(count);
+    static SceneNode leaves[1000000];
+    uint32_t leafCount = 0;
+    Rect bounds = { { -4.0f, -4.0f }, { 4.0f, 4.0f } };
+    SceneTransform transform = sceneTransformIdentity();
+
+    for (uint32_t r = 0; r < count / 100; r++) {
+        transform.position = (Vec2) { (float) r * 10.0f, 0.0f };
+        SceneNode root = sceneAdd(scene, SCENE_INVALID_NODE, transform,
+                                  bounds);
+        for (uint32_t g = 0; g < 9; g++) {
+            transform.position = (Vec2) { 0.0f, (float) g * 20.0f };
+            SceneNode group = sceneAdd(scene, root, transform, bounds);
+            for (uint32_t l = 0; l < 10; l++) {
+                transform.position = (Vec2) { (float) l, 1.0f };
+                leaves[leafCount++] = sceneAdd(scene, group, transform,
+                                               bounds);
+            }
+        }
+    }
+
+    uint64_t start = timerNow();
+    uint32_t recomputed = sceneUpdate(scene);
+    double fullMs = timerToMs(timerNow() - start);
+
+    uint32_t moving = count * movingPercent / 100;
+    start = timerNow();
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        for (uint32_t i = 0; i < moving; i++) {
+            SceneNode leaf = leaves[(i * 7919u + (uint32_t) frame) % leafCount];
+            transform.position = (Vec2) { (float) frame, (float) i };
+            transform.rotation = (float) frame * 0.01f;
+            sceneSetTransform(scene, leaf, transform);
+        }
+        recomputed = sceneUpdate(scene);
+    }
+    double frameMs = timerToMs(timerNow() - start) / FRAME_COUNT;
+
+    printf("%8u nodes | full %7.3f ms | %3u%% moving %7.3f ms per frame, "
+           "%u recomputed\n", count, fullMs, movingPercent, frameMs,
+           recomputed);
+    sceneDestroy(scene);
+}
+
+int main() {
+    benchmarkScene(100000, 1);
+    benchmarkScene(100000, 10);
+    benchmarkScene(1000000, 1);
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include "testing_framework.h"
+#include "../src/scene.h"
+#include "../src/constants.h"
+
+static const Rect unitBounds = { { -1.0f, -1.0f }, { 1.0f, 1.0f } };
+
+static SceneTransform translation(float x, float y) {
+    SceneTransform transform = sceneTransformIdentity();
+    transform.position = (Vec2) { x, y };
+    return transform;
+}
+
+int test_hierarchy() {
+    Scene* scene = sceneNew(0);
+    SceneTransform rootTransform = {
+        { 10.0f, 0.0f }, 0.5f * PI, { 2.0f, 2.0f }
+    };
+    SceneNode root = sceneAdd(scene, SCENE_INVALID_NODE, rootTransform,
+                              unitBounds);
+    SceneNode child = sceneAdd(scene, root, translation(1.0f, 0.0f),
+                               unitBounds);
+    ASSERT_EQ(2, (int) sceneUpdate(scene));
+
+    // child origin: (1, 0) scaled by 2, rotated 90°, then moved by (10, 0)
+    Vec2 origin = sceneGetWorld(scene, child).origin;
+    ASSERT_FLOAT_EQ(origin.x, 10.0);
+    ASSERT_FLOAT_EQ(origin.y, 2.0);
+    Vec2 corner = sceneMatrixApply(sceneGetWorld(scene, child),
+                                   (Vec2) { 1.0f, 0.0f });
+    ASSERT_FLOAT_EQ(corner.x, 10.0);
+    ASSERT_FLOAT_EQ(corner.y, 4.0);
+
+    Rect bounds = sceneGetWorldBounds(scene, child);
+    ASSERT_EQ(1, (int) (fabsf(bounds.min.x - 8.0f) < 1e-5f));
+    ASSERT_EQ(1, (int) (fabsf(bounds.max.y - 4.0f) < 1e-5f));
+    ASSERT_EQ(root, sceneGetParent(scene, child));
+    ASSERT_EQ(0, (int) sceneUpdate(scene));
+    sceneDestroy(scene);
+    return 0;
+}
+
+// 1000 roots with 99 children each, moving one node recomputes its subtree
+int test_incrementalUpdate() {
+    Scene* scene = sceneNew(100000);
+    SceneNode roots[1000];
+    SceneNode leaves[1000];
+    for (int r = 0; r < 1000; r++) {
+        roots[r] = sceneAdd(scene, SCENE_INVALID_NODE,
+                            translation((float) r, 0.0f), unitBounds);
+        for (int c = 0; c < 99; c++) {
+            SceneNode leaf = sceneAdd(scene, roots[r],
+                                      translation(0.0f, (float) c),
+                                      unitBounds);
+            if (c == 50)
+                leaves[r] = leaf;
+        }
+    }
+    ASSERT_EQ(100000, (int) sceneGetCount(scene));
+    ASSERT_EQ(100000, (int) sceneUpdate(scene));
+
+    // 1% of the nodes move, leaves only
+    for (int r = 0; r < 1000; r++)
+        sceneSetTransform(scene, leaves[r], translation(0.5f, 0.5f));
+    ASSERT_EQ(1000, (int) sceneUpdate(scene));
+    Vec2 origin = sceneGetWorld(scene, leaves[7]).origin;
+    ASSERT_FLOAT_EQ(origin.x, 7.5);
+    ASSERT_FLOAT_EQ(origin.y, 0.5);
+
+    // a moved root takes its subtree along, a moved child inside is covered
+    sceneSetTransform(scene, leaves[3], translation(1.0f, 1.0f));
+    sceneSetTransform(scene, roots[3], translation(100.0f, 0.0f));
+    ASSERT_EQ(100, (int) sceneUpdate(scene));
+    origin = sceneGetWorld(scene, leaves[3]).origin;
+    ASSERT_FLOAT_EQ(origin.x, 101.0);
+    sceneDestroy(scene);
+    return 0;
+}
+
+int test_outOfOrderAndReparent() {
+    Scene* scene = sceneNew(0);
+    SceneNode a = sceneAdd(scene, SCENE_INVALID_NODE, translation(10, 0),
+                           unitBounds);
+    SceneNode b = sceneAdd(scene, SCENE_INVALID_NODE, translation(0, 10),
+                           unitBounds);
+    SceneNode childA = sceneAdd(scene, a, translation(1, 0), unitBounds);
+    sceneUpdate(scene);
+    ASSERT_FLOAT_EQ(sceneGetWorld(scene, childA).origin.x, 11.0);
+
+    // cycles are refused
+    ASSERT_EQ(0, (int) sceneSetParent(scene, a, childA));
+    ASSERT_EQ(0, (int) sceneSetParent(scene, a, a));
+
+    ASSERT_EQ(1, (int) sceneSetParent(scene, a, b));
+    sceneUpdate(scene);
+    Vec2 origin = sceneGetWorld(scene, childA).origin;
+    ASSERT_FLOAT_EQ(origin.x, 11.0);
+    ASSERT_FLOAT_EQ(origin.y, 10.0);
+    ASSERT_EQ(b, sceneGetParent(scene, a));
+
+    // b's subtree is now b, a, childA, moving b touches all three
+    sceneSetTransform(scene, b, translation(0, 20));
+    ASSERT_EQ(3, (int) sceneUpdate(scene));
+    ASSERT_FLOAT_EQ(sceneGetWorld(scene, childA).origin.y, 20.0);
+    sceneDestroy(scene);
+    return 0;
+}
+
+int test_removeAndQuery() {
+    Scene* scene = sceneNew(0);
+    SceneNode group = sceneAdd(scene, SCENE_INVALID_NODE, translation(0, 0),
+                               (Rect) { 0 });
+    SceneNode near = sceneAdd(scene, group, translation(5, 5), unitBounds);
+    SceneNode far = sceneAdd(scene, group, translation(500, 5), unitBounds);
+    SceneNode other = sceneAdd(scene, SCENE_INVALID_NODE, translation(8, 8),
+                               unitBounds);
+    sceneUpdate(scene);
+
+    SceneNode visible[4];
+    Rect view = { { 0, 0 }, { 100, 100 } };
+    ASSERT_EQ(2, (int) sceneQuery(scene, view, visible, 4));
+    ASSERT_EQ(near, visible[0]);
+    ASSERT_EQ(other, visible[1]);
+    ASSERT_EQ(1, (int) sceneQuery(scene, (Rect) { { 490, 0 }, { 510, 10 } },
+                                  visible, 4));
+    ASSERT_EQ(far, visible[0]);
+
+    // pending changes on removed nodes are dropped with them
+    sceneSetTransform(scene, near, translation(6, 6));
+    sceneRemove(scene, group);
+    ASSERT_EQ(1, (int) sceneGetCount(scene));
+    ASSERT_EQ(0, (int) sceneUpdate(scene));
+    ASSERT_EQ(1, (int) sceneQuery(scene, view, visible, 4));
+    ASSERT_EQ(other, visible[0]);
+
+    // handles are reused, the survivor keeps its own
+    SceneNode again = sceneAdd(scene, other, translation(1, 1), unitBounds);
+    ASSERT_EQ(1, (int) (again != other));
+    ASSERT_EQ(1, (int) sceneUpdate(scene));
+    ASSERT_FLOAT_EQ(sceneGetWorld(scene, again).origin.x, 9.0);
+    ASSERT_FLOAT_EQ(sceneGetWorld(scene, other).origin.x, 8.0);
+    sceneDestroy(scene);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_hierarchy", test_hierarchy);
+    failed += runTest("test_incrementalUpdate", test_incrementalUpdate);
+    failed += runTest("test_outOfOrderAndReparent",
+                      test_outOfOrderAndReparent);
+    failed += runTest("test_removeAndQuery", test_removeAndQuery);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
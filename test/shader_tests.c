@@ -0,0 +1,121 @@
+#include "testing_framework.h"
+#include "../src/shader.h"
+#include "../src/window.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static Window* glWindow;    // NULL without a display, GL tests are skipped
+
+static const char* const features[] = {
+    "USE_TEXTURE", "USE_VERTEX_COLOR", "USE_SDF", "PREMULTIPLIED"
+};
+
+static const char* const vertexSource =
+    "#version 330 core\n"
+    "layout (location = 0) in vec2 aPosition;\n"
+    "void main() {\n"
+    "    gl_Position = vec4(aPosition, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* const fragmentSource =
+    "#version 330 core\n"
+    "out vec4 FragColor;\n"
+    "void main() {\n"
+    "    FragColor = vec4(1.0);\n"
+    "#ifdef USE_SDF\n"
+    "    FragColor.a *= 0.5;\n"
+    "#endif\n"
+    "}\n";
+
+int test_specializeAfterVersion() {
+    char buffer[512];
+    uint32_t length = shaderSpecialize(fragmentSource, features, 4, 0x5,
+                                       buffer, sizeof(buffer));
+    const char* expected =
+        "#version 330 core\n"
+        "#define USE_TEXTURE 1\n"
+        "#define USE_SDF 1\n"
+        "out vec4 FragColor;\n";
+    ASSERT_EQ((int) strlen(buffer), (int) length);
+    ASSERT_EQ(0, strncmp(buffer, expected, strlen(expected)));
+    ASSERT_EQ(0, strcmp(buffer + strlen(expected),
+                        fragmentSource + strlen("#version 330 core\n") +
+                        strlen("out vec4 FragColor;\n")));
+
+    // no features, the source comes back as it was
+    length = shaderSpecialize(fragmentSource, features, 4, 0, buffer,
+                              sizeof(buffer));
+    ASSERT_EQ((int) strlen(fragmentSource), (int) length);
+    ASSERT_EQ(0, strcmp(buffer, fragmentSource));
+    return 0;
+}
+
+int test_specializeEdgeCases() {
+    char buffer[64];
+    // without #version the defines go first
+    shaderSpecialize("void main() {}\n", features, 4, 0x8, buffer,
+                     sizeof(buffer));
+    ASSERT_EQ(0, strcmp(buffer, "#define PREMULTIPLIED 1\nvoid main() {}\n"));
+
+    // a #version on the last line gets a line break before the defines
+    shaderSpecialize("#version 330", features, 4, 0x2, buffer,
+                     sizeof(buffer));
+    ASSERT_EQ(0, strcmp(buffer, "#version 330\n#define USE_VERTEX_COLOR 1\n"));
+
+    // too small, only the length is reported
+    memset(buffer, 'x', sizeof(buffer));
+    uint32_t length = shaderSpecialize("#version 330\n", features, 4, 0xF,
+                                       buffer, 16);
+    ASSERT_EQ((int) (strlen("#version 330\n") + 4 * strlen("#define  1\n") +
+                     strlen("USE_TEXTURE") + strlen("USE_VERTEX_COLOR") +
+                     strlen("USE_SDF") + strlen("PREMULTIPLIED")),
+              (int) length);
+    ASSERT_EQ('x', buffer[0]);
+    return 0;
+}
+
+int test_variantsCompileLazily() {
+    ASSERT_EQ(1, shaderVariantsNew(vertexSource, fragmentSource, features,
+                                   SHADER_MAX_FEATURES + 1) == NULL);
+    ShaderVariants* variants = shaderVariantsNew(vertexSource, fragmentSource,
+                                                 features, 4);
+    ASSERT_EQ(1, variants != NULL);
+    ASSERT_EQ(0, (int) shaderVariantsGetCompiledCount(variants));
+    if (!glWindow) {
+        printf("variant compilation: no OpenGL context, skipped\n");
+        shaderVariantsDestroy(variants);
+        return 0;
+    }
+
+    uint32_t plain = shaderVariantsGet(variants, 0);
+    uint32_t sdf = shaderVariantsGet(variants, 0x4);
+    ASSERT_EQ(1, plain != 0 && sdf != 0 && plain != sdf);
+    ASSERT_EQ((int) sdf, (int) shaderVariantsGet(variants, 0x4));
+    ASSERT_EQ(2, (int) shaderVariantsGetCompiledCount(variants));
+    ASSERT_EQ(0, (int) shaderVariantsGet(variants, 0x10));
+    shaderVariantsDestroy(variants);
+    return 0;
+}
+
+int main() {
+    glWindow = windowNewHeadless(64, 64);
+
+    int failed = 0;
+    failed += runTest("test_specializeAfterVersion",
+                      test_specializeAfterVersion);
+    failed += runTest("test_specializeEdgeCases", test_specializeEdgeCases);
+    failed += runTest("test_variantsCompileLazily",
+                      test_variantsCompileLazily);
+
+    if (glWindow)
+        windowDestroy(glWindow);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
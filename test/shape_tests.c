@@ -0,0 +1,158 @@
+#include "testing_framework.h"
+#include "../src/shape.h"
+#include "../src/vector_types.h"
+#include "../src/gpu_memory.h"
+#include "../src/window.h"
+
+#include <stdio.h>
+
+#define SHAPE_COUNT 10000
+
+static const float red[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+static const float shade[4] = { 0.0f, 0.0f, 0.0f, 0.5f };
+
+// Instances are packed, styles survive at their stored precision
+int test_instancePacking() {
+    ASSERT_EQ(40, (int) sizeof(ShapeInstance));
+
+    ShapeBatch* batch = shapeBatchNew(0);
+    Shape shape = shapeRoundedRect((Rect) { { 10, 20 }, { 50, 40 } }, 6.0f,
+                                   red);
+    shape.rotation = 0.75f;
+    shape.borderWidth = 2.0f;
+    shape.border[1] = 2.0f;     // clamped to 1
+    shape.border[3] = 0.5f;
+    for (int i = 0; i < 4; i++)
+        shape.shadow[i] = shade[i];
+    shape.shadowOffset = (Vec2) { 3.4f, -40000.0f };
+    shape.shadowBlur = 8.0f;
+    ASSERT_EQ(1, (int) shapeBatchAdd(batch, &shape));
+
+    uint32_t count = 0;
+    const ShapeInstance* instance = shapeBatchGetInstances(batch, &count);
+    ASSERT_EQ(1, (int) count);
+    ASSERT_FLOAT_EQ(30.0f, instance->center[0]);
+    ASSERT_FLOAT_EQ(30.0f, instance->center[1]);
+    ASSERT_FLOAT_EQ(20.0f, instance->halfSize[0]);
+    ASSERT_FLOAT_EQ(10.0f, instance->halfSize[1]);
+
+    float params[4];
+    vectorUnpackHalf(params, instance->params, 4);
+    ASSERT_EQ(1, (int) (fabsf(params[0] - 0.75f) < 1e-3f));
+    ASSERT_FLOAT_EQ(6.0f, params[1]);
+    ASSERT_FLOAT_EQ(2.0f, params[2]);
+    ASSERT_FLOAT_EQ(8.0f, params[3]);
+
+    ASSERT_EQ(3, (int) instance->shadowOffset[0]);
+    ASSERT_EQ(-32767, (int) instance->shadowOffset[1]);
+    ASSERT_EQ(255, (int) instance->fill[0]);
+    ASSERT_EQ(255, (int) instance->fill[3]);
+    ASSERT_EQ(255, (int) instance->border[1]);
+    ASSERT_EQ(128, (int) instance->border[3]);
+    ASSERT_EQ(128, (int) instance->shadow[3]);
+    shapeBatchDestroy(batch);
+    return 0;
+}
+
+// Every kind of shape reports its exact signed distance
+int test_distance() {
+    Shape rect = shapeRect((Rect) { { 0, 0 }, { 40, 20 } }, red);
+    ASSERT_FLOAT_EQ(-10.0f, shapeDistance(&rect, (Vec2) { 20, 10 }));
+    ASSERT_FLOAT_EQ(5.0f, shapeDistance(&rect, (Vec2) { 45, 10 }));
+    ASSERT_FLOAT_EQ(5.0f, shapeDistance(&rect, (Vec2) { 43, 24 }));
+
+    Shape rounded = shapeRoundedRect((Rect) { { 0, 0 }, { 40, 20 } }, 5.0f,
+                                     red);
+    // the corner is cut by the arc around (5, 5)
+    float expected = sqrtf(50.0f) - 5.0f;
+    ASSERT_EQ(1, (int) (fabsf(shapeDistance(&rounded, (Vec2) { 0, 0 }) -
+                              expected) < 1e-5f));
+    ASSERT_FLOAT_EQ(-1.0f, shapeDistance(&rounded, (Vec2) { 20, 1 }));
+
+    Shape circle = shapeCircle((Vec2) { 100, 100 }, 10.0f, red);
+    ASSERT_FLOAT_EQ(-10.0f, shapeDistance(&circle, (Vec2) { 100, 100 }));
+    ASSERT_FLOAT_EQ(0.0f, shapeDistance(&circle, (Vec2) { 106, 108 }));
+    ASSERT_FLOAT_EQ(10.0f, shapeDistance(&circle, (Vec2) { 112, 116 }));
+
+    // a diagonal line with round caps, 4 pixels thick
+    Shape line = shapeLine((Vec2) { 0, 0 }, (Vec2) { 30, 30 }, 4.0f, red);
+    float perpendicular = shapeDistance(&line, (Vec2) { 10, 20 });
+    ASSERT_EQ(1, (int) (fabsf(perpendicular - (sqrtf(50.0f) - 2.0f)) < 1e-4f));
+    float cap = shapeDistance(&line, (Vec2) { -3, -4 });
+    ASSERT_EQ(1, (int) (fabsf(cap - 3.0f) < 1e-4f));
+    ASSERT_EQ(1, (int) (shapeDistance(&line, (Vec2) { 15, 15 }) < -1.99f));
+    return 0;
+}
+
+// Many shapes go into one batch, clearing keeps the storage
+int test_manyShapes() {
+    ShapeBatch* batch = shapeBatchNew(16);
+    for (uint32_t i = 0; i < SHAPE_COUNT; i++) {
+        Vec2 at = { (float) (i % 100) * 10.0f, (float) (i / 100) * 10.0f };
+        Shape shape = i % 3 == 0 ? shapeCircle(at, 4.0f, red)
+                    : i % 3 == 1 ? shapeLine(at, vec2Add(at, (Vec2) { 8, 3 }),
+                                             1.5f, red)
+                    : shapeRect((Rect) { at, vec2Add(at, (Vec2) { 6, 6 }) },
+                                red);
+        ASSERT_EQ(1, (int) shapeBatchAdd(batch, &shape));
+    }
+
+    uint32_t count = 0;
+    const ShapeInstance* before = shapeBatchGetInstances(batch, &count);
+    ASSERT_EQ(SHAPE_COUNT, (int) count);
+    ASSERT_FLOAT_EQ(4.0f, before[0].halfSize[0]);
+
+    shapeBatchClear(batch);
+    shapeBatchGetInstances(batch, &count);
+    ASSERT_EQ(0, (int) count);
+    Shape shape = shapeCircle((Vec2) { 1, 1 }, 1.0f, red);
+    ASSERT_EQ(1, (int) shapeBatchAdd(batch, &shape));
+    const ShapeInstance* after = shapeBatchGetInstances(batch, &count);
+    ASSERT_EQ(1, (int) count);
+    ASSERT_EQ(1, (int) (before == after));
+
+    shapeBatchDestroy(batch);
+    return 0;
+}
+
+// Only the buffers a draw grew are accounted, and freed with the batch
+int test_drawAccountsBuffers() {
+    Window* window = windowNewHeadless(64, 64);
+    if (!window) {
+        printf("buffer accounting: no OpenGL context, skipped\n");
+        return 0;
+    }
+    GpuMemoryStats before = gpuMemoryGetStats();
+    ShapeBatch* batch = shapeBatchNew(16);
+    Shape shape = shapeCircle((Vec2) { 32, 32 }, 8.0f, red);
+    ASSERT_EQ(1, (int) shapeBatchAdd(batch, &shape));
+    shapeBatchDraw(batch, (Vec2) { 64, 64 });
+    GpuMemoryStats drawn = gpuMemoryGetStats();
+    ASSERT_EQ(1, (int) (drawn.counts[GPU_MEMORY_BUFFER] -
+                        before.counts[GPU_MEMORY_BUFFER]));
+
+    shapeBatchDestroy(batch);
+    GpuMemoryStats after = gpuMemoryGetStats();
+    ASSERT_EQ((int) before.counts[GPU_MEMORY_BUFFER],
+              (int) after.counts[GPU_MEMORY_BUFFER]);
+    ASSERT_EQ(1, (int) (after.bytes[GPU_MEMORY_BUFFER] ==
+                        before.bytes[GPU_MEMORY_BUFFER]));
+    windowDestroy(window);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_instancePacking", test_instancePacking);
+    failed += runTest("test_distance", test_distance);
+    failed += runTest("test_manyShapes", test_manyShapes);
+    failed += runTest("test_drawAccountsBuffers", test_drawAccountsBuffers);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <math.h>
+
+#include "../src/spatial.h"
+#include "../src/timer.h"
+
+#define VIEW_WIDTH 1280.0f
+#define VIEW_HEIGHT 720.0f
+#define QUERY_COUNT 1000
+#define PICK_COUNT 100000
+
+static uint32_t rngState = 0x9E3779B9u;
+
+// xorshift, deterministic so runs are comparable
+static float randomFloat(float min, float max) {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return min + (max - min) * (float) (rngState & 0xFFFFFF) / 16777216.0f;
+}
+
+static SpatialHandle results[1 << 16];
+
+static void benchmarkGrid(uint32_t count) {
+    // keep density constant, so a view sees the same number of objects
+    float world = sqrtf((float) count) * 40.0f;
+    SpatialGrid* grid = spatialGridNew(64.0f, count);
+    SpatialHandle* handles = TG_MALLOC(sizeof(SpatialHandle) * count);
+
+    uint64_t start = timerNow();
+    for (uint32_t i = 0; i < count; i++) {
+        Vec2 pos = { randomFloat(0, world), randomFloat(0, world) };
+        Vec2 size = { randomFloat(8, 32), randomFloat(8, 32) };
+        handles[i] = spatialGridInsert(grid, rectFromSize(pos, size), NULL);
+    }
+    double insertMs = timerToMs(timerNow() - start);
+
+    // one frame worth of movement, 1% of the objects
+    uint32_t moving = count / 100;
+    start = timerNow();
+    for (uint32_t i = 0; i < moving; i++) {
+        SpatialHandle h = handles[(i * 97u) % count];
+        Rect bounds = spatialGridGetBounds(grid, h);
+        Vec2 step = { randomFloat(-4, 4), randomFloat(-4, 4) };
+        bounds.min = vec2Add(bounds.min, step);
+        bounds.max = vec2Add(bounds.max, step);
+        spatialGridMove(grid, h, bounds);
+    }
+    double moveMs = timerToMs(timerNow() - start);
+
+    uint64_t visible = 0;
+    start = timerNow();
+    for (uint32_t i = 0; i < QUERY_COUNT; i++) {
+        Vec2 origin = { randomFloat(0, world - VIEW_WIDTH),
+                        randomFloat(0, world - VIEW_HEIGHT) };
+        Rect view = rectFromSize(origin, (Vec2) { VIEW_WIDTH, VIEW_HEIGHT });
+        visible += spatialGridQueryRect(grid, view, results,
+                                        ARRAY_SIZE(results));
+    }
+    double queryMs = timerToMs(timerNow() - start);
+
+    uint64_t hits = 0;
+    start = timerNow();
+    for (uint32_t i = 0; i < PICK_COUNT; i++) {
+        Vec2 point = { randomFloat(0, world), randomFloat(0, world) };
+        hits += spatialGridQueryPoint(grid, point, results,
+                                      ARRAY_SIZE(results));
+    }
+    double pickMs = timerToMs(timerNow() - start);
+
+    printf("%8u objects | insert %8.2f ms | move 1%% %6.3f ms | "
+           "view query %7.2f us (%llu visible) | pick %6.3f us (%llu hits)\n",
+           count, insertMs, moveMs, queryMs * 1000.0 / QUERY_COUNT,
+           (unsigned long long) (visible / QUERY_COUNT),
+           pickMs * 1000.0 / PICK_COUNT, (unsigned long long) hits);
+
+    TG_FREE(handles);
+    spatialGridDestroy(grid);
+}
+
+int main() {
+    benchmarkGrid(10000);
+    benchmarkGrid(100000);
+    benchmarkGrid(1000000);
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "testing_framework.h"
+#include "../src/spatial.h"
+
+static Rect box(float x, float y, float w, float h) {
+    return rectFromSize((Vec2) { x, y }, (Vec2) { w, h });
+}
+
+int test_insertQuery() {
+    SpatialGrid* grid = spatialGridNew(32.0f, 16);
+    SpatialHandle a = spatialGridInsert(grid, box(0, 0, 10, 10), NULL);
+    SpatialHandle b = spatialGridInsert(grid, box(100, 100, 10, 10), NULL);
+    SpatialHandle out[4];
+    uint32_t found = spatialGridQueryRect(grid, box(-5, -5, 20, 20), out, 4);
+    ASSERT_EQ(1, (int) found);
+    ASSERT_EQ((int) a, (int) out[0]);
+    found = spatialGridQueryRect(grid, box(90, 90, 50, 50), out, 4);
+    ASSERT_EQ(1, (int) found);
+    ASSERT_EQ((int) b, (int) out[0]);
+    ASSERT_EQ(2, (int) spatialGridGetCount(grid));
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int test_multiCellReportedOnce() {
+    SpatialGrid* grid = spatialGridNew(8.0f, 16);
+    spatialGridInsert(grid, box(0, 0, 40, 40), NULL);
+    SpatialHandle out[4];
+    uint32_t found = spatialGridQueryRect(grid, box(0, 0, 40, 40), out, 4);
+    ASSERT_EQ(1, (int) found);
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int test_move() {
+    SpatialGrid* grid = spatialGridNew(16.0f, 16);
+    SpatialHandle a = spatialGridInsert(grid, box(0, 0, 4, 4), NULL);
+    spatialGridMove(grid, a, box(500, 500, 4, 4));
+    SpatialHandle out[4];
+    ASSERT_EQ(0, (int) spatialGridQueryRect(grid, box(0, 0, 8, 8), out, 4));
+    ASSERT_EQ(1, (int) spatialGridQueryRect(grid, box(498, 498, 8, 8),
+                                            out, 4));
+    Rect bounds = spatialGridGetBounds(grid, a);
+    ASSERT_FLOAT_EQ(500.0, bounds.min.x);
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int test_removeAndReuse() {
+    SpatialGrid* grid = spatialGridNew(16.0f, 16);
+    int tag = 7;
+    SpatialHandle a = spatialGridInsert(grid, box(0, 0, 4, 4), NULL);
+    spatialGridRemove(grid, a);
+    SpatialHandle out[4];
+    ASSERT_EQ(0, (int) spatialGridQueryPoint(grid, (Vec2) { 1, 1 }, out, 4));
+    SpatialHandle b = spatialGridInsert(grid, box(0, 0, 4, 4), &tag);
+    ASSERT_EQ((int) a, (int) b);
+    ASSERT_EQ(1, (int) (spatialGridGetUserData(grid, b) == &tag));
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int test_pointPick() {
+    SpatialGrid* grid = spatialGridNew(16.0f, 16);
+    spatialGridInsert(grid, box(0, 0, 10, 10), NULL);
+    SpatialHandle top = spatialGridInsert(grid, box(5, 5, 10, 10), NULL);
+    SpatialHandle out[4];
+    ASSERT_EQ(2, (int) spatialGridQueryPoint(grid, (Vec2) { 7, 7 }, out, 4));
+    ASSERT_EQ(1, (int) spatialGridQueryPoint(grid, (Vec2) { 14, 14 },
+                                             out, 4));
+    ASSERT_EQ((int) top, (int) out[0]);
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int test_oversized() {
+    SpatialGrid* grid = spatialGridNew(1.0f, 16);
+    spatialGridInsert(grid, box(-1000, -1000, 2000, 2000), NULL);
+    SpatialHandle out[4];
+    ASSERT_EQ(1, (int) spatialGridQueryPoint(grid, (Vec2) { 3, 3 }, out, 4));
+    ASSERT_EQ(1, (int) spatialGridQueryRect(grid, box(2, 2, 1, 1), out, 4));
+
+    // far beyond the int32 cell range, cells are clamped instead of wrapping
+    spatialGridInsert(grid, box(-1e30f, -1e30f, 2e30f, 2e30f), NULL);
+    ASSERT_EQ(2, (int) spatialGridQueryPoint(grid, (Vec2) { 3, 3 }, out, 4));
+    ASSERT_EQ(2, (int) spatialGridQueryRect(grid, box(-1e20f, -1e20f, 1e20f,
+                                                      1e20f), out, 4));
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int test_capacityTruncation() {
+    SpatialGrid* grid = spatialGridNew(16.0f, 256);
+    for (int i = 0; i < 100; i++)
+        spatialGridInsert(grid, box((float) i, 0, 1, 1), NULL);
+    SpatialHandle out[10];
+    ASSERT_EQ(100, (int) spatialGridQueryRect(grid, box(0, 0, 200, 2),
+                                              out, 10));
+    ASSERT_EQ(100, (int) spatialGridQueryRect(grid, box(0, 0, 200, 2),
+                                              NULL, 0));
+    spatialGridDestroy(grid);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_insertQuery", test_insertQuery);
+    failed += runTest("test_multiCellReportedOnce", test_multiCellReportedOnce);
+    failed += runTest("test_move", test_move);
+    failed += runTest("test_removeAndReuse", test_removeAndReuse);
+    failed += runTest("test_pointPick", test_pointPick);
+    failed += runTest("test_oversized", test_oversized);
+    failed += runTest("test_capacityTruncation", test_capacityTruncation);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
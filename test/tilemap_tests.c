@@ -0,0 +1,130 @@
+#include "testing_framework.h"
+#include "../src/tilemap.h"
+#include "../src/window.h"
+
+#define MAP_SIZE 100
+#define TILE_SIZE 16.0f
+
+static Window* glWindow;    // NULL without a display, GL tests are skipped
+
+static Tilemap* newFilledMap(Texture* atlas) {
+    static uint16_t tiles[MAP_SIZE * MAP_SIZE];
+    for (uint32_t i = 0; i < MAP_SIZE * MAP_SIZE; i++)
+        tiles[i] = (uint16_t) (1 + i % 4);
+    Tilemap* tilemap = tilemapNew(MAP_SIZE, MAP_SIZE, TILE_SIZE, atlas, 2, 2);
+    tilemapSetRegion(tilemap, 0, 0, MAP_SIZE, MAP_SIZE, tiles);
+    return tilemap;
+}
+
+// Tiles read back through the chunked layout, edits stay inside the map
+int test_setAndGet() {
+    Tilemap* tilemap = tilemapNew(MAP_SIZE, MAP_SIZE, TILE_SIZE, NULL, 2, 2);
+    ASSERT_EQ(1, (int) tilemapSetTile(tilemap, 33, 65, 3));
+    ASSERT_EQ(1, (int) tilemapSetTile(tilemap, 99, 99, 4));
+    ASSERT_EQ(0, (int) tilemapSetTile(tilemap, 100, 0, 1));
+    ASSERT_EQ(3, (int) tilemapGetTile(tilemap, 33, 65));
+    ASSERT_EQ(4, (int) tilemapGetTile(tilemap, 99, 99));
+    ASSERT_EQ(TILEMAP_EMPTY, (int) tilemapGetTile(tilemap, 32, 65));
+    ASSERT_EQ(TILEMAP_EMPTY, (int) tilemapGetTile(tilemap, 0, 100));
+
+    uint16_t block[6] = { 1, 2, 3, 4, 5, 6 };
+    ASSERT_EQ(0, (int) tilemapSetRegion(tilemap, 98, 0, 3, 2, block));
+    ASSERT_EQ(TILEMAP_EMPTY, (int) tilemapGetTile(tilemap, 98, 0));
+    ASSERT_EQ(1, (int) tilemapSetRegion(tilemap, 30, 10, 3, 2, block));
+    ASSERT_EQ(3, (int) tilemapGetTile(tilemap, 32, 10));
+    ASSERT_EQ(4, (int) tilemapGetTile(tilemap, 30, 11));
+    ASSERT_EQ(6, (int) tilemapGetTile(tilemap, 32, 11));
+    tilemapDestroy(tilemap);
+    return 0;
+}
+
+// Only chunks overlapping the view and holding tiles are drawn
+int test_viewportCulling() {
+    Tilemap* tilemap = tilemapNew(MAP_SIZE, MAP_SIZE, TILE_SIZE, NULL, 2, 2);
+    uint32_t chunks[16];
+    Rect all = { { 0, 0 }, { MAP_SIZE * TILE_SIZE, MAP_SIZE * TILE_SIZE } };
+    ASSERT_EQ(0, (int) tilemapCollectVisible(tilemap, all, chunks, 16));
+
+    tilemapDestroy(tilemap);
+    tilemap = newFilledMap(NULL);
+    ASSERT_EQ(16, (int) tilemapCollectVisible(tilemap, all, chunks, 16));
+
+    // chunks are 512 pixels wide, the view spans columns 1 and 2 of row 0
+    Rect view = { { 600, 100 }, { 1100, 400 } };
+    ASSERT_EQ(2, (int) tilemapCollectVisible(tilemap, view, chunks, 16));
+    ASSERT_EQ(1, (int) chunks[0]);
+    ASSERT_EQ(2, (int) chunks[1]);
+
+    // touching the right edge of a chunk does not pull in the next one
+    Rect edge = { { 0, 0 }, { 512, 512 } };
+    ASSERT_EQ(1, (int) tilemapCollectVisible(tilemap, edge, chunks, 16));
+
+    Rect outside = { { -900, -900 }, { -10, -10 } };
+    ASSERT_EQ(0, (int) tilemapCollectVisible(tilemap, outside, chunks, 16));
+    Rect beyond = { { 1500, 0 }, { 4000, 4000 } };
+    ASSERT_EQ(8, (int) tilemapCollectVisible(tilemap, beyond, chunks, 16));
+    tilemapDestroy(tilemap);
+    return 0;
+}
+
+// Buffers are built once, edits within a frame become one update per chunk
+int test_chunkUploads() {
+    if (!glWindow) {
+        printf("chunk uploads: no OpenGL context, skipped\n");
+        return 0;
+    }
+    Texture* atlas = textureNew(32, 32, PIXEL_FORMAT_RGBA8, TEXTURE_NEAREST);
+    Tilemap* tilemap = newFilledMap(atlas);
+    uint32_t first, count;
+    ASSERT_EQ(1, (int) tilemapGetPendingUpload(tilemap, 0, &first, &count));
+    ASSERT_EQ(TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE, (int) count);
+
+    Rect view = { { 0, 0 }, { 1000, 600 } };
+    Vec2 size = { 1000, 600 };
+    tilemapDraw(tilemap, view, size);
+    TilemapStats stats = tilemapGetStats(tilemap);
+    ASSERT_EQ(4, (int) stats.chunksDrawn);
+    ASSERT_EQ(4, (int) stats.chunksBuilt);
+    ASSERT_EQ(0, (int) tilemapGetPendingUpload(tilemap, 0, &first, &count));
+
+    tilemapDraw(tilemap, view, size);
+    stats = tilemapGetStats(tilemap);
+    ASSERT_EQ(0, (int) (stats.chunksBuilt + stats.chunksUpdated));
+    ASSERT_EQ(0, (int) stats.uploadBytes);
+
+    // three edits in chunk 0 merge into tiles 34 to 100
+    tilemapSetTile(tilemap, 2, 1, 4);
+    tilemapSetTile(tilemap, 4, 3, 4);
+    tilemapSetTile(tilemap, 3, 2, 4);
+    ASSERT_EQ(1, (int) tilemapGetPendingUpload(tilemap, 0, &first, &count));
+    ASSERT_EQ(34, (int) first);
+    ASSERT_EQ(67, (int) count);
+    tilemapDraw(tilemap, view, size);
+    stats = tilemapGetStats(tilemap);
+    ASSERT_EQ(1, (int) stats.chunksUpdated);
+    ASSERT_EQ(67 * 2, (int) stats.uploadBytes);
+
+    tilemapDestroy(tilemap);
+    textureDestroy(atlas);
+    return 0;
+}
+
+int main() {
+    glWindow = windowNewHeadless(64, 64);
+
+    int failed = 0;
+    failed += runTest("test_setAndGet", test_setAndGet);
+    failed += runTest("test_viewportCulling", test_viewportCulling);
+    failed += runTest("test_chunkUploads", test_chunkUploads);
+
+    if (glWindow)
+        windowDestroy(glWindow);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,70 @@
+// exercise the macros too, whatever the library was built with
+#define TG_TRACE
+
+#include "testing_framework.h"
+#include "../src/trace.h"
+
+#include <string.h>
+
+static void tracedFunction() {
+    TRACE_FUNCTION();
+}
+
+int test_recordsScopes() {
+    traceClear();
+    {
+        TRACE_SCOPE("outer");
+        tracedFunction();
+    }
+    ASSERT_EQ(2, (int) traceGetEventCount());
+    return 0;
+}
+
+int test_ringOverwritesOldest() {
+    traceClear();
+    for (int i = 0; i < TRACE_BUFFER_EVENTS + 100; i++)
+        traceEnd("spin", traceBegin());
+    ASSERT_EQ(TRACE_BUFFER_EVENTS, (int) traceGetEventCount());
+    traceClear();
+    ASSERT_EQ(0, (int) traceGetEventCount());
+    return 0;
+}
+
+int test_exportChromeJson() {
+    traceClear();
+    traceEnd("quoted \"name\"", traceBegin());
+    {
+        TRACE_SCOPE("frame");
+    }
+    const char* path = "trace_tests.json";
+    ASSERT_EQ(1, (int) traceExport(path));
+
+    char text[1024] = { 0 };
+    FILE* file = fopen(path, "r");
+    ASSERT_EQ(1, file != NULL);
+    size_t length = fread(text, 1, sizeof(text) - 1, file);
+    fclose(file);
+    remove(path);
+
+    ASSERT_EQ(1, length > 0);
+    ASSERT_EQ(1, strstr(text, "\"traceEvents\":[") != NULL);
+    ASSERT_EQ(1, strstr(text, "\"name\":\"frame\",\"ph\":\"X\"") != NULL);
+    ASSERT_EQ(1, strstr(text, "quoted \\\"name\\\"") != NULL);
+    ASSERT_EQ(1, strstr(text, "]}") != NULL);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_recordsScopes", test_recordsScopes);
+    failed += runTest("test_ringOverwritesOldest", test_ringOverwritesOldest);
+    failed += runTest("test_exportChromeJson", test_exportChromeJson);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
@@ -0,0 +1,45 @@
+#include <stdio.h>
+
+#include "../src/vector.h"
+#include "../src/timer.h"
+
+// Built twice by meson: once calling the library, once with
+// TG_VECTOR_INLINE so the same loop compiles the functions in
+
+#define VECTOR_COUNT 100000
+#define PASS_COUNT 100
+
+static Vec2 positions[VECTOR_COUNT];
+static Vec2 targets[VECTOR_COUNT];
+
+int main() {
+    for (uint32_t i = 0; i < VECTOR_COUNT; i++) {
+        positions[i] = (Vec2) { (float) (i % 317), (float) (i % 211) };
+        targets[i] = (Vec2) { (float) (i % 97) + 0.5f, (float) (i % 89) };
+    }
+
+    // steering style loop, six vector calls per element
+    Vec2 heading = { 0.6f, 0.8f };
+    float alignment = 0.0f;
+    uint64_t start = timerNow();
+    for (int pass = 0; pass < PASS_COUNT; pass++) {
+        for (uint32_t i = 0; i < VECTOR_COUNT; i++) {
+            Vec2 offset = vec2Sub(targets[i], positions[i]);
+            Vec2 direction = vec2Normalize(offset);
+            alignment += vec2Dot(direction, heading);
+            positions[i] = vec2Add(positions[i], vec2Scale(direction, 0.01f));
+            alignment += vec2Cross(direction, heading) * 0.001f;
+        }
+    }
+    double ms = timerToMs(timerNow() - start);
+    double calls = 6.0 * VECTOR_COUNT * PASS_COUNT;
+
+#ifdef TG_VECTOR_INLINE
+    const char* mode = "inline";
+#else
+    const char* mode = "library call";
+#endif
+    printf("%-12s | %8.3f ms | %6.3f ns per vector call | checksum %.1f\n",
+           mode, ms, ms * 1e6 / calls, alignment);
+    return 0;
+}
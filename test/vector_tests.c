@@ -158,6 +158,88 @@ int test_normalizeInPlace() {
     return 0;
 }
 
+// Largest errors against double precision, over dense sweeps
+int test_fastRsqrt() {
+    double worst = 0.0, worstPortable = 0.0;
+    for (float x = 1e-6f; x < 1e6f; x *= 1.0007f) {
+        double exact = 1.0 / sqrt((double) x);
+        double error = fabs(mathFastRsqrt(x) - exact) / exact;
+        worst = error > worst ? error : worst;
+        // checked directly, on x86 mathFastRsqrt never reaches it
+        error = fabs(mathFastRsqrtPortable(x) - exact) / exact;
+        worstPortable = error > worstPortable ? error : worstPortable;
+    }
+    ASSERT_EQ(1, (int) (worst <= FAST_RSQRT_MAX_ERROR));
+    ASSERT_EQ(1, (int) (worstPortable <= FAST_RSQRT_PORTABLE_MAX_ERROR));
+
+    Vec2 v = vec2FastNormalize((Vec2) { 3.0f, 4.0f });
+    ASSERT_EQ(1, (int) (fabsf(vec2Length(v) - 1.0f) <= FAST_RSQRT_MAX_ERROR));
+    ASSERT_EQ(1, (int) (fabsf(vec2FastLength((Vec2) { 3.0f, 4.0f }) - 5.0f) <=
+                        5.0f * FAST_RSQRT_MAX_ERROR));
+    Vec2 zero = vec2FastNormalize(vec2GetZero());
+    ASSERT_FLOAT_EQ(zero.x, 0.0);
+    ASSERT_FLOAT_EQ(zero.y, 0.0);
+    return 0;
+}
+
+int test_fastAtan2() {
+    double worst = 0.0;
+    for (int i = 0; i < 100000; i++) {
+        double angle = -PI + i * (2.0 * PI / 100000);
+        float radius = 0.001f + (i % 97) * 10.0f;
+        float x = (float) (cos(angle) * radius);
+        float y = (float) (sin(angle) * radius);
+        double error = fabs(mathFastAtan2(y, x) - atan2((double) y, x));
+        worst = error > worst ? error : worst;
+    }
+    ASSERT_EQ(1, (int) (worst <= FAST_ATAN2_MAX_ERROR));
+    ASSERT_FLOAT_EQ(mathFastAtan2(0.0f, 0.0f), 0.0);
+    ASSERT_EQ(1, (int) (fabsf(vec2FastAngle((Vec2) { 0.0f, -1.0f }) -
+                              1.5f * PI) <= FAST_ATAN2_MAX_ERROR));
+    return 0;
+}
+
+int test_fastSinCos() {
+    double worst = 0.0;
+    for (float x = -1000.0f; x <= 1000.0f; x += 0.0137f) {
+        double sinError = fabs(mathFastSin(x) - sin((double) x));
+        double cosError = fabs(mathFastCos(x) - cos((double) x));
+        worst = sinError > worst ? sinError : worst;
+        worst = cosError > worst ? cosError : worst;
+    }
+    ASSERT_EQ(1, (int) (worst <= FAST_SINCOS_MAX_ERROR));
+    return 0;
+}
+
+int test_fastBatch() {
+    Vec2 vectors[11];
+    float angles[11], sines[11], cosines[11], batchAngles[11];
+    for (int i = 0; i < 11; i++) {
+        vectors[i] = (Vec2) { (float) (i - 5) * 3.0f, (float) (i * i) - 7.0f };
+        angles[i] = (float) i * 0.7f - 3.0f;
+    }
+    vectors[4] = vec2GetZero();
+
+    Vec2 normals[11];
+    vec2FastNormalizeBatch(normals, vectors, 11);
+    vec2FastAngleBatch(batchAngles, vectors, 11);
+    mathFastSinCosBatch(sines, cosines, angles, 11);
+    for (int i = 0; i < 11; i++) {
+        Vec2 single = vec2FastNormalize(vectors[i]);
+        ASSERT_FLOAT_EQ(normals[i].x, single.x);
+        ASSERT_FLOAT_EQ(normals[i].y, single.y);
+        ASSERT_FLOAT_EQ(batchAngles[i], vec2FastAngle(vectors[i]));
+        ASSERT_FLOAT_EQ(sines[i], mathFastSin(angles[i]));
+        ASSERT_FLOAT_EQ(cosines[i], mathFastCos(angles[i]));
+    }
+
+    // in place
+    vec2FastNormalizeBatch(vectors, vectors, 11);
+    ASSERT_FLOAT_EQ(vectors[0].x, normals[0].x);
+    ASSERT_FLOAT_EQ(vectors[10].y, normals[10].y);
+    return 0;
+}
+
 int main() {
     int failed = 0;
     failed += runTest("test_zero", test_zero);
@@ -179,6 +261,10 @@ int main() {
     failed += runTest("test_angle", test_angle);
     failed += runTest("test_normalize_in_place", test_normalizeInPlace);
     failed += runTest("test_distanceFromPoint", test_distanceFromPoint);
+    failed += runTest("test_fastRsqrt", test_fastRsqrt);
+    failed += runTest("test_fastAtan2", test_fastAtan2);
+    failed += runTest("test_fastSinCos", test_fastSinCos);
+    failed += runTest("test_fastBatch", test_fastBatch);
 
     printf("\n");
     if (failed == 0)
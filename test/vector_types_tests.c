@@ -0,0 +1,126 @@
+#include "testing_framework.h"
+#include "../src/vector_types.h"
+
+#include <string.h>
+
+int test_vec3() {
+    Vec3 a = { 1.0f, 2.0f, 3.0f };
+    Vec3 b = { 4.0f, 5.0f, 6.0f };
+    Vec3 sum = vec3Add(a, b);
+    ASSERT_FLOAT_EQ(sum.z, 9.0);
+    ASSERT_FLOAT_EQ(vec3Dot(a, b), 32.0);
+    Vec3 cross = vec3Cross((Vec3) { 1, 0, 0 }, (Vec3) { 0, 1, 0 });
+    ASSERT_EQ(1, (int) vec3Equal(cross, (Vec3) { 0, 0, 1 }));
+    Vec3 normal = vec3Normalize((Vec3) { 0.0f, 3.0f, 4.0f });
+    ASSERT_FLOAT_EQ(normal.y, 0.6);
+    ASSERT_FLOAT_EQ(normal.z, 0.8);
+    ASSERT_EQ(1, (int) vec3Equal(vec3Normalize(vec3GetZero()),
+                                 vec3GetZero()));
+    return 0;
+}
+
+int test_vec4() {
+    Vec4 a = { 0.0f, 0.5f, 1.0f, 2.0f };
+    Vec4 b = { 1.0f, 1.5f, 3.0f, 2.0f };
+    Vec4 mid = vec4Lerp(a, b, 0.5f);
+    ASSERT_FLOAT_EQ(mid.x, 0.5);
+    ASSERT_FLOAT_EQ(mid.z, 2.0);
+    Vec4 clamped = vec4Clamp(b, 0.0f, 1.0f);
+    ASSERT_FLOAT_EQ(clamped.y, 1.0);
+    ASSERT_FLOAT_EQ(vec4Length((Vec4) { 1, 1, 1, 1 }), 2.0);
+    Vec4 low = vec4Min(a, b);
+    ASSERT_FLOAT_EQ(low.w, 2.0);
+    return 0;
+}
+
+int test_integerVectors() {
+    IVec2 a = { -3, 7 };
+    IVec2 b = ivec2Scale(a, 2);
+    ASSERT_EQ(-6, b.x);
+    ASSERT_EQ(14, b.y);
+    ASSERT_EQ(1, (int) (ivec2Dot(a, a) == 58));
+
+    // dot products accumulate wide, no overflow
+    IVec3 big = { 100000, 100000, 100000 };
+    ASSERT_EQ(1, (int) (ivec3Dot(big, big) == 30000000000LL));
+
+    U16Vec4 c = { 65535, 1, 2, 3 };
+    U16Vec4 d = u16vec4Add(c, (U16Vec4) { 1, 1, 1, 1 });
+    ASSERT_EQ(0, d.x);     // wraps like uint16_t
+    ASSERT_EQ(2, d.y);
+    ASSERT_EQ(1, (int) (u16vec2Max((U16Vec2) { 3, 9 },
+                                   (U16Vec2) { 5, 1 }).x == 5));
+    ASSERT_EQ(8, (int) sizeof(U16Vec4));
+    return 0;
+}
+
+int test_packNormalized() {
+    float in[6] = { -2.0f, -1.0f, -0.5f, 0.0f, 0.5f, 1.0f };
+    int16_t snorm[6];
+    uint16_t unorm[6];
+    float back[6];
+    vectorPackSnorm16(snorm, in, 6);
+    vectorPackUnorm16(unorm, in, 6);
+    ASSERT_EQ(-32767, snorm[0]);
+    ASSERT_EQ(-32767, snorm[1]);
+    ASSERT_EQ(-16384, snorm[2]);
+    ASSERT_EQ(0, snorm[3]);
+    ASSERT_EQ(32767, snorm[5]);
+    ASSERT_EQ(0, unorm[2]);
+    ASSERT_EQ(32768, unorm[4]);
+    ASSERT_EQ(65535, unorm[5]);
+
+    vectorUnpackSnorm16(back, snorm, 6);
+    for (int i = 1; i < 6; i++)
+        ASSERT_EQ(1, (int) (fabsf(back[i] - in[i]) <= 0.5f / 32767.0f));
+
+    int16_t lowest = -32768;
+    vectorUnpackSnorm16(back, &lowest, 1);
+    ASSERT_FLOAT_EQ(back[0], -1.0);
+    return 0;
+}
+
+int test_packHalf() {
+    float in[10] = { 0.0f, 1.0f, -2.0f, 65504.0f, 1e6f, 5.9604645e-8f,
+                     6.1035156e-5f, 0.1f, 1.0f + 1.0f / 2048.0f,
+                     2.9802322e-8f };
+    uint16_t expected[10] = { 0x0000, 0x3c00, 0xc000, 0x7bff, 0x7c00, 0x0001,
+                              0x0400, 0x2e66, 0x3c00, 0x0000 };
+    uint16_t half[10];
+    vectorPackHalf(half, in, 10);
+    for (int i = 0; i < 10; i++)
+        ASSERT_EQ(expected[i], half[i]);
+
+    float nan = NAN;
+    vectorPackHalf(half, &nan, 1);
+    ASSERT_EQ(1, (int) ((half[0] & 0x7c00) == 0x7c00 && (half[0] & 0x3ff)));
+
+    // every finite half survives the round trip exactly
+    for (uint32_t bits = 0; bits < 0x10000; bits++) {
+        if ((bits & 0x7c00) == 0x7c00)
+            continue;
+        uint16_t source = (uint16_t) bits, result;
+        float value;
+        vectorUnpackHalf(&value, &source, 1);
+        vectorPackHalf(&result, &value, 1);
+        ASSERT_EQ(source, result);
+    }
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_vec3", test_vec3);
+    failed += runTest("test_vec4", test_vec4);
+    failed += runTest("test_integerVectors", test_integerVectors);
+    failed += runTest("test_packNormalized", test_packNormalized);
+    failed += runTest("test_packHalf", test_packHalf);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}
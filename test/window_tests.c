@@ -0,0 +1,106 @@
+#include "testing_framework.h"
+#include "../src/window.h"
+#include "../src/window_internal.h"
+
+#include <stdio.h>
+
+// Capped frames start one interval apart, on the slot they were given
+int test_frameSlotsAdvance() {
+    uint64_t next = 1000;
+    ASSERT_EQ(1000, (int) internal_windowNextFrameSlot(&next, 400, 100));
+    ASSERT_EQ(1100, (int) next);
+    ASSERT_EQ(1100, (int) internal_windowNextFrameSlot(&next, 1050, 100));
+    ASSERT_EQ(1200, (int) next);
+    return 0;
+}
+
+// A late frame doesn't sleep, and the slots restart from it instead of
+// rushing through the missed ones
+int test_frameSlotsFallBehind() {
+    uint64_t next = 1000;
+    ASSERT_EQ(0, (int) internal_windowNextFrameSlot(&next, 1350, 100));
+    ASSERT_EQ(1450, (int) next);
+    ASSERT_EQ(1450, (int) internal_windowNextFrameSlot(&next, 1400, 100));
+    ASSERT_EQ(1550, (int) next);
+
+    // exactly on time is not early, there is nothing to sleep for
+    ASSERT_EQ(0, (int) internal_windowNextFrameSlot(&next, 1550, 100));
+    ASSERT_EQ(1650, (int) next);
+    return 0;
+}
+
+int test_frameStats() {
+    static const uint64_t frameTimes[4] = {
+        10000000, 20000000, 30000000, 40000000
+    };
+    static const uint64_t fenceWaits[4] = { 1000000, 1000000, 2000000, 0 };
+    WindowFrameStats stats = internal_windowFrameStats(frameTimes,
+                                                       fenceWaits, 4);
+    ASSERT_EQ(4, (int) stats.frames);
+    ASSERT_FLOAT_EQ(25.0, stats.meanMs);
+    ASSERT_FLOAT_EQ(125.0, stats.varianceMs);
+    ASSERT_FLOAT_EQ(sqrt(125.0), stats.deviationMs);
+    ASSERT_FLOAT_EQ(10.0, stats.minMs);
+    ASSERT_FLOAT_EQ(40.0, stats.maxMs);
+    ASSERT_FLOAT_EQ(1.0, stats.fenceWaitMs);
+
+    // steady frames have no jitter
+    static const uint64_t steady[3] = { 16000000, 16000000, 16000000 };
+    stats = internal_windowFrameStats(steady, fenceWaits, 3);
+    ASSERT_FLOAT_EQ(16.0, stats.meanMs);
+    ASSERT_FLOAT_EQ(0.0, stats.deviationMs);
+
+    stats = internal_windowFrameStats(frameTimes, fenceWaits, 0);
+    ASSERT_EQ(0, (int) stats.frames);
+    ASSERT_FLOAT_EQ(0.0, stats.meanMs);
+    return 0;
+}
+
+// An animation invalidates while drawing, the request outlives the refresh
+int test_invalidateWhileDrawing() {
+    Window* window = windowNewHeadless(16, 16);
+    if (!window) {
+        printf("invalidate while drawing: no OpenGL context, skipped\n");
+        return 0;
+    }
+    windowSetLoopMode(window, WINDOW_LOOP_ON_DEMAND);
+    ASSERT_EQ(1, (int) windowNeedsRedraw(window));
+    for (int frame = 0; frame < 2; frame++) {
+        windowInvalidate(window);
+        windowRefresh(window);
+        ASSERT_EQ(1, (int) windowNeedsRedraw(window));
+    }
+
+    // a frame without a request leaves nothing pending, refreshing it
+    // continuously keeps an on demand refresh from waiting for events
+    windowSetLoopMode(window, WINDOW_LOOP_CONTINUOUS);
+    windowRefresh(window);
+    windowSetLoopMode(window, WINDOW_LOOP_ON_DEMAND);
+    ASSERT_EQ(0, (int) windowNeedsRedraw(window));
+
+    // with damage tracking the request damages the next frame
+    windowSetDamageTracking(window, 1);
+    windowInvalidate(window);
+    windowRefresh(window);
+    ASSERT_EQ(1, (int) windowNeedsRedraw(window));
+    ASSERT_EQ(0, (int) damageIsEmpty(windowGetDamage(window)));
+    windowDestroy(window);
+    return 0;
+}
+
+int main() {
+    int failed = 0;
+    failed += runTest("test_frameSlotsAdvance", test_frameSlotsAdvance);
+    failed += runTest("test_frameSlotsFallBehind", test_frameSlotsFallBehind);
+    failed += runTest("test_frameStats", test_frameStats);
+    failed += runTest("test_invalidateWhileDrawing",
+                      test_invalidateWhileDrawing);
+
+    printf("\n");
+    if (failed == 0)
+        printf(GREEN "All Tests Passed!\n" RESET);
+    else
+        printf(RED "%d Test(s) Failed.\n" RESET, failed);
+
+    return failed;
+}